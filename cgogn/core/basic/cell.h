@@ -123,8 +123,7 @@ public:
 	 * Creates a new Cell from an another one.
 	 * \param[in] c a cell
 	 */
-	inline Cell(const Self& c) : dart(c.dart)
-	{}
+	Cell(const Cell& c) = default;
 
 	/**
 	 * \brief Tests the validity of the cell.
@@ -139,7 +138,7 @@ public:
 	 * \param[in] rhs the cell to assign
 	 * \return The cell with the assigned value
 	 */
-	inline Self& operator=(Self rhs) { dart = rhs.dart; return *this; }
+	Cell& operator=(const Cell& rhs) = default;
 
 	/**
 	 * \brief Prints a cell to a stream.
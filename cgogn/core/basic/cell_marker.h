@@ -218,6 +218,137 @@ public:
 	{}
 };
 
+/**
+ * @brief CellMarker that can be shared by the workers of a parallel traversal
+ * It must be created and destroyed by the calling thread (its mark attribute comes from the pool of this thread).
+ * All the marking operations are atomic and test_and_mark allows a thread to claim a cell.
+ */
+template <typename MAP, Orbit ORBIT>
+class ConcurrentCellMarker : public CellMarker_T<MAP, ORBIT>
+{
+public:
+
+	using Inherit = CellMarker_T<MAP, ORBIT>;
+	using Self = ConcurrentCellMarker<MAP, ORBIT>;
+	using Map = typename Inherit::Map;
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ConcurrentCellMarker);
+
+	inline ConcurrentCellMarker(const MAP& map) :
+		Inherit(map)
+	{}
+
+	~ConcurrentCellMarker() override
+	{
+		if (this->is_valid())
+			unmark_all();
+	}
+
+	inline void mark(Cell<ORBIT> c)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid ConcurrentCellMarker");
+		this->mark_attribute_->test_and_set_true(this->map_.embedding(c));
+	}
+
+	inline void unmark(Cell<ORBIT> c)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid ConcurrentCellMarker");
+		this->mark_attribute_->test_and_set_false(this->map_.embedding(c));
+	}
+
+	/**
+	 * @brief mark the given cell
+	 * @return true if the cell was not marked, i.e. if the calling thread is the one that marked it
+	 */
+	inline bool test_and_mark(Cell<ORBIT> c)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid ConcurrentCellMarker");
+		return !this->mark_attribute_->test_and_set_true(this->map_.embedding(c));
+	}
+
+	/**
+	 * @brief unmark all the cells (not thread safe: call it once the parallel traversal is finished)
+	 */
+	inline void unmark_all()
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid ConcurrentCellMarker");
+		this->mark_attribute_->all_false();
+	}
+};
+
+/**
+ * @brief CellMarker backed by an array of generation stamps (cf. DartMarkerEpoch)
+ * unmark_all and the release of the marker are O(1).
+ */
+template <typename MAP, Orbit ORBIT>
+class CellMarkerEpoch
+{
+	static_assert(ORBIT < NB_ORBITS, "Unknown orbit parameter");
+
+public:
+
+	using Self = CellMarkerEpoch<MAP, ORBIT>;
+	using Map = MAP;
+	using ChunkArrayGen = typename Map::ChunkArrayGen;
+	using ChunkArrayStamp = typename Map::ChunkArrayStamp;
+
+protected:
+
+	MAP& map_;
+	ChunkArrayStamp* stamp_attribute_;
+
+public:
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(CellMarkerEpoch);
+
+	CellMarkerEpoch(const MAP& map) :
+		map_(const_cast<MAP&>(map))
+	{
+		stamp_attribute_ = map_.template stamp_attribute<ORBIT>();
+		stamp_attribute_->add_external_ref(reinterpret_cast<ChunkArrayGen**>(&stamp_attribute_));
+	}
+
+	~CellMarkerEpoch()
+	{
+		if (is_valid())
+		{
+			stamp_attribute_->next_epoch();
+			stamp_attribute_->remove_external_ref(reinterpret_cast<ChunkArrayGen**>(&stamp_attribute_));
+			map_.template release_stamp_attribute<ORBIT>(stamp_attribute_);
+		}
+	}
+
+	inline void mark(Cell<ORBIT> c)
+	{
+		cgogn_message_assert(is_valid(), "Invalid CellMarkerEpoch");
+		stamp_attribute_->set_true(map_.embedding(c));
+	}
+
+	inline void unmark(Cell<ORBIT> c)
+	{
+		cgogn_message_assert(is_valid(), "Invalid CellMarkerEpoch");
+		stamp_attribute_->set_false(map_.embedding(c));
+	}
+
+	inline bool is_marked(Cell<ORBIT> c) const
+	{
+		cgogn_message_assert(is_valid(), "Invalid CellMarkerEpoch");
+		return stamp_attribute_->is_true(map_.embedding(c));
+	}
+
+	inline void unmark_all()
+	{
+		cgogn_message_assert(is_valid(), "Invalid CellMarkerEpoch");
+		stamp_attribute_->next_epoch();
+	}
+
+	inline bool is_valid() const
+	{
+		// cf. CellMarker_T::is_valid
+		return stamp_attribute_ != nullptr;
+	}
+};
+
 } // namespace cgogn
 
 #endif // CGOGN_CORE_BASIC_CELL_MARKER_H_
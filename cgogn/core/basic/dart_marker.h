@@ -245,6 +245,172 @@ public:
 	{}
 };
 
+/**
+ * @brief DartMarker that can be shared by the workers of a parallel traversal
+ * It must be created and destroyed by the calling thread (its mark attribute comes from the pool of this thread).
+ * All the marking operations are atomic and test_and_mark allows a thread to claim a dart.
+ */
+template <typename MAP>
+class ConcurrentDartMarker : public DartMarker_T<MAP>
+{
+public:
+
+	using Inherit = DartMarker_T<MAP>;
+	using Self = ConcurrentDartMarker<MAP>;
+	using Map = MAP;
+
+	ConcurrentDartMarker(const MAP& map) :
+		Inherit(map)
+	{}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ConcurrentDartMarker);
+
+	~ConcurrentDartMarker() override
+	{
+		if (this->is_valid())
+			unmark_all();
+	}
+
+	inline void mark(Dart d)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid ConcurrentDartMarker");
+		this->mark_attribute_->test_and_set_true(d.index);
+	}
+
+	inline void unmark(Dart d)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid ConcurrentDartMarker");
+		this->mark_attribute_->test_and_set_false(d.index);
+	}
+
+	/**
+	 * @brief mark the given dart
+	 * @return true if the dart was not marked, i.e. if the calling thread is the one that marked it
+	 */
+	inline bool test_and_mark(Dart d)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid ConcurrentDartMarker");
+		return !this->mark_attribute_->test_and_set_true(d.index);
+	}
+
+	template <Orbit ORBIT>
+	inline void mark_orbit(Cell<ORBIT> c)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid ConcurrentDartMarker");
+		this->map_.foreach_dart_of_orbit(c, [this] (Dart d) { this->mark_attribute_->test_and_set_true(d.index); });
+	}
+
+	template <Orbit ORBIT>
+	inline void unmark_orbit(Cell<ORBIT> c)
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid ConcurrentDartMarker");
+		this->map_.foreach_dart_of_orbit(c, [this] (Dart d) { this->mark_attribute_->test_and_set_false(d.index); });
+	}
+
+	/**
+	 * @brief unmark all the darts (not thread safe: call it once the parallel traversal is finished)
+	 */
+	inline void unmark_all()
+	{
+		cgogn_message_assert(this->is_valid(), "Invalid ConcurrentDartMarker");
+		this->mark_attribute_->all_false();
+	}
+};
+
+/**
+ * @brief DartMarker backed by an array of generation stamps
+ * A dart is marked if its stamp equals the current epoch of the array: unmark_all and the
+ * release of the marker only increment the epoch (O(1)), the stamps being reset when the
+ * epoch wraps around (every 65535 uses of the array).
+ * It uses 16 bits per dart instead of 1 and suits markers used many times for local queries.
+ */
+template <typename MAP>
+class DartMarkerEpoch
+{
+public:
+
+	using Self = DartMarkerEpoch<MAP>;
+	using Map = MAP;
+	using ChunkArrayGen = typename Map::ChunkArrayGen;
+	using ChunkArrayStamp = typename Map::ChunkArrayStamp;
+
+protected:
+
+	Map& map_;
+	ChunkArrayStamp* stamp_attribute_;
+
+public:
+
+	DartMarkerEpoch(const MAP& map) :
+		map_(const_cast<MAP&>(map))
+	{
+		stamp_attribute_ = map_.topology_stamp_attribute();
+		stamp_attribute_->add_external_ref(reinterpret_cast<ChunkArrayGen**>(&stamp_attribute_));
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(DartMarkerEpoch);
+
+	~DartMarkerEpoch()
+	{
+		if (is_valid())
+		{
+			stamp_attribute_->next_epoch();
+			stamp_attribute_->remove_external_ref(reinterpret_cast<ChunkArrayGen**>(&stamp_attribute_));
+			map_.release_topology_stamp_attribute(stamp_attribute_);
+		}
+	}
+
+	inline void mark(Dart d)
+	{
+		cgogn_message_assert(is_valid(), "Invalid DartMarkerEpoch");
+		stamp_attribute_->set_true(d.index);
+	}
+
+	inline void unmark(Dart d)
+	{
+		cgogn_message_assert(is_valid(), "Invalid DartMarkerEpoch");
+		stamp_attribute_->set_false(d.index);
+	}
+
+	inline bool is_marked(Dart d) const
+	{
+		cgogn_message_assert(is_valid(), "Invalid DartMarkerEpoch");
+		return stamp_attribute_->is_true(d.index);
+	}
+
+	template <Orbit ORBIT>
+	inline void mark_orbit(Cell<ORBIT> c)
+	{
+		cgogn_message_assert(is_valid(), "Invalid DartMarkerEpoch");
+		map_.foreach_dart_of_orbit(c, [&] (Dart d)
+		{
+			stamp_attribute_->set_true(d.index);
+		});
+	}
+
+	template <Orbit ORBIT>
+	inline void unmark_orbit(Cell<ORBIT> c)
+	{
+		cgogn_message_assert(is_valid(), "Invalid DartMarkerEpoch");
+		map_.foreach_dart_of_orbit(c, [&] (Dart d)
+		{
+			stamp_attribute_->set_false(d.index);
+		});
+	}
+
+	inline void unmark_all()
+	{
+		cgogn_message_assert(is_valid(), "Invalid DartMarkerEpoch");
+		stamp_attribute_->next_epoch();
+	}
+
+	inline bool is_valid() const
+	{
+		// cf. DartMarker_T::is_valid
+		return stamp_attribute_ != nullptr;
+	}
+};
+
 } // namespace cgogn
 
 #endif // CGOGN_CORE_BASIC_DART_MARKER_H_
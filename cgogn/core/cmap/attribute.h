@@ -37,7 +37,6 @@ namespace cgogn
 
 /**
  * \brief Generic Attribute class
- * @TPARAM DATA_TRAITS storage traits (for MapBaseData ptr type)
  */
 class AttributeGen
 {
@@ -45,20 +44,13 @@ public:
 
 	using Self = AttributeGen;
 
-	using ChunkArrayGen = MapBaseData::ChunkArrayGen;
-	using ChunkArrayContainer = MapBaseData::ChunkArrayContainer<uint32>;
-	template <typename T>
-	using ChunkArray = MapBaseData::ChunkArray<T>;
-
-	static const uint32 CHUNK_SIZE = MapBaseData::CHUNK_SIZE;
-
 protected:
 
-	MapBaseData* map_;
+	MapBaseGen* map_;
 
 public:
 
-	inline AttributeGen(MapBaseData* const map) :
+	inline AttributeGen(MapBaseGen* const map) :
 		map_(map)
 	{}
 
@@ -85,7 +77,7 @@ public:
 	virtual ~AttributeGen()
 	{}
 
-	inline bool is_linked_to(MapBaseData* m) const
+	inline bool is_linked_to(const MapBaseGen* m) const
 	{
 		return m == map_;
 	}
@@ -98,20 +90,24 @@ public:
 /**
  * @brief The Attribute_T class
  * @TPARAM T the data type of the attribute to handlde
+ * @TPARAM CHUNK_SIZE chunk size of the containers of the map
  * In this class we do not know the orbit of the Attribute.
  */
-template <typename T>
+template <typename T, uint32 CHUNK_SIZE_ = CGOGN_CHUNK_SIZE>
 class Attribute_T : public AttributeGen
 {
 public:
 
 	using Inherit = AttributeGen;
-	using Self = Attribute_T<T>;
+	using Self = Attribute_T<T, CHUNK_SIZE_>;
 	using value_type = T;
 
-	using ChunkArrayGen = typename Inherit::ChunkArrayGen;
-	using ChunkArrayContainer = typename Inherit::ChunkArrayContainer;
-	using TChunkArray = typename Inherit::ChunkArray<T>;
+	static const uint32 CHUNK_SIZE = CHUNK_SIZE_;
+
+	using MapData = MapBaseData_T<CHUNK_SIZE>;
+	using ChunkArrayGen = typename MapData::ChunkArrayGen;
+	using ChunkArrayContainer = typename MapData::template ChunkArrayContainer<uint32>;
+	using TChunkArray = typename MapData::template ChunkArray<T>;
 
 	inline Attribute_T() :
 		Inherit(nullptr),
@@ -120,7 +116,7 @@ public:
 		orbit_(Orbit(NB_ORBITS))
 	{}
 
-	Attribute_T(MapBaseData* const map, TChunkArray* const ca, Orbit orbit) :
+	Attribute_T(MapData* const map, TChunkArray* const ca, Orbit orbit) :
 		Inherit(map),
 		chunk_array_(ca),
 		orbit_(orbit)
@@ -211,13 +207,13 @@ public:
 	inline T& operator[](Dart d)
 	{
 		cgogn_message_assert(this->is_valid(), "Invalid Attribute");
-		return this->chunk_array_->operator[](this->map_->embedding(d, orbit_));
+		return this->chunk_array_->operator[](this->map()->embedding(d, orbit_));
 	}
 
 	inline const T& operator[](Dart d) const
 	{
 		cgogn_message_assert(this->is_valid(), "Invalid Attribute");
-		return this->chunk_array_->operator[](this->map_->embedding(d, orbit_));
+		return this->chunk_array_->operator[](this->map()->embedding(d, orbit_));
 	}
 
 	virtual const std::string& name() const override
@@ -363,23 +359,34 @@ public:
 
 protected:
 
+	inline MapData* map() const
+	{
+		return static_cast<MapData*>(this->map_);
+	}
+
 	const ChunkArrayContainer* chunk_array_cont_;
 	TChunkArray*               chunk_array_;
 	Orbit                      orbit_;
 };
 
+template <typename T, uint32 CHUNK_SIZE_>
+const uint32 Attribute_T<T, CHUNK_SIZE_>::CHUNK_SIZE;
+
 /**
  * \brief Attribute class
  * @TPARAM T the data type of the attribute to handlde
+ * @TPARAM ORBIT orbit of the attribute
+ * @TPARAM CHUNK_SIZE chunk size of the containers of the map
  */
-template <typename T, Orbit ORBIT>
-class Attribute : public Attribute_T<T>
+template <typename T, Orbit ORBIT, uint32 CHUNK_SIZE_ = CGOGN_CHUNK_SIZE>
+class Attribute : public Attribute_T<T, CHUNK_SIZE_>
 {
 public:
 
-	using Inherit = Attribute_T<T>;
-	using Self = Attribute<T, ORBIT>;
+	using Inherit = Attribute_T<T, CHUNK_SIZE_>;
+	using Self = Attribute<T, ORBIT, CHUNK_SIZE_>;
 
+	using MapData = typename Inherit::MapData;
 	using TChunkArray = typename Inherit::TChunkArray;
 	using Inherit::operator[];
 
@@ -394,7 +401,7 @@ public:
 		Inherit(nullptr, nullptr, Orbit())
 	{}
 
-	inline Attribute(MapBaseData* const map, TChunkArray* const ca) :
+	inline Attribute(MapData* const map, TChunkArray* const ca) :
 		Inherit(map, ca, ORBIT)
 	{}
 
@@ -429,7 +436,7 @@ public:
 	inline T& operator[](Cell<ORBIT> c)
 	{
 		cgogn_message_assert(this->is_valid(), "Invalid Attribute");
-		return this->chunk_array_->operator[](this->map_->embedding(c));
+		return this->chunk_array_->operator[](this->map()->embedding(c));
 	}
 
 	/**
@@ -440,7 +447,7 @@ public:
 	inline const T& operator[](Cell<ORBIT> c) const
 	{
 		cgogn_message_assert(this->is_valid(), "Invalid Attribute");
-		return this->chunk_array_->operator[](this->map_->embedding(c));
+		return this->chunk_array_->operator[](this->map()->embedding(c));
 	}
 
 	inline Orbit orbit() const
@@ -50,6 +50,7 @@ public:
 	friend class MapBase<MAP_TYPE>;
 	friend class CMap0Builder_T<Self>;
 	friend class DartMarker_T<Self>;
+	friend class cgogn::DartMarkerEpoch<Self>;
 	friend class cgogn::DartMarkerStore<Self>;
 
 	using CDart  = Cell<Orbit::DART>;
@@ -65,16 +66,22 @@ public:
 	using ChunkArray = typename Inherit::template ChunkArray<T>;
 
 	template <typename T>
-	using VertexAttribute = Attribute<T, Vertex::ORBIT>;
+	using VertexAttribute = Attribute<T, Vertex::ORBIT, Inherit::CHUNK_SIZE>;
 
 	using DartMarker = typename cgogn::DartMarker<Self>;
 	using DartMarkerStore = typename cgogn::DartMarkerStore<Self>;
+	using ConcurrentDartMarker = typename cgogn::ConcurrentDartMarker<Self>;
+	using DartMarkerEpoch = typename cgogn::DartMarkerEpoch<Self>;
 
 	template <Orbit ORBIT>
 	using CellMarker = typename cgogn::CellMarker<Self, ORBIT>;
 	template <Orbit ORBIT>
 	using CellMarkerNoUnmark = typename cgogn::CellMarkerNoUnmark<Self, ORBIT>;
 	template <Orbit ORBIT>
+	using ConcurrentCellMarker = typename cgogn::ConcurrentCellMarker<Self, ORBIT>;
+	template <Orbit ORBIT>
+	using CellMarkerEpoch = typename cgogn::CellMarkerEpoch<Self, ORBIT>;
+	template <Orbit ORBIT>
 	using CellMarkerStore = typename cgogn::CellMarkerStore<Self, ORBIT>;
 
 	using FilteredQuickTraversor = typename cgogn::FilteredQuickTraversor<Self>;
@@ -216,6 +223,7 @@ protected:
 struct CMap0Type
 {
 	using TYPE = CMap0_T<CMap0Type>;
+	static const uint32 CHUNK_SIZE = CGOGN_CHUNK_SIZE;
 };
 
 using CMap0 = CMap0_T<CMap0Type>;
@@ -50,6 +50,7 @@ public:
 	friend class MapBase<MAP_TYPE>;
 	friend class CMap1Builder_T<Self>;
 	friend class DartMarker_T<Self>;
+	friend class cgogn::DartMarkerEpoch<Self>;
 	friend class cgogn::DartMarkerStore<Self>;
 
 	using CDart  = typename Inherit::Vertex;
@@ -67,18 +68,24 @@ public:
 	using ChunkArray = typename Inherit::template ChunkArray<T>;
 
 	template <typename T>
-	using VertexAttribute = Attribute<T, Vertex::ORBIT>;
+	using VertexAttribute = Attribute<T, Vertex::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using FaceAttribute = Attribute<T, Face::ORBIT>;
+	using FaceAttribute = Attribute<T, Face::ORBIT, Inherit::CHUNK_SIZE>;
 
 	using DartMarker = typename cgogn::DartMarker<Self>;
 	using DartMarkerStore = typename cgogn::DartMarkerStore<Self>;
+	using ConcurrentDartMarker = typename cgogn::ConcurrentDartMarker<Self>;
+	using DartMarkerEpoch = typename cgogn::DartMarkerEpoch<Self>;
 
 	template <Orbit ORBIT>
 	using CellMarker = typename cgogn::CellMarker<Self, ORBIT>;
 	template <Orbit ORBIT>
 	using CellMarkerNoUnmark = typename cgogn::CellMarkerNoUnmark<Self, ORBIT>;
 	template <Orbit ORBIT>
+	using ConcurrentCellMarker = typename cgogn::ConcurrentCellMarker<Self, ORBIT>;
+	template <Orbit ORBIT>
+	using CellMarkerEpoch = typename cgogn::CellMarkerEpoch<Self, ORBIT>;
+	template <Orbit ORBIT>
 	using CellMarkerStore = typename cgogn::CellMarkerStore<Self, ORBIT>;
 
 	using FilteredQuickTraversor = typename cgogn::FilteredQuickTraversor<Self>;
@@ -187,6 +194,7 @@ protected:
 		(*phi1_)[e.index] = f;
 		(*phi_1_)[g.index] = d;
 		(*phi_1_)[f.index] = e;
+		this->topology_changed();
 	}
 
 	/*!
@@ -203,6 +211,7 @@ protected:
 		(*phi1_)[e.index] = e;
 		(*phi_1_)[f.index] = d;
 		(*phi_1_)[e.index] = e;
+		this->topology_changed();
 	}
 
 	/*******************************************************************************
@@ -287,7 +296,11 @@ public:
 	{
 		CGOGN_CHECK_CONCRETE_TYPE;
 
+		const uint64 revision = this->topology_revision();
 		const Face f(add_face_topo(size));
+		this->template update_cell_counter<Vertex>(revision, int32(size));
+		this->template update_cell_counter<Face>(revision, 1);
+		this->cell_counters_updated(revision);
 
 		if (this->template is_embedded<Vertex>())
 		{
@@ -331,7 +344,14 @@ public:
 	{
 		CGOGN_CHECK_CONCRETE_TYPE;
 
+		int32 nb_vertices = 0;
+		foreach_dart_of_orbit(f, [&] (Dart d) { if (!this->is_boundary(d)) ++nb_vertices; });
+
+		const uint64 revision = this->topology_revision();
 		remove_face_topo(f.dart);
+		this->template update_cell_counter<Vertex>(revision, -nb_vertices);
+		this->template update_cell_counter<Face>(revision, -1);
+		this->cell_counters_updated(revision);
 	}
 
 protected:
@@ -363,7 +383,10 @@ public:
 	{
 		CGOGN_CHECK_CONCRETE_TYPE;
 
+		const uint64 revision = this->topology_revision();
 		const Vertex nv(split_vertex_topo(v.dart));
+		this->template update_cell_counter<Vertex>(revision, 1);
+		this->cell_counters_updated(revision);
 
 		if (this->template is_embedded<Vertex>())
 			this->new_orbit_embedding(nv);
@@ -399,7 +422,14 @@ public:
 	{
 		CGOGN_CHECK_CONCRETE_TYPE;
 
+		const bool last_vertex = phi1(v.dart) == v.dart;
+		const bool boundary = this->is_boundary(v.dart);
+
+		const uint64 revision = this->topology_revision();
 		remove_vertex_topo(v.dart);
+		this->template update_cell_counter<Vertex>(revision, boundary ? 0 : -1);
+		this->template update_cell_counter<Face>(revision, last_vertex ? -1 : 0);
+		this->cell_counters_updated(revision);
 	}
 
 protected:
@@ -688,6 +718,7 @@ protected:
 struct CMap1Type
 {
 	using TYPE = CMap1_T<CMap1Type>;
+	static const uint32 CHUNK_SIZE = CGOGN_CHUNK_SIZE;
 };
 
 using CMap1 = CMap1_T<CMap1Type>;
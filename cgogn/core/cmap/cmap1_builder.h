@@ -127,11 +127,15 @@ public:
 
 	inline ChunkArray<Dart>& ca_phi1()
 	{
+		// the topology may be modified through the returned reference
+		map_.topology_changed();
 		return *(map_.phi1_);
 	}
 
 	inline ChunkArrayContainer<uint8>& cac_topology()
 	{
+		// the topology may be modified through the returned reference
+		map_.topology_changed();
 		return map_.topology_;
 	}
 
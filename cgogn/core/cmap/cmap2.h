@@ -24,6 +24,10 @@
 #ifndef CGOGN_CORE_CMAP_CMAP2_H_
 #define CGOGN_CORE_CMAP_CMAP2_H_
 
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
+
 #include <cgogn/core/cmap/cmap1.h>
 
 namespace cgogn
@@ -49,6 +53,7 @@ public:
 	friend class MapBase<MAP_TYPE>;
 	friend class CMap2Builder_T<Self>;
 	friend class DartMarker_T<Self>;
+	friend class cgogn::DartMarkerEpoch<Self>;
 	friend class cgogn::DartMarkerStore<Self>;
 
 	using CDart  = typename Inherit::Vertex;
@@ -67,18 +72,20 @@ public:
 	using ChunkArray = typename Inherit::template ChunkArray<T>;
 
 	template <typename T>
-	using CDartAttribute = Attribute<T, CDart::ORBIT>;
+	using CDartAttribute = Attribute<T, CDart::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using VertexAttribute = Attribute<T, Vertex::ORBIT>;
+	using VertexAttribute = Attribute<T, Vertex::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using EdgeAttribute = Attribute<T, Edge::ORBIT>;
+	using EdgeAttribute = Attribute<T, Edge::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using FaceAttribute = Attribute<T, Face::ORBIT>;
+	using FaceAttribute = Attribute<T, Face::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using VolumeAttribute = Attribute<T, Volume::ORBIT>;
+	using VolumeAttribute = Attribute<T, Volume::ORBIT, Inherit::CHUNK_SIZE>;
 
 	using DartMarker = typename cgogn::DartMarker<Self>;
 	using DartMarkerStore = typename cgogn::DartMarkerStore<Self>;
+	using ConcurrentDartMarker = typename cgogn::ConcurrentDartMarker<Self>;
+	using DartMarkerEpoch = typename cgogn::DartMarkerEpoch<Self>;
 	using DartMarkerNoUnmark = typename cgogn::DartMarkerNoUnmark<Self>;
 
 	template <Orbit ORBIT>
@@ -86,11 +93,17 @@ public:
 	template <Orbit ORBIT>
 	using CellMarkerNoUnmark = typename cgogn::CellMarkerNoUnmark<Self, ORBIT>;
 	template <Orbit ORBIT>
+	using ConcurrentCellMarker = typename cgogn::ConcurrentCellMarker<Self, ORBIT>;
+	template <Orbit ORBIT>
+	using CellMarkerEpoch = typename cgogn::CellMarkerEpoch<Self, ORBIT>;
+	template <Orbit ORBIT>
 	using CellMarkerStore = typename cgogn::CellMarkerStore<Self, ORBIT>;
 
 	using FilteredQuickTraversor = typename cgogn::FilteredQuickTraversor<Self>;
 	using QuickTraversor = typename cgogn::QuickTraversor<Self>;
 	using CellCache = typename cgogn::CellCache<Self>;
+	using DirtyCellCache = typename cgogn::DirtyCellCache<Self>;
+	using IncrementalCellCache = typename cgogn::IncrementalCellCache<Self>;
 	using BoundaryCache = typename cgogn::BoundaryCache<Self>;
 
 protected:
@@ -195,6 +208,7 @@ protected:
 		cgogn_assert(phi2(e) == e);
 		(*phi2_)[d.index] = e;
 		(*phi2_)[e.index] = d;
+		this->topology_changed();
 	}
 
 	/**
@@ -208,6 +222,7 @@ protected:
 		Dart e = phi2(d);
 		(*phi2_)[d.index] = d;
 		(*phi2_)[e.index] = e;
+		this->topology_changed();
 	}
 
 	/*******************************************************************************
@@ -252,6 +267,97 @@ public:
 
 protected:
 
+	/**
+	 * \brief Record for the topology observers that the cells incident to the given darts have been modified.
+	 */
+	inline void record_incident_cells_modified(std::initializer_list<Dart> darts)
+	{
+		if (!this->has_topology_observers())
+			return;
+
+		for (Dart d : darts)
+		{
+			this->record_cell_modified(CDart(d));
+			this->record_cell_modified(Vertex(d));
+			this->record_cell_modified(Edge(d));
+			this->record_cell_modified(Face(d));
+			this->record_cell_modified(Volume(d));
+		}
+	}
+
+	/**
+	 * \brief Record for the topology observers that the cells incident to the darts of c,
+	 * or to their successors in their face, have been modified.
+	 */
+	template <Orbit ORBIT>
+	inline void record_neighborhood_modified(Cell<ORBIT> c)
+	{
+		if (!this->has_topology_observers())
+			return;
+
+		foreach_dart_of_orbit(c, [this] (Dart d)
+		{
+			this->record_incident_cells_modified({ d, this->phi1(d) });
+		});
+	}
+
+	/**
+	 * \brief Record for the topology observers the cut of the edge of d by the vertex of v (cf. cut_edge)
+	 */
+	inline void record_edge_cut(Dart d, Dart v)
+	{
+		if (!this->has_topology_observers())
+			return;
+
+		const Dart nf = phi2(d);
+		if (!this->is_boundary(v)) this->record_cell_created(CDart(v));
+		if (!this->is_boundary(nf)) this->record_cell_created(CDart(nf));
+		this->record_cell_created(Vertex(v));
+		this->record_cell_created(Edge(v));
+		this->record_cell_modified(Edge(d));
+		this->record_cell_modified(Face(d));
+		this->record_cell_modified(Face(nf));
+		this->record_cell_modified(Volume(d));
+	}
+
+	/**
+	 * \brief Record for the topology observers the cut of the face of d and e by the edge of nd (cf. cut_face)
+	 */
+	inline void record_face_cut(Dart d, Dart e, Dart nd)
+	{
+		if (!this->has_topology_observers())
+			return;
+
+		const Dart ne = phi2(nd);
+		this->record_cell_created(CDart(nd));
+		this->record_cell_created(CDart(ne));
+		this->record_cell_created(Edge(nd));
+		this->record_cell_created(Face(ne));
+		this->record_cell_modified(Face(d));
+		this->record_cell_modified(Vertex(d));
+		this->record_cell_modified(Vertex(e));
+		this->record_cell_modified(Volume(d));
+	}
+
+	/**
+	 * \brief Record for the topology observers that all the cells of the new volume v have been created.
+	 */
+	inline void record_volume_created(Volume v)
+	{
+		if (!this->has_topology_observers())
+			return;
+
+		foreach_dart_of_orbit(v, [this] (Dart d)
+		{
+			if (!this->is_boundary(d))
+				this->record_cell_created(CDart(d));
+		});
+		foreach_incident_vertex(v, [this] (Vertex w) { this->record_cell_created(w); });
+		foreach_incident_edge(v, [this] (Edge e) { this->record_cell_created(e); });
+		foreach_incident_face(v, [this] (Face f) { this->record_cell_created(f); });
+		this->record_cell_created(v);
+	}
+
 	/**
 	 * \brief Add a face in the map.
 	 * \param size : the number of darts in the built face
@@ -304,7 +410,14 @@ public:
 	{
 		CGOGN_CHECK_CONCRETE_TYPE;
 
+		const uint64 revision = this->topology_revision();
 		const Face f(add_face_topo(size));
+		this->template update_cell_counter<CDart>(revision, int32(size));
+		this->template update_cell_counter<Vertex>(revision, int32(size));
+		this->template update_cell_counter<Edge>(revision, int32(size));
+		this->template update_cell_counter<Face>(revision, 1);
+		this->template update_cell_counter<Volume>(revision, 1);
+		this->cell_counters_updated(revision);
 
 		if (this->template is_embedded<CDart>())
 		{
@@ -336,6 +449,9 @@ public:
 		if (this->template is_embedded<Volume>())
 			this->new_orbit_embedding(Volume(f.dart));
 
+		record_volume_created(Volume(f.dart));
+		this->flush_topology_events();
+
 		return f;
 	}
 
@@ -374,7 +490,14 @@ public:
 	{
 		CGOGN_CHECK_CONCRETE_TYPE;
 
+		const uint64 revision = this->topology_revision();
 		const Volume vol(add_pyramid_topo(size));
+		this->template update_cell_counter<CDart>(revision, int32(4u * size));
+		this->template update_cell_counter<Vertex>(revision, int32(size + 1u));
+		this->template update_cell_counter<Edge>(revision, int32(2u * size));
+		this->template update_cell_counter<Face>(revision, int32(size + 1u));
+		this->template update_cell_counter<Volume>(revision, 1);
+		this->cell_counters_updated(revision);
 
 		if (this->template is_embedded<CDart>())
 		{
@@ -411,6 +534,9 @@ public:
 		if (this->template is_embedded<Volume>())
 			this->new_orbit_embedding(vol);
 
+		record_volume_created(vol);
+		this->flush_topology_events();
+
 		return vol;
 	}
 
@@ -449,7 +575,14 @@ public:
 	{
 		CGOGN_CHECK_CONCRETE_TYPE;
 
+		const uint64 revision = this->topology_revision();
 		const Volume vol(add_prism_topo(size));
+		this->template update_cell_counter<CDart>(revision, int32(6u * size));
+		this->template update_cell_counter<Vertex>(revision, int32(2u * size));
+		this->template update_cell_counter<Edge>(revision, int32(3u * size));
+		this->template update_cell_counter<Face>(revision, int32(size + 2u));
+		this->template update_cell_counter<Volume>(revision, 1);
+		this->cell_counters_updated(revision);
 
 		if (this->template is_embedded<CDart>())
 		{
@@ -486,6 +619,9 @@ public:
 		if (this->template is_embedded<Volume>())
 			this->new_orbit_embedding(vol);
 
+		record_volume_created(vol);
+		this->flush_topology_events();
+
 		return vol;
 	}
 
@@ -520,6 +656,7 @@ public:
 		CGOGN_CHECK_CONCRETE_TYPE;
 
 		remove_volume_topo(v.dart);
+		this->flush_topology_events();
 	}
 
 protected:
@@ -535,13 +672,9 @@ protected:
 	{
 		Dart e = phi2(d);						// Get the adjacent 1D-edge
 
-		phi2_unsew(d);							// Separate the two 1D-edges of the edge
-
-		Dart nd = this->Inherit::split_vertex_topo(d);
-		Dart ne = this->Inherit::split_vertex_topo(e);	// Cut the two adjacent 1D-edges
-
-		phi2_sew(d, ne);						// Sew the new 1D-edges
-		phi2_sew(e, nd);						// To build the new 2D-edges
+		Dart nd = this->add_topology_element();
+		Dart ne = this->add_topology_element();
+		cut_edge_topo(d, nd, ne);
 
 		this->set_boundary(nd, this->is_boundary(d));
 		this->set_boundary(ne, this->is_boundary(e));
@@ -549,6 +682,23 @@ protected:
 		return nd;
 	}
 
+	/**
+	 * \brief Cut the edge of d with the two given isolated darts (see cut_edge_topo(Dart))
+	 * nd is inserted after d and ne after phi2(d). Their boundary marks are not set.
+	 */
+	inline void cut_edge_topo(Dart d, Dart nd, Dart ne)
+	{
+		Dart e = phi2(d);						// Get the adjacent 1D-edge
+
+		phi2_unsew(d);							// Separate the two 1D-edges of the edge
+
+		this->phi1_sew(d, nd);
+		this->phi1_sew(e, ne);					// Cut the two adjacent 1D-edges
+
+		phi2_sew(d, ne);						// Sew the new 1D-edges
+		phi2_sew(e, nd);						// To build the new 2D-edges
+	}
+
 public:
 
 	/**
@@ -568,9 +718,14 @@ public:
 	{
 		CGOGN_CHECK_CONCRETE_TYPE;
 
+		const uint64 revision = this->topology_revision();
 		const Dart v = cut_edge_topo(e.dart);
 		const Dart nf = phi2(e.dart);
 		const Dart f = phi2(v);
+		this->template update_cell_counter<CDart>(revision, int32(!this->is_boundary(v)) + int32(!this->is_boundary(nf)));
+		this->template update_cell_counter<Vertex>(revision, 1);
+		this->template update_cell_counter<Edge>(revision, 1);
+		this->cell_counters_updated(revision);
 
 		if (this->template is_embedded<CDart>())
 		{
@@ -601,6 +756,9 @@ public:
 			this->template copy_embedding<Volume>(nf, e.dart);
 		}
 
+		record_edge_cut(e.dart, v);
+		this->flush_topology_events();
+
 		return Vertex(v);
 	}
 
@@ -670,8 +828,12 @@ public:
 	{
 		CGOGN_CHECK_CONCRETE_TYPE;
 
+		const uint64 revision = this->topology_revision();
 		if (flip_edge_topo(e.dart))
 		{
+			// a flip does not change the number of cells
+			this->cell_counters_updated(revision);
+
 			Dart d = e.dart;
 			Dart d2 = phi2(d);
 
@@ -686,6 +848,11 @@ public:
 				this->template copy_embedding<Face>(this->phi_1(d), d);
 				this->template copy_embedding<Face>(this->phi_1(d2), d2);
 			}
+
+			// the two incident faces contain the old and new endpoints of the edge
+			record_neighborhood_modified(Face(d));
+			record_neighborhood_modified(Face(d2));
+			this->flush_topology_events();
 		}
 	}
 
@@ -693,8 +860,12 @@ public:
 	{
 		CGOGN_CHECK_CONCRETE_TYPE;
 
+		const uint64 revision = this->topology_revision();
 		if (flip_back_edge_topo(e.dart))
 		{
+			// a flip does not change the number of cells
+			this->cell_counters_updated(revision);
+
 			const Dart d = e.dart;
 			const Dart d2 = phi2(d);
 
@@ -709,6 +880,11 @@ public:
 				this->template copy_embedding<Face>(this->phi1(d), d);
 				this->template copy_embedding<Face>(this->phi1(d2), d2);
 			}
+
+			// the two incident faces contain the old and new endpoints of the edge
+			record_neighborhood_modified(Face(d));
+			record_neighborhood_modified(Face(d2));
+			this->flush_topology_events();
 		}
 	}
 
@@ -826,8 +1002,32 @@ public:
 		Dart e1 = phi2(this->phi_1(e.dart));
 		Dart e2 = phi2(this->phi_1(phi2(e.dart)));
 
+		// the collapsed edge and its vertices are merged, as well as the two other edges of incident triangles
+		const uint64 revision = this->topology_revision();
+		int32 nb_darts = 0, nb_edges = -1, nb_faces = 0;
+		for (Dart d : { e.dart, phi2(e.dart) })
+		{
+			const bool boundary = this->is_boundary(d);
+			nb_darts -= int32(!boundary);
+			if (codegree(Face(d)) == 3u)
+			{
+				--nb_edges;
+				if (!boundary)
+				{
+					nb_darts -= 2;
+					--nb_faces;
+				}
+			}
+		}
+
 		Vertex v(collapse_edge_topo(e.dart));
 
+		this->template update_cell_counter<CDart>(revision, nb_darts);
+		this->template update_cell_counter<Vertex>(revision, -1);
+		this->template update_cell_counter<Edge>(revision, nb_edges);
+		this->template update_cell_counter<Face>(revision, nb_faces);
+		this->cell_counters_updated(revision);
+
 		if (this->template is_embedded<Vertex>())
 			this->template set_orbit_embedding<Vertex>(v, this->embedding(v));
 
@@ -837,6 +1037,9 @@ public:
 			this->template copy_embedding<Edge>(phi2(e2), e2);
 		}
 
+		record_neighborhood_modified(v);
+		this->flush_topology_events();
+
 		return v;
 	}
 
@@ -864,7 +1067,12 @@ public:
 		const Dart dd = phi2(d) ;
 		const Dart ee = phi2(e) ;
 
+		const uint64 revision = this->topology_revision();
 		split_vertex_topo(d, e) ;
+		this->template update_cell_counter<CDart>(revision, int32(!this->is_boundary(this->phi1(dd))) + int32(!this->is_boundary(this->phi1(ee))));
+		this->template update_cell_counter<Vertex>(revision, 1);
+		this->template update_cell_counter<Edge>(revision, 1);
+		this->cell_counters_updated(revision);
 
 		if (this->template is_embedded<CDart>())
 		{
@@ -888,6 +1096,17 @@ public:
 			this->template copy_embedding<Face>(this->phi1(dd), dd);
 			this->template copy_embedding<Face>(this->phi1(ee), ee);
 		}
+
+		if (this->has_topology_observers())
+		{
+			if (!this->is_boundary(this->phi1(dd))) this->record_cell_created(CDart(this->phi1(dd)));
+			if (!this->is_boundary(this->phi1(ee))) this->record_cell_created(CDart(this->phi1(ee)));
+			this->record_cell_created(Vertex(e));
+			this->record_cell_created(Edge(this->phi1(dd)));
+			record_neighborhood_modified(Vertex(d));
+			record_neighborhood_modified(Vertex(e));
+			this->flush_topology_events();
+		}
 	}
 
 protected:
@@ -916,10 +1135,20 @@ public:
 		CGOGN_CHECK_CONCRETE_TYPE;
 
 		Dart d = this->phi_1(v.dart);
+		const uint64 revision = this->topology_revision();
+		const int32 nb_darts = int32(!this->is_boundary(v.dart)) + int32(!this->is_boundary(this->phi1(phi2(v.dart))));
 		if (merge_incident_edges_topo(v.dart))
 		{
+			this->template update_cell_counter<CDart>(revision, -nb_darts);
+			this->template update_cell_counter<Vertex>(revision, -1);
+			this->template update_cell_counter<Edge>(revision, -1);
+			this->cell_counters_updated(revision);
+
 			if (this->template is_embedded<Edge>())
 				this->template copy_embedding<Edge>(phi2(d), d);
+
+			record_incident_cells_modified({ d, phi2(d), this->phi1(d), this->phi1(phi2(d)) });
+			this->flush_topology_events();
 		}
 	}
 
@@ -959,10 +1188,24 @@ public:
 		CGOGN_CHECK_CONCRETE_TYPE;
 
 		Dart d1 = this->phi1(e.dart);
+		// the counters are not updated when the edge is incident twice to the same face
+		const bool same_face = this->same_cell(Face(e.dart), Face(phi2(e.dart)));
+		const uint64 revision = this->topology_revision();
 		if (merge_incident_faces_of_edge_topo(e.dart))
 		{
+			if (!same_face)
+			{
+				this->template update_cell_counter<CDart>(revision, -2);
+				this->template update_cell_counter<Edge>(revision, -1);
+				this->template update_cell_counter<Face>(revision, -1);
+				this->cell_counters_updated(revision);
+			}
+
 			if (this->template is_embedded<Face>())
 				this->template set_orbit_embedding<Face>(Face(d1), this->embedding(Face(d1)));
+
+			record_neighborhood_modified(Face(d1));
+			this->flush_topology_events();
 		}
 	}
 
@@ -1010,6 +1253,9 @@ public:
 		{
 			if (this->template is_embedded<Face>())
 				this->template set_orbit_embedding<Face>(Face(d1), this->embedding(Face(d1)));
+
+			record_neighborhood_modified(Face(d1));
+			this->flush_topology_events();
 		}
 	}
 
@@ -1029,17 +1275,28 @@ protected:
 		cgogn_message_assert(d != e, "cut_face_topo: d and e should be distinct");
 		cgogn_message_assert(this->same_cell(Face(d), Face(e)), "cut_face_topo: d and e should belong to the same face");
 
+		Dart nd = this->add_topology_element();
+		Dart ne = this->add_topology_element();
+		cut_face_topo(d, e, nd, ne);
+
+		this->set_boundary(nd, this->is_boundary(d));
+		this->set_boundary(ne, this->is_boundary(e));
+
+		return nd;
+	}
+
+	/**
+	 * \brief Cut the face of d and e with the two given isolated darts (see cut_face_topo(Dart, Dart))
+	 * nd is inserted before d and ne before e. Their boundary marks are not set.
+	 */
+	inline void cut_face_topo(Dart d, Dart e, Dart nd, Dart ne)
+	{
 		Dart dd = this->phi_1(d);
 		Dart ee = this->phi_1(e);
-		Dart nd = Inherit::split_vertex_topo(dd);	// cut the edge before d (insert a new dart before d)
-		Dart ne = Inherit::split_vertex_topo(ee);	// cut the edge before e (insert a new dart before e)
+		this->phi1_sew(dd, nd);						// cut the edge before d (insert a new dart before d)
+		this->phi1_sew(ee, ne);						// cut the edge before e (insert a new dart before e)
 		this->phi1_sew(dd, ee);						// subdivide phi1 cycle at the inserted darts
 		phi2_sew(nd, ne);							// build the new 2D-edge from the inserted darts
-
-		this->set_boundary(nd, this->is_boundary(dd));
-		this->set_boundary(ne, this->is_boundary(ee));
-
-		return nd;
 	}
 
 public:
@@ -1064,8 +1321,13 @@ public:
 		CGOGN_CHECK_CONCRETE_TYPE;
 		cgogn_message_assert(!is_boundary_cell(Face(d)), "cut_face: should not cut a boundary face");
 
+		const uint64 revision = this->topology_revision();
 		Dart nd = cut_face_topo(d, e);
 		Dart ne = this->phi_1(e);
+		this->template update_cell_counter<CDart>(revision, 2);
+		this->template update_cell_counter<Edge>(revision, 1);
+		this->template update_cell_counter<Face>(revision, 1);
+		this->cell_counters_updated(revision);
 
 		if (this->template is_embedded<CDart>())
 		{
@@ -1094,9 +1356,462 @@ public:
 			this->template copy_embedding<Volume>(ne, d);
 		}
 
+		record_face_cut(d, e, nd);
+		this->flush_topology_events();
+
 		return Edge(nd);
 	}
 
+	/*******************************************************************************
+	 * Batched operators
+	 *******************************************************************************/
+
+protected:
+
+	/**
+	 * \brief apply a batch of operations in rounds of independent operations
+	 * @param nb the number of operations
+	 * @param locked_darts a function (uint32 i, std::vector<Dart>& darts) that appends to darts each dart
+	 * whose relations or embeddings are read or modified by the operation i
+	 * @param apply_round a function (const std::vector<uint32>& round) that applies the given operations
+	 * Each round greedily gathers operations whose sets of locked darts are disjoint, an operation that conflicts
+	 * with an operation of the round is delayed to a following round. Thus the number of rounds is bounded by the
+	 * maximal number of conflicts of an operation plus one, but conflicting operations may not be applied in the
+	 * order of the batch. The locked darts are computed on the topology that results from the previous rounds.
+	 * The same marker is used by all the rounds (only the darts of the round are unmarked after each one).
+	 */
+	template <typename LOCK, typename ROUND>
+	void foreach_independent_round(uint32 nb, const LOCK& locked_darts, const ROUND& apply_round)
+	{
+		std::vector<uint32> pending(nb);
+		for (uint32 i = 0u; i < nb; ++i)
+			pending[i] = i;
+
+		std::vector<uint32> round;
+		std::vector<uint32> delayed;
+		std::vector<Dart>* darts = cgogn::dart_buffers()->buffer();
+		DartMarkerStore dm(*this);
+		while (!pending.empty())
+		{
+			for (uint32 i : pending)
+			{
+				darts->clear();
+				locked_darts(i, *darts);
+				if (std::none_of(darts->begin(), darts->end(), [&] (Dart d) { return dm.is_marked(d); }))
+				{
+					for (Dart d : *darts)
+						dm.mark(d);
+					round.push_back(i);
+				}
+				else
+					delayed.push_back(i);
+			}
+			dm.unmark_all();
+
+			apply_round(round);
+
+			round.clear();
+			pending.swap(delayed);
+			delayed.clear();
+		}
+		cgogn::dart_buffers()->release_buffer(darts);
+	}
+
+	/**
+	 * \brief apply f in parallel on the operations of a round
+	 * The low-level topological modifications do not increment the topology revision during the parallel section
+	 * and f must not allocate darts or lines, nor update reference counters or boundary marks.
+	 */
+	template <typename FUNC>
+	void parallel_foreach_operation(const std::vector<uint32>& round, const FUNC& f)
+	{
+		this->topology_batch_ = true;
+		parallel_for(0u, uint32(round.size()), 64u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 k = first; k < last; ++k)
+				f(k, round[k]);
+		});
+		this->topology_batch_ = false;
+		this->topology_changed();
+	}
+
+	/**
+	 * \brief reserve a line of the given orbit that will be referenced by nb_refs darts
+	 */
+	template <typename CellType>
+	inline uint32 reserve_embedding(uint32 nb_refs)
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		const uint32 emb = this->template add_attribute_element<ORBIT>();
+		for (uint32 i = 0u; i < nb_refs; ++i)
+			this->attributes_[ORBIT].ref_line(emb);
+		return emb;
+	}
+
+	/**
+	 * \brief update the reference counters of the lines of darts whose embeddings changed
+	 * @param changes pairs (old line, new line), ignored when the new line is INVALID_INDEX
+	 * All the new lines are referenced before the old ones are released.
+	 */
+	template <typename CellType>
+	inline void update_embedding_refs(const std::vector<std::pair<uint32, uint32>>& changes)
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		for (const std::pair<uint32, uint32>& c : changes)
+			if (c.second != INVALID_INDEX && c.first != c.second)
+				this->attributes_[ORBIT].ref_line(c.second);
+		for (const std::pair<uint32, uint32>& c : changes)
+			if (c.second != INVALID_INDEX && c.first != c.second && c.first != INVALID_INDEX)
+				this->unref_attribute_line(ORBIT, c.first);
+	}
+
+public:
+
+	/**
+	 * \brief Cut a batch of edges (see cut_edge)
+	 * \param edges : the edges to cut
+	 * \return The inserted vertices, in the order of the edges
+	 * The edges are cut in rounds of distinct edges. In each round, the darts and the attribute elements of
+	 * all the cuts are reserved first, then the cuts are applied in parallel.
+	 * An edge that appears several times is cut again in a following round (its half that contains e.dart).
+	 * Without at least two workers, the edges are cut sequentially by cut_edge.
+	 */
+	std::vector<Vertex> cut_edges(const std::vector<Edge>& edges)
+	{
+		CGOGN_CHECK_CONCRETE_TYPE;
+
+		std::vector<Vertex> result(edges.size());
+
+		if (cgogn::thread_pool()->nb_workers() <= 1u)
+		{
+			for (uint32 i = 0u; i < uint32(edges.size()); ++i)
+				result[i] = cut_edge(edges[i]);
+			return result;
+		}
+
+		const uint64 revision = this->topology_revision();
+		int32 nb_cdarts = 0;
+
+		foreach_independent_round(uint32(edges.size()),
+			[&] (uint32 i, std::vector<Dart>& darts)
+			{
+				darts.push_back(edges[i].dart);
+				darts.push_back(phi2(edges[i].dart));
+			},
+			[&] (const std::vector<uint32>& round)
+			{
+				const uint32 nb = uint32(round.size());
+				std::vector<Dart> new_darts;
+				this->add_topology_elements(2u * nb, new_darts);
+				std::vector<uint32> lines(NB_ORBITS * 2u * nb, INVALID_INDEX);
+				auto line = [&] (Orbit orbit, uint32 k, uint32 j) -> uint32& { return lines[(uint32(orbit) * nb + k) * 2u + j]; };
+
+				// reserve the darts and the lines, update the boundary marks and the reference counters
+				for (uint32 k = 0u; k < nb; ++k)
+				{
+					const Dart d = edges[round[k]].dart;
+					const Dart e = phi2(d);
+					const bool d_boundary = this->is_boundary(d);
+					const bool e_boundary = this->is_boundary(e);
+					const Dart nd = new_darts[2u * k];
+					const Dart ne = new_darts[2u * k + 1u];
+					this->set_boundary(nd, d_boundary);
+					this->set_boundary(ne, e_boundary);
+					nb_cdarts += int32(!d_boundary) + int32(!e_boundary);
+
+					if (this->template is_embedded<CDart>())
+					{
+						if (!d_boundary) line(CDart::ORBIT, k, 0u) = reserve_embedding<CDart>(1u);
+						if (!e_boundary) line(CDart::ORBIT, k, 1u) = reserve_embedding<CDart>(1u);
+					}
+					if (this->template is_embedded<Vertex>())
+						line(Vertex::ORBIT, k, 0u) = reserve_embedding<Vertex>(2u);
+					if (this->template is_embedded<Edge>())
+					{
+						// ne takes the line of e that takes the new line with nd
+						line(Edge::ORBIT, k, 0u) = reserve_embedding<Edge>(2u);
+						line(Edge::ORBIT, k, 1u) = this->embedding(Edge(d));
+					}
+					if (this->template is_embedded<Face>())
+					{
+						if (!d_boundary) this->attributes_[Face::ORBIT].ref_line(line(Face::ORBIT, k, 0u) = this->embedding(Face(d)));
+						if (!e_boundary) this->attributes_[Face::ORBIT].ref_line(line(Face::ORBIT, k, 1u) = this->embedding(Face(e)));
+					}
+					if (this->template is_embedded<Volume>())
+					{
+						line(Volume::ORBIT, k, 0u) = this->embedding(Volume(d));
+						this->attributes_[Volume::ORBIT].ref_line(line(Volume::ORBIT, k, 0u));
+						this->attributes_[Volume::ORBIT].ref_line(line(Volume::ORBIT, k, 0u));
+					}
+				}
+
+				parallel_foreach_operation(round, [&] (uint32 k, uint32 i)
+				{
+					const Dart d = edges[i].dart;
+					const Dart e = phi2(d);
+					const Dart nd = new_darts[2u * k];
+					const Dart ne = new_darts[2u * k + 1u];
+					cut_edge_topo(d, nd, ne);
+					result[i] = Vertex(nd);
+
+					if (this->template is_embedded<CDart>())
+					{
+						if (line(CDart::ORBIT, k, 0u) != INVALID_INDEX) this->template set_raw_embedding<CDart>(nd, line(CDart::ORBIT, k, 0u));
+						if (line(CDart::ORBIT, k, 1u) != INVALID_INDEX) this->template set_raw_embedding<CDart>(ne, line(CDart::ORBIT, k, 1u));
+					}
+					if (this->template is_embedded<Vertex>())
+					{
+						this->template set_raw_embedding<Vertex>(nd, line(Vertex::ORBIT, k, 0u));
+						this->template set_raw_embedding<Vertex>(ne, line(Vertex::ORBIT, k, 0u));
+					}
+					if (this->template is_embedded<Edge>())
+					{
+						this->template set_raw_embedding<Edge>(nd, line(Edge::ORBIT, k, 0u));
+						this->template set_raw_embedding<Edge>(e, line(Edge::ORBIT, k, 0u));
+						this->template set_raw_embedding<Edge>(ne, line(Edge::ORBIT, k, 1u));
+					}
+					if (this->template is_embedded<Face>())
+					{
+						if (line(Face::ORBIT, k, 0u) != INVALID_INDEX) this->template set_raw_embedding<Face>(nd, line(Face::ORBIT, k, 0u));
+						if (line(Face::ORBIT, k, 1u) != INVALID_INDEX) this->template set_raw_embedding<Face>(ne, line(Face::ORBIT, k, 1u));
+					}
+					if (this->template is_embedded<Volume>())
+					{
+						this->template set_raw_embedding<Volume>(nd, line(Volume::ORBIT, k, 0u));
+						this->template set_raw_embedding<Volume>(ne, line(Volume::ORBIT, k, 0u));
+					}
+				});
+			});
+
+		this->template update_cell_counter<CDart>(revision, nb_cdarts);
+		this->template update_cell_counter<Vertex>(revision, int32(edges.size()));
+		this->template update_cell_counter<Edge>(revision, int32(edges.size()));
+		this->cell_counters_updated(revision);
+
+		if (this->has_topology_observers())
+		{
+			for (uint32 i = 0u; i < uint32(edges.size()); ++i)
+				record_edge_cut(edges[i].dart, result[i].dart);
+			this->flush_topology_events();
+		}
+
+		return result;
+	}
+
+	/**
+	 * \brief Flip a batch of edges (see flip_edge)
+	 * \param edges : the edges to flip
+	 * The edges are flipped in rounds of edges whose incident faces are distinct. The flips of a round are applied
+	 * in parallel, then the reference counters of the vertex and face attribute elements are updated.
+	 * Flips of edges that share a face are not applied in the order of the batch.
+	 * Without at least two workers, the edges are flipped sequentially (in the order of the batch) by flip_edge.
+	 */
+	void flip_edges(const std::vector<Edge>& edges)
+	{
+		CGOGN_CHECK_CONCRETE_TYPE;
+
+		if (cgogn::thread_pool()->nb_workers() <= 1u)
+		{
+			for (Edge e : edges)
+				flip_edge(e);
+			return;
+		}
+
+		const uint64 revision = this->topology_revision();
+
+		foreach_independent_round(uint32(edges.size()),
+			[&] (uint32 i, std::vector<Dart>& darts)
+			{
+				// edges incident to the boundary are not flipped and should not lock the boundary faces
+				if (this->is_incident_to_boundary(edges[i]))
+					return;
+				this->foreach_dart_of_orbit(Face(edges[i].dart), [&] (Dart d) { darts.push_back(d); });
+				this->foreach_dart_of_orbit(Face(phi2(edges[i].dart)), [&] (Dart d) { darts.push_back(d); });
+			},
+			[&] (const std::vector<uint32>& round)
+			{
+				// (old, new) vertex embeddings of d and phi2(d), face embeddings of phi_1(d) and phi_1(phi2(d))
+				const std::pair<uint32, uint32> unchanged(INVALID_INDEX, INVALID_INDEX);
+				std::vector<std::pair<uint32, uint32>> vertex_changes(2u * round.size(), unchanged);
+				std::vector<std::pair<uint32, uint32>> face_changes(2u * round.size(), unchanged);
+
+				parallel_foreach_operation(round, [&] (uint32 k, uint32 i)
+				{
+					const Dart d = edges[i].dart;
+					if (!flip_edge_topo(d))
+						return;
+
+					const Dart d2 = phi2(d);
+					if (this->template is_embedded<Vertex>())
+					{
+						vertex_changes[2u * k] = std::make_pair(this->embedding(Vertex(d)), this->embedding(Vertex(this->phi1(d2))));
+						this->template set_raw_embedding<Vertex>(d, vertex_changes[2u * k].second);
+						vertex_changes[2u * k + 1u] = std::make_pair(this->embedding(Vertex(d2)), this->embedding(Vertex(this->phi1(d))));
+						this->template set_raw_embedding<Vertex>(d2, vertex_changes[2u * k + 1u].second);
+					}
+					if (this->template is_embedded<Face>())
+					{
+						face_changes[2u * k] = std::make_pair(this->embedding(Face(this->phi_1(d))), this->embedding(Face(d)));
+						this->template set_raw_embedding<Face>(this->phi_1(d), face_changes[2u * k].second);
+						face_changes[2u * k + 1u] = std::make_pair(this->embedding(Face(this->phi_1(d2))), this->embedding(Face(d2)));
+						this->template set_raw_embedding<Face>(this->phi_1(d2), face_changes[2u * k + 1u].second);
+					}
+				});
+
+				if (this->template is_embedded<Vertex>())
+					update_embedding_refs<Vertex>(vertex_changes);
+				if (this->template is_embedded<Face>())
+					update_embedding_refs<Face>(face_changes);
+			});
+
+		// a flip does not change the number of cells
+		this->cell_counters_updated(revision);
+
+		if (this->has_topology_observers())
+		{
+			for (Edge e : edges)
+			{
+				record_neighborhood_modified(Face(e.dart));
+				record_neighborhood_modified(Face(phi2(e.dart)));
+			}
+			this->flush_topology_events();
+		}
+	}
+
+	/**
+	 * \brief Cut a batch of faces (see cut_face)
+	 * \param cuts : the pairs of darts (d, e) of the cuts, d and e should belong to the same face
+	 * \return The inserted edges, in the order of the cuts
+	 * The faces are cut in rounds of cuts of distinct faces. In each round, the darts and the attribute elements
+	 * of all the cuts are reserved first, then the cuts are applied in parallel.
+	 * Without at least two workers, the faces are cut sequentially by cut_face.
+	 */
+	std::vector<Edge> cut_faces(const std::vector<std::pair<Dart, Dart>>& cuts)
+	{
+		CGOGN_CHECK_CONCRETE_TYPE;
+
+		std::vector<Edge> result(cuts.size());
+
+		if (cgogn::thread_pool()->nb_workers() <= 1u)
+		{
+			for (uint32 i = 0u; i < uint32(cuts.size()); ++i)
+				result[i] = cut_face(cuts[i].first, cuts[i].second);
+			return result;
+		}
+
+		const uint64 revision = this->topology_revision();
+
+		foreach_independent_round(uint32(cuts.size()),
+			[&] (uint32 i, std::vector<Dart>& darts)
+			{
+				this->foreach_dart_of_orbit(Face(cuts[i].first), [&] (Dart d) { darts.push_back(d); });
+			},
+			[&] (const std::vector<uint32>& round)
+			{
+				const uint32 nb = uint32(round.size());
+				std::vector<Dart> new_darts;
+				this->add_topology_elements(2u * nb, new_darts);
+				std::vector<uint32> lines(NB_ORBITS * 2u * nb, INVALID_INDEX);
+				auto line = [&] (Orbit orbit, uint32 k, uint32 j) -> uint32& { return lines[(uint32(orbit) * nb + k) * 2u + j]; };
+
+				// reserve the darts and the lines, update the boundary marks and the reference counters
+				for (uint32 k = 0u; k < nb; ++k)
+				{
+					const Dart d = cuts[round[k]].first;
+					const Dart e = cuts[round[k]].second;
+					cgogn_message_assert(d != e, "cut_faces: d and e should be distinct");
+					cgogn_message_assert(this->same_cell(Face(d), Face(e)), "cut_faces: d and e should belong to the same face");
+					cgogn_message_assert(!this->is_boundary(d), "cut_faces: should not cut a boundary face");
+
+					if (this->template is_embedded<CDart>())
+					{
+						line(CDart::ORBIT, k, 0u) = reserve_embedding<CDart>(1u);
+						line(CDart::ORBIT, k, 1u) = reserve_embedding<CDart>(1u);
+					}
+					if (this->template is_embedded<Vertex>())
+					{
+						this->attributes_[Vertex::ORBIT].ref_line(line(Vertex::ORBIT, k, 0u) = this->embedding(Vertex(e)));
+						this->attributes_[Vertex::ORBIT].ref_line(line(Vertex::ORBIT, k, 1u) = this->embedding(Vertex(d)));
+					}
+					if (this->template is_embedded<Edge>())
+						line(Edge::ORBIT, k, 0u) = reserve_embedding<Edge>(2u);
+					if (this->template is_embedded<Face>())
+					{
+						// the darts from e to phi_1(d) and ne take a new line
+						const uint32 old_face = line(Face::ORBIT, k, 0u) = this->embedding(Face(d));
+						uint32 nb_moved = 0u;
+						for (Dart it = e; it != d; it = this->phi1(it))
+							++nb_moved;
+						line(Face::ORBIT, k, 1u) = reserve_embedding<Face>(nb_moved + 1u);
+						this->attributes_[Face::ORBIT].ref_line(old_face);
+						for (uint32 j = 0u; j < nb_moved; ++j)
+							this->unref_attribute_line(Face::ORBIT, old_face);
+					}
+					if (this->template is_embedded<Volume>())
+					{
+						line(Volume::ORBIT, k, 0u) = this->embedding(Volume(d));
+						this->attributes_[Volume::ORBIT].ref_line(line(Volume::ORBIT, k, 0u));
+						this->attributes_[Volume::ORBIT].ref_line(line(Volume::ORBIT, k, 0u));
+					}
+				}
+
+				parallel_foreach_operation(round, [&] (uint32 k, uint32 i)
+				{
+					const Dart d = cuts[i].first;
+					const Dart e = cuts[i].second;
+					const Dart nd = new_darts[2u * k];
+					const Dart ne = new_darts[2u * k + 1u];
+					cut_face_topo(d, e, nd, ne);
+					result[i] = Edge(nd);
+
+					if (this->template is_embedded<CDart>())
+					{
+						this->template set_raw_embedding<CDart>(nd, line(CDart::ORBIT, k, 0u));
+						this->template set_raw_embedding<CDart>(ne, line(CDart::ORBIT, k, 1u));
+					}
+					if (this->template is_embedded<Vertex>())
+					{
+						this->template set_raw_embedding<Vertex>(nd, line(Vertex::ORBIT, k, 0u));
+						this->template set_raw_embedding<Vertex>(ne, line(Vertex::ORBIT, k, 1u));
+					}
+					if (this->template is_embedded<Edge>())
+					{
+						this->template set_raw_embedding<Edge>(nd, line(Edge::ORBIT, k, 0u));
+						this->template set_raw_embedding<Edge>(ne, line(Edge::ORBIT, k, 0u));
+					}
+					if (this->template is_embedded<Face>())
+					{
+						this->template set_raw_embedding<Face>(nd, line(Face::ORBIT, k, 0u));
+						Dart it = ne;
+						do
+						{
+							this->template set_raw_embedding<Face>(it, line(Face::ORBIT, k, 1u));
+							it = this->phi1(it);
+						} while (it != ne);
+					}
+					if (this->template is_embedded<Volume>())
+					{
+						this->template set_raw_embedding<Volume>(nd, line(Volume::ORBIT, k, 0u));
+						this->template set_raw_embedding<Volume>(ne, line(Volume::ORBIT, k, 0u));
+					}
+				});
+			});
+
+		this->template update_cell_counter<CDart>(revision, 2 * int32(cuts.size()));
+		this->template update_cell_counter<Edge>(revision, int32(cuts.size()));
+		this->template update_cell_counter<Face>(revision, int32(cuts.size()));
+		this->cell_counters_updated(revision);
+
+		if (this->has_topology_observers())
+		{
+			for (uint32 i = 0u; i < uint32(cuts.size()); ++i)
+				record_face_cut(cuts[i].first, cuts[i].second, result[i].dart);
+			this->flush_topology_events();
+		}
+
+		return result;
+	}
+
 protected:
 
 	/**
@@ -1189,6 +1904,13 @@ public:
 				else
 					this->new_orbit_embedding(Volume(d2));
 			}
+
+			if (this->has_topology_observers())
+			{
+				this->record_cell_created(Edge(d2));
+				record_incident_cells_modified({ d, d2, this->phi1(d), this->phi1(d2) });
+				this->flush_topology_events();
+			}
 		}
 	}
 
@@ -1276,6 +1998,9 @@ public:
 			if (volume_merged)
 				this->template set_orbit_embedding<Volume>(Volume(e1d), this->embedding(Volume(e1d)));
 		}
+
+		record_incident_cells_modified({ e1d, e2d, this->phi1(e1d), this->phi1(e2d) });
+		this->flush_topology_events();
 	}
 
 protected:
@@ -1370,7 +2095,10 @@ public:
 
 			if (this->template is_embedded<Edge>())
 				this->template set_orbit_embedding<Edge>(Edge((*darts)[i]), (*e_emb)[i]);
+
+			record_incident_cells_modified({ (*darts)[i], this->phi1((*darts)[i]) });
 		}
+		this->flush_topology_events();
 
 		dart_buffers()->release_buffer(darts);
 		uint_buffers()->release_buffer(v_emb);
@@ -1448,6 +2176,14 @@ protected:
 		if (this->template is_embedded<Volume>())
 			this->template set_orbit_embedding<Volume>(f, this->embedding(Volume(d)));
 
+		if (this->has_topology_observers())
+		{
+			foreach_dart_of_orbit(f, [this] (Dart it) { this->record_cell_created(CDart(it)); });
+			this->record_cell_created(f);
+			record_neighborhood_modified(f);
+			this->flush_topology_events();
+		}
+
 		return f;
 	}
 
@@ -1459,6 +2195,7 @@ protected:
 	 * More precisely :
 	 *  - Vertex, Edge and Volume attributes are copied, if needed, from incident cells.
 	 * If the indexation of embedding was unique, the closed map is well embedded.
+	 * The topology observers see the inserted faces as created faces, that are then marked as boundary.
 	 */
 	// The template parameter is a hack needed to compile the class CMap2_T<DefaultMapTraits, CMap3Type<DefaultMapTraits>> with MSVC. Otherwise calling boundary_mark leads to an error.
 	template <typename = std::enable_if<std::is_same<typename MapType::TYPE, Self>::value>>
@@ -2038,6 +2775,7 @@ protected:
 struct CMap2Type
 {
 	using TYPE = CMap2_T<CMap2Type>;
+	static const uint32 CHUNK_SIZE = CGOGN_CHUNK_SIZE;
 };
 
 using CMap2 = CMap2_T<CMap2Type>;
@@ -2060,6 +2798,8 @@ extern template class CGOGN_CORE_EXPORT CellMarkerStore<CMap2, CMap2::Edge::ORBI
 extern template class CGOGN_CORE_EXPORT CellMarkerStore<CMap2, CMap2::Face::ORBIT>;
 extern template class CGOGN_CORE_EXPORT CellMarkerStore<CMap2, CMap2::Volume::ORBIT>;
 extern template class CGOGN_CORE_EXPORT CellCache<CMap2>;
+extern template class CGOGN_CORE_EXPORT DirtyCellCache<CMap2>;
+extern template class CGOGN_CORE_EXPORT IncrementalCellCache<CMap2>;
 extern template class CGOGN_CORE_EXPORT BoundaryCache<CMap2>;
 extern template class CGOGN_CORE_EXPORT QuickTraversor<CMap2>;
 #endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_CORE_EXTERNAL_TEMPLATES_CPP_))
@@ -150,22 +150,30 @@ public:
 	template <bool B=true>
 	inline auto ca_phi1() -> typename std::enable_if<B && MAP2::PRIM_SIZE==1,ChunkArray<Dart>&>::type
 	{
+		// the topology may be modified through the returned reference
+		map_.topology_changed();
 		return *(map_.Map2::Inherit::phi1_);
 	}
 
 	template <bool B=true>
 	inline auto ca_phi_1() -> typename std::enable_if< B &&MAP2::PRIM_SIZE==1,ChunkArray<Dart>&>::type
 	{
+		// the topology may be modified through the returned reference
+		map_.topology_changed();
 		return *(map_.Map2::Inherit::phi_1_);
 	}
 
 	inline ChunkArray<Dart>& ca_phi2()
 	{
+		// the topology may be modified through the returned reference
+		map_.topology_changed();
 		return *(map_.phi2_);
 	}
 
 	inline ChunkArrayContainer<uint8>& cac_topology()
 	{
+		// the topology may be modified through the returned reference
+		map_.topology_changed();
 		return map_.topology_;
 	}
 
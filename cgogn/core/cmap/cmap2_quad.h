@@ -47,6 +47,7 @@ public:
 	friend class MapBase<MAP_TYPE>;
 	friend class CMap2Builder_T<Self>;
 	friend class DartMarker_T<Self>;
+	friend class cgogn::DartMarkerEpoch<Self>;
 	friend class cgogn::DartMarkerStore<Self>;
 
 	using CDart  = Cell<Orbit::DART>;
@@ -65,21 +66,27 @@ public:
 	using ChunkArray = typename Inherit::template ChunkArray<T>;
 
 	template <typename T>
-	using VertexAttribute = Attribute<T, Vertex::ORBIT>;
+	using VertexAttribute = Attribute<T, Vertex::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using EdgeAttribute = Attribute<T, Edge::ORBIT>;
+	using EdgeAttribute = Attribute<T, Edge::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using FaceAttribute = Attribute<T, Face::ORBIT>;
+	using FaceAttribute = Attribute<T, Face::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using VolumeAttribute = Attribute<T, Volume::ORBIT>;
+	using VolumeAttribute = Attribute<T, Volume::ORBIT, Inherit::CHUNK_SIZE>;
 
 	using DartMarker = typename cgogn::DartMarker<Self>;
 	using DartMarkerStore = typename cgogn::DartMarkerStore<Self>;
+	using ConcurrentDartMarker = typename cgogn::ConcurrentDartMarker<Self>;
+	using DartMarkerEpoch = typename cgogn::DartMarkerEpoch<Self>;
 
 	template <Orbit ORBIT>
 	using CellMarker = typename cgogn::CellMarker<Self, ORBIT>;
 	template <Orbit ORBIT>
 	using CellMarkerNoUnmark = typename cgogn::CellMarkerNoUnmark<Self, ORBIT>;
+	template <Orbit ORBIT>
+	using ConcurrentCellMarker = typename cgogn::ConcurrentCellMarker<Self, ORBIT>;
+	template <Orbit ORBIT>
+	using CellMarkerEpoch = typename cgogn::CellMarkerEpoch<Self, ORBIT>;
 
 	using FilteredQuickTraversor = typename cgogn::FilteredQuickTraversor<Self>;
 	using QuickTraversor = typename cgogn::QuickTraversor<Self>;
@@ -181,6 +188,7 @@ protected:
 		cgogn_assert(phi2(e) == e);
 		(*phi2_)[d.index] = e;
 		(*phi2_)[e.index] = d;
+		this->topology_changed();
 	}
 
 	/**
@@ -194,6 +202,7 @@ protected:
 		Dart e = phi2(d);
 		(*phi2_)[d.index] = d;
 		(*phi2_)[e.index] = e;
+		this->topology_changed();
 	}
 
 	/*******************************************************************************
@@ -1189,6 +1198,7 @@ protected:
 struct CMap2QuadType
 {
 	using TYPE = CMap2Quad_T<CMap2QuadType>;
+	static const uint32 CHUNK_SIZE = CGOGN_CHUNK_SIZE;
 };
 
 using CMap2Quad = CMap2Quad_T<CMap2QuadType>;
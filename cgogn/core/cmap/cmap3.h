@@ -49,6 +49,7 @@ public:
 	friend class MapBase<MAP_TYPE>;
 	friend class CMap3Builder_T<Self>;
 	friend class DartMarker_T<Self>;
+	friend class cgogn::DartMarkerEpoch<Self>;
 	friend class cgogn::DartMarkerStore<Self>;
 
 	using CDart   = typename Inherit::CDart;
@@ -70,29 +71,36 @@ public:
 	using ChunkArray = typename Inherit::template ChunkArray<T>;
 
 	template <typename T>
-	using VertexAttribute = Attribute<T, Vertex::ORBIT>;
+	using VertexAttribute = Attribute<T, Vertex::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using EdgeAttribute = Attribute<T, Edge::ORBIT>;
+	using EdgeAttribute = Attribute<T, Edge::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using FaceAttribute = Attribute<T, Face::ORBIT>;
+	using FaceAttribute = Attribute<T, Face::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using VolumeAttribute = Attribute<T, Volume::ORBIT>;
+	using VolumeAttribute = Attribute<T, Volume::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using CCAttribute = Attribute<T, ConnectedComponent::ORBIT>;
+	using CCAttribute = Attribute<T, ConnectedComponent::ORBIT, Inherit::CHUNK_SIZE>;
 
 	using DartMarker = typename cgogn::DartMarker<Self>;
 	using DartMarkerStore = typename cgogn::DartMarkerStore<Self>;
+	using ConcurrentDartMarker = typename cgogn::ConcurrentDartMarker<Self>;
+	using DartMarkerEpoch = typename cgogn::DartMarkerEpoch<Self>;
 
 	template <Orbit ORBIT>
 	using CellMarker = typename cgogn::CellMarker<Self, ORBIT>;
 	template <Orbit ORBIT>
 	using CellMarkerNoUnmark = typename cgogn::CellMarkerNoUnmark<Self, ORBIT>;
 	template <Orbit ORBIT>
+	using ConcurrentCellMarker = typename cgogn::ConcurrentCellMarker<Self, ORBIT>;
+	template <Orbit ORBIT>
+	using CellMarkerEpoch = typename cgogn::CellMarkerEpoch<Self, ORBIT>;
+	template <Orbit ORBIT>
 	using CellMarkerStore = typename cgogn::CellMarkerStore<Self, ORBIT>;
 
 	using FilteredQuickTraversor = typename cgogn::FilteredQuickTraversor<Self>;
 	using QuickTraversor = typename cgogn::QuickTraversor<Self>;
 	using CellCache = typename cgogn::CellCache<Self>;
+	using DirtyCellCache = typename cgogn::DirtyCellCache<Self>;
 	using BoundaryCache = typename cgogn::BoundaryCache<Self>;
 
 protected:
@@ -208,6 +216,7 @@ protected:
 		cgogn_assert(phi3(e) == e);
 		(*phi3_)[d.index] = e;
 		(*phi3_)[e.index] = d;
+		this->topology_changed();
 	}
 
 	/**
@@ -221,6 +230,7 @@ protected:
 		Dart e = phi3(d);
 		(*phi3_)[d.index] = d;
 		(*phi3_)[e.index] = e;
+		this->topology_changed();
 	}
 
 	/*******************************************************************************
@@ -2322,7 +2332,7 @@ public:
 		static_assert(is_func_parameter_same<FUNC, Volume>::value, "Wrong function cell parameter type");
 		DartMarkerStore marker_volume(*this);
 		marker_volume.mark_orbit(v);
-		foreach_incident_face(v, [&] (Edge inc_face) -> bool
+		foreach_incident_face(v, [&] (Face inc_face) -> bool
 		{
 			bool res_nested_lambda = true;
 			foreach_incident_volume(inc_face, [&] (Volume inc_vol) -> bool
@@ -2623,6 +2633,7 @@ public:
 struct CMap3Type
 {
 	using TYPE = CMap3_T<CMap3Type>;
+	static const uint32 CHUNK_SIZE = CGOGN_CHUNK_SIZE;
 };
 
 using CMap3 = CMap3_T<CMap3Type>;
@@ -2645,6 +2656,7 @@ extern template class CGOGN_CORE_EXPORT CellMarkerStore<CMap3, CMap3::Edge::ORBI
 extern template class CGOGN_CORE_EXPORT CellMarkerStore<CMap3, CMap3::Face::ORBIT>;
 extern template class CGOGN_CORE_EXPORT CellMarkerStore<CMap3, CMap3::Volume::ORBIT>;
 extern template class CGOGN_CORE_EXPORT CellCache<CMap3>;
+extern template class CGOGN_CORE_EXPORT DirtyCellCache<CMap3>;
 extern template class CGOGN_CORE_EXPORT BoundaryCache<CMap3>;
 extern template class CGOGN_CORE_EXPORT QuickTraversor<CMap3>;
 #endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_CORE_EXTERNAL_TEMPLATES_CPP_))
@@ -0,0 +1,834 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_CMAP_FROZEN_TOPOLOGY_H_
+#define CGOGN_CORE_CMAP_FROZEN_TOPOLOGY_H_
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/definitions.h>
+#include <cgogn/core/utils/masks.h>
+#include <cgogn/core/utils/type_traits.h>
+#include <cgogn/core/utils/parallel_for.h>
+#include <cgogn/core/basic/cell.h>
+#include <cgogn/core/basic/dart.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief The FrozenTopology class is a read-only snapshot of the topology of a CMap2 or a CMap3
+ * The phi relations, the boundary marks and the embeddings of the darts are copied in contiguous
+ * arrays (one entry per dart index), so that a step of a traversal costs one array access instead of
+ * a lookup through the chunk tables of the map.
+ * For each orbit of the map, the cells are numbered from 0 to nb_cells - 1 (boundary cells excluded) and
+ * the darts of the orbits that need a marking to be traversed (volumes, 3D vertices, connected components)
+ * are stored contiguously per cell (CSR layout).
+ * The darts keep their index in the map: the attributes of the map can be used with the cells given by
+ * the snapshot, which offers the traversal API of the map (foreach_cell, foreach_incident_*, foreach_adjacent_*, ...)
+ * so that algorithms templated by the map type can be run on it.
+ * The incidence between 2D cells (of a CMap2 or of the volumes of a CMap3) is traversed as in the map, the other
+ * incident or adjacent cells are reported once. Compacting the map before freezing it removes the holes of the arrays.
+ * @warning the snapshot is not updated by the modifications of the map
+ */
+template <typename MAP>
+class FrozenTopology
+{
+public:
+
+	using Self = FrozenTopology<MAP>;
+	using Map = MAP;
+
+	static const uint8 DIMENSION = MAP::DIMENSION;
+	static_assert(DIMENSION == 2u || DIMENSION == 3u, "FrozenTopology is only defined for CMap2 and CMap3");
+
+	using CDart = typename MAP::CDart;
+	using Vertex = typename MAP::Vertex;
+	using Edge = typename MAP::Edge;
+	using Face = typename MAP::Face;
+	using Volume = typename MAP::Volume;
+	using Boundary = typename MAP::Boundary;
+
+	template <typename T, Orbit ORBIT>
+	using Attribute = typename MAP::template Attribute<T, ORBIT>;
+	template <typename T>
+	using VertexAttribute = Attribute<T, Vertex::ORBIT>;
+	template <typename T>
+	using EdgeAttribute = Attribute<T, Edge::ORBIT>;
+	template <typename T>
+	using FaceAttribute = Attribute<T, Face::ORBIT>;
+	template <typename T>
+	using VolumeAttribute = Attribute<T, Volume::ORBIT>;
+
+	/**
+	 * @brief types of the cells through which the cells of the given orbit are incident or adjacent
+	 * (the 2D cells of the volumes of a CMap3 for its Vertex2, Edge2 and Face2 cells, the cells of the map otherwise)
+	 */
+	template <Orbit ORBIT>
+	struct IncidentCells
+	{
+		static const bool CELL2 = DIMENSION == 3u && (ORBIT == Orbit::PHI21 || ORBIT == Orbit::PHI2 || ORBIT == Orbit::PHI1);
+		using Vertex = typename std::conditional<CELL2, Cell<Orbit::PHI21>, typename MAP::Vertex>::type;
+		using Edge = typename std::conditional<CELL2, Cell<Orbit::PHI2>, typename MAP::Edge>::type;
+		using Face = typename std::conditional<CELL2, Cell<Orbit::PHI1>, typename MAP::Face>::type;
+		using Volume = typename MAP::Volume;
+	};
+
+protected:
+
+	const MAP* map_;
+
+	// number of dart indices (end of the topology container of the map)
+	uint32 nb_indices_;
+	uint32 nb_darts_;
+
+	std::vector<uint32> phi1_;
+	std::vector<uint32> phi_1_;
+	std::vector<uint32> phi2_;
+	std::vector<uint32> phi3_;
+	std::vector<uint8> boundary_;
+
+	// for each orbit : representative dart of each cell and index of the cell of each dart (INVALID_INDEX for boundary cells)
+	std::array<std::vector<Dart>, NB_ORBITS> cells_;
+	std::array<std::vector<uint32>, NB_ORBITS> cell_index_;
+
+	// for the orbits traversed with a marker : darts of the orbits and offsets of the cells
+	std::array<std::vector<Dart>, NB_ORBITS> orbit_darts_;
+	std::array<std::vector<uint32>, NB_ORBITS> orbit_offsets_;
+
+	// embeddings of the darts for the embedded orbits
+	std::array<std::vector<uint32>, NB_ORBITS> embeddings_;
+
+public:
+
+	/**
+	 * @brief build the snapshot of the current topology of the given map
+	 */
+	FrozenTopology(const MAP& map) :
+		map_(&map),
+		nb_indices_(map.topology_container().end()),
+		nb_darts_(0u)
+	{
+		phi1_.assign(nb_indices_, INVALID_INDEX);
+		phi_1_.assign(nb_indices_, INVALID_INDEX);
+		phi2_.assign(nb_indices_, INVALID_INDEX);
+		boundary_.assign(nb_indices_, uint8(0));
+
+		map.foreach_dart([&] (Dart d)
+		{
+			++nb_darts_;
+			phi1_[d.index] = map.phi1(d).index;
+			phi_1_[d.index] = map.phi_1(d).index;
+			phi2_[d.index] = map.phi2(d).index;
+			boundary_[d.index] = map.is_boundary(d) ? uint8(1) : uint8(0);
+		});
+		freeze_phi3(std::integral_constant<bool, DIMENSION == 3u>());
+
+		freeze_orbit<Orbit::DART>();
+		freeze_orbit<Orbit::PHI1>();
+		freeze_orbit<Orbit::PHI2>();
+		freeze_orbit<Orbit::PHI21>();
+		freeze_orbit<Orbit::PHI1_PHI2>();
+		freeze_orbits_3(std::integral_constant<bool, DIMENSION == 3u>());
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(FrozenTopology);
+
+	inline const MAP& map() const { return *map_; }
+
+	/*******************************************************************************
+	 * Basic topological operations
+	 *******************************************************************************/
+
+	inline Dart phi1(Dart d) const { return Dart(phi1_[d.index]); }
+
+	inline Dart phi_1(Dart d) const { return Dart(phi_1_[d.index]); }
+
+	inline Dart phi2(Dart d) const { return Dart(phi2_[d.index]); }
+
+	inline Dart phi3(Dart d) const
+	{
+		static_assert(DIMENSION == 3u, "phi3 is only defined in a CMap3");
+		return Dart(phi3_[d.index]);
+	}
+
+	inline bool is_boundary(Dart d) const { return boundary_[d.index] != uint8(0); }
+
+	inline uint32 nb_darts() const { return nb_darts_; }
+
+	/*******************************************************************************
+	 * Cells information
+	 *******************************************************************************/
+
+	template <Orbit ORBIT>
+	inline bool is_embedded() const
+	{
+		return !embeddings_[ORBIT].empty();
+	}
+
+	template <typename CellType>
+	inline bool is_embedded() const
+	{
+		return is_embedded<CellType::ORBIT>();
+	}
+
+	template <Orbit ORBIT>
+	inline uint32 embedding(Cell<ORBIT> c) const
+	{
+		cgogn_message_assert(is_embedded<ORBIT>(), "Invalid parameter: orbit not embedded");
+		return embeddings_[ORBIT][c.dart.index];
+	}
+
+	/**
+	 * @brief index of the cell c among the cells of its orbit (in [0, nb_cells<ORBIT>()))
+	 * @return INVALID_INDEX if c is a boundary cell
+	 */
+	template <Orbit ORBIT>
+	inline uint32 cell_index(Cell<ORBIT> c) const
+	{
+		cgogn_message_assert(!cell_index_[ORBIT].empty(), "Orbit not supported by the map");
+		return cell_index_[ORBIT][c.dart.index];
+	}
+
+	template <Orbit ORBIT>
+	inline uint32 nb_cells() const
+	{
+		return uint32(cells_[ORBIT].size());
+	}
+
+	template <typename CellType>
+	inline uint32 nb_cells() const
+	{
+		return nb_cells<CellType::ORBIT>();
+	}
+
+	template <Orbit ORBIT>
+	inline bool is_boundary_cell(Cell<ORBIT> c) const
+	{
+		return cell_index(c) == INVALID_INDEX;
+	}
+
+	template <Orbit ORBIT>
+	inline bool same_cell(Cell<ORBIT> c1, Cell<ORBIT> c2) const
+	{
+		const uint32 i1 = cell_index(c1);
+		if (i1 != INVALID_INDEX)
+			return i1 == cell_index(c2);
+		return map_->same_cell(c1, c2);
+	}
+
+	template <Orbit ORBIT>
+	bool is_incident_to_boundary(Cell<ORBIT> c) const
+	{
+		return !boundary_dart(c).is_nil();
+	}
+
+	template <Orbit ORBIT>
+	Dart boundary_dart(Cell<ORBIT> c) const
+	{
+		Dart result;
+		foreach_dart_of_orbit(c, [this, &result] (Dart d) -> bool
+		{
+			if (is_boundary(d)) { result = d; return false; }
+			return true;
+		});
+		return result;
+	}
+
+	/*******************************************************************************
+	 * Connectivity information
+	 *******************************************************************************/
+
+	/**
+	 * @brief number of incident cells of the next dimension
+	 */
+	template <Orbit ORBIT>
+	uint32 degree(Cell<ORBIT> c) const
+	{
+		using Cells = IncidentCells<ORBIT>;
+		using Incident = typename std::conditional<ORBIT == Cells::Vertex::ORBIT, typename Cells::Edge,
+			typename std::conditional<ORBIT == Cells::Edge::ORBIT, typename Cells::Face, typename Cells::Volume>::type>::type;
+
+		uint32 result = 0u;
+		foreach_incident_cell<Incident>(c, [&result] (Incident) { ++result; });
+		return result;
+	}
+
+	/**
+	 * @brief number of incident cells of the previous dimension (number of edges of a face)
+	 */
+	template <Orbit ORBIT>
+	uint32 codegree(Cell<ORBIT> c) const
+	{
+		using Cells = IncidentCells<ORBIT>;
+		using Incident = typename std::conditional<ORBIT == Cells::Volume::ORBIT, typename Cells::Face, typename Cells::Vertex>::type;
+
+		uint32 result = 0u;
+		if (ORBIT == Orbit::PHI1 || ORBIT == Orbit::PHI1_PHI3)
+		{
+			Dart it = c.dart;
+			do
+			{
+				++result;
+				it = phi1(it);
+			} while (it != c.dart);
+		}
+		else
+			foreach_incident_cell<Incident>(c, [&result] (Incident) { ++result; });
+		return result;
+	}
+
+	template <Orbit ORBIT>
+	bool has_codegree(Cell<ORBIT> f, uint32 codegree) const
+	{
+		static_assert(ORBIT == Orbit::PHI1 || ORBIT == Orbit::PHI1_PHI3, "has_codegree is only defined for faces");
+		if (codegree < 1u) return false;
+		Dart it = f.dart;
+		for (uint32 i = 1u; i < codegree; ++i)
+		{
+			it = phi1(it);
+			if (it == f.dart)
+				return false;
+		}
+		return phi1(it) == f.dart;
+	}
+
+	template <Orbit ORBIT>
+	inline std::pair<typename IncidentCells<ORBIT>::Vertex, typename IncidentCells<ORBIT>::Vertex> vertices(Cell<ORBIT> e) const
+	{
+		static_assert(ORBIT == Orbit::PHI2 || ORBIT == Orbit::PHI2_PHI3, "vertices is only defined for edges");
+		using VertexType = typename IncidentCells<ORBIT>::Vertex;
+		return std::pair<VertexType, VertexType>(VertexType(e.dart), VertexType(phi1(e.dart)));
+	}
+
+	/*******************************************************************************
+	 * Orbits traversal
+	 *******************************************************************************/
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_dart_of_orbit(Cell<ORBIT> c, const FUNC& f) const
+	{
+		static_assert(is_func_parameter_same<FUNC, Dart>::value, "Wrong function parameter type");
+
+		switch (ORBIT)
+		{
+			case Orbit::DART: f(c.dart); break;
+			case Orbit::PHI1: foreach_dart_of_cycle(c.dart, phi1_, f); break;
+			case Orbit::PHI2:
+				if (internal::void_to_true_binder(f, c.dart))
+					f(phi2(c.dart));
+				break;
+			case Orbit::PHI21:
+			{
+				Dart it = c.dart;
+				do
+				{
+					if (!internal::void_to_true_binder(f, it))
+						break;
+					it = phi2(phi_1(it));
+				} while (it != c.dart);
+				break;
+			}
+			case Orbit::PHI1_PHI3:
+				foreach_dart_of_cycle(c.dart, phi1_, [&] (Dart d) -> bool
+				{
+					if (internal::void_to_true_binder(f, d))
+						return internal::void_to_true_binder(f, Dart(phi3_[d.index]));
+					return false;
+				});
+				break;
+			case Orbit::PHI2_PHI3:
+			{
+				Dart it = c.dart;
+				do
+				{
+					if (!internal::void_to_true_binder(f, it))
+						break;
+					it = phi2(it);
+					if (!internal::void_to_true_binder(f, it))
+						break;
+					it = Dart(phi3_[it.index]);
+				} while (it != c.dart);
+				break;
+			}
+			default:
+				foreach_dart_of_stored_orbit(c, f);
+				break;
+		}
+	}
+
+	template <typename FUNC>
+	inline void foreach_dart(const FUNC& f) const
+	{
+		static_assert(is_func_parameter_same<FUNC, Dart>::value, "foreach_dart: given function should take a Dart as parameter");
+
+		for (uint32 i = 0u; i < nb_indices_; ++i)
+		{
+			if (phi1_[i] != INVALID_INDEX && !internal::void_to_true_binder(f, Dart(i)))
+				break;
+		}
+	}
+
+	template <typename FUNC>
+	inline void parallel_foreach_dart(const FUNC& f) const
+	{
+		static_assert(is_func_parameter_same<FUNC, Dart>::value, "parallel_foreach_dart: given function should take a Dart as parameter");
+
+		parallel_for(0u, nb_indices_, PARALLEL_BUFFER_SIZE, [this, &f] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				if (phi1_[i] != INVALID_INDEX)
+					f(Dart(i));
+		});
+	}
+
+	/*******************************************************************************
+	 * Cells traversal
+	 *******************************************************************************/
+
+	/**
+	 * \brief apply a function on each cell of the snapshot (boundary cells excluded)
+	 * the cells are traversed in the order of the traversal of the map
+	 * if the function returns a boolean, the traversal stops when it first returns false
+	 * The TraversalStrategy parameter is accepted for compatibility with the map and ignored.
+	 */
+	template <uint32 STRATEGY = 0u, typename FUNC>
+	inline void foreach_cell(const FUNC& f) const
+	{
+		using CellType = func_parameter_type<FUNC>;
+		foreach_cell(f, [] (CellType) { return true; });
+	}
+
+	template <uint32 STRATEGY = 0u, typename FUNC>
+	inline void foreach_cell(const FUNC& f, const AllCellsFilter&) const
+	{
+		foreach_cell(f);
+	}
+
+	template <uint32 STRATEGY = 0u, typename FUNC>
+	inline void foreach_cell(const FUNC& f, const CellFilters& filters) const
+	{
+		using CellType = func_parameter_type<FUNC>;
+		foreach_cell(f, [&filters] (CellType c) { return filters.filter(c); });
+	}
+
+	template <uint32 STRATEGY = 0u, typename FUNC, typename FilterFunction>
+	inline auto foreach_cell(const FUNC& f, const FilterFunction& filter) const
+		-> typename std::enable_if<
+			is_func_return_same<FilterFunction, bool>::value &&
+			is_func_parameter_same<FilterFunction, func_parameter_type<FUNC>>::value
+		   >::type
+	{
+		using CellType = func_parameter_type<FUNC>;
+
+		for (Dart d : cells_[CellType::ORBIT])
+		{
+			const CellType c(d);
+			if (filter(c) && !internal::void_to_true_binder(f, c))
+				break;
+		}
+	}
+
+	/**
+	 * \brief apply a function in parallel on each cell of the snapshot (boundary cells excluded)
+	 */
+	template <uint32 STRATEGY = 0u, typename FUNC>
+	inline void parallel_foreach_cell(const FUNC& f) const
+	{
+		using CellType = func_parameter_type<FUNC>;
+		parallel_foreach_cell(f, [] (CellType) { return true; });
+	}
+
+	template <uint32 STRATEGY = 0u, typename FUNC>
+	inline void parallel_foreach_cell(const FUNC& f, const AllCellsFilter&) const
+	{
+		parallel_foreach_cell(f);
+	}
+
+	template <uint32 STRATEGY = 0u, typename FUNC>
+	inline void parallel_foreach_cell(const FUNC& f, const CellFilters& filters) const
+	{
+		using CellType = func_parameter_type<FUNC>;
+		parallel_foreach_cell(f, [&filters] (CellType c) { return filters.filter(c); });
+	}
+
+	template <uint32 STRATEGY = 0u, typename FUNC, typename FilterFunction>
+	inline auto parallel_foreach_cell(const FUNC& f, const FilterFunction& filter) const
+		-> typename std::enable_if<
+			is_func_return_same<FilterFunction, bool>::value &&
+			is_func_parameter_same<FilterFunction, func_parameter_type<FUNC>>::value
+		   >::type
+	{
+		using CellType = func_parameter_type<FUNC>;
+
+		const std::vector<Dart>& cells = cells_[CellType::ORBIT];
+		parallel_for(0u, uint32(cells.size()), PARALLEL_BUFFER_SIZE, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+			{
+				const CellType c(cells[i]);
+				if (filter(c))
+					f(c);
+			}
+		});
+	}
+
+	/*******************************************************************************
+	 * Incidence traversal
+	 *******************************************************************************/
+
+	/**
+	 * \brief apply a function on each cell of type CellType incident to the cell c (boundary cells excluded)
+	 * the incident cells are represented by the first traversed dart of c that belongs to them
+	 */
+	template <typename CellType, Orbit ORBIT, typename FUNC>
+	void foreach_incident_cell(Cell<ORBIT> c, const FUNC& func) const
+	{
+		static_assert(is_func_parameter_same<FUNC, CellType>::value, "Wrong function cell parameter type");
+
+		const std::vector<uint32>& cell_index = cell_index_[CellType::ORBIT];
+		cgogn_message_assert(!cell_index.empty(), "Orbit not supported by the map");
+
+		if (is_cell2(ORBIT) && is_cell2(CellType::ORBIT))
+		{
+			// the orbit of a 2D cell meets each incident 2D cell once (unless it is degenerated)
+			foreach_dart_of_orbit(c, [&] (Dart d) -> bool
+			{
+				if (cell_index[d.index] == INVALID_INDEX)
+					return true;
+				return internal::void_to_true_binder(func, CellType(d));
+			});
+		}
+		else if (ORBIT == Orbit::PHI1_PHI2_PHI3 || (DIMENSION == 2u && ORBIT == Orbit::PHI1_PHI2))
+		{
+			// the traversed cell is a connected component
+			std::vector<bool> visited(nb_cells<CellType>(), false);
+			foreach_dart_of_orbit(c, [&] (Dart d) -> bool
+			{
+				const uint32 index = cell_index[d.index];
+				if (index == INVALID_INDEX || visited[index])
+					return true;
+				visited[index] = true;
+				return internal::void_to_true_binder(func, CellType(d));
+			});
+		}
+		else
+		{
+			std::vector<uint32>* indices = uint_buffers()->buffer();
+			std::vector<Dart>* darts = dart_buffers()->buffer();
+			foreach_dart_of_orbit(c, [&] (Dart d)
+			{
+				const uint32 index = cell_index[d.index];
+				if (index != INVALID_INDEX)
+				{
+					indices->push_back(index);
+					darts->push_back(d);
+				}
+			});
+			foreach_first_occurrence<CellType>(*indices, *darts, 0u, func);
+			dart_buffers()->release_buffer(darts);
+			uint_buffers()->release_buffer(indices);
+		}
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_incident_vertex(Cell<ORBIT> c, const FUNC& func) const
+	{
+		foreach_incident_cell<func_parameter_type<FUNC>>(c, func);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_incident_edge(Cell<ORBIT> c, const FUNC& func) const
+	{
+		foreach_incident_cell<func_parameter_type<FUNC>>(c, func);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_incident_face(Cell<ORBIT> c, const FUNC& func) const
+	{
+		foreach_incident_cell<func_parameter_type<FUNC>>(c, func);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_incident_volume(Cell<ORBIT> c, const FUNC& func) const
+	{
+		foreach_incident_cell<func_parameter_type<FUNC>>(c, func);
+	}
+
+	/*******************************************************************************
+	 * Adjacence traversal
+	 *******************************************************************************/
+
+	/**
+	 * \brief apply a function on each cell adjacent to c through a cell of type ThroughCell
+	 * i.e. on the cells of the orbit of c incident to the cells of type ThroughCell incident to c (c itself excluded)
+	 */
+	template <typename ThroughCell, Orbit ORBIT, typename FUNC>
+	void foreach_adjacent_cell(Cell<ORBIT> c, const FUNC& func) const
+	{
+		using CellType = Cell<ORBIT>;
+		static_assert(is_func_parameter_same<FUNC, CellType>::value, "Wrong function cell parameter type");
+
+		// c itself comes first so that it is skipped
+		std::vector<uint32>* indices = uint_buffers()->buffer();
+		std::vector<Dart>* darts = dart_buffers()->buffer();
+		indices->push_back(cell_index(c));
+		darts->push_back(c.dart);
+		foreach_incident_cell<ThroughCell>(c, [&] (ThroughCell t)
+		{
+			foreach_incident_cell<CellType>(t, [&] (CellType a)
+			{
+				indices->push_back(cell_index(a));
+				darts->push_back(a.dart);
+			});
+		});
+		foreach_first_occurrence<CellType>(*indices, *darts, 1u, func);
+		dart_buffers()->release_buffer(darts);
+		uint_buffers()->release_buffer(indices);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_vertex_through_edge(Cell<ORBIT> v, const FUNC& f) const
+	{
+		if (ORBIT == Orbit::PHI21)
+		{
+			// the other end of each incident edge, as in the map
+			static_assert(is_func_parameter_same<FUNC, Cell<ORBIT>>::value, "Wrong function cell parameter type");
+			foreach_dart_of_orbit(v, [this, &f] (Dart d) -> bool { return internal::void_to_true_binder(f, Cell<ORBIT>(phi2(d))); });
+		}
+		else
+			foreach_adjacent_cell<typename IncidentCells<ORBIT>::Edge>(v, f);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_vertex_through_face(Cell<ORBIT> v, const FUNC& f) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Face>(v, f);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_vertex_through_volume(Cell<ORBIT> v, const FUNC& f) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Volume>(v, f);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_edge_through_vertex(Cell<ORBIT> e, const FUNC& f) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Vertex>(e, f);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_edge_through_face(Cell<ORBIT> e, const FUNC& f) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Face>(e, f);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_edge_through_volume(Cell<ORBIT> e, const FUNC& f) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Volume>(e, f);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_face_through_vertex(Cell<ORBIT> f, const FUNC& func) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Vertex>(f, func);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_face_through_edge(Cell<ORBIT> f, const FUNC& func) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Edge>(f, func);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_face_through_volume(Cell<ORBIT> f, const FUNC& func) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Volume>(f, func);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_volume_through_vertex(Cell<ORBIT> v, const FUNC& f) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Vertex>(v, f);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_volume_through_edge(Cell<ORBIT> v, const FUNC& f) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Edge>(v, f);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_adjacent_volume_through_face(Cell<ORBIT> v, const FUNC& f) const
+	{
+		foreach_adjacent_cell<typename IncidentCells<ORBIT>::Face>(v, f);
+	}
+
+protected:
+
+	// the orbit is a vertex, an edge or a face of a CMap2 or of a volume of a CMap3
+	static inline bool is_cell2(Orbit orbit)
+	{
+		return orbit == Orbit::PHI1 || orbit == Orbit::PHI2 || orbit == Orbit::PHI21;
+	}
+
+	/**
+	 * \brief apply a function on the cells of a sequence of (cell index, dart), in the order of the sequence,
+	 * each cell being given once with its first dart (the cells met before position first are excluded)
+	 * (the first occurrences are found by sorting the positions by cell index)
+	 * @param indices the cell index of each dart (overwritten)
+	 */
+	template <typename CellType, typename FUNC>
+	void foreach_first_occurrence(std::vector<uint32>& indices, const std::vector<Dart>& darts, uint32 first, const FUNC& func) const
+	{
+		const uint32 nb = uint32(indices.size());
+		std::vector<uint32>* positions = uint_buffers()->buffer();
+		positions->resize(nb);
+		for (uint32 i = 0u; i < nb; ++i)
+			(*positions)[i] = i;
+		std::sort(positions->begin(), positions->end(), [&] (uint32 a, uint32 b)
+		{
+			return indices[a] < indices[b] || (indices[a] == indices[b] && a < b);
+		});
+
+		// the positions that are not the first occurrence of their cell are invalidated
+		uint32 previous = INVALID_INDEX;
+		for (uint32 p : *positions)
+		{
+			const uint32 index = indices[p];
+			if (index == previous)
+				indices[p] = INVALID_INDEX;
+			previous = index;
+		}
+		uint_buffers()->release_buffer(positions);
+
+		for (uint32 i = first; i < nb; ++i)
+		{
+			if (indices[i] != INVALID_INDEX && !internal::void_to_true_binder(func, CellType(darts[i])))
+				break;
+		}
+	}
+
+	template <typename FUNC>
+	inline void foreach_dart_of_cycle(Dart d, const std::vector<uint32>& phi, const FUNC& f) const
+	{
+		Dart it = d;
+		do
+		{
+			if (!internal::void_to_true_binder(f, it))
+				break;
+			it = Dart(phi[it.index]);
+		} while (it != d);
+	}
+
+	template <Orbit ORBIT, typename FUNC>
+	inline void foreach_dart_of_stored_orbit(Cell<ORBIT> c, const FUNC& f) const
+	{
+		const uint32 index = cell_index_[ORBIT][c.dart.index];
+		// boundary cells (e.g. boundary volumes of a CMap3) are not stored
+		if (index == INVALID_INDEX)
+			return map_->foreach_dart_of_orbit(c, f);
+
+		const std::vector<Dart>& darts = orbit_darts_[ORBIT];
+		for (uint32 i = orbit_offsets_[ORBIT][index], end = orbit_offsets_[ORBIT][index + 1u]; i < end; ++i)
+		{
+			if (!internal::void_to_true_binder(f, darts[i]))
+				break;
+		}
+	}
+
+	inline void freeze_phi3(std::false_type) {}
+
+	inline void freeze_phi3(std::true_type)
+	{
+		phi3_.assign(nb_indices_, INVALID_INDEX);
+		map_->foreach_dart([&] (Dart d) { phi3_[d.index] = map_->phi3(d).index; });
+	}
+
+	inline void freeze_orbits_3(std::false_type) {}
+
+	inline void freeze_orbits_3(std::true_type)
+	{
+		freeze_orbit<Orbit::PHI1_PHI3>();
+		freeze_orbit<Orbit::PHI2_PHI3>();
+		freeze_orbit<Orbit::PHI21_PHI31>();
+		freeze_orbit<Orbit::PHI1_PHI2_PHI3>();
+	}
+
+	template <Orbit ORBIT>
+	void freeze_orbit()
+	{
+		using CellType = Cell<ORBIT>;
+
+		// the darts of these orbits cannot be traversed without a marker
+		const bool store_darts = ORBIT == Orbit::PHI1_PHI2 || ORBIT == Orbit::PHI21_PHI31 || ORBIT == Orbit::PHI1_PHI2_PHI3;
+
+		std::vector<Dart>& cells = cells_[ORBIT];
+		std::vector<uint32>& cell_index = cell_index_[ORBIT];
+		std::vector<Dart>& darts = orbit_darts_[ORBIT];
+		std::vector<uint32>& offsets = orbit_offsets_[ORBIT];
+
+		cell_index.assign(nb_indices_, INVALID_INDEX);
+		if (store_darts)
+		{
+			darts.reserve(nb_darts_);
+			offsets.push_back(0u);
+		}
+
+		map_->foreach_cell([&] (CellType c)
+		{
+			const uint32 index = uint32(cells.size());
+			cells.push_back(c.dart);
+			map_->foreach_dart_of_orbit(c, [&] (Dart d)
+			{
+				cell_index[d.index] = index;
+				if (store_darts)
+					darts.push_back(d);
+			});
+			if (store_darts)
+				offsets.push_back(uint32(darts.size()));
+		});
+
+		if (map_->template is_embedded<ORBIT>())
+		{
+			std::vector<uint32>& embeddings = embeddings_[ORBIT];
+			embeddings.assign(nb_indices_, INVALID_INDEX);
+			map_->foreach_dart([&] (Dart d)
+			{
+				if (cell_index[d.index] != INVALID_INDEX)
+					embeddings[d.index] = map_->embedding(CellType(d));
+			});
+		}
+	}
+};
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_CMAP_FROZEN_TOPOLOGY_H_
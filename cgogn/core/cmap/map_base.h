@@ -26,11 +26,14 @@
 
 #include <vector>
 #include <memory>
+#include <algorithm>
 
 #include <cgogn/core/utils/masks.h>
 #include <cgogn/core/utils/logger.h>
 #include <cgogn/core/utils/unique_ptr.h>
 #include <cgogn/core/utils/type_traits.h>
+#include <cgogn/core/utils/parallel_for.h>
+#include <cgogn/core/utils/timer.h>
 
 #include <cgogn/core/basic/cell.h>
 #include <cgogn/core/basic/dart_marker.h>
@@ -46,31 +49,44 @@ enum TraversalStrategy
 {
 	AUTO = 0,
 	FORCE_DART_MARKING,
-	FORCE_CELL_MARKING
+	FORCE_CELL_MARKING,
+	FORCE_CHUNK_RANGE
 };
 
 template <typename MAP_TYPE>
-class MapBase : public MapBaseData
+class MapBase : public MapBaseData_T<map_chunk_size<MAP_TYPE>::value>
 {
 public:
 
-	using Inherit = MapBaseData;
+	using Inherit = MapBaseData_T<map_chunk_size<MAP_TYPE>::value>;
 	using Self = MapBase<MAP_TYPE>;
 
+	static const uint32 CHUNK_SIZE = Inherit::CHUNK_SIZE;
+
 	template <typename MAP> friend class DartMarker_T;
 	template <typename MAP, Orbit ORBIT> friend class CellMarker_T;
+	template <typename MAP> friend class DartMarkerEpoch;
+	template <typename MAP, Orbit ORBIT> friend class CellMarkerEpoch;
 
 	using typename Inherit::ChunkArrayGen;
 	template <typename T>
 	using ChunkArray = typename Inherit::template ChunkArray<T>;
 	using typename Inherit::ChunkArrayBool;
+	using typename Inherit::ChunkArrayStamp;
 	template <typename T_REF>
 	using ChunkArrayContainer = typename Inherit::template ChunkArrayContainer<T_REF>;
 
+	template <typename T>
+	using Attribute_T = cgogn::Attribute_T<T, CHUNK_SIZE>;
+	template <typename T, Orbit ORBIT>
+	using Attribute = cgogn::Attribute<T, ORBIT, CHUNK_SIZE>;
+
 	using ConcreteMap = typename MAP_TYPE::TYPE;
 
 	using DartMarker = cgogn::DartMarker<ConcreteMap>;
 	using DartMarkerStore = cgogn::DartMarkerStore<ConcreteMap>;
+	using ConcurrentDartMarker = cgogn::ConcurrentDartMarker<ConcreteMap>;
+	using DartMarkerEpoch = cgogn::DartMarkerEpoch<ConcreteMap>;
 
 	template <Orbit ORBIT>
 	using CellMarker = cgogn::CellMarker<ConcreteMap, ORBIT>;
@@ -78,6 +94,10 @@ public:
 	using CellMarkerStore = cgogn::CellMarkerStore<ConcreteMap, ORBIT>;
 	template <Orbit ORBIT>
 	using CellMarkerNoUnmark = typename cgogn::CellMarkerNoUnmark<ConcreteMap, ORBIT>;
+	template <Orbit ORBIT>
+	using ConcurrentCellMarker = typename cgogn::ConcurrentCellMarker<ConcreteMap, ORBIT>;
+	template <Orbit ORBIT>
+	using CellMarkerEpoch = typename cgogn::CellMarkerEpoch<ConcreteMap, ORBIT>;
 
 	MapBase() :	Inherit() {}
 	CGOGN_NOT_COPYABLE_NOR_MOVABLE(MapBase);
@@ -94,6 +114,7 @@ public:
 	inline void clear()
 	{
 		this->topology_.clear_chunk_arrays();
+		this->topology_changed();
 
 		for (uint32 i = 0u; i < NB_ORBITS; ++i)
 			this->attributes_[i].clear_chunk_arrays();
@@ -106,6 +127,7 @@ public:
 	{
 		// 1st step : some cleaning
 		this->topology_.clear_chunk_arrays();
+		this->topology_changed();
 
 		for (auto& att : this->attributes_)
 			att.remove_chunk_arrays();
@@ -116,6 +138,8 @@ public:
 			std::lock_guard<std::mutex> lock(this->mark_attributes_topology_mutex_);
 			for (ChunkArrayBool* cab : this->topology_.marker_arrays())
 				cab->clear();
+			for (ChunkArrayStamp* cas : this->topology_.stamp_arrays())
+				cas->clear();
 		}
 
 		for (std::size_t i = 0u; i < NB_ORBITS; ++i)
@@ -129,6 +153,8 @@ public:
 			std::lock_guard<std::mutex> lock(this->mark_attributes_mutex_[i]);
 			for (ChunkArrayBool* cab : this->attributes_[i].marker_arrays())
 				cab->clear();
+			for (ChunkArrayStamp* cas : this->attributes_[i].stamp_arrays())
+				cas->clear();
 		}
 	}
 
@@ -149,14 +175,10 @@ protected:
 	 *******************************************************************************/
 
 	/**
-	 * \brief Adds a topological element of PRIM_SIZE to the topology container
-	 * \return the index of the added element
-	 * Adding a topological element consists in adding PRIM_SIZE lines
-	 * to the topological container starting from index
+	 * \brief Initializes the PRIM_SIZE lines of a topological element that has just been inserted
 	 */
-	inline Dart add_topology_element()
+	inline void init_topology_element(uint32 idx)
 	{
-		const uint32 idx = this->topology_.template insert_lines<ConcreteMap::PRIM_SIZE>();
 		for (uint32 jdx = idx; jdx < idx + ConcreteMap::PRIM_SIZE; ++jdx)
 		{
 			this->topology_.init_markers_of_line(jdx);
@@ -167,9 +189,43 @@ protected:
 			}
 			to_concrete()->init_dart(Dart(jdx));
 		}
+	}
+
+	/**
+	 * \brief Adds a topological element of PRIM_SIZE to the topology container
+	 * \return the index of the added element
+	 * Adding a topological element consists in adding PRIM_SIZE lines
+	 * to the topological container starting from index
+	 */
+	inline Dart add_topology_element()
+	{
+		const uint32 idx = this->topology_.template insert_lines<ConcreteMap::PRIM_SIZE>();
+		this->topology_changed();
+		init_topology_element(idx);
 		return Dart(idx);
 	}
 
+	/**
+	 * \brief Adds n topological elements of PRIM_SIZE to the topology container at once
+	 * \param n the number of elements to add
+	 * \param darts the first darts of the added elements are appended to it
+	 * The holes of the container are filled first, the remaining elements are added contiguously
+	 * at the end of the container (see ChunkArrayContainer::insert_lines_bulk)
+	 */
+	inline void add_topology_elements(uint32 n, std::vector<Dart>& darts)
+	{
+		std::vector<uint32>* indices = uint_buffers()->buffer();
+		this->topology_.template insert_lines_bulk<ConcreteMap::PRIM_SIZE>(n, *indices);
+		this->topology_changed();
+		darts.reserve(darts.size() + n);
+		for (uint32 idx : *indices)
+		{
+			init_topology_element(idx);
+			darts.push_back(Dart(idx));
+		}
+		uint_buffers()->release_buffer(indices);
+	}
+
 	/**
 	 * \brief Removes a topological element of PRIM_SIZE from the topology container
 	 * \param d the element to remove ( or one them if PRIM_SIZE >1)
@@ -180,6 +236,14 @@ protected:
 	{
 		uint32 index = d.index;
 		this->topology_.template remove_lines<ConcreteMap::PRIM_SIZE>(index);
+		this->topology_changed();
+
+		if (this->has_topology_observers())
+		{
+			const uint32 first = (index / ConcreteMap::PRIM_SIZE) * ConcreteMap::PRIM_SIZE;
+			for (uint32 jdx = first; jdx < first + ConcreteMap::PRIM_SIZE; ++jdx)
+				this->record_dart_removed(Dart(jdx));
+		}
 
 		for (uint32 orbit = 0; orbit < NB_ORBITS; ++orbit)
 		{
@@ -189,7 +253,7 @@ protected:
 				{
 					uint32 emb = (*this->embeddings_[orbit])[jdx];
 					if (emb != INVALID_INDEX)
-						this->attributes_[orbit].unref_line(emb);
+						this->unref_attribute_line(Orbit(orbit), emb);
 				}
 			}
 		}
@@ -409,6 +473,48 @@ protected:
 		this->mark_attributes_[ORBIT][cgogn::current_thread_marker_index()].push_back(ca);
 	}
 
+	/**
+	* \brief get a stamp attribute on the given ORBIT attribute container (from pool or created)
+	* @return a stamp attribute on the ORBIT attribute container
+	*/
+	template <Orbit ORBIT>
+	inline ChunkArrayStamp* stamp_attribute()
+	{
+		static_assert(ORBIT < NB_ORBITS, "Unknown orbit parameter");
+
+		const std::size_t thread = cgogn::current_thread_marker_index();
+		cgogn_assert(thread < this->stamp_attributes_[ORBIT].size());
+
+		if (!this->stamp_attributes_[ORBIT][thread].empty())
+		{
+			ChunkArrayStamp* ca = this->stamp_attributes_[ORBIT][thread].back();
+			this->stamp_attributes_[ORBIT][thread].pop_back();
+			return ca;
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(this->mark_attributes_mutex_[ORBIT]);
+			if (!this->template is_embedded<ORBIT>())
+				create_embedding<ORBIT>();
+			ChunkArrayStamp* ca = this->attributes_[ORBIT].add_stamp_attribute();
+			return ca;
+		}
+	}
+
+	/**
+	* \brief release a stamp attribute on the given ORBIT attribute container
+	* @param the stamp attribute to release (its marks must have been cleared by a call to next_epoch)
+	*/
+	template <Orbit ORBIT>
+	inline void release_stamp_attribute(ChunkArrayStamp* ca)
+	{
+		static_assert(ORBIT < NB_ORBITS, "Unknown orbit parameter");
+		cgogn_message_assert(this->template is_embedded<ORBIT>(), "Invalid parameter: orbit not embedded");
+		cgogn_assert(cgogn::current_thread_marker_index() < this->stamp_attributes_[ORBIT].size());
+
+		this->stamp_attributes_[ORBIT][cgogn::current_thread_marker_index()].push_back(ca);
+	}
+
 	/*******************************************************************************
 	 * Embedding management
 	 *******************************************************************************/
@@ -652,14 +758,23 @@ public:
 	template <Orbit ORBIT>
 	uint32 nb_cells() const
 	{
+		static_assert(ORBIT < NB_ORBITS, "Unknown orbit parameter");
+
 		if (this->template is_embedded<ORBIT>())
 			return this->attributes_[ORBIT].size();
-		else
+
+		if (is_cell_counter_enabled<ORBIT>())
 		{
-			uint32 result = 0u;
-			foreach_cell([&result] (Cell<ORBIT>) { ++result; });
-			return result;
+			// the counter is stale if an operator that does not maintain it has been applied since last count
+			if (this->nb_cells_revision_[ORBIT] != this->topology_revision_)
+			{
+				this->nb_cells_[ORBIT] = count_cells<ORBIT>();
+				this->nb_cells_revision_[ORBIT] = this->topology_revision_;
+			}
+			return this->nb_cells_[ORBIT];
 		}
+
+		return count_cells<ORBIT>();
 	}
 
 	template <typename CellType>
@@ -668,6 +783,45 @@ public:
 		return nb_cells<CellType::ORBIT>();
 	}
 
+	/**
+	 * \brief maintain the number of cells of the given orbit
+	 * When the orbit is not embedded, nb_cells<ORBIT>() returns the counter updated by the topological
+	 * operators (cut_edge, collapse_edge, add_face, ...) instead of traversing the map. The cells are
+	 * counted again by the first call that follows an operator that does not update the counters.
+	 * @warning nb_cells<ORBIT>() may then modify the counter and must not be called concurrently
+	 */
+	template <Orbit ORBIT>
+	inline void enable_cell_counter()
+	{
+		static_assert(ORBIT < NB_ORBITS, "Unknown orbit parameter");
+		this->counted_orbits_ |= (1u << ORBIT);
+	}
+
+	template <Orbit ORBIT>
+	inline void disable_cell_counter()
+	{
+		static_assert(ORBIT < NB_ORBITS, "Unknown orbit parameter");
+		this->counted_orbits_ &= ~(1u << ORBIT);
+	}
+
+	template <Orbit ORBIT>
+	inline bool is_cell_counter_enabled() const
+	{
+		static_assert(ORBIT < NB_ORBITS, "Unknown orbit parameter");
+		return (this->counted_orbits_ & (1u << ORBIT)) != 0u;
+	}
+
+	/**
+	 * \brief count the cells of the given orbit by a traversal of the map
+	 */
+	template <Orbit ORBIT>
+	uint32 count_cells() const
+	{
+		uint32 result = 0u;
+		foreach_cell([&result] (Cell<ORBIT>) { ++result; });
+		return result;
+	}
+
 	template <Orbit ORBIT, typename MASK>
 	uint32 nb_cells(const MASK& mask) const
 	{
@@ -733,6 +887,7 @@ public:
 	inline void set_boundary(Dart d, bool b)
 	{
 		this->boundary_marker_->set_value(d.index, b);
+		this->topology_changed();
 	}
 
 #pragma warning(push)
@@ -877,70 +1032,15 @@ public:
 	{
 		static_assert(is_func_parameter_same<FUNC, Dart>::value, "parallel_foreach_dart: given function should take a Dart as parameter");
 
-		using Future = std::future<typename std::result_of<FUNC(Dart)>::type>;
-		using VecDarts = std::vector<Dart>;
-
-		ThreadPool* thread_pool = cgogn::thread_pool();
-		uint32 nb_workers = thread_pool->nb_workers();
-		if (nb_workers == 0)
+		if (cgogn::thread_pool()->nb_workers() == 0u)
 			return foreach_dart(f);
 
-		std::array<std::vector<VecDarts*>, 2> dart_buffers;
-		std::array<std::vector<Future>, 2> futures;
-		dart_buffers[0].reserve(nb_workers);
-		dart_buffers[1].reserve(nb_workers);
-		futures[0].reserve(nb_workers);
-		futures[1].reserve(nb_workers);
-
-		Buffers<Dart>* dbuffs = cgogn::dart_buffers();
-		const ConcreteMap* cmap = to_concrete();
-
-		uint32 i = 0u; // buffer id (0/1)
-		uint32 j = 0u; // thread id (0..nb_workers)
-		Dart it = cmap->all_begin();
-		Dart last = cmap->all_end();
-
-		while (it != last)
+		parallel_for(0u, this->topology_.end(), CHUNK_SIZE, [this, &f] (uint32 first, uint32 last)
 		{
-			dart_buffers[i].push_back(dbuffs->buffer());
-			cgogn_assert(dart_buffers[i].size() <= nb_workers);
-			std::vector<Dart>& darts = *dart_buffers[i].back();
-			darts.reserve(PARALLEL_BUFFER_SIZE);
-			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && it.index < last.index; ++k)
-			{
-				darts.push_back(it);
-				cmap->all_next(it);
-			}
-
-			futures[i].push_back(thread_pool->enqueue([&darts, &f] ()
-			{
-				for (auto d : darts)
-					f(d);
-			}));
-
-			// next thread
-			if (++j == nb_workers)
-			{	// again from 0 & change buffer
-				j = 0;
-				i = (i+1u) % 2u;
-				for (auto& fu : futures[i])
-					fu.wait();
-				for (auto& b : dart_buffers[i])
-					dbuffs->release_buffer(b);
-				futures[i].clear();
-				dart_buffers[i].clear();
-			}
-		}
-
-		// clean all at end
-		for (auto& fu : futures[0u])
-			fu.wait();
-		for (auto& b : dart_buffers[0u])
-			dbuffs->release_buffer(b);
-		for (auto& fu : futures[1u])
-			fu.wait();
-		for (auto& b : dart_buffers[1u])
-			dbuffs->release_buffer(b);
+			for (uint32 it = first; it < last; ++it)
+				if (this->topology_.used(it))
+					f(Dart(it));
+		});
 	}
 
 	/**
@@ -1015,6 +1115,9 @@ public:
 			case FORCE_CELL_MARKING :
 				foreach_cell_cell_marking(f, filter);
 				break;
+			case FORCE_CHUNK_RANGE :
+				foreach_cell_chunk_range(f, filter);
+				break;
 			case AUTO :
 				if (this->template is_embedded<CellType>())
 					foreach_cell_cell_marking(f, filter);
@@ -1028,6 +1131,12 @@ public:
 	 * \brief apply a function in parallel on each cell of the map (boundary cells excluded)
 	 * the dimension of the traversed cells is determined based on the parameter of the given callable
 	 * only cells selected by the given FilterFunction (CellType -> bool) are processed
+	 * @warning with the cell marking strategy (AUTO on an embedded orbit, FORCE_CELL_MARKING) and FORCE_CHUNK_RANGE,
+	 * the filter is evaluated concurrently by the worker threads (it must be thread safe),
+	 * and with the cell marking strategy the dart from which each cell is given to f (and to the filter)
+	 * is the first one claimed by a worker, so it depends on the scheduling of the threads
+	 * (the dart marking strategy evaluates the filter on the calling thread and FORCE_CHUNK_RANGE
+	 * always gives the non boundary dart of smallest index of the cell)
 	 * @tparam FUNC type of the callable
 	 * @tparam FilterFunction type of the cell filtering function (CellType -> bool)
 	 * @param f a callable
@@ -1042,6 +1151,8 @@ public:
 	{
 		using CellType = func_parameter_type<FUNC>;
 
+		cgogn_profile_zone("parallel_foreach_cell");
+
 		switch (STRATEGY)
 		{
 			case FORCE_DART_MARKING :
@@ -1050,6 +1161,9 @@ public:
 			case FORCE_CELL_MARKING :
 				parallel_foreach_cell_cell_marking(f, filter);
 				break;
+			case FORCE_CHUNK_RANGE :
+				parallel_foreach_cell_chunk_range(f, filter);
+				break;
 			case AUTO :
 				if (this->template is_embedded<CellType>())
 					parallel_foreach_cell_cell_marking(f, filter);
@@ -1135,70 +1249,102 @@ public:
 	{
 		using CellType = func_parameter_type<FUNC>;
 
-		using VecCell = std::vector<CellType>;
-		using Future = std::future<typename std::result_of<FUNC(CellType)>::type>;
-
 		if (!t.template is_traversed<CellType>())
 			cgogn_log_warning("foreach_cell") << "Using a CellTraversor for a non-traversed CellType";
 
-		ThreadPool* thread_pool = cgogn::thread_pool();
-		uint32 nb_workers = thread_pool->nb_workers();
-		if (nb_workers == 0)
+		if (cgogn::thread_pool()->nb_workers() == 0u)
 			return foreach_cell(f, t);
 
-		std::array<std::vector<VecCell*>, 2> cells_buffers;
-		std::array<std::vector<Future>, 2> futures;
-		cells_buffers[0].reserve(nb_workers);
-		cells_buffers[1].reserve(nb_workers);
-		futures[0].reserve(nb_workers);
-		futures[1].reserve(nb_workers);
-
-		Buffers<Dart>* dbuffs = cgogn::dart_buffers();
-
-		uint32 i = 0u; // buffer id (0/1)
-		uint32 j = 0u; // thread id (0..nb_workers)
 		auto it = t.template begin<CellType>();
 		const auto it_end = t.template end<CellType>();
-		while(it != it_end)
-		{
-			// fill buffer
-			cells_buffers[i].push_back(dbuffs->template cell_buffer<CellType>());
-			VecCell& cells = *cells_buffers[i].back();
-			cells.reserve(PARALLEL_BUFFER_SIZE);
-			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && (it != it_end); ++k)
+		internal::parallel_foreach_buffered<CellType>(
+			cgogn::dart_buffers(),
+			[&] (std::vector<CellType>& cells) -> bool
 			{
-				cells.push_back(CellType(*it));
-				++it;
-			}
-			// launch thread
-			futures[i].push_back(thread_pool->enqueue([&cells, &f] ()
-			{
-				for (auto c : cells)
-					f(c);
-			}));
-			// next thread
-			if (++j == nb_workers)
-			{	// again from 0 & change buffer
-				j = 0;
-				i = (i+1u) % 2u;
-				for (auto& fu : futures[i])
-					fu.wait();
-				for (auto& b : cells_buffers[i])
-					dbuffs->release_cell_buffer(b);
-				futures[i].clear();
-				cells_buffers[i].clear();
-			}
+				for (uint32 k = 0u; k < PARALLEL_BUFFER_SIZE && it != it_end; ++k)
+				{
+					cells.push_back(CellType(*it));
+					++it;
+				}
+				return it != it_end;
+			},
+			f
+		);
+	}
+
+	/**
+	 * \brief reduce the cells of the map (boundary cells excluded) in parallel
+	 * the dimension of the traversed cells is determined based on the second parameter of the given accumulate function
+	 * each thread accumulates the cells it traverses into its own copy of identity with accumulate(acc, c),
+	 * then the accumulators of the threads are combined with reduce
+	 * @param identity neutral element of reduce, used as initial value of the accumulators
+	 * @param accumulate a callable (T&, CellType) adding a cell to an accumulator
+	 * @param reduce a callable (const T&, const T&) -> T combining two accumulators (associative)
+	 * @param mask the cells to traverse (filter function, CellFilters or CellTraversor)
+	 * @return the combination of the accumulators of all the threads
+	 */
+	template <typename T, typename ACCUMULATE, typename REDUCE, typename MASK>
+	inline T parallel_reduce(const T& identity, const ACCUMULATE& accumulate, const REDUCE& reduce, const MASK& mask) const
+	{
+		using CellType = func_ith_parameter_type<ACCUMULATE, 1>;
+		static_assert(is_ith_func_parameter_same<ACCUMULATE, 0, T&>::value, "parallel_reduce: accumulate should take a T& as first parameter");
+
+		// with a single worker, the sequential traversal avoids the cost of the concurrent marking
+		const uint32 nb_workers = cgogn::thread_pool()->nb_workers();
+		if (nb_workers <= 1u)
+		{
+			T result = identity;
+			foreach_cell([&] (CellType c) { accumulate(result, c); }, mask);
+			return result;
 		}
 
-		// clean all at end
-		for (auto& fu : futures[0u])
-			fu.wait();
-		for (auto& b : cells_buffers[0u])
-			dbuffs->release_cell_buffer(b);
-		for (auto& fu : futures[1u])
-			fu.wait();
-		for (auto& b : cells_buffers[1u])
-			dbuffs->release_cell_buffer(b);
+		std::vector<internal::PaddedValue<T>> accumulators(nb_workers, internal::PaddedValue<T>(identity));
+		parallel_foreach_cell([&] (CellType c)
+		{
+			const uint32 thread_index = current_thread_index();
+			cgogn_message_assert(thread_index < nb_workers, "parallel_reduce: called from a thread outside the pool");
+			accumulate(accumulators[thread_index].value_, c);
+		},
+		mask);
+
+		T result = identity;
+		for (const auto& acc : accumulators)
+			result = reduce(result, acc.value_);
+		return result;
+	}
+
+	template <typename T, typename ACCUMULATE, typename REDUCE>
+	inline T parallel_reduce(const T& identity, const ACCUMULATE& accumulate, const REDUCE& reduce) const
+	{
+		return parallel_reduce(identity, accumulate, reduce, AllCellsFilter());
+	}
+
+	/**
+	 * \brief map the cells of the map (boundary cells excluded) to values and reduce these values in parallel
+	 * the dimension of the traversed cells is determined based on the parameter of the given transform function
+	 * @param identity neutral element of reduce
+	 * @param transform a callable (CellType) -> T
+	 * @param reduce a callable (const T&, const T&) -> T combining two values (associative)
+	 * @param mask the cells to traverse (filter function, CellFilters or CellTraversor)
+	 * @return the reduction of the values of all the traversed cells
+	 */
+	template <typename T, typename TRANSFORM, typename REDUCE, typename MASK>
+	inline T parallel_transform_reduce(const T& identity, const TRANSFORM& transform, const REDUCE& reduce, const MASK& mask) const
+	{
+		using CellType = func_parameter_type<TRANSFORM>;
+
+		return parallel_reduce(
+			identity,
+			[&] (T& acc, CellType c) { acc = reduce(acc, transform(c)); },
+			reduce,
+			mask
+		);
+	}
+
+	template <typename T, typename TRANSFORM, typename REDUCE>
+	inline T parallel_transform_reduce(const T& identity, const TRANSFORM& transform, const REDUCE& reduce) const
+	{
+		return parallel_transform_reduce(identity, transform, reduce, AllCellsFilter());
 	}
 
 protected:
@@ -1246,79 +1392,36 @@ protected:
 	{
 		using CellType = func_parameter_type<FUNC>;
 
-		using VecCell = std::vector<CellType>;
-		using Future = std::future<typename std::result_of<FUNC(CellType)>::type>;
-
-		ThreadPool* thread_pool = cgogn::thread_pool();
-		uint32 nb_workers = thread_pool->nb_workers();
-		if (nb_workers == 0)
+		if (cgogn::thread_pool()->nb_workers() == 0u)
 			return foreach_cell_dart_marking(f, filter);
 
-		std::array<std::vector<VecCell*>, 2> cells_buffers;
-		std::array<std::vector<Future>, 2> futures;
-		cells_buffers[0].reserve(nb_workers);
-		cells_buffers[1].reserve(nb_workers);
-		futures[0].reserve(nb_workers);
-		futures[1].reserve(nb_workers);
-
-		Buffers<Dart>* dbuffs = cgogn::dart_buffers();
-
 		const ConcreteMap* cmap = to_concrete();
 		DartMarker dm(*cmap);
 		Dart it = cmap->begin();
-		Dart last = cmap->end();
+		const Dart last = cmap->end();
 
-		uint32 i = 0u; // buffer id (0/1)
-		uint32 j = 0u; // thread id (0..nb_workers)
-		while (it.index < last.index)
-		{
-			// fill buffer
-			cells_buffers[i].push_back(dbuffs->template cell_buffer<CellType>());
-			VecCell& cells = *cells_buffers[i].back();
-			cells.reserve(PARALLEL_BUFFER_SIZE);
-			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && it.index < last.index; )
+		internal::parallel_foreach_buffered<CellType>(
+			cgogn::dart_buffers(),
+			[&] (std::vector<CellType>& cells) -> bool
 			{
-				if (!dm.is_marked(it))
+				for (uint32 k = 0u; k < PARALLEL_BUFFER_SIZE && it.index < last.index; )
 				{
-					CellType c(it);
-					dm.mark_orbit(c);
-					if (filter(c))
+					if (!dm.is_marked(it))
 					{
-						cells.push_back(c);
-						++k;
+						const CellType c(it);
+						dm.mark_orbit(c);
+						if (filter(c))
+						{
+							cells.push_back(c);
+							++k;
+						}
 					}
+					cmap->next(it);
 				}
-				cmap->next(it);
-			}
-			//launch thread
-			futures[i].push_back(thread_pool->enqueue([&cells, &f] ()
-			{
-				for (auto c : cells)
-					f(c);
-			}));
-			// next thread
-			if (++j == nb_workers)
-			{	// again from 0 & change buffer
-				j = 0;
-				i = (i+1u) % 2u;
-				for (auto& fu : futures[i])
-					fu.wait();
-				for (auto& b : cells_buffers[i])
-					dbuffs->release_cell_buffer(b);
-				futures[i].clear();
-				cells_buffers[i].clear();
-			}
-		}
-
-		// clean all at end
-		for (auto& fu : futures[0u])
-			fu.wait();
-		for (auto &b : cells_buffers[0u])
-			dbuffs->release_cell_buffer(b);
-		for (auto& fu : futures[1u])
-			fu.wait();
-		for (auto &b : cells_buffers[1u])
-			dbuffs->release_cell_buffer(b);
+				return it.index < last.index;
+			},
+			f
+		);
 	}
 
 	/**
@@ -1351,7 +1454,9 @@ protected:
 	}
 
 	/**
-	 * \brief apply a function in parallel on each cell of the map (boundary cells excluded) using a CellMarker
+	 * \brief apply a function in parallel on each cell of the map (boundary cells excluded) using a ConcurrentCellMarker
+	 * the workers traverse disjoint chunks of darts and claim the cells themselves with an atomic test-and-set
+	 * so the filter is evaluated by the workers and the dart representing each cell depends on the scheduling
 	 * the dimension of the traversed cells is determined based on the parameter of the given callable
 	 * only cells selected by the given FilterFunction (CellType -> bool) are processed
 	 * @tparam FUNC type of the callable
@@ -1365,79 +1470,145 @@ protected:
 		using CellType = func_parameter_type<FUNC>;
 		static const Orbit ORBIT = CellType::ORBIT;
 
-		using VecCell = std::vector<CellType>;
-		using Future = std::future<typename std::result_of<FUNC(CellType)>::type>;
-
-		ThreadPool* thread_pool = cgogn::thread_pool();
-		uint32 nb_workers = thread_pool->nb_workers();
-		if (nb_workers == 0)
+		if (cgogn::thread_pool()->nb_workers() == 0u)
 			return foreach_cell_cell_marking(f, filter);
 
-		std::array<std::vector<VecCell*>, 2> cells_buffers;
-		std::array<std::vector<Future>, 2> futures;
-		cells_buffers[0].reserve(nb_workers);
-		cells_buffers[1].reserve(nb_workers);
-		futures[0].reserve(nb_workers);
-		futures[1].reserve(nb_workers);
+		ConcurrentCellMarker<ORBIT> cm(*to_concrete());
 
-		Buffers<Dart>* dbuffs = cgogn::dart_buffers();
+		parallel_for(0u, this->topology_.end(), CHUNK_SIZE, [this, &cm, &f, &filter] (uint32 first, uint32 last)
+		{
+			for (uint32 it = first; it < last; ++it)
+			{
+				if (this->topology_.used(it) && !is_boundary(Dart(it)))
+				{
+					const CellType c = CellType(Dart(it));
+					if (cm.test_and_mark(c) && filter(c))
+						f(c);
+				}
+			}
+		});
+	}
+
+	/**
+	 * \brief apply a function on each cell of the map (boundary cells excluded) without any marker
+	 * the cells are enumerated by the lines of their attribute container: a first pass over the darts stores,
+	 * at the embedding index of each cell, its representative dart i.e. the non boundary dart of smallest index
+	 * of the cell (the dart from which a marking traversal processes it), with O(1) work per dart
+	 * only available for embedded orbits: the cells of other orbits are traversed by dart marking
+	 * the dimension of the traversed cells is determined based on the parameter of the given callable
+	 * only cells selected by the given FilterFunction (CellType -> bool) are processed
+	 * if the function returns a boolean, the traversal stops when it first returns false
+	 * @tparam FUNC type of the callable
+	 * @tparam FilterFunction type of the cell filtering function (CellType -> bool)
+	 * @param f a callable
+	 * @param filter a cell filtering function
+	 */
+	template <typename FUNC, typename FilterFunction>
+	inline void foreach_cell_chunk_range(const FUNC& f, const FilterFunction& filter) const
+	{
+		using CellType = func_parameter_type<FUNC>;
+		static const Orbit ORBIT = CellType::ORBIT;
+
+		if (!this->template is_embedded<ORBIT>())
+			return foreach_cell_dart_marking(f, filter);
+
+		const ChunkArray<uint32>& embedding = *this->embeddings_[ORBIT];
+		const ChunkArrayContainer<uint32>& container = this->attributes_[ORBIT];
+
+		std::vector<uint32>* representatives = uint_buffers()->buffer();
+		representatives->assign(container.end(), INVALID_INDEX);
 
 		const ConcreteMap* cmap = to_concrete();
-		CellMarker<ORBIT> cm(*cmap);
-		Dart it = cmap->begin();
-		Dart last = cmap->end();
+		for (Dart it = cmap->begin(), last = cmap->end(); it.index < last.index; cmap->next(it))
+		{
+			if (!is_boundary(it))
+			{
+				uint32& r = (*representatives)[embedding[it.index]];
+				if (r == INVALID_INDEX)
+					r = it.index;
+			}
+		}
 
-		uint32 i = 0u; // buffer id (0/1)
-		uint32 j = 0u; // thread id (0..nb_workers)
-		while (it.index < last.index)
+		for (uint32 i = container.begin(), end = container.end(); i != end; container.next(i))
 		{
-			// fill buffer
-			cells_buffers[i].push_back(dbuffs->template cell_buffer<CellType>());
-			VecCell& cells = *cells_buffers[i].back();
-			cells.reserve(PARALLEL_BUFFER_SIZE);
-			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && it.index < last.index; )
+			const uint32 r = (*representatives)[i];
+			if (r != INVALID_INDEX)
 			{
-				CellType c(it);
-				if (!cm.is_marked(c))
+				const CellType c = CellType(Dart(r));
+				if (filter(c) && !internal::void_to_true_binder(f, c))
+					break;
+			}
+		}
+
+		uint_buffers()->release_buffer(representatives);
+	}
+
+	/**
+	 * \brief apply a function in parallel on each cell of the map (boundary cells excluded) without any marker
+	 * the workers directly traverse whole chunks of the topology container to find the representative dart of each cell
+	 * (cf. foreach_cell_chunk_range, the minimum is taken atomically), then whole chunks of the attribute container
+	 * to process the cells (nothing is gathered by the calling thread)
+	 * the array of the representatives is reused by the next traversals of the calling thread (cf. AtomicUintBuffer)
+	 * only available for embedded orbits: the cells of other orbits are traversed by dart marking
+	 * the dimension of the traversed cells is determined based on the parameter of the given callable
+	 * only cells selected by the given FilterFunction (CellType -> bool) are processed
+	 * @tparam FUNC type of the callable
+	 * @tparam FilterFunction type of the cell filtering function (CellType -> bool)
+	 * @param f a callable
+	 * @param filter a cell filtering function
+	 */
+	template <typename FUNC, typename FilterFunction>
+	inline void parallel_foreach_cell_chunk_range(const FUNC& f, const FilterFunction& filter) const
+	{
+		using CellType = func_parameter_type<FUNC>;
+		static const Orbit ORBIT = CellType::ORBIT;
+
+		if (!this->template is_embedded<ORBIT>())
+			return parallel_foreach_cell_dart_marking(f, filter);
+
+		if (cgogn::thread_pool()->nb_workers() == 0u)
+			return foreach_cell_chunk_range(f, filter);
+
+		const ChunkArray<uint32>& embedding = *this->embeddings_[ORBIT];
+		const ChunkArrayContainer<uint32>& container = this->attributes_[ORBIT];
+		const uint32 nb_lines = container.end();
+
+		AtomicUintBuffer representatives(nb_lines);
+		parallel_for(0u, nb_lines, CHUNK_SIZE, [&representatives] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				representatives[i].store(INVALID_INDEX, std::memory_order_relaxed);
+		});
+
+		parallel_for(0u, this->topology_.end(), CHUNK_SIZE, [this, &embedding, &representatives] (uint32 first, uint32 last)
+		{
+			for (uint32 it = first; it < last; ++it)
+			{
+				if (this->topology_.used(it) && !is_boundary(Dart(it)))
 				{
-					cm.mark(c);
-					if (filter(c))
-					{
-						cells.push_back(c);
-						++k;
-					}
+					std::atomic<uint32>& r = representatives[embedding[it]];
+					uint32 current = r.load(std::memory_order_relaxed);
+					while (it < current && !r.compare_exchange_weak(current, it, std::memory_order_relaxed)) {}
 				}
-				cmap->next(it);
 			}
-			// launch thread
-			futures[i].push_back(thread_pool->enqueue([&cells, &f] ()
+		});
+
+		parallel_for(0u, nb_lines, CHUNK_SIZE, [&container, &representatives, &f, &filter] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
 			{
-				for (auto c : cells)
-					f(c);
-			}));
-			// next thread
-			if (++j == nb_workers)
-			{	// again from 0 & change buffer
-				j = 0;
-				i = (i+1u) % 2u;
-				for (auto& fu : futures[i])
-					fu.wait();
-				for (auto& b : cells_buffers[i])
-					dbuffs->release_cell_buffer(b);
-				futures[i].clear();
-				cells_buffers[i].clear();
+				if (container.used(i))
+				{
+					const uint32 r = representatives[i].load(std::memory_order_relaxed);
+					if (r != INVALID_INDEX)
+					{
+						const CellType c = CellType(Dart(r));
+						if (filter(c))
+							f(c);
+					}
+				}
 			}
-		}
-
-		// clean all at end
-		for (auto& fu : futures[0u])
-			fu.wait();
-		for (auto& b : cells_buffers[0u])
-			dbuffs->release_cell_buffer(b);
-		for (auto& fu : futures[1u])
-			fu.wait();
-		for (auto& b : cells_buffers[1u])
-			dbuffs->release_cell_buffer(b);
+		});
 	}
 
 public:
@@ -1468,12 +1639,16 @@ public:
 		}
 	}
 
-	void compact_topo()
+	/**
+	 * @brief compact the topology container
+	 * @return the map from old to new dart indices (empty if already compact, unchanged darts -> INVALID_INDEX)
+	 */
+	std::vector<uint32> compact_topo()
 	{
 		std::vector<uint32> old_new = this->topology_.template compact<ConcreteMap::PRIM_SIZE>();
 
 		if (old_new.empty())
-			return;			// already compact nothing to do with relationss
+			return old_new;		// already compact nothing to do with relationss
 
 		for (ChunkArrayGen* ptr: this->topology_.chunk_arrays())
 		{
@@ -1489,6 +1664,7 @@ public:
 				}
 			}
 		}
+		return old_new;
 	}
 
 	/**
@@ -1501,6 +1677,266 @@ public:
 			compact_embedding(orbit); // checking if embedding used done inside
 	}
 
+	/**
+	 * @brief compact this map and give back the memory it does not use anymore:
+	 * trailing chunks of the containers, mark attributes kept in the pools, buffers
+	 * cached by the threads. The released chunks go back to the chunk pool shared by all
+	 * the maps, that keeps them for the next allocations (up to its cache limit):
+	 * chunk_pool()->trim() gives the cached chunks of all the maps back to the system.
+	 * @warning no marker of this map may be in use during the call
+	 * @return the number of bytes reclaimed by this map
+	 */
+	std::size_t shrink()
+	{
+		compact();
+
+		std::size_t nb_bytes = this->remove_pooled_mark_attributes();
+		nb_bytes += this->topology_.shrink_to_fit();
+		for (uint32 orbit = 0; orbit < NB_ORBITS; ++orbit)
+			nb_bytes += this->attributes_[orbit].shrink_to_fit();
+		nb_bytes += shrink_thread_buffers();
+
+		return nb_bytes;
+	}
+
+	/*******************************************************************************
+	 * reordering
+	 *******************************************************************************/
+
+	/**
+	 * @brief compact the map and renumber its darts and the lines of its embedded orbits
+	 * so that the given cells are stored one after the other, in this order:
+	 * - the darts of each cell (whole topology elements of PRIM_SIZE darts) are given the next indices,
+	 * the darts that belong to none of the cells are placed after them in their former order
+	 * - the lines of each embedded orbit are numbered in the order of their first dart
+	 * The phi relations, the embeddings, the attributes and the markers are permuted accordingly.
+	 * @param cells the cells in their new order (their darts may have been obtained before compacting)
+	 * @warning all the darts and cell indices held outside of the map are invalidated
+	 */
+	template <typename CellType>
+	void reorder(const std::vector<CellType>& cells)
+	{
+		static const uint32 PRIM_SIZE = ConcreteMap::PRIM_SIZE;
+		const std::vector<uint32> compacted = compact_topo();
+
+		// new index of the topology elements, in the order of the given cells
+		const uint32 nb_elements = this->topology_.end() / PRIM_SIZE;
+		std::vector<uint32> element_new(nb_elements, INVALID_INDEX);
+		uint32 next = 0u;
+		for (CellType c : cells)
+		{
+			// the orbit is traversed in the compacted topology
+			if (!compacted.empty() && compacted[c.dart.index] != INVALID_INDEX)
+				c.dart = Dart(compacted[c.dart.index]);
+			to_concrete()->foreach_dart_of_orbit(c, [&] (Dart d)
+			{
+				uint32& e = element_new[d.index / PRIM_SIZE];
+				if (e == INVALID_INDEX)
+					e = next++;
+			});
+		}
+		for (uint32& e : element_new)
+			if (e == INVALID_INDEX)
+				e = next++;
+
+		reorder_topo(element_new);
+
+		for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+			reorder_embedding(orbit);
+	}
+
+	/**
+	 * @brief reorder the map (see reorder(cells)) by a breadth first traversal of the cells of CellType,
+	 * two cells being neighbours when a phi relation links one of their darts,
+	 * so that the darts and lines of the neighbourhood of a cell are close to each other in memory
+	 */
+	template <typename CellType>
+	void reorder()
+	{
+		compact_topo();
+
+		std::vector<ChunkArray<Dart>*> relations;
+		for (ChunkArrayGen* ptr : this->topology_.chunk_arrays())
+		{
+			ChunkArray<Dart>* ca = dynamic_cast<ChunkArray<Dart>*>(ptr);
+			if (ca)
+				relations.push_back(ca);
+		}
+
+		// the cells vector is also the queue of the traversal
+		std::vector<bool> visited(this->topology_.end(), false);
+		std::vector<CellType> cells;
+		auto visit = [&] (Dart d)
+		{
+			if (visited[d.index])
+				return;
+			to_concrete()->foreach_dart_of_orbit(CellType(d), [&] (Dart e) { visited[e.index] = true; });
+			cells.push_back(CellType(d));
+		};
+
+		for (uint32 it = this->topology_.begin(), end = this->topology_.end(); it != end; this->topology_.next(it))
+		{
+			if (visited[it])
+				continue;
+			std::size_t head = cells.size();
+			visit(Dart(it));
+			while (head < cells.size())
+			{
+				const CellType c = cells[head++];
+				to_concrete()->foreach_dart_of_orbit(c, [&] (Dart d)
+				{
+					for (ChunkArray<Dart>* ca : relations)
+						visit((*ca)[d.index]);
+				});
+			}
+		}
+
+		reorder(cells);
+	}
+
+	/**
+	 * @brief reorder the map by a breadth first traversal of its vertices (see reorder<CellType>())
+	 */
+	void reorder()
+	{
+		reorder<typename ConcreteMap::Vertex>();
+	}
+
+	/**
+	 * @brief reorder the map (see reorder(cells)) by sorting the cells of ORBIT along a Morton (Z-order) curve
+	 * of the given positions, so that the cells that are close in space are close in memory
+	 * @param position an attribute whose values have a size() and an operator[] (only the 3 first coordinates are used)
+	 */
+	template <typename VEC, Orbit ORBIT>
+	void reorder(const Attribute<VEC, ORBIT>& position)
+	{
+		using CellType = Cell<ORBIT>;
+		static const uint32 NB_BITS = 21u;
+		static const float64 MAX_COORD = float64((1u << NB_BITS) - 1u);
+
+		std::vector<CellType> cells;
+		float64 bb_min[3] = { 0.0, 0.0, 0.0 };
+		float64 bb_max[3] = { 0.0, 0.0, 0.0 };
+		foreach_cell([&] (CellType c)
+		{
+			const VEC& p = position[c];
+			for (uint32 k = 0u, dim = std::min(uint32(p.size()), 3u); k < dim; ++k)
+			{
+				const float64 x = float64(p[k]);
+				if (cells.empty() || x < bb_min[k])
+					bb_min[k] = x;
+				if (cells.empty() || x > bb_max[k])
+					bb_max[k] = x;
+			}
+			cells.push_back(c);
+		});
+
+		std::vector<std::pair<uint64, CellType>> codes;
+		codes.reserve(cells.size());
+		for (CellType c : cells)
+		{
+			const VEC& p = position[c];
+			uint64 code = 0u;
+			for (uint32 k = 0u, dim = std::min(uint32(p.size()), 3u); k < dim; ++k)
+			{
+				const float64 extent = bb_max[k] - bb_min[k];
+				const uint64 q = extent > 0.0 ? uint64((float64(p[k]) - bb_min[k]) / extent * MAX_COORD) : 0u;
+				code |= morton_spread(q) << k;
+			}
+			codes.emplace_back(code, c);
+		}
+		std::stable_sort(codes.begin(), codes.end(), [] (const std::pair<uint64, CellType>& a, const std::pair<uint64, CellType>& b)
+		{
+			return a.first < b.first;
+		});
+		for (std::size_t i = 0u; i < codes.size(); ++i)
+			cells[i] = codes[i].second;
+
+		reorder(cells);
+	}
+
+protected:
+
+	/**
+	 * @brief permute the darts of a compact map and update the phi relations
+	 * @param element_new new index of each topology element (block of PRIM_SIZE darts)
+	 */
+	void reorder_topo(const std::vector<uint32>& element_new)
+	{
+		static const uint32 PRIM_SIZE = ConcreteMap::PRIM_SIZE;
+
+		std::vector<uint32> old_new(this->topology_.end());
+		for (uint32 i = 0u; i < uint32(old_new.size()); ++i)
+			old_new[i] = element_new[i / PRIM_SIZE] * PRIM_SIZE + i % PRIM_SIZE;
+
+		this->topology_.permute(old_new);
+
+		for (ChunkArrayGen* ptr : this->topology_.chunk_arrays())
+		{
+			ChunkArray<Dart>* ca = dynamic_cast<ChunkArray<Dart>*>(ptr);
+			if (ca)
+			{
+				for (uint32 i = this->topology_.begin(); i != this->topology_.end(); this->topology_.next(i))
+				{
+					Dart& d = (*ca)[i];
+					d = Dart(old_new[d.index]);
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief compact an embedding orbit and number its lines in the order of their first dart
+	 * the lines that are not referenced by any dart are placed after the others
+	 * @param orbit to reorder
+	 */
+	void reorder_embedding(uint32 orbit)
+	{
+		ChunkArray<uint32>* embedding = this->embeddings_[orbit];
+		if (embedding == nullptr)
+			return;
+
+		compact_embedding(orbit);
+
+		ChunkArrayContainer<uint32>& container = this->attributes_[orbit];
+		std::vector<uint32> old_new(container.end(), INVALID_INDEX);
+		uint32 next = 0u;
+		for (uint32 i = this->topology_.begin(); i != this->topology_.end(); this->topology_.next(i))
+		{
+			const uint32 emb = (*embedding)[i];
+			if (emb != INVALID_INDEX && old_new[emb] == INVALID_INDEX)
+				old_new[emb] = next++;
+		}
+		for (uint32& e : old_new)
+			if (e == INVALID_INDEX)
+				e = next++;
+
+		container.permute(old_new);
+
+		for (uint32 i = this->topology_.begin(); i != this->topology_.end(); this->topology_.next(i))
+		{
+			uint32& emb = (*embedding)[i];
+			if (emb != INVALID_INDEX)
+				emb = old_new[emb];
+		}
+	}
+
+	/**
+	 * @brief spread the 21 low bits of x so that two zero bits separate them (used for 3D Morton codes)
+	 */
+	static inline uint64 morton_spread(uint64 x)
+	{
+		x &= 0x1fffffull;
+		x = (x | (x << 32)) & 0x1f00000000ffffull;
+		x = (x | (x << 16)) & 0x1f0000ff0000ffull;
+		x = (x | (x << 8)) & 0x100f00f00f00f00full;
+		x = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+		x = (x | (x << 2)) & 0x1249249249249249ull;
+		return x;
+	}
+
+public:
+
 	/**
 	 * @brief merge map in this map
 	 * @param map must be of same type than map
@@ -1529,6 +1965,7 @@ public:
 
 		// store index of copied darts
 		std::vector<uint32> old_new_topo = this->topology_.template merge<ConcreteMap::PRIM_SIZE>(map.topology_);
+		this->topology_changed();
 
 		// mark new darts with the given dartmarker
 		newdarts.unmark_all();
@@ -1590,8 +2027,124 @@ public:
 		// ok
 		return true;
 	}
+
+	/**
+	 * @brief replace the content of this map by a copy of map
+	 * The topology and the attribute containers are copied chunk by chunk, so that the darts
+	 * and the cells keep their indices (contrary to merge, which compacts and copies line by line).
+	 * The attributes of this map are removed beforehand.
+	 * @param map must be of same type than map
+	 */
+	void copy(const ConcreteMap& map)
+	{
+		this->clear_and_remove_attributes();
+
+		// the embeddings of map are also created in this map (with the same names)
+		to_concrete()->merge_check_embedding(map);
+
+		this->topology_.copy(map.topology_);
+		for (uint32 i = 0; i < NB_ORBITS; ++i)
+		{
+			if (map.embeddings_[i] != nullptr)
+				this->attributes_[i].copy(map.attributes_[i]);
+		}
+		this->boundary_marker_->copy_data(*map.boundary_marker_);
+
+		this->topology_changed();
+	}
+
+	/**
+	 * @brief create a copy of this map (cf. copy)
+	 */
+	std::unique_ptr<ConcreteMap> clone() const
+	{
+		std::unique_ptr<ConcreteMap> map = make_unique<ConcreteMap>();
+		map->copy(*to_concrete());
+		return map;
+	}
+
+	/**
+	 * @brief save the map in a snapshot file (.cgogn)
+	 * The topology and the attribute containers are written in the native binary format
+	 * (cf. SnapshotWriter), so that load_snapshot can map them in memory without parsing.
+	 * @param filename the name of the file
+	 * @return false if the file could not be written
+	 */
+	bool save_snapshot(const std::string& filename) const
+	{
+		SnapshotWriter w(filename);
+		if (!w.good())
+		{
+			cgogn_log_warning("save_snapshot") << "Unable to open file \"" << filename << "\".";
+			return false;
+		}
+
+		w.write_header(name_of_type(*to_concrete()), CHUNK_SIZE);
+		this->topology_.save_snapshot(w);
+		save_chunk_array(w, this->boundary_marker_, this->topology_.end());
+		for (uint32 i = 0; i < NB_ORBITS; ++i)
+		{
+			const uint8 embedded = this->embeddings_[i] != nullptr ? 1u : 0u;
+			w.write(embedded);
+			if (embedded)
+				this->attributes_[i].save_snapshot(w);
+		}
+
+		return w.good();
+	}
+
+	/**
+	 * @brief replace the content of this map by the content of a snapshot file (cf. save_snapshot)
+	 * The file is mapped in memory and the chunks of the attributes that can be copied bytewise (including
+	 * the topology, cf. is_raw_copyable) point straight into the mapping, that is released with the last of these chunks.
+	 * The attributes of this map are removed beforehand.
+	 * @param filename the name of the file
+	 * @param mode copy-on-write (the attributes can be modified, the file never is) or read-only
+	 * @return false if the file is not a snapshot of a map of this type (the map is then empty)
+	 */
+	bool load_snapshot(const std::string& filename, SnapshotMode mode = SnapshotMode::COPY_ON_WRITE)
+	{
+		SnapshotReader r(filename, mode);
+		if (!r.good())
+		{
+			cgogn_log_warning("load_snapshot") << "Unable to open file \"" << filename << "\".";
+			return false;
+		}
+		if (!r.read_header(name_of_type(*to_concrete()), CHUNK_SIZE))
+		{
+			cgogn_log_warning("load_snapshot") << "\"" << filename << "\" is not a snapshot of a " << name_of_type(*to_concrete()) << ".";
+			return false;
+		}
+
+		this->clear_and_remove_attributes();
+
+		bool ok = this->topology_.load_snapshot(r) && load_chunk_array(r, this->boundary_marker_);
+		for (uint32 i = 0; ok && i < NB_ORBITS; ++i)
+		{
+			uint8 embedded = 0u;
+			ok = r.read(embedded);
+			if (ok && embedded)
+			{
+				std::ostringstream oss;
+				oss << "EMB_" << orbit_name(Orbit(i));
+				this->embeddings_[i] = this->topology_.template get_chunk_array<uint32>(oss.str());
+				ok = this->embeddings_[i] != nullptr && this->attributes_[i].load_snapshot(r);
+			}
+		}
+		this->topology_changed();
+
+		if (!ok)
+		{
+			cgogn_log_warning("load_snapshot") << "\"" << filename << "\" is corrupted.";
+			this->clear_and_remove_attributes();
+		}
+		return ok;
+	}
 };
 
+template <typename MAP_TYPE>
+const uint32 MapBase<MAP_TYPE>::CHUNK_SIZE;
+
 } // namespace cgogn
 
 #endif // CGOGN_CORE_CMAP_MAP_BASE_H_
@@ -28,44 +28,71 @@
 namespace cgogn
 {
 
-std::vector<const MapBaseData*>* MapBaseData::instances_ = nullptr;
+TopologyObserver::~TopologyObserver()
+{}
+
+void TopologyObserver::darts_removed(const std::vector<Dart>&)
+{}
+
+void TopologyObserver::cells_removed(Orbit, const std::vector<uint32>&)
+{}
+
+void TopologyObserver::cells_created(Orbit, const std::vector<Dart>&)
+{}
+
+void TopologyObserver::cells_modified(Orbit, const std::vector<Dart>&)
+{}
+
+std::vector<const MapBaseGen*>* MapBaseGen::instances_ = nullptr;
 // tetra_phi2 = {3,5,7,-3,7,2,-5,-2,2,-7,-2,-7}
-const std::array<uint32, 12> MapBaseData::tetra_phi2 = {3,5,7,uint32(-3),7,2,uint32(-5),uint32(-2),2,uint32(-7),uint32(-2),uint32(-7)};
+const std::array<uint32, 12> MapBaseGen::tetra_phi2 = {3,5,7,uint32(-3),7,2,uint32(-5),uint32(-2),2,uint32(-7),uint32(-2),uint32(-7)};
 // hexa_phi2 = {4,7,10,13, -4,14,17,2, -7,-2,12,2, -10,-2,7,2, -13,-2,2,-14, -2,-7,-12,-17}
-const std::array<uint32, 24> MapBaseData::hexa_phi2 = {4,7,10,13, uint32(-4),14,17,2, uint32(-7),uint32(-2),12,2, uint32(-10),uint32(-2),7,2, uint32(-13),uint32(-2),2,uint32(-14), uint32(-2),uint32(-7),uint32(-12),uint32(-17)};
+const std::array<uint32, 24> MapBaseGen::hexa_phi2 = {4,7,10,13, uint32(-4),14,17,2, uint32(-7),uint32(-2),12,2, uint32(-10),uint32(-2),7,2, uint32(-13),uint32(-2),2,uint32(-14), uint32(-2),uint32(-7),uint32(-12),uint32(-17)};
 
-MapBaseData::MapBaseData()
+std::size_t MapMemoryUsage::total() const
+{
+	std::size_t nb_bytes = topology.total();
+	for (const auto& a : attributes)
+		nb_bytes += a.total();
+	return nb_bytes;
+}
+
+std::ostream& operator<<(std::ostream& o, const MapMemoryUsage& usage)
+{
+	auto print_container = [&o] (const std::string& name, const ContainerMemoryUsage& cmu)
+	{
+		o << "\n  " << name << ": " << cmu.total() << " bytes (" << cmu.nb_lines << " lines, markers " << cmu.markers << ", internal " << cmu.internal << ")";
+		for (const auto& a : cmu.arrays)
+			o << "\n    " << a.name << " <" << a.type_name << ">: " << a.bytes;
+	};
+
+	o << "total " << usage.total() << " bytes";
+	print_container("topology", usage.topology);
+	for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+	{
+		// skip the orbits that are not embedded
+		if (usage.attributes[orbit].nb_lines > 0u || !usage.attributes[orbit].arrays.empty())
+			print_container(orbit_name(Orbit(orbit)), usage.attributes[orbit]);
+	}
+	o << "\n  mark pools: " << usage.mark_pools << " bytes";
+	o << "\n  thread buffers (shared): " << usage.thread_buffers << " bytes";
+	return o;
+}
+
+MapBaseGen::MapBaseGen()
 {
 	if (instances_ == nullptr)
 	{
 		cgogn::thread_start(0,0);
-		instances_ = new std::vector<const MapBaseData*>;
+		instances_ = new std::vector<const MapBaseGen*>;
 	}
 
 	// register the map in the vector of instances
 	cgogn_assert(std::find(instances_->begin(), instances_->end(), this) == instances_->end());
 	instances_->push_back(this);
-
-	uint32 nb_mark_threads = thread_pool()->max_nb_workers() + external_thread_pool()->max_nb_workers() + 1; // +1 for main thread
-
-	for (uint32 i = 0u; i < NB_ORBITS; ++i)
-	{
-		mark_attributes_[i].resize(nb_mark_threads);
-
-		embeddings_[i] = nullptr;
-		for (uint32 j = 0u; j < nb_mark_threads; ++j)
-			mark_attributes_[i][j].reserve(8u);
-	}
-
-	mark_attributes_topology_.resize(nb_mark_threads);
-
-	for (uint32 i = 0u; i < nb_mark_threads; ++i)
-		mark_attributes_topology_[i].reserve(8u);
-
-	boundary_marker_ = topology_.add_marker_attribute();
 }
 
-MapBaseData::~MapBaseData()
+MapBaseGen::~MapBaseGen()
 {
 	// remove the map from the vector of instances
 	auto it = std::find(instances_->begin(), instances_->end(), this);
@@ -80,4 +107,58 @@ MapBaseData::~MapBaseData()
 	}
 }
 
+void MapBaseGen::add_topology_observer(TopologyObserver* o)
+{
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+	cgogn_assert(std::find(topology_observers_.begin(), topology_observers_.end(), o) == topology_observers_.end());
+	topology_observers_.push_back(o);
+#else
+	unused_parameters(o);
+	cgogn_log_error("MapBaseGen::add_topology_observer") << "The topology observers are disabled (CGOGN_WITH_TOPOLOGY_OBSERVERS is OFF).";
+#endif
+}
+
+void MapBaseGen::remove_topology_observer(TopologyObserver* o)
+{
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+	auto it = std::find(topology_observers_.begin(), topology_observers_.end(), o);
+	if (it != topology_observers_.end())
+		topology_observers_.erase(it);
+
+	// pending events are of no use to the remaining observers if there are none
+	if (topology_observers_.empty())
+		topology_events_ = TopologyEvents();
+#else
+	unused_parameters(o);
+#endif
+}
+
+void MapBaseGen::deliver_topology_events()
+{
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+	// the events are moved out before the delivery: observers may modify the map while handling them
+	TopologyEvents events;
+	std::swap(events, topology_events_);
+
+	if (!events.removed_darts.empty())
+		for (TopologyObserver* o : topology_observers_)
+			o->darts_removed(events.removed_darts);
+
+	for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+		if (!events.removed_cells[orbit].empty())
+			for (TopologyObserver* o : topology_observers_)
+				o->cells_removed(Orbit(orbit), events.removed_cells[orbit]);
+
+	for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+		if (!events.created_cells[orbit].empty())
+			for (TopologyObserver* o : topology_observers_)
+				o->cells_created(Orbit(orbit), events.created_cells[orbit]);
+
+	for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+		if (!events.modified_cells[orbit].empty())
+			for (TopologyObserver* o : topology_observers_)
+				o->cells_modified(Orbit(orbit), events.modified_cells[orbit]);
+#endif
+}
+
 } // namespace cgogn
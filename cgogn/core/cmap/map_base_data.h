@@ -53,22 +53,188 @@ namespace cgogn
 
 // forward declarations
 class AttributeGen;
-template <typename T> class Attribute_T;
-template <typename T, Orbit ORBIT> class Attribute;
+template <typename T, uint32 CHUNK_SIZE> class Attribute_T;
+template <typename T, Orbit ORBIT, uint32 CHUNK_SIZE> class Attribute;
 
 /**
- * @brief The MapBaseData class
+ * @brief memory used by a map
+ * topology: darts container, attributes: per orbit containers,
+ * mark_pools: part of the marker arrays that is kept in the pools (not used by a marker),
+ * thread_buffers: buffers cached by the threads (shared by all the maps)
  */
-class CGOGN_CORE_EXPORT MapBaseData
+struct CGOGN_CORE_EXPORT MapMemoryUsage
+{
+	ContainerMemoryUsage topology;
+	std::array<ContainerMemoryUsage, NB_ORBITS> attributes;
+	std::size_t mark_pools = 0u;
+	std::size_t thread_buffers = 0u;
+
+	/**
+	 * @brief total number of bytes used by the containers of the map (thread buffers excluded)
+	 */
+	std::size_t total() const;
+};
+
+CGOGN_CORE_EXPORT std::ostream& operator<<(std::ostream& o, const MapMemoryUsage& usage);
+
+/**
+ * @brief The TopologyObserver class
+ * Interface of the objects notified of the modifications of the topology of a map (cf. MapBaseGen::add_topology_observer).
+ * The events are recorded by the operators of the map and delivered in batches, once the operator (embeddings included)
+ * is done (cf. MapBaseGen::flush_topology_events), in this order:
+ * - darts_removed: the darts removed from the map
+ * - cells_removed: the embeddings of the cells of an embedded orbit whose attribute line has been released
+ * - cells_created: a dart of each cell created by the operator
+ * - cells_modified: a dart of each cell whose set of darts has changed
+ * The reports are conservative: a cell may be reported more than once, reported as modified although it has been
+ * created or left unchanged, and a dart given in a batch may have been removed by the same operator.
+ * The operators of CMap2 record and flush all their events, the other maps only record the removals of darts
+ * and cells, delivered at the next call to flush_topology_events.
+ * The default implementations ignore the events.
+ */
+class CGOGN_CORE_EXPORT TopologyObserver
+{
+public:
+
+	virtual ~TopologyObserver();
+	virtual void darts_removed(const std::vector<Dart>& darts);
+	virtual void cells_removed(Orbit orbit, const std::vector<uint32>& embeddings);
+	virtual void cells_created(Orbit orbit, const std::vector<Dart>& darts);
+	virtual void cells_modified(Orbit orbit, const std::vector<Dart>& darts);
+};
+
+/**
+ * @brief The MapBaseGen class
+ * Part of the maps data that does not depend on the chunk size of their containers.
+ */
+class CGOGN_CORE_EXPORT MapBaseGen
+{
+public:
+
+	using Self = MapBaseGen;
+
+protected:
+#pragma warning(push)
+#pragma warning(disable:4251)
+	// vector of Map instances
+	static std::vector<const MapBaseGen*>* instances_;
+
+	// table of tetra phi2 indices
+	static const std::array<uint32, 12> tetra_phi2;
+	// table of hexa phi2 indices
+	static const std::array<uint32, 24> hexa_phi2;
+
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+	// observers notified of the modifications of the topology
+	std::vector<TopologyObserver*> topology_observers_;
+
+	// events recorded since the last flush
+	struct TopologyEvents
+	{
+		std::vector<Dart> removed_darts;
+		std::array<std::vector<uint32>, NB_ORBITS> removed_cells;
+		std::array<std::vector<Dart>, NB_ORBITS> created_cells;
+		std::array<std::vector<Dart>, NB_ORBITS> modified_cells;
+	};
+	TopologyEvents topology_events_;
+#endif
+#pragma warning(pop)
+
+public:
+
+	MapBaseGen();
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(MapBaseGen);
+	virtual ~MapBaseGen();
+
+	static inline bool is_alive(const MapBaseGen* map)
+	{
+		return (instances_ != nullptr) && (std::find(instances_->begin(), instances_->end(), map) != instances_->end());
+	}
+
+	/**
+	 * @brief register an observer of the topology of the map
+	 * Without CGOGN_WITH_TOPOLOGY_OBSERVERS, the observers are compiled out and this is an error.
+	 */
+	void add_topology_observer(TopologyObserver* o);
+
+	void remove_topology_observer(TopologyObserver* o);
+
+	/**
+	 * @brief deliver the recorded events to the observers and clear them
+	 * Called at the end of the operators that record events.
+	 */
+	inline void flush_topology_events()
+	{
+		if (has_topology_observers())
+			deliver_topology_events();
+	}
+
+protected:
+
+	void deliver_topology_events();
+
+	inline bool has_topology_observers() const
+	{
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+		return !topology_observers_.empty();
+#else
+		return false;
+#endif
+	}
+
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+	inline void record_dart_removed(Dart d)
+	{
+		if (has_topology_observers())
+			topology_events_.removed_darts.push_back(d);
+	}
+
+	inline void record_cell_removed(Orbit orbit, uint32 emb)
+	{
+		if (has_topology_observers())
+			topology_events_.removed_cells[orbit].push_back(emb);
+	}
+
+	template <Orbit ORBIT>
+	inline void record_cell_created(Cell<ORBIT> c)
+	{
+		if (has_topology_observers())
+			topology_events_.created_cells[ORBIT].push_back(c.dart);
+	}
+
+	template <Orbit ORBIT>
+	inline void record_cell_modified(Cell<ORBIT> c)
+	{
+		if (has_topology_observers())
+			topology_events_.modified_cells[ORBIT].push_back(c.dart);
+	}
+#else
+	// the events are not recorded: the calls of the operators compile to nothing
+	inline void record_dart_removed(Dart) {}
+	inline void record_cell_removed(Orbit, uint32) {}
+	template <Orbit ORBIT>
+	inline void record_cell_created(Cell<ORBIT>) {}
+	template <Orbit ORBIT>
+	inline void record_cell_modified(Cell<ORBIT>) {}
+#endif
+};
+
+/**
+ * @brief The MapBaseData_T class
+ * @tparam CHUNK_SIZE_ chunk size of all the containers of the map (cf. map_chunk_size)
+ */
+template <uint32 CHUNK_SIZE_>
+class MapBaseData_T : public MapBaseGen
 {
 public:
 
-	using Self = MapBaseData;
+	using Inherit = MapBaseGen;
+	using Self = MapBaseData_T<CHUNK_SIZE_>;
 
-	static const uint32 CHUNK_SIZE = CGOGN_CHUNK_SIZE;
+	static const uint32 CHUNK_SIZE = CHUNK_SIZE_;
 
-	template <typename T> friend class Attribute_T;
-	template <typename T, Orbit ORBIT> friend class Attribute;
+	template <typename T, uint32 CS> friend class Attribute_T;
+	template <typename T, Orbit ORBIT, uint32 CS> friend class Attribute;
 
 	template <typename T_REF>
 	using ChunkArrayContainer = cgogn::ChunkArrayContainer<CHUNK_SIZE, T_REF>;
@@ -76,6 +242,7 @@ public:
 	template <typename T>
 	using ChunkArray = cgogn::ChunkArray<CHUNK_SIZE, T>;
 	using ChunkArrayBool = cgogn::ChunkArrayBool<CHUNK_SIZE>;
+	using ChunkArrayStamp = cgogn::ChunkArrayStamp<CHUNK_SIZE>;
 
 protected:
 #pragma warning(push)
@@ -94,32 +261,68 @@ protected:
 
 	// vector of available mark attributes per thread on the topology container
 	std::vector<std::vector<ChunkArrayBool*>> mark_attributes_topology_;
-	std::mutex mark_attributes_topology_mutex_;
+	mutable std::mutex mark_attributes_topology_mutex_;
 
 	// vector of available mark attributes per orbit per thread on attributes containers
 	std::array<std::vector<std::vector<ChunkArrayBool*>>, NB_ORBITS> mark_attributes_;
-	std::array<std::mutex, NB_ORBITS> mark_attributes_mutex_;
+	mutable std::array<std::mutex, NB_ORBITS> mark_attributes_mutex_;
 
-	// vector of Map instances
-	static std::vector<const MapBaseData*>* instances_;
+	// vectors of available stamp attributes (epoch markers) per thread, protected by the same mutexes
+	std::vector<std::vector<ChunkArrayStamp*>> stamp_attributes_topology_;
+	std::array<std::vector<std::vector<ChunkArrayStamp*>>, NB_ORBITS> stamp_attributes_;
 
-	// table of tetra phi2 indices
-	static const std::array<uint32, 12> tetra_phi2;
-	// table of hexa phi2 indices
-	static const std::array<uint32, 24> hexa_phi2;
+	// revision of the topology, incremented by each low-level topological modification
+	uint64 topology_revision_;
+
+	// true while a batched operator applies a round of independent operations in parallel:
+	// the low-level modifications do not increment the revision, the batch does it once per round
+	bool topology_batch_;
+
+	// number of cells per orbit and revision of the topology for which this number is exact (cf. MapBase::nb_cells)
+	mutable std::array<uint32, NB_ORBITS> nb_cells_;
+	mutable std::array<uint64, NB_ORBITS> nb_cells_revision_;
+
+	// orbits whose number of cells is maintained (bit mask)
+	uint32 counted_orbits_;
 #pragma warning(pop)
 
 public:
 
-	MapBaseData();
-	CGOGN_NOT_COPYABLE_NOR_MOVABLE(MapBaseData);
-	virtual ~MapBaseData();
-
-	static inline bool is_alive(const MapBaseData* map)
+	MapBaseData_T() : Inherit(),
+		topology_revision_(0u),
+		topology_batch_(false),
+		counted_orbits_(0u)
 	{
-		return (instances_ != nullptr) && (std::find(instances_->begin(), instances_->end(), map) != instances_->end());
+		// the numbers of cells of the empty map are exact
+		nb_cells_.fill(0u);
+		nb_cells_revision_.fill(0u);
+
+		uint32 nb_mark_threads = thread_pool()->max_nb_workers() + external_thread_pool()->max_nb_workers() + 1; // +1 for main thread
+
+		for (uint32 i = 0u; i < NB_ORBITS; ++i)
+		{
+			mark_attributes_[i].resize(nb_mark_threads);
+			stamp_attributes_[i].resize(nb_mark_threads);
+
+			embeddings_[i] = nullptr;
+			for (uint32 j = 0u; j < nb_mark_threads; ++j)
+				mark_attributes_[i][j].reserve(8u);
+		}
+
+		mark_attributes_topology_.resize(nb_mark_threads);
+		stamp_attributes_topology_.resize(nb_mark_threads);
+
+		for (uint32 i = 0u; i < nb_mark_threads; ++i)
+			mark_attributes_topology_[i].reserve(8u);
+
+		boundary_marker_ = topology_.add_marker_attribute();
 	}
 
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(MapBaseData_T);
+
+	~MapBaseData_T() override
+	{}
+
 	/*******************************************************************************
 	 * Containers management
 	 *******************************************************************************/
@@ -151,6 +354,58 @@ protected:
 		return attributes_[ORBIT];
 	}
 
+	/*******************************************************************************
+	 * Cell counters management
+	 *******************************************************************************/
+
+	/**
+	 * \brief signal a low-level modification of the topology (dart insertion or removal, sewing, boundary marking)
+	 * The cell counters that are not updated by the calling operator become stale.
+	 */
+	inline void topology_changed()
+	{
+		if (!topology_batch_)
+			++topology_revision_;
+	}
+
+public:
+
+	/**
+	 * \brief counter incremented by each modification of the topology
+	 */
+	inline uint64 topology_revision() const
+	{
+		return topology_revision_;
+	}
+
+protected:
+
+	/**
+	 * \brief add delta to the number of cells of the orbit of CellType if it was exact before the operator
+	 * @param revision the topology revision at the beginning of the operator
+	 */
+	template <typename CellType>
+	inline void update_cell_counter(uint64 revision, int32 delta)
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		if (nb_cells_revision_[ORBIT] == revision)
+			nb_cells_[ORBIT] = uint32(int64(nb_cells_[ORBIT]) + delta);
+	}
+
+	/**
+	 * \brief end of an operator that updated the cell counters of all the orbits it modifies
+	 * The counters that were exact at the beginning of the operator are exact for the current topology.
+	 * @param revision the topology revision at the beginning of the operator
+	 */
+	inline void cell_counters_updated(uint64 revision)
+	{
+		for (uint64& r : nb_cells_revision_)
+		{
+			if (r == revision)
+				r = topology_revision_;
+		}
+	}
+
 	/*******************************************************************************
 	 * Marking attributes management
 	 *******************************************************************************/
@@ -188,6 +443,162 @@ protected:
 		this->mark_attributes_topology_[thread].push_back(ca);
 	}
 
+	/**
+	* \brief get a stamp attribute on the topology container (from pool or created)
+	* @return a stamp attribute on the topology container
+	*/
+	inline ChunkArrayStamp* topology_stamp_attribute()
+	{
+		const std::size_t thread = cgogn::current_thread_marker_index();
+		cgogn_assert(thread < stamp_attributes_topology_.size());
+		if (!this->stamp_attributes_topology_[thread].empty())
+		{
+			ChunkArrayStamp* ca = this->stamp_attributes_topology_[thread].back();
+			this->stamp_attributes_topology_[thread].pop_back();
+			return ca;
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(this->mark_attributes_topology_mutex_);
+			ChunkArrayStamp* ca = this->topology_.add_stamp_attribute();
+			return ca;
+		}
+	}
+
+	/**
+	* \brief release a stamp attribute on the topology container
+	* @param the stamp attribute to release (its marks must have been cleared by a call to next_epoch)
+	*/
+	inline void release_topology_stamp_attribute(ChunkArrayStamp* ca)
+	{
+		const std::size_t thread = cgogn::current_thread_marker_index();
+		cgogn_assert(thread < stamp_attributes_topology_.size());
+		this->stamp_attributes_topology_[thread].push_back(ca);
+	}
+
+	/**
+	* \brief delete the mark attributes kept in the pools of all threads
+	* The mark attributes currently used by markers are not affected.
+	* @return the number of bytes released
+	*/
+	std::size_t remove_pooled_mark_attributes()
+	{
+		std::size_t nb_bytes = 0u;
+		{
+			std::lock_guard<std::mutex> lock(mark_attributes_topology_mutex_);
+			for (auto& pool : mark_attributes_topology_)
+				nb_bytes += remove_mark_attributes(topology_, pool);
+			for (auto& pool : stamp_attributes_topology_)
+				nb_bytes += remove_stamp_attributes(topology_, pool);
+		}
+		for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+		{
+			std::lock_guard<std::mutex> lock(mark_attributes_mutex_[orbit]);
+			for (auto& pool : mark_attributes_[orbit])
+				nb_bytes += remove_mark_attributes(attributes_[orbit], pool);
+			for (auto& pool : stamp_attributes_[orbit])
+				nb_bytes += remove_stamp_attributes(attributes_[orbit], pool);
+		}
+		return nb_bytes;
+	}
+
+public:
+
+	/*******************************************************************************
+	 * Memory accounting
+	 *******************************************************************************/
+
+	/**
+	 * @brief compute the memory used by the map, per container and per attribute
+	 */
+	MapMemoryUsage memory_usage() const
+	{
+		MapMemoryUsage usage;
+		usage.topology = topology_.memory_usage();
+		for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+			usage.attributes[orbit] = attributes_[orbit].memory_usage();
+
+		{
+			std::lock_guard<std::mutex> lock(mark_attributes_topology_mutex_);
+			for (const auto& pool : mark_attributes_topology_)
+				for (const ChunkArrayBool* ca : pool)
+					usage.mark_pools += ca->memory_usage();
+			for (const auto& pool : stamp_attributes_topology_)
+				for (const ChunkArrayStamp* ca : pool)
+					usage.mark_pools += ca->memory_usage();
+		}
+		for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+		{
+			std::lock_guard<std::mutex> lock(mark_attributes_mutex_[orbit]);
+			for (const auto& pool : mark_attributes_[orbit])
+				for (const ChunkArrayBool* ca : pool)
+					usage.mark_pools += ca->memory_usage();
+			for (const auto& pool : stamp_attributes_[orbit])
+				for (const ChunkArrayStamp* ca : pool)
+					usage.mark_pools += ca->memory_usage();
+		}
+
+		usage.thread_buffers = thread_buffers_memory_usage();
+		return usage;
+	}
+
+	/**
+	 * @brief log the memory used by the map
+	 * A warning is emitted for each attribute whose name starts with "__" (temporary attribute
+	 * that has not been removed) and if the memory used by the map exceeds the given budget.
+	 * @param budget maximum number of bytes the map is expected to use (0 for no limit)
+	 * @return the memory used by the map
+	 */
+	MapMemoryUsage log_memory_usage(std::size_t budget = 0u) const
+	{
+		const MapMemoryUsage usage = memory_usage();
+		cgogn_log_info("memory_usage") << usage;
+
+		for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+		{
+			for (const auto& a : usage.attributes[orbit].arrays)
+			{
+				if (a.name.compare(0u, 2u, "__") == 0)
+					cgogn_log_warning("memory_usage") << "temporary attribute \"" << a.name << "\" of orbit " << orbit_name(Orbit(orbit)) << " is still allocated (" << a.bytes << " bytes).";
+			}
+		}
+
+		if (budget > 0u && usage.total() > budget)
+			cgogn_log_warning("memory_usage") << "the map uses " << usage.total() << " bytes, budget is " << budget << " bytes.";
+
+		return usage;
+	}
+
+private:
+
+	template <typename T_REF>
+	static std::size_t remove_mark_attributes(ChunkArrayContainer<T_REF>& container, std::vector<ChunkArrayBool*>& pool)
+	{
+		std::size_t nb_bytes = 0u;
+		for (ChunkArrayBool* ca : pool)
+		{
+			nb_bytes += sizeof(ChunkArrayBool) + ca->nb_chunks() * ca->chunk_bytes();
+			container.remove_marker_attribute(ca);
+		}
+		pool.clear();
+		return nb_bytes;
+	}
+
+	template <typename T_REF>
+	static std::size_t remove_stamp_attributes(ChunkArrayContainer<T_REF>& container, std::vector<ChunkArrayStamp*>& pool)
+	{
+		std::size_t nb_bytes = 0u;
+		for (ChunkArrayStamp* ca : pool)
+		{
+			nb_bytes += sizeof(ChunkArrayStamp) + ca->nb_chunks() * ca->chunk_bytes();
+			container.remove_stamp_attribute(ca);
+		}
+		pool.clear();
+		return nb_bytes;
+	}
+
+protected:
+
 	/*******************************************************************************
 	 * Embedding (orbit indexing) management
 	 *******************************************************************************/
@@ -242,6 +653,15 @@ public:
 
 protected:
 
+	/**
+	 * \brief unref a line of the attribute container of an orbit, recording the removal of the cell if it is released
+	 */
+	inline void unref_attribute_line(Orbit orbit, uint32 emb)
+	{
+		if (attributes_[orbit].unref_line(emb))
+			record_cell_removed(orbit, emb);
+	}
+
 	template <class CellType>
 	inline void set_embedding(Dart d, uint32 emb)
 	{
@@ -255,11 +675,26 @@ protected:
 		// ref_line() is done before unref_line() to avoid deleting the indexed line if old == emb
 		attributes_[ORBIT].ref_line(emb);			// ref the new emb
 		if (old != INVALID_INDEX)
-			attributes_[ORBIT].unref_line(old);		// unref the old emb
+			unref_attribute_line(ORBIT, old);		// unref the old emb
 
 		(*embeddings_[ORBIT])[d.index] = emb;		// affect the embedding to the dart
 	}
 
+	/**
+	 * \brief set the embedding of a dart without updating the reference counters of the lines
+	 * Used by the batched operators that update the counters of the lines they use beforehand.
+	 * Can be called concurrently on distinct darts.
+	 */
+	template <class CellType>
+	inline void set_raw_embedding(Dart d, uint32 emb)
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		static_assert(ORBIT < NB_ORBITS, "Unknown orbit parameter");
+		cgogn_message_assert(is_embedded<ORBIT>(), "Invalid parameter: orbit not embedded");
+
+		(*embeddings_[ORBIT])[d.index] = emb;
+	}
+
 	template <class CellType>
 	inline void copy_embedding(Dart dest, Dart src)
 	{
@@ -271,6 +706,15 @@ protected:
 
 };
 
+template <uint32 CHUNK_SIZE_>
+const uint32 MapBaseData_T<CHUNK_SIZE_>::CHUNK_SIZE;
+
+using MapBaseData = MapBaseData_T<CGOGN_CHUNK_SIZE>;
+
+#if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_CORE_EXTERNAL_TEMPLATES_CPP_))
+extern template class CGOGN_CORE_EXPORT MapBaseData_T<CGOGN_CHUNK_SIZE>;
+#endif // defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_CORE_EXTERNAL_TEMPLATES_CPP_))
+
 } // namespace cgogn
 
 #endif // CGOGN_CORE_CMAP_MAP_BASE_DATA_H_
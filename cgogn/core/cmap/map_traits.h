@@ -24,6 +24,8 @@
 #ifndef CGOGN_CORE_CMAP_MAP_TRAITS_H_
 #define CGOGN_CORE_CMAP_MAP_TRAITS_H_
 
+#include <type_traits>
+
 #include <cgogn/core/utils/numerics.h>
 
 namespace cgogn
@@ -31,6 +33,25 @@ namespace cgogn
 
 static const cgogn::uint32 CGOGN_CHUNK_SIZE = 4096u;
 
+/**
+ * @brief chunk size of the containers of a map type
+ * The map traits (CMap2Type, CMap3Type, ...) may declare a static CHUNK_SIZE member
+ * (a power of 2) to change the size of the chunks of all the containers of their maps:
+ * small chunks for the maps kept by the thousands, large chunks for huge meshes.
+ * Traits that do not declare it use CGOGN_CHUNK_SIZE.
+ */
+template <typename MAP_TYPE, typename = void>
+struct map_chunk_size
+{
+	static const cgogn::uint32 value = CGOGN_CHUNK_SIZE;
+};
+
+template <typename MAP_TYPE>
+struct map_chunk_size<MAP_TYPE, typename std::enable_if<(MAP_TYPE::CHUNK_SIZE > 0u)>::type>
+{
+	static const cgogn::uint32 value = MAP_TYPE::CHUNK_SIZE;
+};
+
 } // namespace cgogn
 
 #endif
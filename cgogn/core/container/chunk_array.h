@@ -26,24 +26,106 @@
 
 #include <algorithm>
 #include <array>
+#include <list>
+#include <vector>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <cstring>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <limits>
 
 #include <cgogn/core/cgogn_core_export.h>
 #include <cgogn/core/container/chunk_array_gen.h>
+#include <cgogn/core/container/chunk_pool.h>
 #include <cgogn/core/utils/name_types.h>
 #include <cgogn/core/utils/serialization.h>
 #include <cgogn/core/utils/assert.h>
 #include <cgogn/core/utils/logger.h>
 #include <cgogn/core/utils/endian.h>
 #include <cgogn/core/utils/string.h>
+#include <cgogn/core/utils/thread_pool.h>
 
 #include <cgogn/core/cmap/map_traits.h>
 
 namespace cgogn
 {
 
+namespace internal
+{
+
+/**
+ * @brief number of bytes of dynamic memory owned by a value (sizeof(T) excluded)
+ */
+template <typename T>
+struct HeapMemory
+{
+	static const bool owns_memory = false;
+	static inline std::size_t bytes(const T&) { return 0u; }
+};
+
+template <typename U, typename A>
+struct HeapMemory<std::vector<U, A>>
+{
+	static const bool owns_memory = true;
+	static inline std::size_t bytes(const std::vector<U, A>& v)
+	{
+		std::size_t nb_bytes = v.capacity() * sizeof(U);
+		if (HeapMemory<U>::owns_memory)
+			for (const U& u : v)
+				nb_bytes += HeapMemory<U>::bytes(u);
+		return nb_bytes;
+	}
+};
+
+template <typename U, typename A>
+struct HeapMemory<std::list<U, A>>
+{
+	static const bool owns_memory = true;
+	static inline std::size_t bytes(const std::list<U, A>& l)
+	{
+		// each node stores the value and two links
+		std::size_t nb_bytes = l.size() * (sizeof(U) + 2u * sizeof(void*));
+		if (HeapMemory<U>::owns_memory)
+			for (const U& u : l)
+				nb_bytes += HeapMemory<U>::bytes(u);
+		return nb_bytes;
+	}
+};
+
+template <typename U, std::size_t N>
+struct HeapMemory<std::array<U, N>>
+{
+	static const bool owns_memory = HeapMemory<U>::owns_memory;
+	static inline std::size_t bytes(const std::array<U, N>& a)
+	{
+		std::size_t nb_bytes = 0u;
+		if (HeapMemory<U>::owns_memory)
+			for (const U& u : a)
+				nb_bytes += HeapMemory<U>::bytes(u);
+		return nb_bytes;
+	}
+};
+
+template <>
+struct HeapMemory<std::string>
+{
+	static const bool owns_memory = true;
+	static inline std::size_t bytes(const std::string& s)
+	{
+		// short strings are stored inside the object
+		const char* data = s.data();
+		const char* obj = reinterpret_cast<const char*>(&s);
+		if (data >= obj && data < obj + sizeof(std::string))
+			return 0u;
+		return s.capacity() + 1u;
+	}
+};
+
+} // namespace internal
+
 /**
  *	@brief chunk array class storage
  *	@tparam CHUNK_SIZE size of each chunk (in T, not in bytes!), must be a power of 2 >=32
@@ -60,9 +142,61 @@ public:
 
 protected:
 
+	static_assert(alignof(T) <= ChunkPool::ALIGNMENT, "ChunkArray: type alignment not supported by the ChunkPool");
+
 	// vector of block pointers
 	std::vector<T*> table_data_;
 
+	/**
+	 * @brief get a block of the chunk pool and value-initialize its elements
+	 */
+	static inline T* allocate_chunk()
+	{
+		T* chunk = static_cast<T*>(chunk_pool()->allocate(CHUNK_SIZE * sizeof(T)));
+		construct_chunk(chunk);
+		return chunk;
+	}
+
+	/**
+	 * @brief value-initialize the elements of a (raw or released) block of the chunk pool
+	 */
+	static inline void construct_chunk(T* chunk)
+	{
+		for (uint32 i = 0u; i < CHUNK_SIZE; ++i)
+			new (chunk + i) T();
+	}
+
+	/**
+	 * @brief destroy the elements of a chunk and give it back to the chunk pool
+	 */
+	static inline void release_chunk(T* chunk)
+	{
+		if (!std::is_trivially_destructible<T>::value)
+		{
+			for (uint32 i = 0u; i < CHUNK_SIZE; ++i)
+				chunk[i].~T();
+		}
+		chunk_pool()->release(chunk, CHUNK_SIZE * sizeof(T));
+	}
+
+	/**
+	 * @brief copy the elements of a chunk into another one (one memcpy for the raw copyable types, cf. is_raw_copyable)
+	 */
+	static inline void copy_chunk(T* dst, const T* src)
+	{
+		copy_chunk(dst, src, std::integral_constant<bool, is_raw_copyable<T>::value>());
+	}
+
+	static inline void copy_chunk(T* dst, const T* src, std::true_type)
+	{
+		std::memcpy(static_cast<void*>(dst), src, CHUNK_SIZE * sizeof(T));
+	}
+
+	static inline void copy_chunk(T* dst, const T* src, std::false_type)
+	{
+		std::copy(src, src + CHUNK_SIZE, dst);
+	}
+
 public:
 
 	/**
@@ -84,7 +218,7 @@ public:
 	~ChunkArray() override
 	{
 		for(auto chunk : table_data_)
-			delete[] chunk;
+			release_chunk(chunk);
 	}
 
 	std::string nested_type_name() const override
@@ -121,6 +255,27 @@ public:
 		return uint32(table_data_.size())*CHUNK_SIZE;
 	}
 
+	std::size_t chunk_bytes() const override
+	{
+		return CHUNK_SIZE * sizeof(T);
+	}
+
+	/**
+	 * @brief memory used by the array: chunks, vector of chunk pointers and
+	 * dynamic memory owned by the elements (for std::vector, std::string, ... types)
+	 */
+	std::size_t memory_usage() const override
+	{
+		std::size_t nb_bytes = sizeof(Self) + table_data_.capacity() * sizeof(T*) + table_data_.size() * chunk_bytes();
+		if (internal::HeapMemory<T>::owns_memory)
+		{
+			for (const T* chunk : table_data_)
+				for (uint32 i = 0u; i < CHUNK_SIZE; ++i)
+					nb_bytes += internal::HeapMemory<T>::bytes(chunk[i]);
+		}
+		return nb_bytes;
+	}
+
 	/**
 	 * @brief return a vector with pointers to all chunks
 	 * @param byte_chunk_size filled with CHUNK_SIZE*sizeof(T)
@@ -139,6 +294,23 @@ public:
 		return addr;
 	}
 
+	bool is_trivially_copyable() const override
+	{
+		return is_raw_copyable<T>::value;
+	}
+
+	bool set_chunks(const std::vector<void*>& chunks) override
+	{
+		if (!is_raw_copyable<T>::value)
+			return false;
+		for (T* chunk : table_data_)
+			release_chunk(chunk);
+		table_data_.clear();
+		for (void* chunk : chunks)
+			table_data_.push_back(static_cast<T*>(chunk));
+		return true;
+	}
+
 	/**
 	 * @brief create a ChunkArray<CHUNK_SIZE,T>
 	 * @return generic pointer
@@ -162,29 +334,91 @@ public:
 		return true;
 	}
 
+	/**
+	 * @brief add nb chunks, first touched (initialized) in NUMA-aware mode by the workers
+	 * that process them in the parallel traversals (cf. parallel_for)
+	 * The blocks recycled by the chunk pool have already been touched: they are initialized
+	 * by the calling thread. The other ones are initialized by one job per worker.
+	 */
+	void add_chunks_first_touch(std::size_t nb)
+	{
+		ThreadPool* pool = cgogn::thread_pool();
+		const uint32 nb_workers = pool->nb_workers();
+
+		// chunks to initialize by each worker
+		std::vector<std::vector<T*>> to_touch(nb_workers);
+		for (std::size_t i = 0u; i < nb; ++i)
+		{
+			bool recycled = false;
+			T* chunk = static_cast<T*>(chunk_pool()->allocate(CHUNK_SIZE * sizeof(T), recycled));
+			if (recycled || nb_workers == 0u)
+				construct_chunk(chunk);
+			else
+				to_touch[table_data_.size() % nb_workers].push_back(chunk);
+			table_data_.push_back(chunk);
+		}
+
+		auto touch = [] (const std::vector<T*>& chunks)
+		{
+			for (T* chunk : chunks)
+				construct_chunk(chunk);
+		};
+
+		if (pool->is_worker())
+		{
+			for (const std::vector<T*>& chunks : to_touch)
+				touch(chunks);
+			return;
+		}
+
+		std::vector<std::function<void()>> jobs;
+		jobs.reserve(nb_workers);
+		JobCounter counter;
+		for (uint32 w = 0u; w < nb_workers; ++w)
+		{
+			if (to_touch[w].empty())
+				continue;
+			const std::vector<T*>* chunks = &to_touch[w];
+			jobs.push_back([chunks, &touch] () { touch(*chunks); });
+			pool->enqueue_job(counter, jobs.back(), w);
+		}
+		pool->wait(counter);
+	}
+
 	/**
 	 * @brief add a chunk (T[CHUNK_SIZE])
+	 * In NUMA-aware mode, the chunk is first touched (initialized) by the worker
+	 * that processes it in the parallel traversals (cf. parallel_for).
 	 */
 	void add_chunk() override
 	{
-		table_data_.push_back(new T[CHUNK_SIZE]());
+		if (cgogn::thread_pool()->numa_aware())
+			add_chunks_first_touch(1u);
+		else
+			table_data_.push_back(allocate_chunk());
 	}
 
 	/**
 	 * @brief set number of chunks
+	 * In NUMA-aware mode, the new chunks are first touched by the workers in one batch.
 	 * @param nbc number of chunks
 	 */
 	void set_nb_chunks(uint32 nbc) override
 	{
 		if (nbc >= table_data_.size())
 		{
-			for (std::size_t i = table_data_.size(); i < nbc; ++i)
-				add_chunk();
+			if (cgogn::thread_pool()->numa_aware())
+				add_chunks_first_touch(nbc - table_data_.size());
+			else
+			{
+				for (std::size_t i = table_data_.size(); i < nbc; ++i)
+					add_chunk();
+			}
 		}
 		else
 		{
 			for (std::size_t i = static_cast<std::size_t>(nbc); i < table_data_.size(); ++i)
-				delete[] table_data_[i];
+				release_chunk(table_data_[i]);
 			table_data_.resize(nbc);
 		}
 	}
@@ -195,12 +429,19 @@ public:
 	void clear() override
 	{
 		for(auto chunk : table_data_)
-			delete[] chunk;
+			release_chunk(chunk);
 		table_data_.clear();
 		table_data_.shrink_to_fit();
 		table_data_.reserve(1024u);
 	}
 
+	std::size_t shrink_to_fit() override
+	{
+		const std::size_t old_capacity = table_data_.capacity();
+		table_data_.shrink_to_fit();
+		return (old_capacity - table_data_.capacity()) * sizeof(T*);
+	}
+
 
 
 	/**
@@ -235,6 +476,29 @@ public:
 		table_data_[dst / CHUNK_SIZE][dst % CHUNK_SIZE] = std::move(table_data_[src / CHUNK_SIZE][src % CHUNK_SIZE]);
 	}
 
+	/**
+	 * @brief move the elements in a new set of chunks (see ChunkArrayGen::permute_elements)
+	 */
+	void permute_elements(const std::vector<uint32>& old_new) override
+	{
+		std::vector<T*> table(table_data_.size());
+		for (T*& chunk : table)
+			chunk = allocate_chunk();
+
+		const uint32 nb = uint32(old_new.size());
+		for (uint32 i = 0u; i < nb; ++i)
+		{
+			const uint32 j = old_new[i];
+			table[j / CHUNK_SIZE][j % CHUNK_SIZE] = std::move(table_data_[i / CHUNK_SIZE][i % CHUNK_SIZE]);
+		}
+		for (uint32 i = nb, end = capacity(); i < end; ++i)
+			table[i / CHUNK_SIZE][i % CHUNK_SIZE] = std::move(table_data_[i / CHUNK_SIZE][i % CHUNK_SIZE]);
+
+		for (T* chunk : table_data_)
+			release_chunk(chunk);
+		table_data_.swap(table);
+	}
+
 	/**
 	 * @brief swap two elements
 	 * @param idx1 first element index
@@ -408,12 +672,10 @@ public:
 			cgogn_log_error("ChunkArray") << "trying to copy between different types";
 			return;
 		}
-		for (T* chunk : ca->table_data_)
+		for (const T* chunk : ca->table_data_)
 		{
 			add_chunk();
-			T* ptr = table_data_.back();
-			for(uint32 i=0; i< CHUNK_SIZE; ++i)
-				*ptr++ = *chunk++;
+			copy_chunk(table_data_.back(), chunk);
 		}
 	}
 
@@ -429,17 +691,16 @@ public:
 		cgogn_message_assert(ca->nb_chunks()==this->nb_chunks(), "copy_data only with same sized ChunkArray");
 
 		auto td = table_data_.begin();
-		for (T* chunk : ca->table_data_)
-		{
-			T* ptr = *td++;
-			for(uint32 i=0; i< CHUNK_SIZE; ++i)
-				*ptr++ = *chunk++;
-		}
+		for (const T* chunk : ca->table_data_)
+			copy_chunk(*td++, chunk);
 	}
 };
 
 /**
  * @brief separate version of ChunkArray specialized for bool data. One bit per bool.
+ * The bits are stored in atomic words: the usual accessors (operator[], set_true, set_false, ...)
+ * only use relaxed loads and stores and cost the same as plain words, whereas the test_and_set_*
+ * methods use atomic read-modify-write operations and can be called concurrently (cf. ConcurrentDartMarker).
  */
 template <uint32 CHUNK_SIZE>
 class ChunkArrayBool : public ChunkArrayGen<CHUNK_SIZE>
@@ -449,6 +710,9 @@ public:
 	using Inherit = ChunkArrayGen<CHUNK_SIZE>;
 	using Self = ChunkArrayBool;
 	using value_type = uint32;
+	using Word = std::atomic<uint32>;
+
+	static_assert(sizeof(Word) == sizeof(uint32), "ChunkArrayBool needs atomic words without overhead");
 
 protected:
 
@@ -456,7 +720,23 @@ protected:
 	static const uint32 BOOLS_PER_INT = (CHUNK_SIZE<32u) ? CHUNK_SIZE : 32u;
 
 	// vector of block pointers
-	std::vector<uint32*> table_data_;
+	std::vector<Word*> table_data_;
+
+	/**
+	 * @brief get a block of the chunk pool with all its bits set to false
+	 */
+	static inline Word* allocate_chunk()
+	{
+		Word* chunk = static_cast<Word*>(chunk_pool()->allocate(CHUNK_SIZE / BOOLS_PER_INT * sizeof(Word)));
+		for (uint32 i = 0u; i < CHUNK_SIZE / BOOLS_PER_INT; ++i)
+			new (chunk + i) Word(0u);
+		return chunk;
+	}
+
+	static inline void release_chunk(Word* chunk)
+	{
+		chunk_pool()->release(chunk, CHUNK_SIZE / BOOLS_PER_INT * sizeof(Word));
+	}
 
 public:
 
@@ -476,7 +756,7 @@ public:
 	~ChunkArrayBool() override
 	{
 		for(auto chunk : table_data_)
-			delete[] chunk;
+			release_chunk(chunk);
 	}
 
 	std::string nested_type_name() const override
@@ -512,6 +792,16 @@ public:
 		return uint32(table_data_.size())*CHUNK_SIZE/BOOLS_PER_INT;
 	}
 
+	std::size_t chunk_bytes() const override
+	{
+		return CHUNK_SIZE / BOOLS_PER_INT * sizeof(Word);
+	}
+
+	std::size_t memory_usage() const override
+	{
+		return sizeof(Self) + table_data_.capacity() * sizeof(Word*) + table_data_.size() * chunk_bytes();
+	}
+
 	/**
 	 * @brief return a vector with pointers to all chunks
 	 * @param byte_block_size filled with CHUNK_SIZE*sizeof(T)
@@ -524,12 +814,27 @@ public:
 
 		addr.reserve(table_data_.size());
 
-		for (typename std::vector<uint32*>::const_iterator it = table_data_.begin(); it != table_data_.end(); ++it)
+		for (typename std::vector<Word*>::const_iterator it = table_data_.begin(); it != table_data_.end(); ++it)
 			addr.push_back(*it);
 
 		return addr;
 	}
 
+	bool is_trivially_copyable() const override
+	{
+		return true;
+	}
+
+	bool set_chunks(const std::vector<void*>& chunks) override
+	{
+		for (Word* chunk : table_data_)
+			release_chunk(chunk);
+		table_data_.clear();
+		for (void* chunk : chunks)
+			table_data_.push_back(static_cast<Word*>(chunk));
+		return true;
+	}
+
 	/**
 	 * @brief create a ChunkArray<CHUNK_SIZE,T>
 	 * @return generic pointer
@@ -558,8 +863,7 @@ public:
 	 */
 	void add_chunk() override
 	{
-		// adding the empty parentheses for default-initialization
-		table_data_.push_back(new uint32[CHUNK_SIZE/BOOLS_PER_INT]());
+		table_data_.push_back(allocate_chunk());
 	}
 
 	/**
@@ -576,7 +880,7 @@ public:
 		else
 		{
 			for (std::size_t i = nbc; i < table_data_.size(); ++i)
-				delete[] table_data_[i];
+				release_chunk(table_data_[i]);
 			table_data_.resize(nbc);
 		}
 	}
@@ -587,12 +891,19 @@ public:
 	void clear() override
 	{
 		for(auto chunk : table_data_)
-			delete[] chunk;
+			release_chunk(chunk);
 		table_data_.clear();
 		table_data_.shrink_to_fit();
 		table_data_.reserve(1024u);
 	}
 
+	std::size_t shrink_to_fit() override
+	{
+		const std::size_t old_capacity = table_data_.capacity();
+		table_data_.shrink_to_fit();
+		return (old_capacity - table_data_.capacity()) * sizeof(Word*);
+	}
+
 
 	/**
 	 * @brief copy an element to another one
@@ -616,6 +927,31 @@ public:
 		set_value(dst, ca->operator[](src));
 	}
 
+	/**
+	 * @brief set the bits in a new set of chunks (see ChunkArrayGen::permute_elements)
+	 */
+	void permute_elements(const std::vector<uint32>& old_new) override
+	{
+		std::vector<Word*> table(table_data_.size());
+		for (Word*& chunk : table)
+			chunk = allocate_chunk();
+
+		const uint32 nb = uint32(old_new.size());
+		for (uint32 i = 0u, end = uint32(table_data_.size()) * CHUNK_SIZE; i < end; ++i)
+		{
+			if (this->operator[](i))
+			{
+				const uint32 j = i < nb ? old_new[i] : i;
+				Word& w = table[j / CHUNK_SIZE][(j % CHUNK_SIZE) / BOOLS_PER_INT];
+				w.store(w.load(std::memory_order_relaxed) | bit_mask(j), std::memory_order_relaxed);
+			}
+		}
+
+		for (Word* chunk : table_data_)
+			release_chunk(chunk);
+		table_data_.swap(table);
+	}
+
 	/**
 	 * @brief swap two elements
 	 * @param idx1 first element index
@@ -715,6 +1051,21 @@ public:
 		return nullptr; // shall not be used with ChunkArrayBool
 	}
 
+private:
+
+	inline Word& word(uint32 i) const
+	{
+		cgogn_assert(i / CHUNK_SIZE < table_data_.size());
+		return table_data_[i / CHUNK_SIZE][(i % CHUNK_SIZE) / BOOLS_PER_INT];
+	}
+
+	static inline uint32 bit_mask(uint32 i)
+	{
+		return 1u << ((i % CHUNK_SIZE) % BOOLS_PER_INT);
+	}
+
+public:
+
 	/**
 	 * @brief operator[]
 	 * @param i index of element to access
@@ -722,20 +1073,39 @@ public:
 	 */
 	inline bool operator[](uint32 i) const
 	{
-		cgogn_assert(i / CHUNK_SIZE < table_data_.size());
-		return (table_data_[i / CHUNK_SIZE][(i % CHUNK_SIZE)/BOOLS_PER_INT] & (1u << ((i % CHUNK_SIZE) % BOOLS_PER_INT))) != 0u;
+		return (word(i).load(std::memory_order_relaxed) & bit_mask(i)) != 0u;
 	}
 
 	inline void set_false(uint32 i)
 	{
-		cgogn_assert(i / CHUNK_SIZE < table_data_.size());
-		table_data_[i / CHUNK_SIZE][(i % CHUNK_SIZE)/ BOOLS_PER_INT] &= ~(1u << ((i % CHUNK_SIZE) % BOOLS_PER_INT));
+		Word& w = word(i);
+		w.store(w.load(std::memory_order_relaxed) & ~bit_mask(i), std::memory_order_relaxed);
 	}
 
 	inline void set_true(uint32 i)
 	{
-		cgogn_assert(i / CHUNK_SIZE < table_data_.size());
-		table_data_[i / CHUNK_SIZE][(i % CHUNK_SIZE)/ BOOLS_PER_INT] |= 1u << ((i % CHUNK_SIZE) % BOOLS_PER_INT);
+		Word& w = word(i);
+		w.store(w.load(std::memory_order_relaxed) | bit_mask(i), std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief atomically set the element i to true (thread safe)
+	 * @return the previous value of the element
+	 */
+	inline bool test_and_set_true(uint32 i)
+	{
+		const uint32 mask = bit_mask(i);
+		return (word(i).fetch_or(mask, std::memory_order_acq_rel) & mask) != 0u;
+	}
+
+	/**
+	 * @brief atomically set the element i to false (thread safe)
+	 * @return the previous value of the element
+	 */
+	inline bool test_and_set_false(uint32 i)
+	{
+		const uint32 mask = bit_mask(i);
+		return (word(i).fetch_and(~mask, std::memory_order_acq_rel) & mask) != 0u;
 	}
 
 	inline void set_value(uint32 i, bool b)
@@ -755,16 +1125,15 @@ public:
 	 */
 	inline void set_false_byte(uint32 i)
 	{
-		cgogn_assert(i / CHUNK_SIZE < table_data_.size());
-		table_data_[i / CHUNK_SIZE][(i % CHUNK_SIZE) / BOOLS_PER_INT] = 0u;
+		word(i).store(0u, std::memory_order_relaxed);
 	}
 
 	inline void all_false()
 	{
-		for (uint32* const ptr : table_data_)
+		for (Word* const ptr : table_data_)
 		{
 			for (int32 j = 0; j < int32(CHUNK_SIZE / BOOLS_PER_INT); ++j)
-				ptr[j] = 0u;
+				ptr[j].store(0u, std::memory_order_relaxed);
 		}
 	}
 
@@ -777,12 +1146,12 @@ public:
 			cgogn_log_error("ChunkArray") << "trying to copy between different types";
 			return;
 		}
-		for (uint32* chunk : ca->table_data_)
+		for (const Word* chunk : ca->table_data_)
 		{
 			add_chunk();
-			uint32* ptr = table_data_.back();
+			Word* ptr = table_data_.back();
 			for(uint32 i=0; i< CHUNK_SIZE/BOOLS_PER_INT; ++i)
-				*ptr++ = *chunk++;
+				(ptr++)->store((chunk++)->load(std::memory_order_relaxed), std::memory_order_relaxed);
 		}
 	}
 
@@ -797,22 +1166,22 @@ public:
 		cgogn_message_assert(ca->nb_chunks()==this->nb_chunks(), "copy_data only with same sized ChunkArray");
 
 		auto td = table_data_.begin();
-		for (uint32* chunk : ca->table_data_)
+		for (const Word* chunk : ca->table_data_)
 		{
-			uint32* ptr = *td++;
-			for(uint32 i=0; i< CHUNK_SIZE; ++i)
-				*ptr++ = *chunk++;
+			Word* ptr = *td++;
+			for(uint32 i=0; i< CHUNK_SIZE/BOOLS_PER_INT; ++i)
+				(ptr++)->store((chunk++)->load(std::memory_order_relaxed), std::memory_order_relaxed);
 		}
 	}
 
 	inline uint32 count_true()
 	{
 		uint32 nb=0;
-		for (uint32* ptr : table_data_)
+		for (const Word* ptr : table_data_)
 		{
 			for (int32 j = 0; j < int32(CHUNK_SIZE / BOOLS_PER_INT); ++j)
 			{
-				uint32 word = ptr[j];
+				uint32 word = ptr[j].load(std::memory_order_relaxed);
 				while (word != 0)
 				{
 					nb += (word & 1u);
@@ -825,6 +1194,69 @@ public:
 
 };
 
+/**
+ * @brief ChunkArray of generation stamps used by the epoch markers (cf. DartMarkerEpoch)
+ * An element is marked if its stamp is equal to the current epoch of the array.
+ * Unmarking all the elements consists in incrementing the epoch: the stamps are only
+ * reset when the epoch wraps around. The stamp 0 is never used as an epoch.
+ */
+template <uint32 CHUNK_SIZE>
+class ChunkArrayStamp : public ChunkArray<CHUNK_SIZE, uint16>
+{
+public:
+
+	using Inherit = ChunkArray<CHUNK_SIZE, uint16>;
+	using Self = ChunkArrayStamp<CHUNK_SIZE>;
+	using value_type = uint16;
+
+protected:
+
+	uint16 epoch_;
+
+public:
+
+	inline ChunkArrayStamp() : Inherit(),
+		epoch_(1u)
+	{}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ChunkArrayStamp);
+
+	inline uint16 epoch() const
+	{
+		return epoch_;
+	}
+
+	/**
+	 * @brief start a new epoch: all the elements become unmarked
+	 * The stamps are reset only when the epoch wraps around.
+	 */
+	inline void next_epoch()
+	{
+		if (epoch_ == std::numeric_limits<uint16>::max())
+		{
+			this->set_all_values(0u);
+			epoch_ = 1u;
+		}
+		else
+			++epoch_;
+	}
+
+	inline void set_true(uint32 i)
+	{
+		this->set_value(i, epoch_);
+	}
+
+	inline void set_false(uint32 i)
+	{
+		this->set_value(i, 0u);
+	}
+
+	inline bool is_true(uint32 i) const
+	{
+		return this->operator[](i) == epoch_;
+	}
+};
+
 #if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_CORE_EXTERNAL_TEMPLATES_CPP_))
 //extern template class CGOGN_CORE_EXPORT ChunkArray<CGOGN_CHUNK_SIZE, bool>;
 extern template class CGOGN_CORE_EXPORT ChunkArray<CGOGN_CHUNK_SIZE, uint32>;
@@ -28,9 +28,12 @@
 #include <fstream>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <memory>
 #include <climits>
+#include <atomic>
+#include <algorithm>
 
 #include <cgogn/core/utils/logger.h>
 #include <cgogn/core/cgogn_core_export.h>
@@ -40,16 +43,49 @@
 #include <cgogn/core/utils/unique_ptr.h>
 #include <cgogn/core/utils/thread_pool.h>
 #include <cgogn/core/utils/buffers.h>
+#include <cgogn/core/utils/parallel_for.h>
 
 #include <cgogn/core/container/chunk_array.h>
 #include <cgogn/core/container/chunk_stack.h>
 #include <cgogn/core/container/chunk_array_factory.h>
+#include <cgogn/core/container/snapshot.h>
 
 #include <cgogn/core/cmap/map_traits.h>
 
 namespace cgogn
 {
 
+/**
+ * @brief memory used by one ChunkArray of a container
+ */
+struct ChunkArrayMemoryUsage
+{
+	std::string name;
+	std::string type_name;
+	std::size_t bytes;
+};
+
+/**
+ * @brief memory used by a ChunkArrayContainer
+ * arrays: the attributes, markers: the boolean marker arrays,
+ * internal: refs, holes stack and bookkeeping
+ */
+struct ContainerMemoryUsage
+{
+	std::vector<ChunkArrayMemoryUsage> arrays;
+	std::size_t markers = 0u;
+	std::size_t internal = 0u;
+	uint32 nb_lines = 0u;
+
+	inline std::size_t total() const
+	{
+		std::size_t nb_bytes = markers + internal;
+		for (const auto& a : arrays)
+			nb_bytes += a.bytes;
+		return nb_bytes;
+	}
+};
+
 /**
  * @brief class that manage the storage of several ChunkArray
  * @tparam CHUNK_SIZE chunk size for ChunkArray
@@ -66,6 +102,7 @@ public:
 	template <class T>
 	using ChunkArray = cgogn::ChunkArray<CHUNK_SIZE, T>;
 	using ChunkArrayBool = cgogn::ChunkArrayBool<CHUNK_SIZE>;
+	using ChunkArrayStamp = cgogn::ChunkArrayStamp<CHUNK_SIZE>;
 	template <class T>
 	using ChunkStack = cgogn::ChunkStack<CHUNK_SIZE, T>;
 	using ChunkArrayFactory = cgogn::ChunkArrayFactory<CHUNK_SIZE>;
@@ -91,6 +128,11 @@ protected:
 	*/
 	std::vector<ChunkArrayBool*> table_marker_arrays_;
 
+	/**
+	* vector of pointers to the stamp ChunkArray of the epoch markers
+	*/
+	std::vector<ChunkArrayStamp*> table_stamp_arrays_;
+
 	/**
 	 * @brief ChunkArray of refs
 	 */
@@ -111,6 +153,16 @@ protected:
 	*/
 	uint32 nb_max_lines_;
 
+#pragma warning(push)
+#pragma warning(disable:4251)
+	/**
+	 * @brief indices of the chunk arrays in table_arrays_ by name and by pointer
+	 * (kept in sync with table_arrays_ and names_)
+	 */
+	std::unordered_map<std::string, uint32> name_index_;
+	std::unordered_map<const ChunkArrayGen*, uint32> ptr_index_;
+#pragma warning(pop)
+
 	/**
 	 * @brief get chunk array index from name
 	 * @warning do not store index (not stable)
@@ -119,12 +171,8 @@ protected:
 	 */
 	uint32 array_index(const std::string& name) const
 	{
-		for (uint32 i = 0u; i != names_.size(); ++i)
-		{
-			if (names_[i] == name)
-				return i;
-		}
-		return UNKNOWN;
+		const auto it = name_index_.find(name);
+		return it == name_index_.end() ? UNKNOWN : it->second;
 	}
 
 	/**
@@ -135,12 +183,35 @@ protected:
 	 */
 	uint32 array_index(const ChunkArrayGen* ptr) const
 	{
-		for (uint32 i = 0u; i != table_arrays_.size(); ++i)
+		const auto it = ptr_index_.find(ptr);
+		return it == ptr_index_.end() ? UNKNOWN : it->second;
+	}
+
+	/**
+	 * @brief append a chunk array to the table and index it
+	 */
+	void push_chunk_array(ChunkArrayGen* ca, const std::string& name, std::string type_name)
+	{
+		const uint32 index = uint32(table_arrays_.size());
+		table_arrays_.push_back(ca);
+		names_.push_back(name);
+		type_names_.push_back(std::move(type_name));
+		name_index_[name] = index;
+		ptr_index_[ca] = index;
+	}
+
+	/**
+	 * @brief rebuild the name and pointer indices from the table of chunk arrays
+	 */
+	void rebuild_indices()
+	{
+		name_index_.clear();
+		ptr_index_.clear();
+		for (uint32 i = 0u; i < table_arrays_.size(); ++i)
 		{
-			if (table_arrays_[i] == ptr)
-				return i;
+			name_index_[names_[i]] = i;
+			ptr_index_[table_arrays_[i]] = i;
 		}
-		return UNKNOWN;
 	}
 
 	/**
@@ -152,11 +223,16 @@ protected:
 		// store ptr for using it before delete
 		ChunkArrayGen* ptr_to_del = table_arrays_[index];
 
+		name_index_.erase(names_[index]);
+		ptr_index_.erase(ptr_to_del);
+
 		if (index != table_arrays_.size() - std::size_t(1u))
 		{
 			table_arrays_[index] = table_arrays_.back();
-			names_[index]        = names_.back();
-			type_names_[index]   = type_names_.back();
+			names_[index]        = std::move(names_.back());
+			type_names_[index]   = std::move(type_names_.back());
+			name_index_[names_[index]] = index;
+			ptr_index_[table_arrays_[index]] = index;
 		}
 
 		table_arrays_.pop_back();
@@ -179,6 +255,7 @@ public:
 		names_.reserve(16);
 		type_names_.reserve(16);
 		table_marker_arrays_.reserve(16);
+		table_stamp_arrays_.reserve(16);
 	}
 
 	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ChunkArrayContainer);
@@ -193,6 +270,9 @@ public:
 
 		for (auto ptr : table_marker_arrays_)
 			delete ptr;
+
+		for (auto ptr : table_stamp_arrays_)
+			delete ptr;
 	}
 
 	inline const std::vector<std::string>& names() const
@@ -274,6 +354,11 @@ public:
 		return table_marker_arrays_;
 	}
 
+	inline const std::vector<ChunkArrayStamp*>& stamp_arrays()
+	{
+		return table_stamp_arrays_;
+	}
+
 	/**
 	 * @brief add an attribute
 	 * @param name name of chunk array
@@ -302,9 +387,7 @@ public:
 		carr->set_nb_chunks(refs_.nb_chunks());
 
 		// store pointer, name & typename.
-		table_arrays_.push_back(carr);
-		names_.push_back(name);
-		type_names_.push_back(std::move(type_name));
+		push_chunk_array(carr, name, std::move(type_name));
 
 		return carr;
 	}
@@ -420,25 +503,51 @@ public:
 		return mca;
 	}
 
-//	/**
-//	 * @brief remove a marker attribute by its ChunkArray pointer
-//	 * @param ptr ChunkArray pointer to the attribute to remove
-//	 * @return true if attribute exists and has been removed
-//	 */
-//	void remove_marker_attribute(const ChunkArrayBool* ptr)
-//	{
-//		uint32 index = 0u;
-//		while (index < table_marker_arrays_.size() && table_marker_arrays_[index] != ptr)
-//			++index;
+	/**
+	 * @brief remove a marker attribute by its ChunkArray pointer
+	 * @param ptr ChunkArray pointer to the attribute to remove
+	 */
+	void remove_marker_attribute(const ChunkArrayBool* ptr)
+	{
+		std::size_t index = 0u;
+		while (index < table_marker_arrays_.size() && table_marker_arrays_[index] != ptr)
+			++index;
+
+		cgogn_message_assert(index != table_marker_arrays_.size(), "remove_marker_attribute by ptr: attribute not found.");
+
+		if (index != table_marker_arrays_.size() - std::size_t(1u))
+			table_marker_arrays_[index] = table_marker_arrays_.back();
+		table_marker_arrays_.pop_back();
+
+		delete ptr;
+	}
+
+	/**
+	 * @brief add a stamp attribute (for epoch markers)
+	 * @return pointer on created ChunkArray
+	 */
+	ChunkArrayStamp* add_stamp_attribute()
+	{
+		ChunkArrayStamp* sca = new ChunkArrayStamp();
+		sca->set_nb_chunks(refs_.nb_chunks());
+		table_stamp_arrays_.push_back(sca);
+		return sca;
+	}
 
-//		cgogn_message_assert(index != table_marker_arrays_.size(), "remove_marker_attribute by ptr: attribute not found.");
+	/**
+	 * @brief remove a stamp attribute by its ChunkArray pointer
+	 * @param ptr ChunkArray pointer to the attribute to remove
+	 */
+	void remove_stamp_attribute(const ChunkArrayStamp* ptr)
+	{
+		auto it = std::find(table_stamp_arrays_.begin(), table_stamp_arrays_.end(), ptr);
+		cgogn_message_assert(it != table_stamp_arrays_.end(), "remove_stamp_attribute by ptr: attribute not found.");
 
-//		if (index != table_marker_arrays_.size() - std::size_t(1u))
-//			table_marker_arrays_[index] = table_marker_arrays_.back();
-//		table_marker_arrays_.pop_back();
+		*it = table_stamp_arrays_.back();
+		table_stamp_arrays_.pop_back();
 
-//		delete ptr;
-//	}
+		delete ptr;
+	}
 
 	/**
 	 * @brief Number of chunk arrays of the container
@@ -565,6 +674,8 @@ public:
 			 cagen->clear();
 		for (auto ca_bool : table_marker_arrays_)
 			ca_bool->clear();
+		for (auto ca_stamp : table_stamp_arrays_)
+			ca_stamp->clear();
 	}
 
 	void remove_chunk_arrays()
@@ -583,6 +694,8 @@ public:
 		table_arrays_.clear();
 		names_.clear();
 		type_names_.clear();
+		name_index_.clear();
+		ptr_index_.clear();
 	}
 
 	/**
@@ -595,7 +708,10 @@ public:
 		table_arrays_.swap(container.table_arrays_);
 		names_.swap(container.names_);
 		type_names_.swap(container.type_names_);
+		name_index_.swap(container.name_index_);
+		ptr_index_.swap(container.ptr_index_);
 		table_marker_arrays_.swap(container.table_marker_arrays_);
+		table_stamp_arrays_.swap(container.table_stamp_arrays_);
 		refs_.swap_data(&(container.refs_));
 		holes_stack_.swap_data(&(container.holes_stack_));
 		std::swap(nb_used_lines_, container.nb_used_lines_);
@@ -605,10 +721,14 @@ public:
 			cagen->invalidate_external_refs();
 		for (auto cagen : table_marker_arrays_)
 			cagen->invalidate_external_refs();
+		for (auto cagen : table_stamp_arrays_)
+			cagen->invalidate_external_refs();
 		for (auto cagen : container.table_arrays_)
 			cagen->invalidate_external_refs();
 		for (auto cagen : container.table_marker_arrays_)
 			cagen->invalidate_external_refs();
+		for (auto cagen : container.table_stamp_arrays_)
+			cagen->invalidate_external_refs();
 	}
 
 	/**
@@ -661,18 +781,122 @@ public:
 		for (auto arr : table_marker_arrays_)
 			arr->set_nb_chunks(new_nb_blocks);
 
+		for (auto arr : table_stamp_arrays_)
+			arr->set_nb_chunks(new_nb_blocks);
+
 		refs_.set_nb_chunks(new_nb_blocks);
 
 		return map_old_new;
 	}
 
+	/**
+	 * @brief permute the lines of a compact container (cf. compact), with refs & markers
+	 * @param old_new new index of each line: a permutation of [0, end())
+	 */
+	void permute(const std::vector<uint32>& old_new)
+	{
+		cgogn_message_assert(holes_stack_.empty(), "permute: the container must be compact");
+		cgogn_message_assert(old_new.size() == end(), "permute: the permutation does not cover the container");
+
+		for (auto ptr : table_arrays_)
+			ptr->permute_elements(old_new);
+		for (auto ptr : table_marker_arrays_)
+			ptr->permute_elements(old_new);
+		for (auto ptr : table_stamp_arrays_)
+			ptr->permute_elements(old_new);
+		refs_.permute_elements(old_new);
+	}
+
+	/**
+	 * @brief free the chunks located after the last line of a compact container
+	 * (cf. compact) and the unused capacity of the internal vectors
+	 * @return the number of bytes released
+	 */
+	std::size_t shrink_to_fit()
+	{
+		std::size_t nb_bytes = 0u;
+
+		if (holes_stack_.empty())
+		{
+			// same number of chunks as the one maintained by insert_lines
+			const uint32 nb_chunks = nb_max_lines_ == 0u ? 0u : nb_max_lines_ / CHUNK_SIZE + 1u;
+			if (nb_chunks < refs_.nb_chunks())
+			{
+				const uint32 nb_freed = refs_.nb_chunks() - nb_chunks;
+				for (auto arr : table_arrays_)
+				{
+					nb_bytes += nb_freed * arr->chunk_bytes();
+					arr->set_nb_chunks(nb_chunks);
+				}
+				for (auto arr : table_marker_arrays_)
+				{
+					nb_bytes += nb_freed * arr->chunk_bytes();
+					arr->set_nb_chunks(nb_chunks);
+				}
+				for (auto arr : table_stamp_arrays_)
+				{
+					nb_bytes += nb_freed * arr->chunk_bytes();
+					arr->set_nb_chunks(nb_chunks);
+				}
+				nb_bytes += nb_freed * refs_.chunk_bytes();
+				refs_.set_nb_chunks(nb_chunks);
+			}
+		}
+
+		const uint32 nb_stack_chunks = holes_stack_.nb_chunks();
+		holes_stack_.compact();
+		nb_bytes += (nb_stack_chunks - holes_stack_.nb_chunks()) * holes_stack_.chunk_bytes();
+
+		for (auto arr : table_arrays_)
+			nb_bytes += arr->shrink_to_fit();
+		for (auto arr : table_marker_arrays_)
+			nb_bytes += arr->shrink_to_fit();
+		for (auto arr : table_stamp_arrays_)
+			nb_bytes += arr->shrink_to_fit();
+		nb_bytes += refs_.shrink_to_fit();
+		nb_bytes += holes_stack_.shrink_to_fit();
+
+		return nb_bytes;
+	}
+
+	/**
+	 * @brief compute the memory used by each array of the container
+	 */
+	ContainerMemoryUsage memory_usage() const
+	{
+		ContainerMemoryUsage usage;
+		usage.nb_lines = nb_used_lines_;
+		usage.arrays.reserve(table_arrays_.size());
+		for (uint32 i = 0u; i < table_arrays_.size(); ++i)
+			usage.arrays.push_back({names_[i], type_names_[i], table_arrays_[i]->memory_usage()});
+
+		for (auto arr : table_marker_arrays_)
+			usage.markers += arr->memory_usage();
+		for (auto arr : table_stamp_arrays_)
+			usage.markers += arr->memory_usage();
+
+		usage.internal = sizeof(Self) + refs_.memory_usage() + holes_stack_.memory_usage() +
+			table_arrays_.capacity() * sizeof(ChunkArrayGen*) +
+			table_marker_arrays_.capacity() * sizeof(ChunkArrayBool*) +
+			table_stamp_arrays_.capacity() * sizeof(ChunkArrayStamp*) +
+			(names_.capacity() + type_names_.capacity()) * sizeof(std::string);
+		for (uint32 i = 0u; i < names_.size(); ++i)
+			usage.internal += internal::HeapMemory<std::string>::bytes(names_[i]) + internal::HeapMemory<std::string>::bytes(type_names_[i]);
+		// name and pointer indices: buckets + nodes (value and link)
+		usage.internal += (name_index_.bucket_count() + ptr_index_.bucket_count()) * sizeof(void*) +
+			name_index_.size() * (sizeof(std::pair<const std::string, uint32>) + 2u * sizeof(void*)) +
+			ptr_index_.size() * (sizeof(std::pair<const ChunkArrayGen*, uint32>) + sizeof(void*));
+
+		return usage;
+	}
+
 	bool check_before_merge(const Self& cac)
 	{
 		for (uint32 i = 0; i < cac.names_.size(); ++i)
 		{
 			// compute indice of ith names of cac in this (size if not found)
-			std::size_t j = std::find(names_.begin(), names_.end(), cac.names_[i]) - names_.begin();
-			if (j != names_.size())
+			const uint32 j = array_index(cac.names_[i]);
+			if (j != UNKNOWN)
 			{
 				if (cac.type_names_[i] != type_names_[j])
 				{
@@ -693,8 +917,8 @@ public:
 		// First check & find missing attributes
 		for (uint32 i = 0; i < cac.names_.size(); ++i)
 		{
-			std::size_t j = std::find(names_.begin(), names_.end(), cac.names_[i]) - names_.begin();
-			if (j == names_.size()) // attrib not in this
+			const uint32 j = array_index(cac.names_[i]);
+			if (j == UNKNOWN) // attrib not in this
 			{
 				const std::string& name = cac.names_[i];
 				const std::string& type_name = cac.type_names_[i];
@@ -702,9 +926,7 @@ public:
 				auto cag = chunk_array_factory<CHUNK_SIZE>().create(type_name,name);
 				cgogn_assert(cag);
 				cag->set_nb_chunks(refs_.nb_chunks());
-				table_arrays_.push_back(cag.release());
-				names_.push_back(name);
-				type_names_.push_back(type_name);
+				push_chunk_array(cag.release(), name, type_name);
 			}
 			else
 				if (cac.type_names_[i] == type_names_[j])
@@ -739,6 +961,155 @@ public:
 		return map_old_new;
 	}
 
+	/**
+	 * @brief copy the lines and the chunk arrays of cac into this container
+	 * Contrary to merge, the lines keep their indices: the chunk arrays are copied chunk by chunk
+	 * (memcpy for trivially copyable types), in parallel. The chunk arrays of cac that do not exist
+	 * in this container are created, the markers and the stamps of this container are reset.
+	 * @param cac the container to copy
+	 * @return false if cac and this container have chunk arrays of same name but different types
+	 */
+	bool copy(const Self& cac)
+	{
+		if (!check_before_merge(cac))
+			return false;
+
+		std::vector<std::pair<ChunkArrayGen*, const ChunkArrayGen*>> copies;
+		copies.reserve(cac.table_arrays_.size() + 1u);
+		for (uint32 i = 0u; i < cac.names_.size(); ++i)
+		{
+			uint32 j = array_index(cac.names_[i]);
+			if (j == UNKNOWN)
+			{
+				auto cag = chunk_array_factory<CHUNK_SIZE>().create(cac.type_names_[i], cac.names_[i]);
+				cgogn_assert(cag);
+				j = uint32(table_arrays_.size());
+				push_chunk_array(cag.release(), cac.names_[i], cac.type_names_[i]);
+			}
+			copies.push_back(std::make_pair(table_arrays_[j], cac.table_arrays_[i]));
+		}
+		copies.push_back(std::make_pair(&refs_, &cac.refs_));
+
+		// the allocation is done by the calling thread (cf. ChunkArray::add_chunk)
+		const uint32 nb_chunks = cac.refs_.nb_chunks();
+		refs_.set_nb_chunks(nb_chunks);
+		for (auto* ca : table_arrays_)
+			ca->set_nb_chunks(nb_chunks);
+		reset_markers_and_stamps(nb_chunks);
+
+		parallel_for(0u, uint32(copies.size()), 1u, [&copies] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				copies[i].first->copy_data(*copies[i].second);
+		});
+
+		holes_stack_.copy(cac.holes_stack_);
+		nb_used_lines_ = cac.nb_used_lines_;
+		nb_max_lines_ = cac.nb_max_lines_;
+
+		return true;
+	}
+
+	/**
+	 * @brief write the lines and the chunk arrays of the container in a snapshot (cf. SnapshotWriter)
+	 */
+	void save_snapshot(SnapshotWriter& w) const
+	{
+		w.write(nb_used_lines_);
+		w.write(nb_max_lines_);
+		w.write(refs_.nb_chunks());
+		save_chunk_array(w, &refs_, nb_max_lines_);
+
+		w.write(holes_stack_.size());
+		for (uint32 i = 1u; i <= holes_stack_.size(); ++i)
+			w.write(holes_stack_[i]);
+
+		w.write(uint32(table_arrays_.size()));
+		for (uint32 i = 0u; i < table_arrays_.size(); ++i)
+		{
+			w.write(names_[i]);
+			w.write(type_names_[i]);
+			save_chunk_array(w, table_arrays_[i], nb_max_lines_);
+		}
+	}
+
+	/**
+	 * @brief read the lines and the chunk arrays of the container from a snapshot (cf. SnapshotReader)
+	 * The chunks of the trivially copyable chunk arrays point into the mapping of the reader.
+	 * The chunk arrays of the snapshot that do not exist in this container are created (the ones
+	 * of unknown types are skipped), the markers and the stamps of this container are reset.
+	 * @return false if the snapshot is corrupted or does not fit this container
+	 */
+	bool load_snapshot(SnapshotReader& r)
+	{
+		chunk_array_factory<CHUNK_SIZE>().register_known_types();
+
+		uint32 nb_used_lines = 0u;
+		uint32 nb_max_lines = 0u;
+		uint32 nb_chunks = 0u;
+		if (!r.read(nb_used_lines) || !r.read(nb_max_lines) || !r.read(nb_chunks))
+			return false;
+		if (!load_chunk_array(r, &refs_) || refs_.nb_chunks() != nb_chunks)
+			return false;
+
+		uint32 nb_holes = 0u;
+		if (!r.read(nb_holes))
+			return false;
+		holes_stack_.clear();
+		for (uint32 i = 0u; i < nb_holes; ++i)
+		{
+			uint32 hole = 0u;
+			if (!r.read(hole))
+				return false;
+			holes_stack_.push(hole);
+		}
+
+		nb_used_lines_ = nb_used_lines;
+		nb_max_lines_ = nb_max_lines;
+		reset_markers_and_stamps(nb_chunks);
+
+		uint32 nb_arrays = 0u;
+		if (!r.read(nb_arrays))
+			return false;
+		for (uint32 i = 0u; i < nb_arrays; ++i)
+		{
+			std::string name;
+			std::string type_name;
+			if (!r.read(name) || !r.read(type_name))
+				return false;
+			ChunkArrayGen* ca = nullptr;
+			const uint32 j = array_index(name);
+			if (j != UNKNOWN)
+			{
+				if (type_names_[j] != type_name)
+				{
+					cgogn_log_warning("load_snapshot") << "same name: " << name << " but different type: " << type_name << " / " << type_names_[j];
+					return false;
+				}
+				ca = table_arrays_[j];
+			}
+			else
+			{
+				auto cag = chunk_array_factory<CHUNK_SIZE>().create(type_name, name);
+				if (cag)
+				{
+					ca = cag.release();
+					push_chunk_array(ca, name, type_name);
+				}
+				else
+					cgogn_log_warning("load_snapshot") << "Could not load attribute \"" << name << "\" of type \"" << type_name << "\".";
+			}
+			if (!load_chunk_array(r, ca))
+				return false;
+		}
+
+		// the chunk arrays that are not in the snapshot (or not fully serialized) are resized
+		for (auto* ca : table_arrays_)
+			ca->set_nb_chunks(nb_chunks);
+
+		return true;
+	}
+
 	/**************************************
 	 *          LINES MANAGEMENT          *
 	 **************************************/
@@ -772,6 +1143,8 @@ public:
 					arr->add_chunk();
 				for (auto arr : table_marker_arrays_)
 					arr->add_chunk();
+				for (auto arr : table_stamp_arrays_)
+					arr->add_chunk();
 				refs_.add_chunk();
 			}
 
@@ -783,6 +1156,8 @@ public:
 					arr->add_chunk();
 				for (auto arr : table_marker_arrays_)
 					arr->add_chunk();
+				for (auto arr : table_stamp_arrays_)
+					arr->add_chunk();
 				refs_.add_chunk();
 			}
 
@@ -804,6 +1179,142 @@ public:
 		return index;
 	}
 
+	/**
+	* @brief insert n groups of PRIM_SIZE consecutive lines in the container
+	* The holes are filled first, the remaining groups are inserted contiguously at the end
+	* of the container, whose chunks are allocated once.
+	* @param n number of groups to insert
+	* @param indices the indices of the first lines of the groups are appended to it
+	*/
+	template <uint32 PRIM_SIZE>
+	void insert_lines_bulk(uint32 n, std::vector<uint32>& indices)
+	{
+		static_assert(PRIM_SIZE < CHUNK_SIZE, "Cannot insert lines in a container if PRIM_SIZE < CHUNK_SIZE");
+
+		indices.reserve(indices.size() + n);
+
+		uint32 nb_holes = 0u;
+		for (; nb_holes < n && !holes_stack_.empty(); ++nb_holes)
+		{
+			const uint32 index = holes_stack_.head();
+			holes_stack_.pop();
+			for (uint32 i = 0u; i < PRIM_SIZE; ++i)
+				refs_.set_value(index + i, 1u); // do not use [] in case of refs_ is bool
+			indices.push_back(index);
+		}
+		nb_used_lines_ += nb_holes * PRIM_SIZE;
+
+		const uint32 first = insert_contiguous_lines<PRIM_SIZE>(n - nb_holes);
+		for (uint32 i = 0u; i < n - nb_holes; ++i)
+			indices.push_back(first + i * PRIM_SIZE);
+	}
+
+	/**
+	* @brief insert n groups of PRIM_SIZE consecutive lines at the end of the container (the holes are not used)
+	* @param n number of groups to insert
+	* @return index of the first line, the groups are at index + k * PRIM_SIZE
+	*/
+	template <uint32 PRIM_SIZE>
+	uint32 insert_contiguous_lines(uint32 n)
+	{
+		static_assert(PRIM_SIZE < CHUNK_SIZE, "Cannot insert lines in a container if PRIM_SIZE < CHUNK_SIZE");
+
+		const uint32 index = nb_max_lines_;
+		if (n == 0u)
+			return index;
+
+		// same number of chunks as the one maintained by insert_lines
+		const uint32 nb_chunks = (nb_max_lines_ + n * PRIM_SIZE) / CHUNK_SIZE + 1u;
+		while (refs_.nb_chunks() < nb_chunks)
+		{
+			for (auto arr : table_arrays_)
+				arr->add_chunk();
+			for (auto arr : table_marker_arrays_)
+				arr->add_chunk();
+			for (auto arr : table_stamp_arrays_)
+				arr->add_chunk();
+			refs_.add_chunk();
+		}
+
+		nb_max_lines_ += n * PRIM_SIZE;
+		for (uint32 i = index; i < nb_max_lines_; ++i)
+			refs_.set_value(i, 1u); // do not use [] in case of refs_ is bool
+
+		nb_used_lines_ += n * PRIM_SIZE;
+
+		return index;
+	}
+
+	/**
+	 * @brief groups of PRIM_SIZE lines inserted in advance in a container, that several threads can take concurrently
+	 * The lines are inserted and their markers are initialized at construction. Taking lines is thread-safe
+	 * (an atomic counter) whereas the container must not be modified by other means in the meantime.
+	 * The lines that have not been taken are removed from the container at destruction.
+	 */
+	template <uint32 PRIM_SIZE>
+	class LineReservation
+	{
+		Self& container_;
+		std::vector<uint32> lines_;
+		std::atomic<uint32> next_;
+
+	public:
+
+		/**
+		 * @brief reserve n groups of lines in the container (see insert_lines_bulk)
+		 */
+		LineReservation(Self& container, uint32 n) :
+			container_(container),
+			next_(0u)
+		{
+			container_.template insert_lines_bulk<PRIM_SIZE>(n, lines_);
+			for (uint32 index : lines_)
+				for (uint32 i = 0u; i < PRIM_SIZE; ++i)
+					container_.init_markers_of_line(index + i);
+		}
+
+		CGOGN_NOT_COPYABLE_NOR_MOVABLE(LineReservation);
+
+		~LineReservation()
+		{
+			for (uint32 k = std::min(next_.load(), uint32(lines_.size())); k < lines_.size(); ++k)
+				container_.template remove_lines<PRIM_SIZE>(lines_[k]);
+		}
+
+		/**
+		 * @brief take a group of lines (thread-safe)
+		 * @return the index of its first line, UNKNOWN if all the groups have been taken
+		 */
+		inline uint32 take()
+		{
+			const uint32 k = next_++;
+			return k < lines_.size() ? lines_[k] : UNKNOWN;
+		}
+
+		/**
+		 * @brief take nb groups of lines at once (thread-safe), e.g. a block for the current thread
+		 * @param lines the indices of the first lines of the taken groups are appended to it
+		 * @return the number of taken groups, lower than nb if the reservation is exhausted
+		 */
+		inline uint32 take(uint32 nb, std::vector<uint32>& lines)
+		{
+			const uint32 first = next_.fetch_add(nb);
+			const uint32 last = std::min(first + nb, uint32(lines_.size()));
+			for (uint32 k = first; k < last; ++k)
+				lines.push_back(lines_[k]);
+			return first < last ? last - first : 0u;
+		}
+
+		/**
+		 * @brief number of groups that have not been taken yet
+		 */
+		inline uint32 nb_available() const
+		{
+			const uint32 k = next_.load();
+			return k < lines_.size() ? uint32(lines_.size()) - k : 0u;
+		}
+	};
+
 	/**
 	* @brief remove a group of PRIM_SIZE lines in the container
 	* @param index index of one line of group to remove
@@ -835,6 +1346,8 @@ public:
 
 		for (auto ptr : table_marker_arrays_)
 			ptr->set_false(index);
+		for (auto ptr : table_stamp_arrays_)
+			ptr->set_false(index);
 	}
 
 	/**
@@ -853,6 +1366,8 @@ public:
 		{
 			for (auto ptr : table_marker_arrays_)
 				ptr->copy_element(dst, src);
+			for (auto ptr : table_stamp_arrays_)
+				ptr->copy_element(dst, src);
 		}
 		if (copy_refs)
 			refs_[dst] = refs_[src];
@@ -876,6 +1391,8 @@ public:
 		{
 			for (auto ptr : table_marker_arrays_)
 				ptr->copy_element(dst, src);
+			for (auto ptr : table_stamp_arrays_)
+				ptr->copy_element(dst, src);
 		}
 		if (copy_refs)
 			refs_[dst] = refs_[src];
@@ -923,6 +1440,23 @@ public:
 		return refs_[index];
 	}
 
+	/**
+	 * @brief set the number of chunks of the markers and the stamps and unmark all the lines
+	 */
+	void reset_markers_and_stamps(uint32 nb_chunks)
+	{
+		for (auto* cab : table_marker_arrays_)
+		{
+			cab->set_nb_chunks(nb_chunks);
+			cab->all_false();
+		}
+		for (auto* cas : table_stamp_arrays_)
+		{
+			cas->set_nb_chunks(nb_chunks);
+			cas->set_all_values(0u);
+		}
+	}
+
 	/**
 	 * @brief copy management section, and allocate data (no copy), use carefully
 	 * @param from source for copy into this
@@ -939,6 +1473,9 @@ public:
 
 		for (auto* cab : table_marker_arrays_)
 			cab->set_nb_chunks(refs_.nb_chunks());
+
+		for (auto* cas : table_stamp_arrays_)
+			cas->set_nb_chunks(refs_.nb_chunks());
 	}
 
 
@@ -1037,6 +1574,8 @@ public:
 		}
 		ok &= refs_.load(fs);
 
+		rebuild_indices();
+
 		return ok;
 	}
 
@@ -1055,73 +1594,24 @@ public:
 		}
 	}
 
+	/**
+	 * @brief apply f in parallel on each used line of the container
+	 * Each worker processes whole chunks of lines and directly checks the used flags.
+	 */
 	template <typename FUNC>
 	void parallel_foreach_index(const FUNC& f) const
 	{
 		static_assert(is_ith_func_parameter_same<FUNC,0,uint32>::value, "Wrong function first parameter type");
 
-		using VecIndice = std::vector<uint32>;
-		using Future = std::future<typename std::result_of<FUNC(uint32)>::type>;
-
-		ThreadPool* thread_pool = cgogn::thread_pool();
-		uint32 nb_workers = thread_pool->nb_workers();
-		if (nb_workers==0)
+		if (cgogn::thread_pool()->nb_workers() == 0u)
 			return foreach_index(f);
 
-		std::array<std::vector<VecIndice*>, 2> indices_buffers;
-		std::array<std::vector<Future>, 2> futures;
-		indices_buffers[0].reserve(nb_workers);
-		indices_buffers[1].reserve(nb_workers);
-		futures[0].reserve(nb_workers);
-		futures[1].reserve(nb_workers);
-
-		Buffers<uint32>* buffs = cgogn::uint_buffers();
-
-		uint32 i = 0u; // buffer id (0/1)
-		uint32 j = 0u; // thread id (0..nb_workers)
-
-		uint32 it = begin();
-		uint32 it_end = end();
-		while(it != it_end)
+		parallel_for(0u, end(), CHUNK_SIZE, [this, &f] (uint32 first, uint32 last)
 		{
-			// fill buffer
-			indices_buffers[i].push_back(buffs->buffer());
-			VecIndice& indices = *indices_buffers[i].back();
-			indices.reserve(PARALLEL_BUFFER_SIZE);
-			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && (it != it_end); ++k)
-			{
-				indices.push_back(it);
-				next(it);
-			}
-			// launch thread
-			futures[i].push_back(thread_pool->enqueue([&indices, &f] ()
-			{
-				for (auto ind : indices)
-					f(ind);
-			}));
-			// next thread
-			if (++j == nb_workers)
-			{	// again from 0 & change buffer
-				j = 0;
-				i = (i+1u) % 2u;
-				for (auto& fu : futures[i])
-					fu.wait();
-				for (auto& b : indices_buffers[i])
-					buffs->release_buffer(b);
-				futures[i].clear();
-				indices_buffers[i].clear();
-			}
-		}
-
-		// clean all at end
-		for (auto& fu : futures[0u])
-			fu.wait();
-		for (auto& b : indices_buffers[0u])
-			buffs->release_buffer(b);
-		for (auto& fu : futures[1u])
-			fu.wait();
-		for (auto& b : indices_buffers[1u])
-			buffs->release_buffer(b);
+			for (uint32 it = first; it < last; ++it)
+				if (used(it))
+					f(it);
+		});
 	}
 };
 
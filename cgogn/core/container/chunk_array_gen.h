@@ -133,6 +133,16 @@ public:
 	 */
 	virtual uint32 capacity() const = 0;
 
+	/**
+	 * @brief get the size in bytes of a chunk of the array
+	 */
+	virtual std::size_t chunk_bytes() const = 0;
+
+	/**
+	 * @brief get the number of bytes used by the array
+	 */
+	virtual std::size_t memory_usage() const = 0;
+
 	/**
 	 * @brief return a vector with pointers to all chunks
 	 * @param byte_block_size filled with CHUNK_SIZE*sizeof(T)
@@ -140,6 +150,19 @@ public:
 	 */
 	virtual std::vector<const void*> chunks_pointers(uint32& byte_block_size) const = 0;
 
+	/**
+	 * @brief tell if the chunks of the array can be copied bytewise (cf. is_raw_copyable)
+	 */
+	virtual bool is_trivially_copyable() const = 0;
+
+	/**
+	 * @brief replace the chunks of the array by the given blocks of chunk_bytes() bytes
+	 * The blocks must come from the chunk pool (allocated or mapped, cf. ChunkPool::map_block)
+	 * and are owned by the array afterwards.
+	 * @return false if the chunks of the array can not be copied bytewise
+	 */
+	virtual bool set_chunks(const std::vector<void*>& chunks) = 0;
+
 	/**
 	 * @brief create a ChunkArray object without knowing type
 	 * @return generic pointer
@@ -164,6 +187,12 @@ public:
 	 */
 	virtual void clear() = 0;
 
+	/**
+	 * @brief release the unused capacity of the vector of chunk pointers
+	 * @return the number of bytes released
+	 */
+	virtual std::size_t shrink_to_fit() = 0;
+
 
 	/**
 	 * @brief copy an element to another one
@@ -197,6 +226,27 @@ public:
 	 */
 	virtual void swap_elements(uint32 idx1, uint32 idx2) = 0;
 
+	/**
+	 * @brief move each element i to index old_new[i] (the following elements keep their index)
+	 * @param old_new a permutation of [0, old_new.size())
+	 */
+	virtual void permute_elements(const std::vector<uint32>& old_new)
+	{
+		std::vector<bool> done(old_new.size(), false);
+		for (uint32 i = 0u, nb = uint32(old_new.size()); i < nb; ++i)
+		{
+			if (done[i])
+				continue;
+			done[i] = true;
+			// follow the cycle of i: element i always holds an element that has not reached its place yet
+			for (uint32 j = old_new[i]; j != i; j = old_new[j])
+			{
+				this->swap_elements(i, j);
+				done[j] = true;
+			}
+		}
+	}
+
 	/**
 	 * @brief save
 	 * @param fs file stream
@@ -0,0 +1,584 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/container/chunk_pool.h>
+#include <cgogn/core/utils/logger.h>
+#include <cgogn/core/utils/assert.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <initializer_list>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+// the mappings of the snapshots and the huge page slabs are released with munmap
+#if defined(_POSIX_MAPPED_FILES) && (_POSIX_MAPPED_FILES > 0)
+#define CGOGN_CHUNK_POOL_MMAP
+#include <sys/mman.h>
+#endif
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace cgogn
+{
+
+namespace
+{
+
+inline void* aligned_malloc(std::size_t nb_bytes, std::size_t alignment)
+{
+#ifdef _WIN32
+	return _aligned_malloc(nb_bytes, alignment);
+#else
+	void* ptr = nullptr;
+	if (posix_memalign(&ptr, alignment, nb_bytes) != 0)
+		return nullptr;
+	return ptr;
+#endif
+}
+
+inline void aligned_free(void* ptr)
+{
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	std::free(ptr);
+#endif
+}
+
+inline std::size_t round_up(std::size_t n, std::size_t multiple)
+{
+	return ((n + multiple - 1u) / multiple) * multiple;
+}
+
+// the stripe of the calling thread (the threads are distributed in turn over the stripes)
+inline uint32 stripe_index()
+{
+	static std::atomic<uint32> next_index(0u);
+	static thread_local uint32 index = 0u; // 1 + index of the stripe once assigned
+	if (index == 0u)
+		index = 1u + next_index++ % ChunkPool::NB_STRIPES;
+	return index - 1u;
+}
+
+inline void* pop_block(std::unordered_map<std::size_t, std::vector<void*>>& free_lists, std::size_t nb_bytes)
+{
+	auto it = free_lists.find(nb_bytes);
+	if (it == free_lists.end() || it->second.empty())
+		return nullptr;
+	void* block = it->second.back();
+	it->second.pop_back();
+	return block;
+}
+
+// iterator on the region (sorted by address) that contains block (or end)
+template <typename REGIONS>
+auto find_region(REGIONS& regions, const void* block) -> decltype(regions.begin())
+{
+	using REGION = typename REGIONS::value_type;
+	const char* b = static_cast<const char*>(block);
+	auto it = std::upper_bound(regions.begin(), regions.end(), b, [] (const char* p, const REGION& r) { return p < r.begin_; });
+	if (it == regions.begin())
+		return regions.end();
+	--it;
+	return b < it->end_ ? it : regions.end();
+}
+
+template <typename REGION>
+void insert_region(std::vector<REGION>& regions, const REGION& region)
+{
+	auto it = std::upper_bound(regions.begin(), regions.end(), region.begin_, [] (const char* p, const REGION& r) { return p < r.begin_; });
+	regions.insert(it, region);
+}
+
+} // namespace
+
+ChunkPool::ChunkPool() :
+	published_regions_(nullptr),
+	nb_slabs_(0u),
+	nb_mappings_(0u),
+	cached_bytes_(0u),
+	max_cached_bytes_(DEFAULT_MAX_CACHED_BYTES),
+	enabled_(true),
+	huge_pages_(false)
+{
+	for (Stripe& s : stripes_)
+	{
+		s.hits_ = 0u;
+		s.misses_ = 0u;
+		s.releases_ = 0u;
+		s.used_bytes_ = 0;
+		s.nb_readers_ = 0u;
+	}
+}
+
+ChunkPool::~ChunkPool()
+{
+	for (Stripe& s : stripes_)
+		for (auto& it : s.free_blocks_)
+			for (void* block : it.second)
+				if (!in_slab(block))
+					aligned_free(block);
+	for (const Slab& s : slabs_)
+	{
+#ifdef CGOGN_CHUNK_POOL_MMAP
+		if (s.mmapped_)
+		{
+			munmap(s.begin_, std::size_t(s.end_ - s.begin_));
+			continue;
+		}
+#endif
+		aligned_free(s.begin_);
+	}
+	delete published_regions_.load();
+	for (const std::vector<Region>* regions : retired_regions_)
+		delete regions;
+}
+
+void ChunkPool::add_mapping(void* begin, std::size_t nb_bytes, bool mmapped)
+{
+	std::lock_guard<std::mutex> lock(regions_mutex_);
+	Mapping m;
+	m.begin_ = static_cast<char*>(begin);
+	m.end_ = m.begin_ + nb_bytes;
+	m.nb_blocks_ = 0u;
+	m.mmapped_ = mmapped;
+	m.closed_ = false;
+	insert_region(mappings_, m);
+	++nb_mappings_;
+	publish_regions();
+}
+
+void* ChunkPool::map_block(void* block)
+{
+	std::lock_guard<std::mutex> lock(regions_mutex_);
+	auto it = find_region(mappings_, block);
+	cgogn_message_assert(it != mappings_.end() && !it->closed_, "map_block: the block does not belong to an open mapping");
+	++it->nb_blocks_;
+	return block;
+}
+
+void ChunkPool::close_mapping(void* begin)
+{
+	std::lock_guard<std::mutex> lock(regions_mutex_);
+	auto it = find_region(mappings_, begin);
+	cgogn_message_assert(it != mappings_.end(), "close_mapping: unknown mapping");
+	it->closed_ = true;
+	if (it->nb_blocks_ == 0u)
+		free_mapping(it);
+}
+
+void* ChunkPool::allocate_mapping(std::size_t nb_bytes)
+{
+	void* mapping = aligned_malloc(round_up(std::max(nb_bytes, std::size_t(1u)), ALIGNMENT), 4096u);
+	if (mapping == nullptr)
+		throw std::bad_alloc();
+	return mapping;
+}
+
+void* ChunkPool::allocate(std::size_t nb_bytes)
+{
+	bool recycled;
+	return allocate(nb_bytes, recycled);
+}
+
+void* ChunkPool::allocate(std::size_t nb_bytes, bool& recycled)
+{
+	Stripe& own = stripe();
+	void* block = take_block(own, nb_bytes, recycled);
+	if (block != nullptr)
+		return block;
+
+	// the blocks released by the threads of the other stripes
+	if (cached_bytes_.load(std::memory_order_relaxed) >= nb_bytes)
+	{
+		for (Stripe& s : stripes_)
+		{
+			if (&s == &own)
+				continue;
+			block = take_block(s, nb_bytes, recycled);
+			if (block != nullptr)
+				return block;
+		}
+	}
+
+	recycled = false;
+	if (huge_pages_.load(std::memory_order_relaxed))
+		return allocate_from_slab(own, nb_bytes);
+
+	block = allocate_block(nb_bytes);
+	std::lock_guard<std::mutex> lock(own.mutex_);
+	++own.misses_;
+	own.used_bytes_ += std::ptrdiff_t(nb_bytes);
+	return block;
+}
+
+void ChunkPool::release(void* block, std::size_t nb_bytes)
+{
+	if (block == nullptr)
+		return;
+
+	const RegionType region = region_type(block);
+
+	// blocks of mappings are not recycled
+	// (the mapping of the block can not be freed meanwhile: the block is still counted)
+	if (region == MAPPING)
+	{
+		std::lock_guard<std::mutex> lock(regions_mutex_);
+		auto it = find_region(mappings_, block);
+		cgogn_assert(it != mappings_.end());
+		if (--it->nb_blocks_ == 0u && it->closed_)
+			free_mapping(it);
+		return;
+	}
+
+	// blocks of slabs can not be freed individually
+	// (the bound of the cached memory is not strict when several threads release blocks at the same time)
+	const bool keep = region == SLAB || (enabled_.load(std::memory_order_relaxed) &&
+		cached_bytes_.load(std::memory_order_relaxed) + nb_bytes <= max_cached_bytes_.load(std::memory_order_relaxed));
+	if (keep)
+		cached_bytes_.fetch_add(nb_bytes, std::memory_order_relaxed);
+
+	Stripe& s = stripe();
+	{
+		std::lock_guard<std::mutex> lock(s.mutex_);
+		++s.releases_;
+		s.used_bytes_ -= std::ptrdiff_t(nb_bytes);
+		if (keep)
+			s.free_blocks_[nb_bytes].push_back(block);
+	}
+	if (!keep)
+		aligned_free(block);
+}
+
+std::size_t ChunkPool::trim()
+{
+	std::size_t freed = 0u;
+	for (Stripe& s : stripes_)
+	{
+		std::lock_guard<std::mutex> lock(s.mutex_);
+		for (auto& it : s.free_blocks_)
+		{
+			std::vector<void*>& blocks = it.second;
+			auto slab_end = std::partition(blocks.begin(), blocks.end(), [this] (void* b) { return in_slab(b); });
+			for (auto b = slab_end; b != blocks.end(); ++b)
+			{
+				aligned_free(*b);
+				freed += it.first;
+			}
+			blocks.erase(slab_end, blocks.end());
+		}
+	}
+	cached_bytes_.fetch_sub(freed, std::memory_order_relaxed);
+	if (nb_slabs_.load(std::memory_order_acquire) > 0u)
+		freed += trim_slabs();
+	return freed;
+}
+
+std::size_t ChunkPool::trim_slabs()
+{
+	// the blocks of a slab can be cached in any stripe: all the stripes are locked to count them
+	std::vector<std::unique_lock<std::mutex>> stripe_locks;
+	stripe_locks.reserve(NB_STRIPES);
+	for (Stripe& s : stripes_)
+		stripe_locks.emplace_back(s.mutex_);
+	std::lock_guard<std::mutex> lock(regions_mutex_);
+
+	std::vector<std::size_t> nb_free(slabs_.size(), 0u);
+	auto slab_index = [this] (const void* b) { return std::size_t(find_region(slabs_, b) - slabs_.begin()); };
+	for (Stripe& s : stripes_)
+	{
+		for (FreeLists* lists : { &s.free_blocks_, &s.untouched_blocks_ })
+			for (auto& it : *lists)
+				for (void* b : it.second)
+					++nb_free[slab_index(b)];
+	}
+
+	std::vector<bool> unused(slabs_.size(), false);
+	bool found = false;
+	for (std::size_t i = 0u; i < slabs_.size(); ++i)
+	{
+		unused[i] = nb_free[i] == slabs_[i].nb_blocks_;
+		found = found || unused[i];
+	}
+	if (!found)
+		return 0u;
+
+	// the blocks of the unused slabs are removed from the free lists
+	std::size_t uncached = 0u;
+	for (Stripe& s : stripes_)
+	{
+		for (FreeLists* lists : { &s.free_blocks_, &s.untouched_blocks_ })
+		{
+			for (auto& it : *lists)
+			{
+				std::vector<void*>& blocks = it.second;
+				auto end = std::remove_if(blocks.begin(), blocks.end(), [&] (void* b) { return unused[slab_index(b)]; });
+				uncached += std::size_t(blocks.end() - end) * it.first;
+				blocks.erase(end, blocks.end());
+			}
+		}
+	}
+	cached_bytes_.fetch_sub(uncached, std::memory_order_relaxed);
+
+	// the ranges of the slabs are unpublished before their memory can be reused by another allocation
+	std::vector<Slab> freed_slabs;
+	std::vector<Slab> kept_slabs;
+	for (std::size_t i = 0u; i < slabs_.size(); ++i)
+		(unused[i] ? freed_slabs : kept_slabs).push_back(slabs_[i]);
+	slabs_.swap(kept_slabs);
+	nb_slabs_ = uint32(slabs_.size());
+	publish_regions();
+
+	std::size_t freed = 0u;
+	for (const Slab& s : freed_slabs)
+	{
+		freed += std::size_t(s.end_ - s.begin_);
+#ifdef CGOGN_CHUNK_POOL_MMAP
+		if (s.mmapped_)
+		{
+			munmap(s.begin_, std::size_t(s.end_ - s.begin_));
+			continue;
+		}
+#endif
+		aligned_free(s.begin_);
+	}
+	return freed;
+}
+
+void ChunkPool::set_enabled(bool b)
+{
+	enabled_ = b;
+	if (!b)
+		trim();
+}
+
+bool ChunkPool::enabled() const
+{
+	return enabled_;
+}
+
+void ChunkPool::set_huge_pages(bool b)
+{
+	huge_pages_ = b;
+}
+
+bool ChunkPool::huge_pages() const
+{
+	return huge_pages_;
+}
+
+void ChunkPool::set_max_cached_bytes(std::size_t nb_bytes)
+{
+	max_cached_bytes_ = nb_bytes;
+}
+
+ChunkPoolStats ChunkPool::stats() const
+{
+	ChunkPoolStats stats;
+	stats.hits = 0u;
+	stats.misses = 0u;
+	stats.releases = 0u;
+	// a block can be allocated and released in different stripes
+	std::ptrdiff_t used_bytes = 0;
+	for (const Stripe& s : stripes_)
+	{
+		std::lock_guard<std::mutex> lock(s.mutex_);
+		stats.hits += s.hits_;
+		stats.misses += s.misses_;
+		stats.releases += s.releases_;
+		used_bytes += s.used_bytes_;
+	}
+	cgogn_assert(used_bytes >= 0);
+	stats.used_bytes = std::size_t(used_bytes);
+	stats.cached_bytes = cached_bytes_;
+	return stats;
+}
+
+void ChunkPool::reset_stats()
+{
+	for (Stripe& s : stripes_)
+	{
+		std::lock_guard<std::mutex> lock(s.mutex_);
+		s.hits_ = 0u;
+		s.misses_ = 0u;
+		s.releases_ = 0u;
+	}
+}
+
+ChunkPool::Stripe& ChunkPool::stripe()
+{
+	return stripes_[stripe_index()];
+}
+
+void* ChunkPool::take_block(Stripe& s, std::size_t nb_bytes, bool& recycled)
+{
+	std::lock_guard<std::mutex> lock(s.mutex_);
+	void* block = pop_block(s.free_blocks_, nb_bytes);
+	recycled = block != nullptr;
+	if (block == nullptr)
+		block = pop_block(s.untouched_blocks_, nb_bytes);
+	if (block != nullptr)
+	{
+		cached_bytes_.fetch_sub(nb_bytes, std::memory_order_relaxed);
+		// the never used blocks of a slab are new blocks
+		if (recycled)
+			++s.hits_;
+		else
+			++s.misses_;
+		s.used_bytes_ += std::ptrdiff_t(nb_bytes);
+	}
+	return block;
+}
+
+void* ChunkPool::allocate_block(std::size_t nb_bytes)
+{
+	void* block = aligned_malloc(round_up(nb_bytes, ALIGNMENT), ALIGNMENT);
+	if (block == nullptr)
+		throw std::bad_alloc();
+	return block;
+}
+
+void* ChunkPool::allocate_from_slab(Stripe& stripe, std::size_t nb_bytes)
+{
+	const std::size_t stride = round_up(nb_bytes, ALIGNMENT);
+	const std::size_t nb_blocks = std::max(std::size_t(1u), HUGE_PAGE_SIZE / stride);
+	const std::size_t slab_bytes = round_up(nb_blocks * stride, HUGE_PAGE_SIZE);
+
+	Slab s;
+	s.nb_blocks_ = nb_blocks;
+	s.mmapped_ = false;
+	s.begin_ = nullptr;
+#if defined(__linux__) && defined(MAP_HUGETLB)
+	// explicit huge pages (only available if some have been reserved by the system)
+	void* ptr = mmap(nullptr, slab_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (ptr != MAP_FAILED)
+	{
+		s.begin_ = static_cast<char*>(ptr);
+		s.mmapped_ = true;
+	}
+#endif
+	if (s.begin_ == nullptr)
+	{
+		s.begin_ = static_cast<char*>(aligned_malloc(slab_bytes, HUGE_PAGE_SIZE));
+		if (s.begin_ == nullptr)
+			throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		// transparent huge pages
+		madvise(s.begin_, slab_bytes, MADV_HUGEPAGE);
+#endif
+	}
+	s.end_ = s.begin_ + slab_bytes;
+	{
+		std::lock_guard<std::mutex> lock(regions_mutex_);
+		insert_region(slabs_, s);
+		++nb_slabs_;
+		publish_regions();
+	}
+
+	// the first block is returned, the others are put in the free list of the stripe
+	std::lock_guard<std::mutex> lock(stripe.mutex_);
+	++stripe.misses_;
+	stripe.used_bytes_ += std::ptrdiff_t(nb_bytes);
+	std::vector<void*>& blocks = stripe.untouched_blocks_[nb_bytes];
+	for (std::size_t i = nb_blocks - 1u; i > 0u; --i)
+		blocks.push_back(s.begin_ + i * stride);
+	cached_bytes_.fetch_add((nb_blocks - 1u) * nb_bytes, std::memory_order_relaxed);
+	return s.begin_;
+}
+
+bool ChunkPool::in_slab(const void* block) const
+{
+	return nb_slabs_.load(std::memory_order_acquire) > 0u && region_type(block) == SLAB;
+}
+
+ChunkPool::RegionType ChunkPool::region_type(const void* block) const
+{
+	if (nb_slabs_.load(std::memory_order_acquire) == 0u && nb_mappings_.load(std::memory_order_acquire) == 0u)
+		return NO_REGION;
+
+	// the copy can not be deleted while the counter of the stripe is not null (cf. publish_regions)
+	std::atomic<uint32>& nb_readers = stripes_[stripe_index()].nb_readers_;
+	nb_readers.fetch_add(1u);
+	RegionType type = NO_REGION;
+	const std::vector<Region>* regions = published_regions_.load();
+	if (regions != nullptr)
+	{
+		auto it = find_region(*regions, block);
+		if (it != regions->end())
+			type = it->type_;
+	}
+	nb_readers.fetch_sub(1u);
+	return type;
+}
+
+void ChunkPool::publish_regions()
+{
+	// (regions_mutex_ is locked by the caller)
+	std::vector<Region>* regions = new std::vector<Region>();
+	regions->reserve(slabs_.size() + mappings_.size());
+	for (const Slab& s : slabs_)
+		regions->push_back(Region{s.begin_, s.end_, SLAB});
+	for (const Mapping& m : mappings_)
+		regions->push_back(Region{m.begin_, m.end_, MAPPING});
+	std::sort(regions->begin(), regions->end(), [] (const Region& a, const Region& b) { return a.begin_ < b.begin_; });
+	retired_regions_.push_back(published_regions_.exchange(regions));
+
+	// a thread that starts a search after this check loads the new copy (all the operations are sequentially consistent)
+	if (std::all_of(stripes_.begin(), stripes_.end(), [] (const Stripe& s) { return s.nb_readers_.load() == 0u; }))
+	{
+		for (const std::vector<Region>* r : retired_regions_)
+			delete r;
+		retired_regions_.clear();
+	}
+}
+
+void ChunkPool::free_mapping(std::vector<Mapping>::iterator it)
+{
+	// the range is unpublished before its memory can be reused by another allocation
+	const Mapping m = *it;
+	mappings_.erase(it);
+	--nb_mappings_;
+	publish_regions();
+#ifdef CGOGN_CHUNK_POOL_MMAP
+	if (m.mmapped_)
+		munmap(m.begin_, std::size_t(m.end_ - m.begin_));
+	else
+#endif
+		aligned_free(m.begin_);
+}
+
+CGOGN_CORE_EXPORT ChunkPool* chunk_pool()
+{
+	// never destroyed: chunks of static maps may be released after the end of main
+	static ChunkPool* pool = new ChunkPool();
+	return pool;
+}
+
+} // namespace cgogn
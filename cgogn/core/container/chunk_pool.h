@@ -0,0 +1,234 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_CONTAINER_CHUNK_POOL_H_
+#define CGOGN_CORE_CONTAINER_CHUNK_POOL_H_
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <cgogn/core/cgogn_core_export.h>
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/definitions.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief statistics of a ChunkPool
+ */
+struct ChunkPoolStats
+{
+	uint64 hits;              // allocations served by a recycled block
+	uint64 misses;            // allocations that needed a new block (including the never used blocks of a slab)
+	uint64 releases;          // blocks given back to the pool
+	std::size_t used_bytes;   // bytes of the blocks currently in use
+	std::size_t cached_bytes; // bytes of the free blocks kept by the pool
+};
+
+/**
+ * @brief Pool of memory blocks used to store the chunks of the ChunkArrays.
+ * Released blocks are kept in a free list indexed by their size in bytes and are
+ * recycled by the next allocations of the same size: adding and removing temporary
+ * attributes does not go through the system allocator anymore.
+ * The free lists are split in NB_STRIPES stripes, each one with its own lock: a thread releases
+ * its blocks in its stripe and takes the blocks of its stripe first (the other stripes are only
+ * searched before allocating a new block), so that concurrent threads rarely wait for each other.
+ * Blocks are aligned on cache lines. The memory kept in free lists is bounded
+ * (cf. set_max_cached_bytes, 64 MB by default) and can be given back to the system with trim().
+ * In huge pages mode, new blocks are carved in slabs backed by (transparent) huge pages;
+ * the memory of a slab is only given back to the system by trim(), once all its blocks are free.
+ * All methods are thread safe.
+ */
+class CGOGN_CORE_EXPORT ChunkPool final
+{
+public:
+
+	static const std::size_t ALIGNMENT = 64u;
+	static const std::size_t HUGE_PAGE_SIZE = 2u * 1024u * 1024u;
+	static const std::size_t DEFAULT_MAX_CACHED_BYTES = 64u * 1024u * 1024u;
+	static const uint32 NB_STRIPES = 16u;
+
+	ChunkPool();
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ChunkPool);
+	~ChunkPool();
+
+	/**
+	 * @brief get a block of nb_bytes bytes (uninitialized memory)
+	 */
+	void* allocate(std::size_t nb_bytes);
+
+	/**
+	 * @brief get a block of nb_bytes bytes (uninitialized memory)
+	 * @param recycled set to true if the block has already been used (its pages have already been touched)
+	 */
+	void* allocate(std::size_t nb_bytes, bool& recycled);
+
+	/**
+	 * @brief give back a block obtained by allocate(nb_bytes)
+	 * The slab or mapping of the block is searched without lock (cf. region_type), only the release
+	 * of a block of a mapping takes the lock of the regions.
+	 */
+	void release(void* block, std::size_t nb_bytes);
+
+	/**
+	 * @brief free all the cached blocks that do not belong to huge pages slabs,
+	 * and the slabs whose blocks are all cached (i.e. none is in use)
+	 * @return the number of bytes given back to the system
+	 */
+	std::size_t trim();
+
+	/**
+	 * @brief enable / disable the recycling of blocks (disabling trims the pool)
+	 */
+	void set_enabled(bool b);
+	bool enabled() const;
+
+	/**
+	 * @brief enable / disable the huge pages backing of new blocks
+	 */
+	void set_huge_pages(bool b);
+	bool huge_pages() const;
+
+	void set_max_cached_bytes(std::size_t nb_bytes);
+
+	/**
+	 * @brief hand over a memory mapping (e.g. a mapped file, cf. SnapshotReader) to the pool
+	 * The blocks taken in the mapping (cf. map_block) can be used as chunks. They are not recycled
+	 * when they are released: the mapping is freed once it has been closed and all its blocks released.
+	 * @param begin the beginning of the mapping
+	 * @param nb_bytes the size of the mapping
+	 * @param mmapped true if the mapping has been obtained with mmap, false if it has been allocated with allocate_mapping
+	 */
+	void add_mapping(void* begin, std::size_t nb_bytes, bool mmapped);
+
+	/**
+	 * @brief take the block of the mapping that contains it (the block is counted until it is released)
+	 */
+	void* map_block(void* block);
+
+	/**
+	 * @brief no more block of the mapping will be taken: free it if none of its blocks is in use
+	 */
+	void close_mapping(void* begin);
+
+	/**
+	 * @brief allocate a mapping that can be handed over to the pool (where mmap is not available)
+	 */
+	static void* allocate_mapping(std::size_t nb_bytes);
+
+	ChunkPoolStats stats() const;
+	void reset_stats();
+
+private:
+
+	struct Slab
+	{
+		char* begin_;
+		char* end_;
+		std::size_t nb_blocks_;
+		bool mmapped_;
+	};
+
+	struct Mapping
+	{
+		char* begin_;
+		char* end_;
+		std::size_t nb_blocks_;
+		bool mmapped_;
+		bool closed_;
+	};
+
+	enum RegionType
+	{
+		NO_REGION = 0,
+		SLAB,
+		MAPPING
+	};
+
+	// address range of a slab or of a mapping
+	struct Region
+	{
+		const char* begin_;
+		const char* end_;
+		RegionType type_;
+	};
+
+	using FreeLists = std::unordered_map<std::size_t, std::vector<void*>>;
+
+	// free lists of the blocks released by a group of threads
+	struct Stripe
+	{
+		mutable std::mutex mutex_;
+		FreeLists free_blocks_;
+		// blocks carved in a slab that have never been used (cf. allocate(nb_bytes, recycled))
+		FreeLists untouched_blocks_;
+		uint64 hits_;
+		uint64 misses_;
+		uint64 releases_;
+		std::ptrdiff_t used_bytes_; // allocated minus released in this stripe
+		mutable std::atomic<uint32> nb_readers_; // threads of the stripe that search the published regions
+		char padding_[64]; // the locks of two stripes never share a cache line
+	};
+
+	Stripe& stripe();
+	void* take_block(Stripe& s, std::size_t nb_bytes, bool& recycled);
+	void* allocate_block(std::size_t nb_bytes);
+	void* allocate_from_slab(Stripe& s, std::size_t nb_bytes);
+	std::size_t trim_slabs();
+	bool in_slab(const void* block) const;
+	RegionType region_type(const void* block) const;
+	void publish_regions();
+	void free_mapping(std::vector<Mapping>::iterator it);
+
+#pragma warning(push)
+#pragma warning(disable:4251)
+	std::array<Stripe, NB_STRIPES> stripes_;
+	// slabs and mappings sorted by address (protected by regions_mutex_)
+	mutable std::mutex regions_mutex_;
+	std::vector<Slab> slabs_;
+	std::vector<Mapping> mappings_;
+	// immutable copy of the ranges of the slabs and mappings, searched without lock (cf. publish_regions)
+	std::atomic<const std::vector<Region>*> published_regions_;
+	// previous copies, deleted once no thread searches them (protected by regions_mutex_)
+	std::vector<const std::vector<Region>*> retired_regions_;
+	std::atomic<uint32> nb_slabs_;
+	std::atomic<uint32> nb_mappings_;
+	std::atomic<std::size_t> cached_bytes_;
+	std::atomic<std::size_t> max_cached_bytes_;
+	std::atomic<bool> enabled_;
+	std::atomic<bool> huge_pages_;
+#pragma warning(pop)
+};
+
+/**
+ * @brief the pool used by all the ChunkArrays
+ */
+CGOGN_CORE_EXPORT ChunkPool* chunk_pool();
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_CONTAINER_CHUNK_POOL_H_
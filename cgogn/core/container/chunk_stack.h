@@ -128,10 +128,11 @@ public:
 	 */
 	void compact()
 	{
-		const uint32 keep = (stack_size_+CHUNK_SIZE-1u) / CHUNK_SIZE;
+		// elements are stored from index 1 (cf. push)
+		const uint32 keep = stack_size_ == 0u ? 0u : stack_size_ / CHUNK_SIZE + 1u;
 		while (this->table_data_.size() > keep)
 		{
-			delete[] this->table_data_.back();
+			Inherit::release_chunk(this->table_data_.back());
 			this->table_data_.pop_back();
 		}
 	}
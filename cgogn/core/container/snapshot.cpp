@@ -0,0 +1,192 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/container/snapshot.h>
+
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+// the POSIX systems (Linux, macOS, BSD) that provide memory mapped files
+#if defined(_POSIX_MAPPED_FILES) && (_POSIX_MAPPED_FILES > 0)
+#define CGOGN_SNAPSHOT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace cgogn
+{
+
+namespace
+{
+
+const char SNAPSHOT_MAGIC[8] = { 'C', 'G', 'o', 'G', 'N', 'S', 'N', 'P' };
+const uint32 SNAPSHOT_ENDIANNESS = 0x01020304u;
+
+} // namespace
+
+const uint32 SnapshotWriter::VERSION;
+const std::size_t SnapshotWriter::PAGE_SIZE;
+
+SnapshotWriter::SnapshotWriter(const std::string& filename) :
+	fs_(filename, std::ios::out | std::ios::binary | std::ios::trunc),
+	position_(0u)
+{}
+
+void SnapshotWriter::write_header(const std::string& map_type, uint32 chunk_size)
+{
+	write_bytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	write(VERSION);
+	write(SNAPSHOT_ENDIANNESS);
+	write(chunk_size);
+	write(map_type);
+}
+
+void SnapshotWriter::write(const std::string& s)
+{
+	write(uint32(s.size()));
+	write_bytes(s.data(), s.size());
+}
+
+void SnapshotWriter::write_bytes(const void* data, std::size_t nb_bytes)
+{
+	fs_.write(static_cast<const char*>(data), std::streamsize(nb_bytes));
+	position_ += nb_bytes;
+}
+
+void SnapshotWriter::align()
+{
+	static const char zeros[PAGE_SIZE] = {};
+	const std::size_t padding = (PAGE_SIZE - position_ % PAGE_SIZE) % PAGE_SIZE;
+	write_bytes(zeros, padding);
+}
+
+SnapshotReader::SnapshotReader(const std::string& filename, SnapshotMode mode) :
+	begin_(nullptr),
+	size_(0u),
+	position_(0u),
+	ok_(false)
+{
+#ifdef CGOGN_SNAPSHOT_MMAP
+	const int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size > 0)
+	{
+		// private mapping: the modifications of the chunks are never written in the file
+		const int prot = mode == SnapshotMode::READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+		void* ptr = mmap(nullptr, std::size_t(st.st_size), prot, MAP_PRIVATE, fd, 0);
+		if (ptr != MAP_FAILED)
+		{
+			begin_ = static_cast<char*>(ptr);
+			size_ = std::size_t(st.st_size);
+		}
+	}
+	close(fd);
+	if (begin_ == nullptr)
+		return;
+	chunk_pool()->add_mapping(begin_, size_, true);
+#else
+	unused_parameters(mode);
+	std::ifstream fs(filename, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!fs.good() || fs.tellg() <= 0)
+		return;
+	size_ = std::size_t(fs.tellg());
+	begin_ = static_cast<char*>(ChunkPool::allocate_mapping(size_));
+	fs.seekg(0);
+	fs.read(begin_, std::streamsize(size_));
+	chunk_pool()->add_mapping(begin_, size_, false);
+	if (!fs.good())
+		return;
+#endif
+	ok_ = true;
+}
+
+SnapshotReader::~SnapshotReader()
+{
+	if (begin_ != nullptr)
+		chunk_pool()->close_mapping(begin_);
+}
+
+bool SnapshotReader::read_header(const std::string& map_type, uint32 chunk_size)
+{
+	const char* magic = read_bytes(sizeof(SNAPSHOT_MAGIC));
+	if (magic == nullptr || !std::equal(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + sizeof(SNAPSHOT_MAGIC), magic))
+		return false;
+	uint32 version = 0u;
+	uint32 endianness = 0u;
+	uint32 file_chunk_size = 0u;
+	std::string file_map_type;
+	return read(version) && version == SnapshotWriter::VERSION &&
+		read(endianness) && endianness == SNAPSHOT_ENDIANNESS &&
+		read(file_chunk_size) && file_chunk_size == chunk_size &&
+		read(file_map_type) && file_map_type == map_type;
+}
+
+bool SnapshotReader::read(std::string& s)
+{
+	uint32 size = 0u;
+	if (!read(size))
+		return false;
+	const char* data = read_bytes(size);
+	if (data == nullptr)
+		return false;
+	s.assign(data, size);
+	return true;
+}
+
+const char* SnapshotReader::read_bytes(std::size_t nb_bytes)
+{
+	if (!ok_ || nb_bytes > size_ - position_)
+	{
+		ok_ = false;
+		return nullptr;
+	}
+	const char* data = begin_ + position_;
+	position_ += nb_bytes;
+	return data;
+}
+
+void SnapshotReader::align()
+{
+	const std::size_t page = SnapshotWriter::PAGE_SIZE;
+	position_ = std::min(size_, ((position_ + page - 1u) / page) * page);
+}
+
+bool SnapshotReader::map_chunks(uint32 nb_chunks, std::size_t chunk_bytes, std::vector<void*>& chunks)
+{
+	char* data = const_cast<char*>(read_bytes(std::size_t(nb_chunks) * chunk_bytes));
+	if (data == nullptr)
+		return false;
+	ChunkPool* pool = chunk_pool();
+	chunks.reserve(chunks.size() + nb_chunks);
+	for (uint32 i = 0u; i < nb_chunks; ++i)
+		chunks.push_back(pool->map_block(data + std::size_t(i) * chunk_bytes));
+	return true;
+}
+
+} // namespace cgogn
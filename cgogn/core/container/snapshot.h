@@ -0,0 +1,236 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_CONTAINER_SNAPSHOT_H_
+#define CGOGN_CORE_CONTAINER_SNAPSHOT_H_
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cgogn/core/cgogn_core_export.h>
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/definitions.h>
+#include <cgogn/core/container/chunk_array_gen.h>
+#include <cgogn/core/container/chunk_pool.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief how the chunks of a snapshot are mapped in memory when it is loaded
+ * COPY_ON_WRITE: the chunks can be modified, the modified pages are copied (the file is never modified)
+ * READ_ONLY: the chunks can not be modified (writing in an attribute of the loaded map crashes)
+ */
+enum class SnapshotMode : uint8
+{
+	COPY_ON_WRITE = 0,
+	READ_ONLY
+};
+
+/**
+ * @brief Writer of snapshot files (.cgogn)
+ * A snapshot stores the containers of a map in the native binary format: the chunks of the
+ * trivially copyable chunk arrays are written as they are in memory, aligned on pages, so that
+ * they can be used in place once the file is mapped in memory (cf. SnapshotReader).
+ */
+class CGOGN_CORE_EXPORT SnapshotWriter final
+{
+public:
+
+	static const uint32 VERSION = 1u;
+	static const std::size_t PAGE_SIZE = 4096u;
+
+	SnapshotWriter(const std::string& filename);
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(SnapshotWriter);
+
+	inline bool good() const { return fs_.good(); }
+
+	/**
+	 * @brief write the header of the file: magic number, version, endianness, chunk size and map type
+	 */
+	void write_header(const std::string& map_type, uint32 chunk_size);
+
+	template <typename T>
+	inline void write(const T& value)
+	{
+		write_bytes(&value, sizeof(T));
+	}
+
+	void write(const std::string& s);
+
+	void write_bytes(const void* data, std::size_t nb_bytes);
+
+	/**
+	 * @brief pad the file with zeros up to the next page
+	 */
+	void align();
+
+private:
+
+	std::ofstream fs_;
+	std::size_t position_;
+};
+
+/**
+ * @brief Reader of snapshot files (.cgogn)
+ * The file is mapped in memory (read in memory where mmap is not available) and the mapping
+ * is handed over to the chunk pool: the chunks taken with map_chunks point straight into it
+ * and the mapping lives until the last of these chunks is released.
+ */
+class CGOGN_CORE_EXPORT SnapshotReader final
+{
+public:
+
+	SnapshotReader(const std::string& filename, SnapshotMode mode);
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(SnapshotReader);
+	~SnapshotReader();
+
+	/**
+	 * @brief false if the file could not be mapped or if a read went past its end
+	 */
+	inline bool good() const { return ok_; }
+
+	/**
+	 * @brief read and check the header written by SnapshotWriter::write_header
+	 */
+	bool read_header(const std::string& map_type, uint32 chunk_size);
+
+	template <typename T>
+	inline bool read(T& value)
+	{
+		const char* data = read_bytes(sizeof(T));
+		if (data != nullptr)
+			std::memcpy(&value, data, sizeof(T));
+		return data != nullptr;
+	}
+
+	bool read(std::string& s);
+
+	/**
+	 * @brief get the address of the next nb_bytes of the file and skip them
+	 * @return nullptr if the file is too short
+	 */
+	const char* read_bytes(std::size_t nb_bytes);
+
+	/**
+	 * @brief skip the padding up to the next page
+	 */
+	void align();
+
+	/**
+	 * @brief take nb_chunks blocks of chunk_bytes bytes at the current position of the mapping
+	 * The blocks can be given to ChunkArrayGen::set_chunks.
+	 * @return false if the file is too short
+	 */
+	bool map_chunks(uint32 nb_chunks, std::size_t chunk_bytes, std::vector<void*>& chunks);
+
+private:
+
+	char* begin_;
+	std::size_t size_;
+	std::size_t position_;
+	bool ok_;
+};
+
+/**
+ * @brief write the chunks of a chunk array
+ * The chunks of the arrays that can be copied bytewise (cf. is_raw_copyable), e.g. the arrays of
+ * scalars or of fixed size vectors, are written as they are (one page aligned block),
+ * the other arrays are serialized (cf. ChunkArrayGen::save).
+ * @param nb_lines the number of lines to serialize for the arrays that can not be copied bytewise
+ */
+template <uint32 CHUNK_SIZE>
+void save_chunk_array(SnapshotWriter& w, const ChunkArrayGen<CHUNK_SIZE>* ca, uint32 nb_lines)
+{
+	const uint8 raw = ca->is_trivially_copyable() ? 1u : 0u;
+	w.write(raw);
+	if (raw)
+	{
+		uint32 chunk_bytes = 0u;
+		const std::vector<const void*> chunks = ca->chunks_pointers(chunk_bytes);
+		w.write(uint32(ca->chunk_bytes()));
+		w.write(uint32(chunks.size()));
+		w.align();
+		for (const void* chunk : chunks)
+			w.write_bytes(chunk, ca->chunk_bytes());
+	}
+	else
+	{
+		std::ostringstream oss(std::ios::binary);
+		ca->save(oss, nb_lines);
+		const std::string data = oss.str();
+		w.write(uint64(data.size()));
+		w.write_bytes(data.data(), data.size());
+	}
+}
+
+/**
+ * @brief read the chunks of a chunk array written by save_chunk_array
+ * The chunks of the arrays that can be copied bytewise point into the mapping of the reader.
+ * @param ca the array to fill (nullptr to skip the array)
+ * @return false if the file is corrupted or if its chunks do not fit the array
+ */
+template <uint32 CHUNK_SIZE>
+bool load_chunk_array(SnapshotReader& r, ChunkArrayGen<CHUNK_SIZE>* ca)
+{
+	uint8 raw = 0u;
+	if (!r.read(raw))
+		return false;
+	if (ca != nullptr && (raw != 0u) != ca->is_trivially_copyable())
+		return false;
+
+	if (raw)
+	{
+		uint32 chunk_bytes = 0u;
+		uint32 nb_chunks = 0u;
+		if (!r.read(chunk_bytes) || !r.read(nb_chunks))
+			return false;
+		if (ca != nullptr && chunk_bytes != ca->chunk_bytes())
+			return false;
+		r.align();
+		if (ca == nullptr)
+			return r.read_bytes(std::size_t(nb_chunks) * chunk_bytes) != nullptr;
+		std::vector<void*> chunks;
+		if (!r.map_chunks(nb_chunks, chunk_bytes, chunks))
+			return false;
+		return ca->set_chunks(chunks);
+	}
+
+	uint64 nb_bytes = 0u;
+	if (!r.read(nb_bytes))
+		return false;
+	const char* data = r.read_bytes(std::size_t(nb_bytes));
+	if (data == nullptr)
+		return false;
+	if (ca == nullptr)
+		return true;
+	std::istringstream iss(std::string(data, std::size_t(nb_bytes)), std::ios::binary);
+	return ca->load(iss);
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_CONTAINER_SNAPSHOT_H_
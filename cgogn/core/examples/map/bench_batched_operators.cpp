@@ -0,0 +1,122 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap2_builder.h>
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 GRID_SIZE = 500u;
+
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+using Face = CMap2::Face;
+
+// GRID_SIZE x GRID_SIZE grid of quads with embedded vertices, edges and faces
+void build_grid(CMap2& map)
+{
+	CMap2Builder_T<CMap2> builder(map);
+	std::vector<Dart> quads(GRID_SIZE * GRID_SIZE);
+	for (Dart& d : quads)
+		d = builder.add_face_topo_fp(4u);
+
+	for (uint32 j = 0u; j < GRID_SIZE; ++j)
+	{
+		for (uint32 i = 0u; i < GRID_SIZE; ++i)
+		{
+			const Dart d = quads[j * GRID_SIZE + i];
+			if (i + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(d), map.phi_1(quads[j * GRID_SIZE + i + 1u]));
+			if (j + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(map.phi1(d)), quads[(j + 1u) * GRID_SIZE + i]);
+		}
+	}
+	builder.close_map();
+
+	map.add_attribute<float64, Vertex>("vertices");
+	map.add_attribute<float64, Edge>("edges");
+	map.add_attribute<float64, Face>("faces");
+}
+
+std::vector<Edge> all_edges(const CMap2& map)
+{
+	std::vector<Edge> edges;
+	map.foreach_cell([&] (Edge e) { edges.push_back(e); });
+	return edges;
+}
+
+// one cut per quad, between its first and third darts
+std::vector<std::pair<Dart, Dart>> all_cuts(const CMap2& map)
+{
+	std::vector<std::pair<Dart, Dart>> cuts;
+	map.foreach_cell([&] (Face f) { cuts.push_back(std::make_pair(f.dart, map.phi1(map.phi1(f.dart)))); });
+	return cuts;
+}
+
+template <typename F>
+float64 timed(const F& f)
+{
+	const auto start = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+int main()
+{
+	thread_start(0, 0);
+
+	float64 sequential[3];
+	float64 batched[3];
+	{
+		CMap2 map;
+		build_grid(map);
+		const std::vector<Edge> edges = all_edges(map);
+		sequential[0] = timed([&] () { for (Edge e : edges) map.cut_edge(e); });
+		sequential[1] = timed([&] () { for (Edge e : edges) map.flip_edge(e); });
+		const std::vector<std::pair<Dart, Dart>> cuts = all_cuts(map);
+		sequential[2] = timed([&] () { for (const auto& c : cuts) map.cut_face(c.first, c.second); });
+	}
+	{
+		CMap2 map;
+		build_grid(map);
+		const std::vector<Edge> edges = all_edges(map);
+		batched[0] = timed([&] () { map.cut_edges(edges); });
+		batched[1] = timed([&] () { map.flip_edges(edges); });
+		const std::vector<std::pair<Dart, Dart>> cuts = all_cuts(map);
+		batched[2] = timed([&] () { map.cut_faces(cuts); });
+	}
+
+	const char* names[3] = { "cut_edge", "flip_edge", "cut_face" };
+	cgogn_log_info("bench_batched_operators") << thread_pool()->nb_workers() << " workers";
+	for (uint32 i = 0u; i < 3u; ++i)
+		cgogn_log_info("bench_batched_operators") << names[i] << ": sequential " << sequential[i] << " ms, batched " << batched[i] << " ms";
+
+	thread_stop();
+	return 0;
+}
@@ -0,0 +1,123 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap1.h>
+#include <cgogn/core/cmap/cmap2.h>
+
+#include <chrono>
+#include <array>
+#include <memory>
+#include <vector>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 NB_POLYLINES = 2000u;
+const uint32 POLYLINE_SIZE = 20u;
+const uint32 NB_FACES = 200000u;
+const uint32 NB_REPEAT = 10u;
+
+using Vec3 = std::array<float64, 3>;
+
+template <uint32 SIZE>
+struct CMap1Traits
+{
+	using TYPE = CMap1_T<CMap1Traits<SIZE>>;
+	static const uint32 CHUNK_SIZE = SIZE;
+};
+
+template <uint32 SIZE>
+struct CMap2Traits
+{
+	using TYPE = CMap2_T<CMap2Traits<SIZE>>;
+	static const uint32 CHUNK_SIZE = SIZE;
+};
+
+// memory (in MB) used by many small maps with one vertex attribute
+template <uint32 SIZE>
+float64 bench_memory()
+{
+	using Map = CMap1_T<CMap1Traits<SIZE>>;
+	using Vertex = typename Map::Vertex;
+
+	const std::size_t before = chunk_pool()->stats().used_bytes;
+
+	std::vector<std::unique_ptr<Map>> maps;
+	for (uint32 i = 0u; i < NB_POLYLINES; ++i)
+	{
+		maps.push_back(make_unique<Map>());
+		maps.back()->template add_attribute<Vec3, Vertex>("position");
+		maps.back()->add_face(POLYLINE_SIZE);
+	}
+
+	return float64(chunk_pool()->stats().used_bytes - before) / (1024.0 * 1024.0);
+}
+
+// time (in ms) of NB_REPEAT sequential and parallel traversals of the faces of a large map
+template <uint32 SIZE>
+std::array<float64, 2> bench_traversal()
+{
+	using Map = CMap2_T<CMap2Traits<SIZE>>;
+	using Face = typename Map::Face;
+
+	Map map;
+	typename Map::template FaceAttribute<Vec3> att = map.template add_attribute<Vec3, Face>("att");
+	for (uint32 i = 0u; i < NB_FACES; ++i)
+		map.add_face(4u);
+
+	std::array<float64, 2> res;
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32 r = 0u; r < NB_REPEAT; ++r)
+		map.foreach_cell([&] (Face f) { Vec3& v = att[f]; v[0] += 1.0; v[1] = v[0] * 0.5; v[2] = v[1] + v[0]; });
+	auto end = std::chrono::steady_clock::now();
+	res[0] = std::chrono::duration<float64, std::milli>(end - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (uint32 r = 0u; r < NB_REPEAT; ++r)
+		map.parallel_foreach_cell([&] (Face f) { Vec3& v = att[f]; v[0] += 1.0; v[1] = v[0] * 0.5; v[2] = v[1] + v[0]; });
+	end = std::chrono::steady_clock::now();
+	res[1] = std::chrono::duration<float64, std::milli>(end - start).count();
+
+	return res;
+}
+
+template <uint32 SIZE>
+void bench()
+{
+	const float64 mem = bench_memory<SIZE>();
+	const std::array<float64, 2> t = bench_traversal<SIZE>();
+	cgogn_log_info("bench_chunk_size") << "CHUNK_SIZE " << SIZE << ": "
+		<< NB_POLYLINES << " small maps use " << mem << " MB / "
+		<< "foreach_cell " << t[0] << " ms / parallel_foreach_cell " << t[1] << " ms";
+}
+
+int main()
+{
+	bench<64u>();
+	bench<512u>();
+	bench<4096u>();
+	bench<16384u>();
+
+	return 0;
+}
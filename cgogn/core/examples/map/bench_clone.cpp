@@ -0,0 +1,108 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap2_builder.h>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 GRID_SIZE = 1000u;
+const uint32 NB_RUNS = 5u;
+
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+using Face = CMap2::Face;
+
+// GRID_SIZE x GRID_SIZE grid of quads with a position per vertex, a scalar per edge and a normal per face
+void build_grid(CMap2& map)
+{
+	CMap2Builder_T<CMap2> builder(map);
+	std::vector<Dart> quads(GRID_SIZE * GRID_SIZE);
+	for (Dart& d : quads)
+		d = builder.add_face_topo_fp(4u);
+
+	for (uint32 j = 0u; j < GRID_SIZE; ++j)
+	{
+		for (uint32 i = 0u; i < GRID_SIZE; ++i)
+		{
+			const Dart d = quads[j * GRID_SIZE + i];
+			if (i + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(d), map.phi_1(quads[j * GRID_SIZE + i + 1u]));
+			if (j + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(map.phi1(d)), quads[(j + 1u) * GRID_SIZE + i]);
+		}
+	}
+	builder.close_map();
+
+	CMap2::VertexAttribute<std::array<float64, 3>> position = map.add_attribute<std::array<float64, 3>, Vertex>("position");
+	CMap2::EdgeAttribute<float64> length = map.add_attribute<float64, Edge>("length");
+	CMap2::FaceAttribute<std::array<float64, 3>> normal = map.add_attribute<std::array<float64, 3>, Face>("normal");
+	map.foreach_cell([&] (Vertex v) { position[v] = {{ float64(v.dart.index), 0.0, 1.0 }}; });
+	map.foreach_cell([&] (Edge e) { length[e] = 1.0; });
+	map.foreach_cell([&] (Face f) { normal[f] = {{ 0.0, 0.0, 1.0 }}; });
+}
+
+template <typename F>
+float64 timed(const F& f)
+{
+	const auto start = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+int main()
+{
+	thread_start(0, 0);
+
+	CMap2 map;
+	build_grid(map);
+
+	float64 merge = 0.0;
+	float64 clone = 0.0;
+	for (uint32 i = 0u; i < NB_RUNS; ++i)
+	{
+		merge += timed([&] ()
+		{
+			CMap2 copy;
+			CMap2::DartMarker dm(copy);
+			copy.merge(map, dm);
+		});
+		clone += timed([&] ()
+		{
+			std::unique_ptr<CMap2> copy = map.clone();
+		});
+	}
+
+	cgogn_log_info("bench_clone") << map.nb_darts() << " darts, " << thread_pool()->nb_workers() << " workers";
+	cgogn_log_info("bench_clone") << "merge: " << merge / NB_RUNS << " ms, clone: " << clone / NB_RUNS << " ms";
+
+	thread_stop();
+	return 0;
+}
@@ -0,0 +1,146 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap2_builder.h>
+#include <cgogn/core/cmap/frozen_topology.h>
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 GRID_SIZE = 1000u;
+const uint32 NB_ITERATIONS = 5u;
+
+using Vertex = CMap2::Vertex;
+using Face = CMap2::Face;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+
+// GRID_SIZE x GRID_SIZE grid of quads
+void build_grid(CMap2& map)
+{
+	CMap2Builder_T<CMap2> builder(map);
+	std::vector<Dart> quads(GRID_SIZE * GRID_SIZE);
+	for (Dart& d : quads)
+		d = builder.add_face_topo_fp(4u);
+
+	for (uint32 j = 0u; j < GRID_SIZE; ++j)
+	{
+		for (uint32 i = 0u; i < GRID_SIZE; ++i)
+		{
+			const Dart d = quads[j * GRID_SIZE + i];
+			if (i + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(d), map.phi_1(quads[j * GRID_SIZE + i + 1u]));
+			if (j + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(map.phi1(d)), quads[(j + 1u) * GRID_SIZE + i]);
+		}
+	}
+	builder.close_map();
+}
+
+// NB_ITERATIONS steps of laplacian smoothing of a scalar field
+template <typename MAP>
+float64 smooth(const MAP& map, VertexAttribute<float64>& value, VertexAttribute<float64>& tmp)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32 i = 0u; i < NB_ITERATIONS; ++i)
+	{
+		map.foreach_cell([&] (Vertex v)
+		{
+			float64 sum = 0.0;
+			uint32 nb = 0u;
+			map.foreach_adjacent_vertex_through_edge(v, [&] (Vertex av)
+			{
+				sum += value[av];
+				++nb;
+			});
+			tmp[v] = sum / nb;
+		});
+		std::swap(value, tmp);
+	}
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+// NB_ITERATIONS computations of the mean of the field on each face
+template <typename MAP>
+float64 face_means(const MAP& map, const VertexAttribute<float64>& value, float64& total)
+{
+	total = 0.0;
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32 i = 0u; i < NB_ITERATIONS; ++i)
+	{
+		map.foreach_cell([&] (Face f)
+		{
+			float64 sum = 0.0;
+			map.foreach_incident_vertex(f, [&] (Vertex v) { sum += value[v]; });
+			total += sum / map.codegree(f);
+		});
+	}
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+int main()
+{
+	thread_start(0, 0);
+
+	CMap2 map;
+	build_grid(map);
+	VertexAttribute<float64> value = map.add_attribute<float64, Vertex>("value");
+	VertexAttribute<float64> tmp = map.add_attribute<float64, Vertex>("tmp");
+
+	auto init_values = [&] ()
+	{
+		uint32 i = 0u;
+		map.foreach_cell([&] (Vertex v) { value[v] = float64(i++ % 7u); });
+	};
+
+	float64 map_total = 0.0, frozen_total = 0.0;
+
+	init_values();
+	const float64 map_smooth = smooth(map, value, tmp);
+	const float64 map_means = face_means(map, value, map_total);
+
+	const auto start = std::chrono::steady_clock::now();
+	FrozenTopology<CMap2> frozen(map);
+	const auto end = std::chrono::steady_clock::now();
+	const float64 freeze = std::chrono::duration<float64, std::milli>(end - start).count();
+
+	init_values();
+	const float64 frozen_smooth = smooth(frozen, value, tmp);
+	const float64 frozen_means = face_means(frozen, value, frozen_total);
+
+	cgogn_log_info("bench_frozen_topology") << "snapshot built in " << freeze << " ms";
+	cgogn_log_info("bench_frozen_topology") << "smoothing: map " << map_smooth << " ms / frozen " << frozen_smooth << " ms";
+	cgogn_log_info("bench_frozen_topology") << "face means: map " << map_means << " ms / frozen " << frozen_means << " ms";
+	if (map_total != frozen_total)
+		cgogn_log_warning("bench_frozen_topology") << "different results: " << map_total << " / " << frozen_total;
+
+	thread_stop();
+	return 0;
+}
@@ -0,0 +1,159 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap2_builder.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 GRID_SIZE = 1000u;
+const uint32 NB_QUERIES = 2000u;
+const uint32 NB_RINGS = 3u;
+
+using Vertex = CMap2::Vertex;
+using Face = CMap2::Face;
+
+// GRID_SIZE x GRID_SIZE grid of quads
+void build_grid(CMap2& map)
+{
+	CMap2Builder_T<CMap2> builder(map);
+	std::vector<Dart> quads(GRID_SIZE * GRID_SIZE);
+	for (Dart& d : quads)
+		d = builder.add_face_topo_fp(4u);
+
+	for (uint32 j = 0u; j < GRID_SIZE; ++j)
+	{
+		for (uint32 i = 0u; i < GRID_SIZE; ++i)
+		{
+			const Dart d = quads[j * GRID_SIZE + i];
+			if (i + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(d), map.phi_1(quads[j * GRID_SIZE + i + 1u]));
+			if (j + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(map.phi1(d)), quads[(j + 1u) * GRID_SIZE + i]);
+		}
+	}
+	builder.close_map();
+}
+
+// collect the faces of the NB_RINGS-ring of the given face (the marker is created for each query)
+template <typename MARKER, typename MARK, typename IS_MARKED>
+uint32 ring_query(const CMap2& map, Face f, const MARK& mark, const IS_MARKED& is_marked, std::vector<Face>& ring)
+{
+	MARKER marker(map);
+	ring.clear();
+	ring.push_back(f);
+	mark(marker, f);
+	std::size_t begin = 0u;
+	for (uint32 r = 0u; r < NB_RINGS; ++r)
+	{
+		const std::size_t end = ring.size();
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			map.foreach_dart_of_orbit(ring[i], [&] (Dart d)
+			{
+				map.foreach_incident_face(Vertex(d), [&] (Face af)
+				{
+					if (!is_marked(marker, af))
+					{
+						mark(marker, af);
+						ring.push_back(af);
+					}
+				});
+			});
+		}
+		begin = end;
+	}
+	return uint32(ring.size());
+}
+
+// time (in ms) of NB_QUERIES ring queries
+template <typename MARKER, typename MARK, typename IS_MARKED>
+float64 bench(const CMap2& map, const std::vector<Face>& seeds, const MARK& mark, const IS_MARKED& is_marked, uint32& nb_faces)
+{
+	std::vector<Face> ring;
+	nb_faces = 0u;
+	const auto start = std::chrono::steady_clock::now();
+	for (Face f : seeds)
+		nb_faces += ring_query<MARKER>(map, f, mark, is_marked, ring);
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+template <typename MARKER>
+float64 bench_dart_marker(const CMap2& map, const std::vector<Face>& seeds, uint32& nb_faces)
+{
+	return bench<MARKER>(map, seeds,
+		[] (MARKER& m, Face f) { m.mark_orbit(f); },
+		[] (const MARKER& m, Face f) { return m.is_marked(f.dart); },
+		nb_faces
+	);
+}
+
+template <typename MARKER>
+float64 bench_cell_marker(const CMap2& map, const std::vector<Face>& seeds, uint32& nb_faces)
+{
+	return bench<MARKER>(map, seeds,
+		[] (MARKER& m, Face f) { m.mark(f); },
+		[] (const MARKER& m, Face f) { return m.is_marked(f); },
+		nb_faces
+	);
+}
+
+int main()
+{
+	CMap2 map;
+	build_grid(map);
+	map.add_attribute<uint32, Face>("face_id");
+
+	std::vector<Face> faces;
+	map.foreach_cell([&] (Face f) { faces.push_back(f); });
+	std::vector<Face> seeds(NB_QUERIES);
+	std::mt19937 gen(42u);
+	std::uniform_int_distribution<std::size_t> dist(0u, faces.size() - 1u);
+	for (Face& f : seeds)
+		f = faces[dist(gen)];
+
+	cgogn_log_info("bench_markers") << map.nb_darts() << " darts, " << NB_QUERIES << " queries of the " << NB_RINGS << "-ring of a face";
+
+	uint32 nb = 0u;
+	float64 t = bench_dart_marker<CMap2::DartMarker>(map, seeds, nb);
+	cgogn_log_info("bench_markers") << "DartMarker: " << t << " ms (" << nb << " faces)";
+	t = bench_dart_marker<CMap2::DartMarkerStore>(map, seeds, nb);
+	cgogn_log_info("bench_markers") << "DartMarkerStore: " << t << " ms (" << nb << " faces)";
+	t = bench_dart_marker<CMap2::DartMarkerEpoch>(map, seeds, nb);
+	cgogn_log_info("bench_markers") << "DartMarkerEpoch: " << t << " ms (" << nb << " faces)";
+
+	t = bench_cell_marker<CMap2::CellMarker<Face::ORBIT>>(map, seeds, nb);
+	cgogn_log_info("bench_markers") << "CellMarker: " << t << " ms (" << nb << " faces)";
+	t = bench_cell_marker<CMap2::CellMarkerStore<Face::ORBIT>>(map, seeds, nb);
+	cgogn_log_info("bench_markers") << "CellMarkerStore: " << t << " ms (" << nb << " faces)";
+	t = bench_cell_marker<CMap2::CellMarkerEpoch<Face::ORBIT>>(map, seeds, nb);
+	cgogn_log_info("bench_markers") << "CellMarkerEpoch: " << t << " ms (" << nb << " faces)";
+
+	return 0;
+}
@@ -0,0 +1,159 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap2_builder.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 GRID_SIZE = 1000u;
+const uint32 NB_ITERATIONS = 5u;
+
+using Vertex = CMap2::Vertex;
+using Face = CMap2::Face;
+template <typename T>
+using VertexAttribute = CMap2::VertexAttribute<T>;
+using Vec3 = std::array<float64, 3>;
+
+// accumulates the results of the traversals so that they are not optimized out
+float64 checksum = 0.0;
+
+// GRID_SIZE x GRID_SIZE grid of quads
+void build_grid(CMap2& map, VertexAttribute<Vec3>& position)
+{
+	CMap2Builder_T<CMap2> builder(map);
+	std::vector<Dart> quads(GRID_SIZE * GRID_SIZE);
+	for (Dart& d : quads)
+		d = builder.add_face_topo_fp(4u);
+
+	for (uint32 j = 0u; j < GRID_SIZE; ++j)
+	{
+		for (uint32 i = 0u; i < GRID_SIZE; ++i)
+		{
+			const Dart d = quads[j * GRID_SIZE + i];
+			if (i + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(d), map.phi_1(quads[j * GRID_SIZE + i + 1u]));
+			if (j + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(map.phi1(d)), quads[(j + 1u) * GRID_SIZE + i]);
+		}
+	}
+	builder.close_map();
+
+	position = map.add_attribute<Vec3, Vertex>("position");
+	for (uint32 j = 0u; j < GRID_SIZE; ++j)
+	{
+		for (uint32 i = 0u; i < GRID_SIZE; ++i)
+		{
+			const Dart d = quads[j * GRID_SIZE + i];
+			position[Vertex(d)] = {{ float64(i), float64(j), 0.0 }};
+			position[Vertex(map.phi1(d))] = {{ float64(i + 1u), float64(j), 0.0 }};
+			position[Vertex(map.phi1(map.phi1(d)))] = {{ float64(i + 1u), float64(j + 1u), 0.0 }};
+			position[Vertex(map.phi_1(d))] = {{ float64(i), float64(j + 1u), 0.0 }};
+		}
+	}
+}
+
+// NB_ITERATIONS steps of laplacian smoothing of the positions followed by the computation of the face centers
+float64 traversals(const CMap2& map, VertexAttribute<Vec3>& position, VertexAttribute<Vec3>& tmp)
+{
+	float64 total = 0.0;
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32 i = 0u; i < NB_ITERATIONS; ++i)
+	{
+		map.foreach_cell([&] (Vertex v)
+		{
+			Vec3 sum = {{ 0.0, 0.0, 0.0 }};
+			uint32 nb = 0u;
+			map.foreach_adjacent_vertex_through_edge(v, [&] (Vertex av)
+			{
+				for (uint32 k = 0u; k < 3u; ++k)
+					sum[k] += position[av][k];
+				++nb;
+			});
+			for (uint32 k = 0u; k < 3u; ++k)
+				tmp[v][k] = sum[k] / nb;
+		});
+		std::swap(position, tmp);
+
+		map.foreach_cell([&] (Face f)
+		{
+			map.foreach_incident_vertex(f, [&] (Vertex v) { total += position[v][0]; });
+		});
+	}
+	const auto end = std::chrono::steady_clock::now();
+	checksum += total;
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+template <typename F>
+float64 timed(const F& f)
+{
+	const auto start = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+int main()
+{
+	thread_start(0, 0);
+
+	CMap2 map;
+	VertexAttribute<Vec3> position;
+	build_grid(map, position);
+	VertexAttribute<Vec3> tmp = map.add_attribute<Vec3, Vertex>("tmp");
+
+	// scatter the darts and the vertex lines as after a remeshing
+	auto scatter = [&] ()
+	{
+		std::vector<Vertex> vertices;
+		map.foreach_cell([&] (Vertex v) { vertices.push_back(v); });
+		std::shuffle(vertices.begin(), vertices.end(), std::mt19937(0u));
+		map.reorder(vertices);
+	};
+
+	scatter();
+	const float64 scattered = traversals(map, position, tmp);
+
+	const float64 bfs_time = timed([&] () { map.reorder(); });
+	const float64 bfs = traversals(map, position, tmp);
+
+	scatter();
+	const float64 morton_time = timed([&] () { map.reorder(position); });
+	const float64 morton = traversals(map, position, tmp);
+
+	cgogn_log_info("bench_reorder") << "scattered: " << scattered << " ms";
+	cgogn_log_info("bench_reorder") << "BFS: " << bfs << " ms (reordering " << bfs_time << " ms)";
+	cgogn_log_info("bench_reorder") << "Morton: " << morton << " ms (reordering " << morton_time << " ms)";
+
+	thread_stop();
+	return 0;
+}
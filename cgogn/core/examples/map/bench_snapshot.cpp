@@ -0,0 +1,111 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap2_builder.h>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 GRID_SIZE = 1000u;
+
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+using Face = CMap2::Face;
+
+// GRID_SIZE x GRID_SIZE grid of quads with a position per vertex, a scalar per edge and a normal per face
+void build_grid(CMap2& map)
+{
+	CMap2Builder_T<CMap2> builder(map);
+	std::vector<Dart> quads(GRID_SIZE * GRID_SIZE);
+	for (Dart& d : quads)
+		d = builder.add_face_topo_fp(4u);
+
+	for (uint32 j = 0u; j < GRID_SIZE; ++j)
+	{
+		for (uint32 i = 0u; i < GRID_SIZE; ++i)
+		{
+			const Dart d = quads[j * GRID_SIZE + i];
+			if (i + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(d), map.phi_1(quads[j * GRID_SIZE + i + 1u]));
+			if (j + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(map.phi1(d)), quads[(j + 1u) * GRID_SIZE + i]);
+		}
+	}
+	builder.close_map();
+
+	CMap2::VertexAttribute<std::array<float64, 3>> position = map.add_attribute<std::array<float64, 3>, Vertex>("position");
+	CMap2::EdgeAttribute<float64> length = map.add_attribute<float64, Edge>("length");
+	CMap2::FaceAttribute<std::array<float64, 3>> normal = map.add_attribute<std::array<float64, 3>, Face>("normal");
+	map.foreach_cell([&] (Vertex v) { position[v] = {{ float64(v.dart.index), 0.0, 1.0 }}; });
+	map.foreach_cell([&] (Edge e) { length[e] = 1.0; });
+	map.foreach_cell([&] (Face f) { normal[f] = {{ 0.0, 0.0, 1.0 }}; });
+}
+
+template <typename F>
+float64 timed(const F& f)
+{
+	const auto start = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+int main()
+{
+	thread_start(0, 0);
+
+	const std::string filename("bench_snapshot.cgogn");
+	float64 save = 0.0;
+	uint32 nb_darts = 0u;
+	{
+		CMap2 map;
+		build_grid(map);
+		nb_darts = map.nb_darts();
+		save = timed([&] () { map.save_snapshot(filename); });
+	}
+
+	float64 load = 0.0;
+	float64 traversal = 0.0;
+	{
+		CMap2 map;
+		load = timed([&] () { map.load_snapshot(filename); });
+		// the pages of the file are read on the first access
+		CMap2::VertexAttribute<std::array<float64, 3>> position = map.get_attribute<std::array<float64, 3>, Vertex>("position");
+		float64 sum = 0.0;
+		traversal = timed([&] () { map.foreach_cell([&] (Vertex v) { sum += position[v][0]; }); });
+		cgogn_log_info("bench_snapshot") << "checksum " << sum;
+	}
+	std::remove(filename.c_str());
+
+	cgogn_log_info("bench_snapshot") << nb_darts << " darts";
+	cgogn_log_info("bench_snapshot") << "save: " << save << " ms, load: " << load << " ms, first vertex traversal: " << traversal << " ms";
+
+	thread_stop();
+	return 0;
+}
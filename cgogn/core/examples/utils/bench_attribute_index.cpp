@@ -0,0 +1,79 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/container/chunk_array_container.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 NB_LINES = 10000u;
+const uint32 NB_CYCLES = 20000u;
+
+using Container = ChunkArrayContainer<CGOGN_CHUNK_SIZE, uint32>;
+
+// time (in ms) of NB_CYCLES add / lookup / remove cycles of a temporary attribute
+// in a container that already holds nb_attributes attributes
+float64 bench_cycles(uint32 nb_attributes)
+{
+	Container container;
+	for (uint32 i = 0u; i < NB_LINES; ++i)
+		container.insert_lines<1>();
+
+	std::vector<std::string> names;
+	for (uint32 i = 0u; i < nb_attributes; ++i)
+	{
+		names.push_back("attribute_" + std::to_string(i));
+		container.add_chunk_array<float64>(names.back());
+	}
+
+	uint32 nb_found = 0u;
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32 c = 0u; c < NB_CYCLES; ++c)
+	{
+		ChunkArray<CGOGN_CHUNK_SIZE, float64>* tmp = container.add_chunk_array<float64>("__tmp");
+		for (const std::string& name : names)
+			if (container.has_array(name))
+				++nb_found;
+		if (container.get_chunk_array<float64>("__tmp") == tmp)
+			++nb_found;
+		container.remove_chunk_array(tmp);
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	cgogn_assert(nb_found == NB_CYCLES * (nb_attributes + 1u));
+	unused_parameters(nb_found);
+
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+int main()
+{
+	for (uint32 nb : { 4u, 16u, 64u, 256u })
+		cgogn_log_info("bench_attribute_index") << nb << " attributes: " << bench_cycles(nb) << " ms for " << NB_CYCLES << " add/lookup/remove cycles";
+
+	return 0;
+}
@@ -0,0 +1,81 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <chrono>
+
+#include <cgogn/core/utils/logger.h>
+#include <cgogn/core/utils/parallel_for.h>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+using Logger = logger::Logger;
+
+const uint32 NB_WARNINGS = 20000u;
+
+// warnings emitted by the workers of a parallel loop (as in a surface import with many non-manifold inputs)
+float64 bench_warnings()
+{
+	const auto start = std::chrono::steady_clock::now();
+	parallel_for(0u, NB_WARNINGS, 64u, [] (uint32 b, uint32 e)
+	{
+		for (uint32 i = b; i < e; ++i)
+			cgogn_log_warning("bench_logger") << "non-manifold vertex " << i;
+	});
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+int main()
+{
+	thread_start(0, 0);
+
+	Logger& logger = Logger::get_logger();
+	logger.remove_console_output();
+
+	const float64 t_sync = bench_warnings();
+
+	logger.set_async(true, 4096u, Logger::OverflowPolicy::BLOCK);
+	const float64 t_block = bench_warnings();
+	logger.flush();
+
+	logger.set_async(true, 4096u, Logger::OverflowPolicy::DROP);
+	const float64 t_drop = bench_warnings();
+	const uint64 nb_dropped = logger.nb_dropped_entries();
+	logger.set_async(false);
+
+	logger.set_rate_limit(100u);
+	const float64 t_rate = bench_warnings();
+	logger.set_rate_limit(0u);
+
+	logger.add_console_output();
+	cgogn_log_info("bench_logger") << NB_WARNINGS << " warnings logged (console output disabled, file output cgogn.log)";
+	cgogn_log_info("bench_logger") << "synchronous: " << t_sync << " ms";
+	cgogn_log_info("bench_logger") << "asynchronous (block): " << t_block << " ms";
+	cgogn_log_info("bench_logger") << "asynchronous (drop): " << t_drop << " ms (" << nb_dropped << " dropped)";
+	cgogn_log_info("bench_logger") << "rate limited (100 per second per call site): " << t_rate << " ms";
+
+	thread_stop();
+
+	return 0;
+}
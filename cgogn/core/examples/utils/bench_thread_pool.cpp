@@ -0,0 +1,102 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/container/chunk_array_container.h>
+#include <cgogn/core/utils/parallel_foreach_element.h>
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 NB_LINES = 8000000u;
+const uint32 NB_REPEAT = 10u;
+const uint32 NB_NESTED = 64u;
+
+using Container = ChunkArrayContainer<CGOGN_CHUNK_SIZE, uint32>;
+using ChunkArrayF = ChunkArray<CGOGN_CHUNK_SIZE, float64>;
+
+// time (in ms) of NB_REPEAT parallel traversals of the container
+float64 bench_parallel_foreach_index(const Container& container, ChunkArrayF* values)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32 r = 0u; r < NB_REPEAT; ++r)
+	{
+		container.parallel_foreach_index([values] (uint32 i)
+		{
+			float64& v = (*values)[i];
+			v = std::sqrt(v * v + 1.0) - std::cos(v);
+		});
+	}
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+// parallel loops launched from inside the tasks of another parallel loop
+float64 bench_nested(const Container& container, ChunkArrayF* values)
+{
+	std::vector<uint32> outer(NB_NESTED);
+	const auto start = std::chrono::steady_clock::now();
+	parallel_foreach_element(outer, [&] (uint32&)
+	{
+		container.parallel_foreach_index([values] (uint32 i)
+		{
+			float64& v = (*values)[i];
+			v = std::sqrt(v * v + 1.0) - std::cos(v);
+		});
+	});
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+int main()
+{
+	thread_start(0, 0);
+
+	Container container;
+	ChunkArrayF* values = container.add_chunk_array<float64>("values");
+	for (uint32 i = 0u; i < NB_LINES; ++i)
+		(*values)[container.insert_lines<1>()] = float64(i) * 1e-6;
+
+	ThreadPool* pool = thread_pool();
+	const uint32 max_workers = pool->max_nb_workers();
+
+	pool->set_nb_workers(0u);
+	const float64 ref = bench_parallel_foreach_index(container, values);
+	cgogn_log_info("bench_thread_pool") << "sequential: " << ref << " ms";
+
+	for (uint32 nb = 1u; nb <= max_workers; ++nb)
+	{
+		pool->set_nb_workers(nb);
+		const float64 t = bench_parallel_foreach_index(container, values);
+		const float64 tn = bench_nested(container, values);
+		cgogn_log_info("bench_thread_pool") << nb << " workers: " << t << " ms (speedup " << ref / t << ") / nested: " << tn << " ms";
+	}
+
+	pool->set_nb_workers();
+	thread_stop();
+
+	return 0;
+}
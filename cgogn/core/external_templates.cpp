@@ -53,6 +53,9 @@ template CGOGN_CORE_EXPORT ChunkArrayFactory<CGOGN_CHUNK_SIZE>& chunk_array_fact
 
 template class CGOGN_CORE_EXPORT ChunkStack<CGOGN_CHUNK_SIZE, uint32>;
 
+/// MAP DATA
+template class CGOGN_CORE_EXPORT MapBaseData_T<CGOGN_CHUNK_SIZE>;
+
 /// CMAP0
 template class CGOGN_CORE_EXPORT CMap0_T<CMap0Type>;
 template class CGOGN_CORE_EXPORT CMap0Builder_T<CMap0>;
@@ -96,6 +99,8 @@ template class CGOGN_CORE_EXPORT CellMarkerStore<CMap2, CMap2::Edge::ORBIT>;
 template class CGOGN_CORE_EXPORT CellMarkerStore<CMap2, CMap2::Face::ORBIT>;
 template class CGOGN_CORE_EXPORT CellMarkerStore<CMap2, CMap2::Volume::ORBIT>;
 template class CGOGN_CORE_EXPORT CellCache<CMap2>;
+template class CGOGN_CORE_EXPORT DirtyCellCache<CMap2>;
+template class CGOGN_CORE_EXPORT IncrementalCellCache<CMap2>;
 template class CGOGN_CORE_EXPORT BoundaryCache<CMap2>;
 template class CGOGN_CORE_EXPORT QuickTraversor<CMap2>;
 
@@ -154,6 +159,7 @@ template class CGOGN_CORE_EXPORT CellMarkerStore<CMap3, CMap3::Edge::ORBIT>;
 template class CGOGN_CORE_EXPORT CellMarkerStore<CMap3, CMap3::Face::ORBIT>;
 template class CGOGN_CORE_EXPORT CellMarkerStore<CMap3, CMap3::Volume::ORBIT>;
 template class CGOGN_CORE_EXPORT CellCache<CMap3>;
+template class CGOGN_CORE_EXPORT DirtyCellCache<CMap3>;
 template class CGOGN_CORE_EXPORT BoundaryCache<CMap3>;
 template class CGOGN_CORE_EXPORT QuickTraversor<CMap3>;
 
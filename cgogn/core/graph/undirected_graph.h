@@ -47,6 +47,7 @@ public:
 	friend class MapBase<MAP_TYPE>;
 	friend class UndirectedGraphBuilder_T<Self>;
 	friend class DartMarker_T<Self>;
+	friend class cgogn::DartMarkerEpoch<Self>;
 	friend class cgogn::DartMarkerStore<Self>;
 
 	using CDart = Cell<Orbit::DART>;
@@ -63,14 +64,16 @@ public:
 	using ChunkArray = typename Inherit::template ChunkArray<T>;
 
 	template <typename T>
-	using CDartAttribute = Attribute<T, CDart::ORBIT>;
+	using CDartAttribute = Attribute<T, CDart::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using VertexAttribute = Attribute<T, Vertex::ORBIT>;
+	using VertexAttribute = Attribute<T, Vertex::ORBIT, Inherit::CHUNK_SIZE>;
 	template <typename T>
-	using EdgeAttribute = Attribute<T, Edge::ORBIT>;
+	using EdgeAttribute = Attribute<T, Edge::ORBIT, Inherit::CHUNK_SIZE>;
 
 	using DartMarker = typename cgogn::DartMarker<Self>;
 	using DartMarkerStore = typename cgogn::DartMarkerStore<Self>;
+	using ConcurrentDartMarker = typename cgogn::ConcurrentDartMarker<Self>;
+	using DartMarkerEpoch = typename cgogn::DartMarkerEpoch<Self>;
 	using DartMarkerNoUnmark = typename cgogn::DartMarkerNoUnmark<Self>;
 
 	template <Orbit ORBIT>
@@ -78,6 +81,10 @@ public:
 	template <Orbit ORBIT>
 	using CellMarkerNoUnmark = typename cgogn::CellMarkerNoUnmark<Self, ORBIT>;
 	template <Orbit ORBIT>
+	using ConcurrentCellMarker = typename cgogn::ConcurrentCellMarker<Self, ORBIT>;
+	template <Orbit ORBIT>
+	using CellMarkerEpoch = typename cgogn::CellMarkerEpoch<Self, ORBIT>;
+	template <Orbit ORBIT>
 	using CellMarkerStore = typename cgogn::CellMarkerStore<Self, ORBIT>;
 
 	using CellCache = typename cgogn::CellCache<Self>;
@@ -146,6 +153,7 @@ protected:
 	{
 		(*alpha0_)[d.index] = e;
 		(*alpha0_)[e.index] = d;
+		this->topology_changed();
 	}
 
 	inline void alpha0_unsew(Dart d)
@@ -153,6 +161,7 @@ protected:
 		Dart e = alpha0(d);
 		(*alpha0_)[d.index] = d;
 		(*alpha0_)[e.index] = e;
+		this->topology_changed();
 	}
 
 	/* alpha1 is a permutation */
@@ -164,6 +173,7 @@ protected:
 		(*alpha1_)[e.index] = f;
 		(*alpha_1_)[g.index] = d;
 		(*alpha_1_)[f.index] = e;
+		this->topology_changed();
 	}
 
 	inline void alpha1_unsew(Dart d)
@@ -174,6 +184,7 @@ protected:
 		(*alpha1_)[d.index] = d;
 		(*alpha_1_)[e.index] = f;
 		(*alpha_1_)[d.index] = d;
+		this->topology_changed();
 	}
 
 public:
@@ -645,6 +656,7 @@ public:
 struct UndirectedGraphType
 {
 	using TYPE = UndirectedGraph_T<UndirectedGraphType>;
+	static const uint32 CHUNK_SIZE = CGOGN_CHUNK_SIZE;
 };
 
 using UndirectedGraph = UndirectedGraph_T<UndirectedGraphType>;
@@ -23,6 +23,8 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+
 #include <cgogn/core/basic/cell.h>
 #include <cgogn/core/cmap/cmap2_tri.h>
 #include <cgogn/core/cmap/cmap2_quad.h>
@@ -383,4 +385,48 @@ TYPED_TEST(CellMarkerTest, unmark_all)
 	});
 }
 
+TYPED_TEST(CellMarkerTest, concurrent_marking)
+{
+	using Vertex = typename TypeParam::Vertex;
+
+	typename TypeParam::template ConcurrentCellMarker<Vertex::ORBIT> cmarker(this->map);
+
+	std::atomic<uint32> nb_claimed(0u);
+	this->map.parallel_foreach_dart([&](Dart d)
+	{
+		if (!this->map.is_boundary(d) && cmarker.test_and_mark(Vertex(d)))
+			++nb_claimed;
+	});
+
+	uint32 nb_vertices = 0u;
+	this->map.foreach_cell([&](Vertex v)
+	{
+		++nb_vertices;
+		EXPECT_TRUE(cmarker.is_marked(v));
+	});
+	EXPECT_EQ(nb_claimed, nb_vertices);
+}
+
+TYPED_TEST(CellMarkerTest, epoch_marking)
+{
+	using Vertex = typename TypeParam::Vertex;
+
+	{
+		typename TypeParam::template CellMarkerEpoch<Vertex::ORBIT> emarker(this->map);
+		this->map.foreach_cell([&](Vertex v) { emarker.mark(v); });
+		this->map.foreach_cell([&](Vertex v) { EXPECT_TRUE(emarker.is_marked(v)); });
+	}
+
+	typename TypeParam::template CellMarkerEpoch<Vertex::ORBIT> emarker(this->map);
+	uint32 nb_vertices = 0u;
+	this->map.foreach_cell([&](Vertex v)
+	{
+		EXPECT_FALSE(emarker.is_marked(v));
+		if (nb_vertices++ % 2u == 0u)
+			emarker.mark(v);
+	});
+	emarker.unmark_all();
+	this->map.foreach_cell([&](Vertex v) { EXPECT_FALSE(emarker.is_marked(v)); });
+}
+
 } // namespace cell_marker_test
@@ -23,6 +23,8 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+
 #include <cgogn/core/cmap/cmap2_tri.h>
 #include <cgogn/core/cmap/cmap2_quad.h>
 #include <cgogn/core/cmap/cmap3.h>
@@ -379,4 +381,63 @@ TYPED_TEST(DartMarkerTest, unmark_all)
 	});
 }
 
+TYPED_TEST(DartMarkerTest, concurrent_marking)
+{
+	typename TypeParam::ConcurrentDartMarker cmarker(this->map);
+
+	std::atomic<uint32> nb_claimed(0u);
+	for (uint32 i = 0u; i < 2u; ++i)
+	{
+		// the second traversal does not claim anything
+		this->map.parallel_foreach_dart([&](Dart d)
+		{
+			if (cmarker.test_and_mark(d))
+				++nb_claimed;
+		});
+	}
+
+	uint32 nb_darts = 0u;
+	this->map.foreach_dart([&](Dart d)
+	{
+		++nb_darts;
+		EXPECT_TRUE(cmarker.is_marked(d));
+	});
+	EXPECT_EQ(nb_claimed, nb_darts);
+
+	cmarker.unmark_all();
+	this->map.foreach_dart([&](Dart d)
+	{
+		EXPECT_FALSE(cmarker.is_marked(d));
+	});
+}
+
+TYPED_TEST(DartMarkerTest, epoch_marking)
+{
+	{
+		typename TypeParam::DartMarkerEpoch emarker(this->map);
+		this->map.foreach_dart([&](Dart d) { emarker.mark(d); });
+		this->map.foreach_dart([&](Dart d) { EXPECT_TRUE(emarker.is_marked(d)); });
+		emarker.unmark_all();
+		this->map.foreach_dart([&](Dart d) { EXPECT_FALSE(emarker.is_marked(d)); });
+		this->map.foreach_dart([&](Dart d) { emarker.mark(d); });
+	}
+
+	// the stamp array of the released marker is reused (more times than the number of epochs)
+	Dart first;
+	this->map.foreach_dart([&](Dart d) -> bool { first = d; return false; });
+	for (uint32 i = 0u; i < 70000u; ++i)
+	{
+		typename TypeParam::DartMarkerEpoch emarker(this->map);
+		if (emarker.is_marked(first))
+		{
+			ADD_FAILURE() << "dart marked by a previous marker (iteration " << i << ")";
+			break;
+		}
+		emarker.mark(first);
+	}
+
+	typename TypeParam::DartMarkerEpoch emarker(this->map);
+	this->map.foreach_dart([&](Dart d) { EXPECT_FALSE(emarker.is_marked(d)); });
+}
+
 } // namespace dart_marker_test
@@ -21,6 +21,10 @@
 *                                                                              *
 *******************************************************************************/
 
+#include <algorithm>
+#include <array>
+#include <utility>
+
 #include <gtest/gtest.h>
 
 #include <cgogn/core/cmap/cmap2.h>
@@ -158,6 +162,29 @@ protected:
 			mbuild.new_orbit_embedding(w);
 		});
 	}
+
+	/**
+	 * \brief Check that an incremental cell cache contains each selected cell of the map once
+	 */
+	template <typename CellType, typename SelectionFunction>
+	void check_incremental_cache(const CMap2::IncrementalCellCache& cache, const SelectionFunction& select)
+	{
+		CMap2::DartMarker dm(cmap_);
+		uint32 nb_cached = 0u;
+		cmap_.foreach_cell([&] (CellType c)
+		{
+			EXPECT_TRUE(cmap_.topology_container().used(c.dart.index));
+			EXPECT_FALSE(dm.is_marked(c.dart));
+			EXPECT_TRUE(select(c));
+			dm.mark_orbit(c);
+			++nb_cached;
+		},
+		cache);
+		uint32 nb_selected = 0u;
+		cmap_.foreach_cell([&] (CellType c) { if (select(c)) ++nb_selected; });
+		EXPECT_EQ(nb_cached, nb_selected);
+		EXPECT_EQ(cache.template size<CellType>(), nb_cached);
+	}
 };
 
 /**
@@ -375,6 +402,609 @@ TEST_F(CMap2Test, compact_map)
 //	});
 }
 
+TEST_F(CMap2Test, shrink_map)
+{
+	for (uint32 i = 0u; i < 5000u; ++i)
+		darts_.push_back(cmap_.add_face(4u).dart);
+
+	// fill the pools of mark attributes
+	{
+		CMap2::DartMarker dm(cmap_);
+		CMap2::CellMarker<Vertex::ORBIT> cm(cmap_);
+	}
+
+	for (uint32 i = 100u; i < 5000u; ++i)
+		cmap_.remove_volume(Volume(darts_[i]));
+
+	const uint32 nb_chunks = cmap_.topology_container().get_chunk_array("phi1")->nb_chunks();
+	EXPECT_GT(cmap_.shrink(), 0u);
+	EXPECT_LT(cmap_.topology_container().get_chunk_array("phi1")->nb_chunks(), nb_chunks);
+	EXPECT_TRUE(cmap_.check_map_integrity());
+
+	uint32 nb_faces = 0u;
+	cmap_.foreach_cell([&] (Face) { ++nb_faces; });
+	EXPECT_EQ(nb_faces, 100u);
+
+	// markers can still be used
+	CMap2::DartMarker dm(cmap_);
+	cmap_.foreach_dart([&] (Dart d) { dm.mark(d); });
+	cmap_.foreach_dart([&] (Dart d) { EXPECT_TRUE(dm.is_marked(d)); });
+}
+
+TEST_F(CMap2Test, reorder_map)
+{
+	add_closed_surfaces();
+	std::vector<Volume> volumes;
+	cmap_.foreach_cell([&] (Volume w) { volumes.push_back(w); });
+	for (uint32 i = 0u; i < volumes.size(); i += 3u)
+		cmap_.remove_volume(volumes[i]);
+
+	CMap2::VertexAttribute<int32> att_v = cmap_.get_attribute<int32, Vertex>("vertices");
+	CMap2::EdgeAttribute<int32> att_e = cmap_.get_attribute<int32, Edge>("edges");
+	CMap2::FaceAttribute<int32> att_f = cmap_.get_attribute<int32, Face>("faces");
+	CMap2::VertexAttribute<std::array<float64, 3>> position = cmap_.add_attribute<std::array<float64, 3>, Vertex>("position");
+	int32 value = 0;
+	cmap_.foreach_cell([&] (Vertex v) { att_v[v] = value++; position[v] = {{ float64(std::rand() % 100), float64(std::rand() % 100), 0.0 }}; });
+	cmap_.foreach_cell([&] (Edge e) { att_e[e] = value++; });
+	cmap_.foreach_cell([&] (Face f) { att_f[f] = value++; });
+
+	// the faces with an even value and the vertices of these faces are marked
+	CMap2::DartMarker dm(cmap_);
+	CMap2::CellMarker<Vertex::ORBIT> cm(cmap_);
+	cmap_.foreach_cell([&] (Face f)
+	{
+		if (att_f[f] % 2 == 0)
+		{
+			dm.mark_orbit(f);
+			cmap_.foreach_incident_vertex(f, [&] (Vertex v) { cm.mark(v); });
+		}
+	});
+
+	// each face is described by its value and the values of its incident vertices and edges
+	auto faces_signature = [&] ()
+	{
+		std::vector<std::vector<int32>> signature;
+		cmap_.foreach_cell([&] (Face f)
+		{
+			std::vector<int32> s;
+			cmap_.foreach_incident_vertex(f, [&] (Vertex v) { s.push_back(att_v[v]); });
+			cmap_.foreach_incident_edge(f, [&] (Edge e) { s.push_back(att_e[e]); });
+			std::sort(s.begin(), s.end());
+			s.insert(s.begin(), att_f[f]);
+			signature.push_back(s);
+		});
+		std::sort(signature.begin(), signature.end());
+		return signature;
+	};
+
+	auto check_markers = [&] ()
+	{
+		cmap_.foreach_cell([&] (Face f)
+		{
+			const bool even = att_f[f] % 2 == 0;
+			cmap_.foreach_dart_of_orbit(f, [&] (Dart d) { EXPECT_EQ(dm.is_marked(d), even); });
+			if (even)
+				cmap_.foreach_incident_vertex(f, [&] (Vertex v) { EXPECT_TRUE(cm.is_marked(v)); });
+		});
+	};
+
+	const uint32 nb_darts = cmap_.nb_darts();
+	const uint32 nb_vertices = cmap_.nb_cells<Vertex::ORBIT>();
+	const auto signature = faces_signature();
+
+	cmap_.reorder();
+	EXPECT_TRUE(cmap_.check_map_integrity());
+	EXPECT_EQ(cmap_.topology_container().size(), cmap_.topology_container().end());
+	EXPECT_EQ(cmap_.attribute_container<Vertex::ORBIT>().size(), cmap_.attribute_container<Vertex::ORBIT>().end());
+	EXPECT_EQ(cmap_.nb_darts(), nb_darts);
+	EXPECT_EQ(cmap_.nb_cells<Vertex::ORBIT>(), nb_vertices);
+	EXPECT_TRUE(faces_signature() == signature);
+	check_markers();
+
+	cmap_.reorder<Face>();
+	EXPECT_TRUE(cmap_.check_map_integrity());
+	EXPECT_TRUE(faces_signature() == signature);
+	check_markers();
+
+	cmap_.reorder(position);
+	EXPECT_TRUE(cmap_.check_map_integrity());
+	EXPECT_TRUE(faces_signature() == signature);
+	check_markers();
+
+	// the vertex lines follow the order of the curve
+	uint32 previous = 0u;
+	cmap_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_GE(cmap_.embedding(v), previous);
+		previous = cmap_.embedding(v);
+	});
+}
+
+TEST_F(CMap2Test, reorder_map_with_holes)
+{
+	// the freed chunks are given back to the system
+	chunk_pool()->set_enabled(false);
+
+	for (uint32 i = 0u; i < 3000u; ++i)
+		darts_.push_back(cmap_.add_face(4u).dart);
+	CMap2::VertexAttribute<std::array<float64, 3>> position = cmap_.add_attribute<std::array<float64, 3>, Vertex>("position");
+	cmap_.foreach_cell([&] (Vertex v) { position[v] = {{ float64(std::rand() % 100), float64(std::rand() % 100), 0.0 }}; });
+
+	// the darts of the last faces are moved into the holes of the first ones and the last chunks are freed
+	for (uint32 i = 0u; i < 2000u; ++i)
+		cmap_.remove_volume(Volume(darts_[i]));
+
+	const uint32 nb_darts = cmap_.nb_darts();
+	const uint32 nb_vertices = cmap_.nb_cells<Vertex::ORBIT>();
+	std::vector<std::array<float64, 3>> positions;
+	cmap_.foreach_cell([&] (Vertex v) { positions.push_back(position[v]); });
+	std::sort(positions.begin(), positions.end());
+
+	// the cells are collected before the topology is compacted
+	cmap_.reorder(position);
+	EXPECT_TRUE(cmap_.check_map_integrity());
+	EXPECT_EQ(cmap_.topology_container().size(), cmap_.topology_container().end());
+	EXPECT_EQ(cmap_.nb_darts(), nb_darts);
+	EXPECT_EQ(cmap_.nb_cells<Vertex::ORBIT>(), nb_vertices);
+
+	std::vector<std::array<float64, 3>> reordered_positions;
+	cmap_.foreach_cell([&] (Vertex v) { reordered_positions.push_back(position[v]); });
+	std::sort(reordered_positions.begin(), reordered_positions.end());
+	EXPECT_TRUE(reordered_positions == positions);
+
+	// the darts of each vertex follow those of the previous vertices on the curve
+	uint32 previous = 0u;
+	cmap_.foreach_dart([&] (Dart d)
+	{
+		const uint32 emb = cmap_.embedding(Vertex(d));
+		EXPECT_GE(emb, previous);
+		previous = emb;
+	});
+
+	chunk_pool()->set_enabled(true);
+}
+
+TEST_F(CMap2Test, memory_usage)
+{
+	for (uint32 i = 0u; i < 100u; ++i)
+		cmap_.add_face(4u);
+
+	const MapMemoryUsage before = cmap_.memory_usage();
+	EXPECT_GT(before.topology.total(), 0u);
+	EXPECT_EQ(before.topology.nb_lines, cmap_.nb_darts());
+
+	auto attribute_bytes = [] (const MapMemoryUsage& usage, const std::string& name) -> std::size_t
+	{
+		for (const auto& a : usage.attributes[Vertex::ORBIT].arrays)
+			if (a.name == name)
+				return a.bytes;
+		return 0u;
+	};
+
+	auto darts_per_vertex = cmap_.add_attribute<std::vector<Dart>, Vertex>("__darts_per_vertex");
+	const std::size_t bytes_empty_vectors = attribute_bytes(cmap_.memory_usage(), "__darts_per_vertex");
+	EXPECT_GT(bytes_empty_vectors, 0u);
+	cmap_.foreach_cell([&] (Vertex v)
+	{
+		darts_per_vertex[v].resize(8u);
+		darts_per_vertex[v].shrink_to_fit();
+	});
+
+	// the content of the vectors is accounted
+	const MapMemoryUsage after = cmap_.log_memory_usage(before.total());
+	EXPECT_GT(after.total(), before.total());
+	EXPECT_EQ(attribute_bytes(after, "__darts_per_vertex") - bytes_empty_vectors, cmap_.nb_cells<Vertex::ORBIT>() * 8u * sizeof(Dart));
+
+	// the pooled mark attributes are accounted
+	{
+		CMap2::DartMarker dm(cmap_);
+	}
+	EXPECT_GT(cmap_.memory_usage().mark_pools, 0u);
+}
+
+/**
+ * \brief The maintained cell counters match the number of traversed cells
+ */
+TEST_F(CMap2Test, cell_counters)
+{
+	CMap2 map;
+	map.enable_cell_counter<CDart::ORBIT>();
+	map.enable_cell_counter<Vertex::ORBIT>();
+	map.enable_cell_counter<Edge::ORBIT>();
+	map.enable_cell_counter<Face::ORBIT>();
+	map.enable_cell_counter<Volume::ORBIT>();
+	EXPECT_TRUE(map.is_cell_counter_enabled<Face::ORBIT>());
+
+	auto check_counters = [&map] ()
+	{
+		EXPECT_EQ(map.nb_cells<CDart::ORBIT>(), map.count_cells<CDart::ORBIT>());
+		EXPECT_EQ(map.nb_cells<Vertex::ORBIT>(), map.count_cells<Vertex::ORBIT>());
+		EXPECT_EQ(map.nb_cells<Edge::ORBIT>(), map.count_cells<Edge::ORBIT>());
+		EXPECT_EQ(map.nb_cells<Face::ORBIT>(), map.count_cells<Face::ORBIT>());
+		EXPECT_EQ(map.nb_cells<Volume::ORBIT>(), map.count_cells<Volume::ORBIT>());
+	};
+
+	for (uint32 i = 0u; i < 10u; ++i)
+	{
+		darts_.push_back(map.add_face(3u + i).dart);
+		darts_.push_back(map.add_pyramid(3u + i).dart);
+		darts_.push_back(map.add_prism(3u + i).dart);
+	}
+	EXPECT_EQ(map.nb_cells<Volume::ORBIT>(), 30u);
+	check_counters();
+
+	for (Dart d : darts_)
+	{
+		const Vertex v = map.cut_edge(Edge(d));
+		map.cut_face(v.dart, map.phi1(map.phi1(v.dart)));
+		map.flip_edge(Edge(map.phi1(d)));
+	}
+	check_counters();
+
+	for (Dart d : darts_)
+	{
+		map.merge_incident_faces(Edge(map.phi_1(d)));
+		const Dart e = map.phi1(d);
+		if (map.degree(Vertex(e)) == 2u)
+			map.merge_incident_edges(Vertex(e));
+	}
+	check_counters();
+
+	// operators that do not maintain the counters make them stale
+	map.unsew_faces(Edge(darts_[1]));
+	map.remove_volume(Volume(darts_.back()));
+	check_counters();
+
+	const Volume p = map.add_pyramid(5u);
+	map.collapse_edge(Edge(map.phi1(map.phi2(p.dart))));
+	map.collapse_edge(Edge(map.cut_edge(Edge(darts_.front())).dart));
+	check_counters();
+
+	map.disable_cell_counter<Face::ORBIT>();
+	EXPECT_FALSE(map.is_cell_counter_enabled<Face::ORBIT>());
+	map.add_face(3u);
+	check_counters();
+
+	// embedded orbits use the size of their attribute container
+	map.add_attribute<int32, Vertex>("vertices");
+	EXPECT_EQ(map.nb_cells<Vertex::ORBIT>(), map.count_cells<Vertex::ORBIT>());
+	EXPECT_TRUE(map.check_map_integrity());
+}
+
+/**
+ * \brief Batched operators preserve the cell indexation and the number of attribute elements
+ */
+TEST_F(CMap2Test, batched_operators)
+{
+	add_closed_surfaces();
+
+	auto check_cells = [this] ()
+	{
+		EXPECT_TRUE(cmap_.check_map_integrity());
+		EXPECT_EQ(cmap_.nb_cells<CDart::ORBIT>(), cmap_.count_cells<CDart::ORBIT>());
+		EXPECT_EQ(cmap_.nb_cells<Vertex::ORBIT>(), cmap_.count_cells<Vertex::ORBIT>());
+		EXPECT_EQ(cmap_.nb_cells<Edge::ORBIT>(), cmap_.count_cells<Edge::ORBIT>());
+		EXPECT_EQ(cmap_.nb_cells<Face::ORBIT>(), cmap_.count_cells<Face::ORBIT>());
+		EXPECT_EQ(cmap_.nb_cells<Volume::ORBIT>(), cmap_.count_cells<Volume::ORBIT>());
+	};
+
+	// some edges are given twice
+	std::vector<Edge> edges;
+	for (Dart d : darts_)
+		edges.push_back(Edge(d));
+	for (uint32 i = 0u; i < NB_MAX / 10u; ++i)
+		edges.push_back(Edge(darts_[i]));
+
+	uint32 nb_vertices = cmap_.nb_cells<Vertex::ORBIT>();
+	uint32 nb_edges = cmap_.nb_cells<Edge::ORBIT>();
+	const std::vector<Vertex> vertices = cmap_.cut_edges(edges);
+	EXPECT_EQ(vertices.size(), edges.size());
+	for (Vertex v : vertices)
+		EXPECT_EQ(cmap_.degree(v), 2u);
+	EXPECT_EQ(cmap_.nb_cells<Vertex::ORBIT>(), nb_vertices + uint32(edges.size()));
+	EXPECT_EQ(cmap_.nb_cells<Edge::ORBIT>(), nb_edges + uint32(edges.size()));
+	check_cells();
+
+	// edges of a same face conflict
+	edges.clear();
+	cmap_.foreach_cell([&] (Edge e) { edges.push_back(e); });
+	nb_vertices = cmap_.nb_cells<Vertex::ORBIT>();
+	nb_edges = cmap_.nb_cells<Edge::ORBIT>();
+	cmap_.flip_edges(edges);
+	EXPECT_EQ(cmap_.nb_cells<Vertex::ORBIT>(), nb_vertices);
+	EXPECT_EQ(cmap_.nb_cells<Edge::ORBIT>(), nb_edges);
+	check_cells();
+
+	std::vector<std::pair<Dart, Dart>> cuts;
+	cmap_.foreach_cell([&] (Face f)
+	{
+		if (cmap_.codegree(f) > 3u)
+			cuts.push_back(std::make_pair(f.dart, cmap_.phi1(cmap_.phi1(f.dart))));
+	});
+	nb_edges = cmap_.nb_cells<Edge::ORBIT>();
+	const uint32 nb_faces = cmap_.nb_cells<Face::ORBIT>();
+	const std::vector<Edge> new_edges = cmap_.cut_faces(cuts);
+	EXPECT_EQ(new_edges.size(), cuts.size());
+	for (uint32 i = 0u; i < uint32(cuts.size()); ++i)
+		EXPECT_TRUE(cmap_.same_cell(Vertex(new_edges[i].dart), Vertex(cuts[i].second)));
+	EXPECT_EQ(cmap_.nb_cells<Edge::ORBIT>(), nb_edges + uint32(cuts.size()));
+	EXPECT_EQ(cmap_.nb_cells<Face::ORBIT>(), nb_faces + uint32(cuts.size()));
+	check_cells();
+}
+
+/**
+ * \brief An incremental cell cache stays equal to a rebuilt one across the operators of the map.
+ */
+TEST_F(CMap2Test, incremental_cell_cache)
+{
+	// closed manifold surfaces on which all the operators are sound
+	for (uint32 i = 0u; i < NB_MAX / 10u; ++i)
+		cmap_.add_prism(3u + i);
+
+	auto triangle = [this] (Face f) { return cmap_.codegree(f) == 3u; };
+	auto high_degree = [this] (Vertex v) { return cmap_.degree(v) > 3u; };
+	auto any_edge = [] (Edge) { return true; };
+
+	CMap2::IncrementalCellCache cache(cmap_);
+	cache.build<Face>(triangle);
+	cache.build<Vertex>(high_degree);
+	cache.build<Edge>();
+
+	auto check = [&] ()
+	{
+		EXPECT_TRUE(cmap_.check_map_integrity());
+		check_incremental_cache<Face>(cache, triangle);
+		check_incremental_cache<Vertex>(cache, high_degree);
+		check_incremental_cache<Edge>(cache, any_edge);
+	};
+	check();
+
+	std::vector<Edge> edges;
+	auto collect_edges = [&] ()
+	{
+		edges.clear();
+		cmap_.foreach_cell([&] (Edge e) { edges.push_back(e); });
+	};
+	auto alive = [this] (Dart d) { return cmap_.topology_container().used(d.index); };
+
+	collect_edges();
+	for (uint32 i = 0u; i < uint32(edges.size()); i += 3u)
+		cmap_.cut_edge(edges[i]);
+	check();
+
+	// triangulate the faces (the collapses are only sound on triangle meshes)
+	std::vector<Face> faces;
+	cmap_.foreach_cell([&] (Face f) { faces.push_back(f); });
+	for (Face f : faces)
+	{
+		while (cmap_.codegree(f) > 3u)
+			cmap_.cut_face(cmap_.phi_1(f.dart), cmap_.phi1(f.dart));
+	}
+	check();
+
+	// the collapses and merges only remove darts
+	collect_edges();
+	for (uint32 i = 0u; i < uint32(edges.size()); i += 5u)
+	{
+		if (alive(edges[i].dart) && cmap_.edge_can_collapse(edges[i]))
+			cmap_.collapse_edge(edges[i]);
+	}
+	check();
+
+	collect_edges();
+	for (uint32 i = 0u; i < uint32(edges.size()); i += 2u)
+		cmap_.flip_edge(edges[i]);
+	check();
+
+	collect_edges();
+	for (uint32 i = 0u; i < uint32(edges.size()); i += 7u)
+	{
+		if (alive(edges[i].dart) && !cmap_.same_cell(Face(edges[i].dart), Face(cmap_.phi2(edges[i].dart))))
+			cmap_.merge_incident_faces(edges[i]);
+	}
+	check();
+
+	std::vector<Vertex> vertices;
+	cmap_.foreach_cell([&] (Vertex v) { if (cmap_.degree(v) == 2u) vertices.push_back(v); });
+	for (Vertex v : vertices)
+	{
+		if (alive(v.dart))
+			cmap_.merge_incident_edges(v);
+	}
+	check();
+
+	collect_edges();
+	cmap_.cut_edges(edges);
+	check();
+
+	collect_edges();
+	cmap_.flip_edges(edges);
+	check();
+
+	std::vector<std::pair<Dart, Dart>> cuts;
+	cmap_.foreach_cell([&] (Face f)
+	{
+		if (cmap_.codegree(f) > 3u)
+			cuts.push_back(std::make_pair(f.dart, cmap_.phi1(cmap_.phi1(f.dart))));
+	});
+	cmap_.cut_faces(cuts);
+	check();
+
+	// a removed cell is added again when it changes
+	const std::size_t nb_edges = cache.size<Edge>();
+	ASSERT_GT(nb_edges, 0u);
+	const Edge e(*cache.begin<Edge>());
+	cache.remove(e);
+	EXPECT_EQ(cache.size<Edge>(), nb_edges - 1u);
+	cache.add(e);
+	cache.add(Edge(cmap_.phi2(e.dart)));
+	EXPECT_EQ(cache.size<Edge>(), nb_edges);
+	cache.remove(e);
+	cmap_.cut_edge(e);
+	check();
+
+	// the cache can be emptied as a worklist
+	for (Face f = cache.pop<Face>(); f.is_valid(); f = cache.pop<Face>())
+		EXPECT_TRUE(triangle(f));
+	EXPECT_EQ(cache.size<Face>(), 0u);
+}
+
+/**
+ * \brief An incremental cell cache used as a worklist yields the cells created by the modifications of the map
+ * (followed by the observers or collected by the rebuild that ends each pass) and only selected cells.
+ */
+TEST_F(CMap2Test, incremental_cell_cache_worklist)
+{
+	for (uint32 i = 0u; i < NB_MAX / 10u; ++i)
+		cmap_.add_prism(3u + i);
+
+	auto polygon = [this] (Face f) { return cmap_.codegree(f) > 3u; };
+
+	CMap2::IncrementalCellCache cache(cmap_);
+	cache.build<Face>(polygon);
+	ASSERT_GT(cache.size<Face>(), 0u);
+
+	// each cut leaves a polygon with one edge less, that is popped again until it is a triangle
+	uint32 nb_cuts = 0u;
+	for (Face f = cache.pop<Face>(); f.is_valid(); f = cache.pop<Face>())
+	{
+		ASSERT_TRUE(cmap_.topology_container().used(f.dart.index));
+		ASSERT_TRUE(polygon(f));
+		cmap_.cut_face(cmap_.phi_1(f.dart), cmap_.phi1(f.dart));
+		++nb_cuts;
+	}
+	EXPECT_GT(nb_cuts, 0u);
+	EXPECT_TRUE(cmap_.check_map_integrity());
+	cmap_.foreach_cell([&] (Face f) { EXPECT_EQ(cmap_.codegree(f), 3u); });
+	EXPECT_EQ(cache.size<Face>(), 0u);
+}
+
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+
+/**
+ * \brief Counts the topology events of a map per kind and per orbit.
+ */
+class TopologyEventCounter : public TopologyObserver
+{
+public:
+
+	uint32 nb_flushes = 0u;
+	uint32 nb_removed_darts = 0u;
+	std::array<uint32, NB_ORBITS> nb_removed_cells;
+	std::array<uint32, NB_ORBITS> nb_created_cells;
+	std::array<uint32, NB_ORBITS> nb_modified_cells;
+
+	TopologyEventCounter()
+	{
+		reset();
+	}
+
+	void reset()
+	{
+		nb_flushes = 0u;
+		nb_removed_darts = 0u;
+		nb_removed_cells.fill(0u);
+		nb_created_cells.fill(0u);
+		nb_modified_cells.fill(0u);
+	}
+
+	void darts_removed(const std::vector<Dart>& darts) override
+	{
+		++nb_flushes;
+		nb_removed_darts += uint32(darts.size());
+	}
+
+	void cells_removed(Orbit orbit, const std::vector<uint32>& embeddings) override
+	{
+		nb_removed_cells[orbit] += uint32(embeddings.size());
+	}
+
+	void cells_created(Orbit orbit, const std::vector<Dart>& darts) override
+	{
+		nb_created_cells[orbit] += uint32(darts.size());
+	}
+
+	void cells_modified(Orbit orbit, const std::vector<Dart>& darts) override
+	{
+		nb_modified_cells[orbit] += uint32(darts.size());
+	}
+};
+
+TEST_F(CMap2Test, topology_observer_events)
+{
+	TopologyEventCounter counter;
+	cmap_.add_topology_observer(&counter);
+
+	const Face f = cmap_.add_face(4u);
+	EXPECT_EQ(counter.nb_created_cells[CDart::ORBIT], 4u);
+	EXPECT_EQ(counter.nb_created_cells[Vertex::ORBIT], 4u);
+	EXPECT_EQ(counter.nb_created_cells[Edge::ORBIT], 4u);
+	EXPECT_EQ(counter.nb_created_cells[Face::ORBIT], 1u);
+	EXPECT_EQ(counter.nb_created_cells[Volume::ORBIT], 1u);
+
+	counter.reset();
+	cmap_.cut_edge(Edge(f.dart));
+	EXPECT_EQ(counter.nb_created_cells[CDart::ORBIT], 1u);
+	EXPECT_EQ(counter.nb_created_cells[Vertex::ORBIT], 1u);
+	EXPECT_EQ(counter.nb_created_cells[Edge::ORBIT], 1u);
+	EXPECT_EQ(counter.nb_created_cells[Face::ORBIT], 0u);
+	EXPECT_GT(counter.nb_modified_cells[Edge::ORBIT], 0u);
+	EXPECT_EQ(counter.nb_removed_darts, 0u);
+
+	counter.reset();
+	cmap_.cut_face(f.dart, cmap_.phi1(cmap_.phi1(f.dart)));
+	EXPECT_EQ(counter.nb_created_cells[CDart::ORBIT], 2u);
+	EXPECT_EQ(counter.nb_created_cells[Edge::ORBIT], 1u);
+	EXPECT_EQ(counter.nb_created_cells[Face::ORBIT], 1u);
+	EXPECT_GT(counter.nb_modified_cells[Face::ORBIT], 0u);
+
+	// the removals are reported with the released attribute lines
+	counter.reset();
+	cmap_.remove_volume(Volume(f.dart));
+	EXPECT_EQ(counter.nb_flushes, 1u);
+	EXPECT_EQ(counter.nb_removed_darts, 12u);
+	EXPECT_EQ(counter.nb_removed_cells[CDart::ORBIT], 7u);
+	EXPECT_EQ(counter.nb_removed_cells[Vertex::ORBIT], 5u);
+	EXPECT_EQ(counter.nb_removed_cells[Edge::ORBIT], 6u);
+	EXPECT_EQ(counter.nb_removed_cells[Face::ORBIT], 2u);
+	EXPECT_EQ(counter.nb_removed_cells[Volume::ORBIT], 1u);
+
+	// the collapse of an edge of a triangle mesh removes a vertex, three edges and two faces
+	const Volume prism = cmap_.add_prism(5u);
+	std::vector<Face> faces;
+	cmap_.foreach_incident_face(prism, [&] (Face g) { faces.push_back(g); });
+	for (Face g : faces)
+	{
+		while (cmap_.codegree(g) > 3u)
+			cmap_.cut_face(cmap_.phi_1(g.dart), cmap_.phi1(g.dart));
+	}
+	Edge collapsed;
+	cmap_.foreach_incident_edge(prism, [&] (Edge e) -> bool
+	{
+		if (cmap_.degree(Vertex(e.dart)) > 3u && cmap_.degree(Vertex(cmap_.phi2(e.dart))) > 3u && cmap_.edge_can_collapse(e))
+			collapsed = e;
+		return !collapsed.is_valid();
+	});
+	ASSERT_TRUE(collapsed.is_valid());
+
+	counter.reset();
+	cmap_.collapse_edge(collapsed);
+	EXPECT_TRUE(cmap_.check_map_integrity());
+	EXPECT_EQ(counter.nb_removed_darts, 6u);
+	EXPECT_EQ(counter.nb_removed_cells[Vertex::ORBIT], 1u);
+	EXPECT_EQ(counter.nb_removed_cells[Edge::ORBIT], 3u);
+	EXPECT_EQ(counter.nb_removed_cells[Face::ORBIT], 2u);
+	EXPECT_GT(counter.nb_modified_cells[Vertex::ORBIT], 0u);
+
+	// no event once the observer is removed
+	cmap_.remove_topology_observer(&counter);
+	counter.reset();
+	cmap_.add_face(3u);
+	EXPECT_EQ(counter.nb_created_cells[Face::ORBIT], 0u);
+}
+
+#endif // CGOGN_WITH_TOPOLOGY_OBSERVERS
+
 TEST_F(CMap2Test, merge_map)
 {
 	using CDart = CMap2::CDart;
@@ -426,6 +1056,179 @@ TEST_F(CMap2Test, merge_map)
 	EXPECT_EQ(map1.nb_cells<Volume::ORBIT>(),10u);
 }
 
+/**
+ * \brief The clone of a map has the same darts, cells and attribute values and is independent of its source
+ */
+TEST_F(CMap2Test, clone)
+{
+	add_faces(NB_MAX);
+	add_closed_surfaces();
+	std::vector<Volume> volumes;
+	cmap_.foreach_cell([&] (Volume w) { volumes.push_back(w); });
+	for (uint32 i = 0u; i < volumes.size(); i += 3u)
+		cmap_.remove_volume(volumes[i]);
+	const Dart d0 = volumes[1].dart;
+
+	CMap2::VertexAttribute<int32> vertices = cmap_.get_attribute<int32, Vertex>("vertices");
+	CMap2::FaceAttribute<std::string> names = cmap_.add_attribute<std::string, Face>("names");
+	cmap_.foreach_cell([&] (Vertex v) { vertices[v] = int32(v.dart.index); });
+	cmap_.foreach_cell([&] (Face f) { names[f] = std::to_string(f.dart.index); });
+
+	std::unique_ptr<CMap2> copy = cmap_.clone();
+	EXPECT_TRUE(copy->check_map_integrity());
+	EXPECT_EQ(copy->nb_darts(), cmap_.nb_darts());
+	EXPECT_EQ(copy->nb_cells<Vertex>(), cmap_.nb_cells<Vertex>());
+	EXPECT_EQ(copy->nb_cells<Face>(), cmap_.nb_cells<Face>());
+	EXPECT_EQ(copy->nb_cells<Volume>(), cmap_.nb_cells<Volume>());
+
+	CMap2::VertexAttribute<int32> copy_vertices = copy->get_attribute<int32, Vertex>("vertices");
+	CMap2::FaceAttribute<std::string> copy_names = copy->get_attribute<std::string, Face>("names");
+	EXPECT_TRUE(copy_vertices.is_valid());
+	EXPECT_TRUE(copy_names.is_valid());
+	cmap_.foreach_dart([&] (Dart d)
+	{
+		EXPECT_EQ(copy->phi1(d), cmap_.phi1(d));
+		EXPECT_EQ(copy->phi2(d), cmap_.phi2(d));
+		EXPECT_EQ(copy->is_boundary(d), cmap_.is_boundary(d));
+		EXPECT_EQ(copy->embedding(Vertex(d)), cmap_.embedding(Vertex(d)));
+		EXPECT_EQ(copy_vertices[Vertex(d)], vertices[Vertex(d)]);
+		if (!cmap_.is_boundary(d))
+		{
+			EXPECT_EQ(copy_names[Face(d)], names[Face(d)]);
+		}
+	});
+
+	copy->cut_edge(Edge(d0));
+	copy_vertices[Vertex(d0)] = -1;
+	EXPECT_TRUE(copy->check_map_integrity());
+	EXPECT_EQ(copy->nb_darts(), cmap_.nb_darts() + 2u);
+	EXPECT_NE(vertices[Vertex(d0)], -1);
+}
+
+/**
+ * \brief A map loaded from a snapshot has the same darts, cells and attribute values as the saved map
+ * and the modifications of the loaded map do not change the file
+ */
+TEST_F(CMap2Test, snapshot)
+{
+	const std::string filename("cmap2_test_snapshot.cgogn");
+
+	add_faces(NB_MAX);
+	add_closed_surfaces();
+	std::vector<Volume> volumes;
+	cmap_.foreach_cell([&] (Volume w) { volumes.push_back(w); });
+	for (uint32 i = 0u; i < volumes.size(); i += 3u)
+		cmap_.remove_volume(volumes[i]);
+	const Dart d0 = volumes[1].dart;
+
+	CMap2::VertexAttribute<int32> vertices = cmap_.get_attribute<int32, Vertex>("vertices");
+	CMap2::FaceAttribute<std::string> names = cmap_.add_attribute<std::string, Face>("names");
+	cmap_.foreach_cell([&] (Vertex v) { vertices[v] = int32(v.dart.index); });
+	cmap_.foreach_cell([&] (Face f) { names[f] = std::to_string(f.dart.index); });
+	EXPECT_TRUE(cmap_.save_snapshot(filename));
+
+	for (SnapshotMode mode : { SnapshotMode::COPY_ON_WRITE, SnapshotMode::READ_ONLY })
+	{
+		CMap2 map;
+		EXPECT_TRUE(map.load_snapshot(filename, mode));
+		EXPECT_TRUE(map.check_map_integrity());
+		EXPECT_EQ(map.nb_darts(), cmap_.nb_darts());
+		EXPECT_EQ(map.nb_cells<Vertex>(), cmap_.nb_cells<Vertex>());
+		EXPECT_EQ(map.nb_cells<Face>(), cmap_.nb_cells<Face>());
+		EXPECT_EQ(map.nb_cells<Volume>(), cmap_.nb_cells<Volume>());
+
+		CMap2::VertexAttribute<int32> map_vertices = map.get_attribute<int32, Vertex>("vertices");
+		CMap2::FaceAttribute<std::string> map_names = map.get_attribute<std::string, Face>("names");
+		EXPECT_TRUE(map_vertices.is_valid());
+		EXPECT_TRUE(map_names.is_valid());
+		cmap_.foreach_dart([&] (Dart d)
+		{
+			EXPECT_EQ(map.phi1(d), cmap_.phi1(d));
+			EXPECT_EQ(map.phi2(d), cmap_.phi2(d));
+			EXPECT_EQ(map.is_boundary(d), cmap_.is_boundary(d));
+			EXPECT_EQ(map_vertices[Vertex(d)], vertices[Vertex(d)]);
+			if (!cmap_.is_boundary(d))
+			{
+				EXPECT_EQ(map_names[Face(d)], names[Face(d)]);
+			}
+		});
+
+		if (mode == SnapshotMode::COPY_ON_WRITE)
+		{
+			map.cut_edge(Edge(d0));
+			map_vertices[Vertex(d0)] = -1;
+			EXPECT_TRUE(map.check_map_integrity());
+			EXPECT_EQ(map.nb_darts(), cmap_.nb_darts() + 2u);
+		}
+	}
+
+	CMap2 map;
+	EXPECT_FALSE(map.load_snapshot("cmap2_test_no_snapshot.cgogn"));
+	std::remove(filename.c_str());
+}
+
+/**
+ * \brief The chunk range traversals visit the same cells from the same darts as the marking traversals
+ */
+TEST_F(CMap2Test, chunk_range_traversal)
+{
+	add_faces(NB_MAX);
+	add_closed_surfaces();
+	for (Dart d : darts_)
+		cmap_.cut_edge(Edge(d));
+
+	const uint32 nb_lines = cmap_.topology_container().end();
+
+	std::vector<uint32> marking(nb_lines, 0u);
+	cmap_.foreach_cell<FORCE_DART_MARKING>([&] (Vertex v) { marking[v.dart.index] += 1u; });
+	cmap_.foreach_cell<FORCE_CELL_MARKING>([&] (Face f) { marking[f.dart.index] += 2u; });
+
+	std::vector<uint32> chunk_range(nb_lines, 0u);
+	cmap_.foreach_cell<FORCE_CHUNK_RANGE>([&] (Vertex v) { chunk_range[v.dart.index] += 1u; });
+	cmap_.foreach_cell<FORCE_CHUNK_RANGE>([&] (Face f) { chunk_range[f.dart.index] += 2u; });
+	EXPECT_EQ(marking, chunk_range);
+
+	// each dart is the representative of at most one cell of each orbit: no concurrent write on the same line
+	std::vector<uint32> parallel_chunk_range(nb_lines, 0u);
+	cmap_.parallel_foreach_cell<FORCE_CHUNK_RANGE>([&] (Vertex v) { parallel_chunk_range[v.dart.index] += 1u; });
+	cmap_.parallel_foreach_cell<FORCE_CHUNK_RANGE>([&] (Face f) { parallel_chunk_range[f.dart.index] += 2u; });
+	EXPECT_EQ(marking, parallel_chunk_range);
+}
+
+/**
+ * \brief The parallel reductions give the same results as the sequential traversals
+ */
+TEST_F(CMap2Test, parallel_reduce)
+{
+	add_faces(NB_MAX);
+	add_closed_surfaces();
+	cmap_.add_attribute<int32, Vertex>("vertices");
+
+	const uint32 nb_vertices = cmap_.parallel_reduce(
+		0u,
+		[] (uint32& nb, Vertex) { ++nb; },
+		[] (uint32 a, uint32 b) { return a + b; }
+	);
+	EXPECT_EQ(nb_vertices, cmap_.nb_cells<Vertex::ORBIT>());
+
+	uint32 max_degree = 0u;
+	cmap_.foreach_cell([&] (Face f) { max_degree = std::max(max_degree, cmap_.codegree(f)); });
+	EXPECT_EQ(cmap_.parallel_transform_reduce(
+		0u,
+		[this] (Face f) { return cmap_.codegree(f); },
+		[] (uint32 a, uint32 b) { return std::max(a, b); }
+	), max_degree);
+
+	uint32 nb_triangles = 0u;
+	cmap_.foreach_cell([&] (Face f) { if (cmap_.codegree(f) == 3u) ++nb_triangles; });
+	EXPECT_EQ(cmap_.parallel_transform_reduce(
+		0u,
+		[] (Face) { return 1u; },
+		[] (uint32 a, uint32 b) { return a + b; },
+		[this] (Face f) { return cmap_.codegree(f) == 3u; }
+	), nb_triangles);
+}
+
 #undef NB_MAX
 
 } // namespace cgogn
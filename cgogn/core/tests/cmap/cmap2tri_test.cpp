@@ -263,4 +263,27 @@ TEST_F(CMap2TriTest, add_tetra)
 	});
 }
 
+TEST_F(CMap2TriTest, reorder)
+{
+	embed_map();
+	for (uint32 i = 0u; i < 20u; ++i)
+		cmap_.split_triangle(Face(cmap_.add_tetra().dart));
+
+	CMap2Tri::VertexAttribute<int32> att_v = cmap_.get_attribute<int32, Vertex>("vertices");
+	int32 value = 0;
+	cmap_.foreach_cell([&] (Vertex v) { att_v[v] = value++; });
+	int32 sum = 0;
+	cmap_.foreach_cell([&] (Face f) { cmap_.foreach_incident_vertex(f, [&] (Vertex v) { sum += att_v[v]; }); });
+
+	cmap_.reorder();
+
+	EXPECT_TRUE(cmap_.check_map_integrity());
+	EXPECT_EQ(cmap_.topology_container().size(), cmap_.topology_container().end());
+	EXPECT_EQ(cmap_.nb_cells<Vertex::ORBIT>(), 100u);
+	EXPECT_EQ(cmap_.nb_cells<Face::ORBIT>(), 120u);
+	int32 new_sum = 0;
+	cmap_.foreach_cell([&] (Face f) { cmap_.foreach_incident_vertex(f, [&] (Vertex v) { new_sum += att_v[v]; }); });
+	EXPECT_EQ(new_sum, sum);
+}
+
 } // namespace cgogn
@@ -0,0 +1,248 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <atomic>
+#include <functional>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap3.h>
+#include <cgogn/core/cmap/cmap3_builder.h>
+#include <cgogn/core/cmap/frozen_topology.h>
+
+namespace cgogn
+{
+
+/**
+ * \brief The FrozenTopologyTest class checks that the traversals of a FrozenTopology
+ * report the same cells as the traversals of the map it has been built from.
+ */
+class FrozenTopologyTest : public ::testing::Test
+{
+protected:
+
+	// returns a function that stores the index of the given cells in ids
+	template <typename CellType, typename FROZEN>
+	static std::function<void(CellType)> collect(const FROZEN& frozen, std::vector<uint32>& ids)
+	{
+		return [&frozen, &ids] (CellType c) { ids.push_back(frozen.cell_index(c)); };
+	}
+
+	static std::vector<uint32> sorted(std::vector<uint32> ids)
+	{
+		std::sort(ids.begin(), ids.end());
+		ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+		return ids;
+	}
+};
+
+TEST_F(FrozenTopologyTest, cmap2)
+{
+	using Vertex = CMap2::Vertex;
+	using Edge = CMap2::Edge;
+	using Face = CMap2::Face;
+	using Volume = CMap2::Volume;
+
+	CMap2 map;
+	auto position = map.add_attribute<float64, Vertex>("position");
+
+	for (uint32 i = 0u; i < 10u; ++i)
+	{
+		map.add_face(3u + i);
+		const Dart p = map.add_pyramid(3u + i).dart;
+		map.cut_face(p, map.phi1(map.phi1(p)));
+		const Dart q = map.add_prism(3u + i).dart;
+		map.cut_edge(Edge(q));
+	}
+	float64 value = 0.0;
+	map.foreach_cell([&] (Vertex v) { position[v] = value; value += 1.0; });
+
+	FrozenTopology<CMap2> frozen(map);
+
+	EXPECT_EQ(frozen.nb_darts(), map.nb_darts());
+	EXPECT_EQ(frozen.nb_cells<Vertex>(), map.nb_cells<Vertex>());
+	EXPECT_EQ(frozen.nb_cells<Edge>(), map.nb_cells<Edge>());
+	EXPECT_EQ(frozen.nb_cells<Face>(), map.nb_cells<Face>());
+	EXPECT_EQ(frozen.nb_cells<Volume>(), map.nb_cells<Volume>());
+	EXPECT_TRUE(frozen.is_embedded<Vertex>());
+	EXPECT_FALSE(frozen.is_embedded<Edge>());
+
+	map.foreach_dart([&] (Dart d)
+	{
+		EXPECT_EQ(frozen.phi1(d), map.phi1(d));
+		EXPECT_EQ(frozen.phi_1(d), map.phi_1(d));
+		EXPECT_EQ(frozen.phi2(d), map.phi2(d));
+		EXPECT_EQ(frozen.is_boundary(d), map.is_boundary(d));
+	});
+
+	map.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_EQ(frozen.embedding(v), map.embedding(v));
+		EXPECT_EQ(frozen.degree(v), map.degree(v));
+
+		std::vector<uint32> m, f;
+		map.foreach_incident_edge(v, collect<Edge>(frozen, m));
+		frozen.foreach_incident_edge(v, collect<Edge>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+
+		m.clear(); f.clear();
+		map.foreach_incident_face(v, collect<Face>(frozen, m));
+		frozen.foreach_incident_face(v, collect<Face>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+
+		m.clear(); f.clear();
+		map.foreach_adjacent_vertex_through_edge(v, collect<Vertex>(frozen, m));
+		frozen.foreach_adjacent_vertex_through_edge(v, collect<Vertex>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+	});
+
+	map.foreach_cell([&] (Edge e)
+	{
+		EXPECT_EQ(frozen.degree(e), map.degree(e));
+		EXPECT_TRUE(frozen.same_cell(frozen.vertices(e).second, map.vertices(e).second));
+	});
+
+	map.foreach_cell([&] (Face fa)
+	{
+		EXPECT_EQ(frozen.codegree(fa), map.codegree(fa));
+
+		std::vector<uint32> m, f;
+		map.foreach_incident_vertex(fa, collect<Vertex>(frozen, m));
+		frozen.foreach_incident_vertex(fa, collect<Vertex>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+
+		m.clear(); f.clear();
+		map.foreach_adjacent_face_through_edge(fa, collect<Face>(frozen, m));
+		frozen.foreach_adjacent_face_through_edge(fa, collect<Face>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+	});
+
+	map.foreach_cell([&] (Volume w)
+	{
+		EXPECT_EQ(frozen.codegree(w), map.codegree(w));
+
+		std::vector<uint32> m, f;
+		map.foreach_incident_vertex(w, collect<Vertex>(frozen, m));
+		frozen.foreach_incident_vertex(w, collect<Vertex>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+	});
+
+	// the attributes of the map are accessed with the cells of the snapshot
+	float64 map_sum = 0.0, frozen_sum = 0.0;
+	map.foreach_cell([&] (Vertex v) { map_sum += position[v]; });
+	frozen.foreach_cell([&] (Vertex v) { frozen_sum += position[v]; });
+	EXPECT_EQ(map_sum, frozen_sum);
+
+	std::atomic_uint nb_faces(0u);
+	frozen.parallel_foreach_cell([&] (Face) { ++nb_faces; });
+	EXPECT_EQ(nb_faces, map.nb_cells<Face>());
+}
+
+TEST_F(FrozenTopologyTest, cmap3)
+{
+	using Vertex = CMap3::Vertex;
+	using Edge = CMap3::Edge;
+	using Face = CMap3::Face;
+	using Volume = CMap3::Volume;
+	using Face2 = CMap3::Face2;
+	using Vertex2 = CMap3::Vertex2;
+
+	CMap3 map;
+	CMap3::Builder mbuild(map);
+
+	Dart p1 = mbuild.add_prism_topo_fp(3u);
+	Dart p2 = mbuild.add_prism_topo_fp(3u);
+	mbuild.sew_volumes_fp(p1, p2);
+	Dart p3 = mbuild.add_pyramid_topo_fp(4u);
+	Dart p4 = mbuild.add_pyramid_topo_fp(4u);
+	mbuild.sew_volumes_fp(p3, p4);
+	mbuild.close_map();
+	map.add_attribute<int32, Face>("faces");
+
+	FrozenTopology<CMap3> frozen(map);
+
+	EXPECT_EQ(frozen.nb_cells<Vertex>(), map.nb_cells<Vertex>());
+	EXPECT_EQ(frozen.nb_cells<Edge>(), map.nb_cells<Edge>());
+	EXPECT_EQ(frozen.nb_cells<Face>(), map.nb_cells<Face>());
+	EXPECT_EQ(frozen.nb_cells<Volume>(), map.nb_cells<Volume>());
+	EXPECT_EQ(frozen.nb_cells<Face2>(), map.nb_cells<Face2>());
+
+	map.foreach_dart([&] (Dart d) { EXPECT_EQ(frozen.phi3(d), map.phi3(d)); });
+
+	map.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_EQ(frozen.degree(v), map.degree(v));
+
+		std::vector<uint32> m, f;
+		map.foreach_incident_edge(v, collect<Edge>(frozen, m));
+		frozen.foreach_incident_edge(v, collect<Edge>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+
+		m.clear(); f.clear();
+		map.foreach_incident_volume(v, collect<Volume>(frozen, m));
+		frozen.foreach_incident_volume(v, collect<Volume>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+
+		m.clear(); f.clear();
+		map.foreach_adjacent_vertex_through_edge(v, collect<Vertex>(frozen, m));
+		frozen.foreach_adjacent_vertex_through_edge(v, collect<Vertex>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+	});
+
+	map.foreach_cell([&] (Face fa)
+	{
+		EXPECT_EQ(frozen.embedding(fa), map.embedding(fa));
+		EXPECT_EQ(frozen.codegree(fa), map.codegree(fa));
+		EXPECT_EQ(frozen.degree(fa), map.degree(fa));
+
+		std::vector<uint32> m, f;
+		map.foreach_incident_volume(fa, collect<Volume>(frozen, m));
+		frozen.foreach_incident_volume(fa, collect<Volume>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+	});
+
+	map.foreach_cell([&] (Volume w)
+	{
+		std::vector<uint32> m, f;
+		map.foreach_incident_vertex(w, collect<Vertex>(frozen, m));
+		frozen.foreach_incident_vertex(w, collect<Vertex>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+
+		m.clear(); f.clear();
+		map.foreach_adjacent_volume_through_face(w, collect<Volume>(frozen, m));
+		frozen.foreach_adjacent_volume_through_face(w, collect<Volume>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+	});
+
+	map.foreach_cell([&] (Face2 fa)
+	{
+		std::vector<uint32> m, f;
+		map.foreach_incident_vertex(fa, collect<Vertex2>(frozen, m));
+		frozen.foreach_incident_vertex(fa, collect<Vertex2>(frozen, f));
+		EXPECT_EQ(sorted(m), sorted(f));
+	});
+}
+
+} // namespace cgogn
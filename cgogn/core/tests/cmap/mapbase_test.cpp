@@ -52,7 +52,22 @@ private:
 	{}
 };
 
-using MapTypes = ::testing::Types<CMap1, CMap2, CMap3>;
+// map types with non default chunk sizes
+struct SmallChunksCMap1Type
+{
+	using TYPE = CMap1_T<SmallChunksCMap1Type>;
+	static const uint32 CHUNK_SIZE = 32u;
+};
+using SmallChunksCMap1 = CMap1_T<SmallChunksCMap1Type>;
+
+struct LargeChunksCMap2Type
+{
+	using TYPE = CMap2_T<LargeChunksCMap2Type>;
+	static const uint32 CHUNK_SIZE = 16384u;
+};
+using LargeChunksCMap2 = CMap2_T<LargeChunksCMap2Type>;
+
+using MapTypes = ::testing::Types<CMap1, CMap2, CMap3, SmallChunksCMap1, LargeChunksCMap2>;
 TYPED_TEST_CASE(MapBaseTest, MapTypes);
 
 /**
@@ -64,15 +79,15 @@ TYPED_TEST_CASE(MapBaseTest, MapTypes);
 TYPED_TEST(MapBaseTest, add_attribute)
 {
 	using Vertex = typename MapBaseTest<TypeParam>::Vertex;
-	Attribute <int32, Vertex::ORBIT> vatt1 = this->cmap_.template add_attribute<int32, Vertex>("cool_attribute");
+	typename TypeParam::template Attribute<int32, Vertex::ORBIT> vatt1 = this->cmap_.template add_attribute<int32, Vertex>("cool_attribute");
 	EXPECT_TRUE(vatt1.is_valid());
 
 
-	Attribute <int32, Vertex::ORBIT> vatt3 = this->cmap_.template add_attribute<int32, Vertex>("cool_attribute");
+	typename TypeParam::template Attribute<int32, Vertex::ORBIT> vatt3 = this->cmap_.template add_attribute<int32, Vertex>("cool_attribute");
 	EXPECT_TRUE(vatt1.is_valid());
 	EXPECT_FALSE(vatt3.is_valid());
 
-	Attribute <float32, Vertex::ORBIT> vatt4 = this->cmap_.template add_attribute<float32, Vertex>("cool_attribute");
+	typename TypeParam::template Attribute<float32, Vertex::ORBIT> vatt4 = this->cmap_.template add_attribute<float32, Vertex>("cool_attribute");
 	EXPECT_TRUE(vatt1.is_valid());
 	EXPECT_FALSE(vatt3.is_valid());
 	EXPECT_FALSE(vatt4.is_valid());
@@ -84,7 +99,7 @@ TYPED_TEST(MapBaseTest, has_attribute)
 {
 	using Vertex = typename MapBaseTest<TypeParam>::Vertex;
 	using Face = typename MapBaseTest<TypeParam>::Face;
-	Attribute <int32, Vertex::ORBIT> vatt1 = this->cmap_.template add_attribute<int32, Vertex>("cool_attribute");
+	typename TypeParam::template Attribute<int32, Vertex::ORBIT> vatt1 = this->cmap_.template add_attribute<int32, Vertex>("cool_attribute");
 	EXPECT_TRUE(this->cmap_.has_attribute(Vertex::ORBIT,"cool_attribute"));
 	EXPECT_FALSE(this->cmap_.has_attribute(Face::ORBIT,"cool_attribute"));
 }
@@ -93,8 +108,8 @@ TYPED_TEST(MapBaseTest, remove_attribute)
 {
 	using Vertex = typename MapBaseTest<TypeParam>::Vertex;
 
-	Attribute <int32, Vertex::ORBIT> vatt1 = this->cmap_.template add_attribute<int32, Vertex>("cool_attribute");
-	Attribute <int32, Vertex::ORBIT> vatt2 = this->cmap_.template add_attribute<int32, Vertex>("cool_attribute2");
+	typename TypeParam::template Attribute<int32, Vertex::ORBIT> vatt1 = this->cmap_.template add_attribute<int32, Vertex>("cool_attribute");
+	typename TypeParam::template Attribute<int32, Vertex::ORBIT> vatt2 = this->cmap_.template add_attribute<int32, Vertex>("cool_attribute2");
 
 	EXPECT_TRUE(this->cmap_.has_attribute(Vertex::ORBIT,"cool_attribute"));
 	this->cmap_.remove_attribute(vatt1);
@@ -107,4 +122,25 @@ TYPED_TEST(MapBaseTest, remove_attribute)
 	EXPECT_FALSE(vatt2.is_valid());
 }
 
+TEST(MapBaseChunkSizeTest, chunk_size_of_map_traits)
+{
+	EXPECT_EQ(CMap2::CHUNK_SIZE, CGOGN_CHUNK_SIZE);
+	EXPECT_EQ(SmallChunksCMap1::CHUNK_SIZE, 32u);
+	EXPECT_EQ(LargeChunksCMap2::CHUNK_SIZE, 16384u);
+
+	SmallChunksCMap1 map;
+	SmallChunksCMap1::VertexAttribute<int32> vatt = map.add_attribute<int32, SmallChunksCMap1::Vertex>("vatt");
+	for (uint32 i = 0u; i < 100u; ++i)
+		map.add_face(5u);
+
+	EXPECT_EQ(map.topology_container().get_chunk_array("phi1")->nb_chunks(), (500u + 31u) / 32u);
+	EXPECT_EQ(vatt.data()->nb_chunks(), (500u + 31u) / 32u);
+
+	uint32 nb = 0u;
+	map.foreach_cell([&] (SmallChunksCMap1::Vertex v) { vatt[v] = int32(nb++); });
+	EXPECT_EQ(nb, 500u);
+	EXPECT_EQ(map.nb_cells<SmallChunksCMap1::Vertex::ORBIT>(), 500u);
+	EXPECT_TRUE(map.check_map_integrity());
+}
+
 } // namespace cgogn
@@ -21,6 +21,9 @@
 *                                                                              *
 *******************************************************************************/
 
+#include <algorithm>
+#include <thread>
+
 #include <gtest/gtest.h>
 
 #include <cgogn/core/container/chunk_array_container.h>
@@ -83,6 +86,42 @@ TEST_F(ChunkArrayContainerTest, testRemove)
 	EXPECT_EQ(i3,3u);
 }
 
+TEST_F(ChunkArrayContainerTest, test_array_index)
+{
+	ChunkArrayContainer ca_cont;
+	std::vector<ChunkArray<float32>*> arrays;
+	for (uint32 i = 0u; i < 40u; ++i)
+		arrays.push_back(ca_cont.add_chunk_array<float32>("att_" + std::to_string(i)));
+
+	EXPECT_EQ(ca_cont.add_chunk_array<float32>("att_3"), nullptr);
+
+	// remove by name and by pointer (the last arrays are moved in the holes)
+	EXPECT_TRUE(ca_cont.remove_chunk_array("att_3"));
+	EXPECT_TRUE(ca_cont.remove_chunk_array(arrays[10]));
+	EXPECT_FALSE(ca_cont.remove_chunk_array("att_3"));
+	EXPECT_FALSE(ca_cont.has_array("att_10"));
+
+	for (uint32 i = 0u; i < 40u; ++i)
+	{
+		if (i == 3u || i == 10u)
+			continue;
+		EXPECT_EQ(ca_cont.get_chunk_array<float32>("att_" + std::to_string(i)), arrays[i]);
+	}
+
+	// indices follow the swapped containers
+	ChunkArrayContainer ca_cont2;
+	ca_cont2.add_chunk_array<uint32>("other");
+	ca_cont.swap(ca_cont2);
+	EXPECT_TRUE(ca_cont.has_array("other"));
+	EXPECT_FALSE(ca_cont.has_array("att_39"));
+	EXPECT_TRUE(ca_cont2.remove_chunk_array(arrays[39]));
+	EXPECT_EQ(ca_cont2.nb_chunk_arrays(), 37u);
+
+	ca_cont2.remove_chunk_arrays();
+	EXPECT_FALSE(ca_cont2.has_array("att_0"));
+	EXPECT_NE(ca_cont2.add_chunk_array<float32>("att_0"), nullptr);
+}
+
 TEST_F(ChunkArrayContainerTest, test_compact)
 {
 	using DATA = uint32;
@@ -397,4 +436,243 @@ TEST_F(ChunkArrayContainerTest, test_merge_tri)
 
 
 
+TEST_F(ChunkArrayContainerTest, test_chunk_pool)
+{
+	ChunkArrayContainer ca_cont;
+	for (uint32 i = 0u; i < 40u; ++i)
+		ca_cont.insert_lines<1>();
+	ChunkArray<float64>* tmp = ca_cont.add_chunk_array<float64>("tmp");
+	ChunkArray<std::string>* str = ca_cont.add_chunk_array<std::string>("str");
+	for (uint32 i = ca_cont.begin(); i != ca_cont.end(); ca_cont.next(i))
+	{
+		(*tmp)[i] = 1.5;
+		(*str)[i] = "a string long enough to be allocated on the heap";
+	}
+	const uint32 nb_chunks = tmp->nb_chunks();
+	EXPECT_EQ(nb_chunks, 3u);
+	ca_cont.remove_chunk_array(tmp);
+	ca_cont.remove_chunk_array(str);
+
+	// the chunks of the removed arrays are recycled
+	chunk_pool()->reset_stats();
+	tmp = ca_cont.add_chunk_array<float64>("tmp");
+	str = ca_cont.add_chunk_array<std::string>("str");
+	const ChunkPoolStats stats = chunk_pool()->stats();
+	EXPECT_EQ(stats.hits, 2u * uint64(nb_chunks));
+	EXPECT_EQ(stats.misses, 0u);
+
+	// and their elements are initialized again
+	for (uint32 i = ca_cont.begin(); i != ca_cont.end(); ca_cont.next(i))
+	{
+		EXPECT_EQ((*tmp)[i], 0.0);
+		EXPECT_TRUE((*str)[i].empty());
+	}
+}
+
+TEST_F(ChunkArrayContainerTest, test_chunk_pool_threads)
+{
+	ChunkPool* pool = chunk_pool();
+	const std::size_t nb_bytes = 3u * ChunkPool::ALIGNMENT;
+	std::vector<void*> blocks;
+	for (uint32 i = 0u; i < 8u; ++i)
+		blocks.push_back(pool->allocate(nb_bytes));
+
+	// the blocks released by a thread are recycled by the allocations of the other threads
+	std::thread t([&] ()
+	{
+		for (void* b : blocks)
+			pool->release(b, nb_bytes);
+	});
+	t.join();
+
+	pool->reset_stats();
+	std::vector<void*> recycled;
+	for (uint32 i = 0u; i < 8u; ++i)
+		recycled.push_back(pool->allocate(nb_bytes));
+	EXPECT_EQ(pool->stats().hits, 8u);
+	EXPECT_TRUE(std::is_permutation(blocks.begin(), blocks.end(), recycled.begin()));
+	for (void* b : recycled)
+		pool->release(b, nb_bytes);
+}
+
+TEST_F(ChunkArrayContainerTest, test_chunk_pool_mapping)
+{
+	ChunkPool* pool = chunk_pool();
+	const std::size_t nb_bytes = 3u * ChunkPool::ALIGNMENT;
+	const uint32 nb_blocks = 64u;
+	char* mapping = static_cast<char*>(ChunkPool::allocate_mapping(nb_blocks * nb_bytes));
+	pool->add_mapping(mapping, nb_blocks * nb_bytes, false);
+	std::vector<void*> mapped;
+	for (uint32 i = 0u; i < nb_blocks; ++i)
+		mapped.push_back(pool->map_block(mapping + i * nb_bytes));
+	pool->close_mapping(mapping);
+	std::vector<void*> blocks;
+	for (uint32 i = 0u; i < nb_blocks; ++i)
+		blocks.push_back(pool->allocate(nb_bytes));
+
+	// the blocks of the mapping and the other ones are released at the same time by several threads
+	pool->reset_stats();
+	std::vector<std::thread> threads;
+	for (uint32 t = 0u; t < 4u; ++t)
+	{
+		threads.emplace_back([&, t] ()
+		{
+			for (uint32 i = t; i < nb_blocks; i += 4u)
+			{
+				pool->release(mapped[i], nb_bytes);
+				pool->release(blocks[i], nb_bytes);
+			}
+		});
+	}
+	for (std::thread& t : threads)
+		t.join();
+
+	// only the blocks that do not belong to the mapping are recycled
+	EXPECT_EQ(pool->stats().releases, uint64(nb_blocks));
+	std::vector<void*> recycled;
+	for (uint32 i = 0u; i < nb_blocks; ++i)
+		recycled.push_back(pool->allocate(nb_bytes));
+	EXPECT_EQ(pool->stats().hits, uint64(nb_blocks));
+	EXPECT_TRUE(std::is_permutation(blocks.begin(), blocks.end(), recycled.begin()));
+	for (void* b : recycled)
+		pool->release(b, nb_bytes);
+}
+
+TEST_F(ChunkArrayContainerTest, test_chunk_pool_huge_pages)
+{
+	ChunkPool* pool = chunk_pool();
+	const std::size_t nb_bytes = 4096u;
+	pool->trim();
+	pool->reset_stats();
+
+	// the blocks carved in a new slab are new blocks
+	pool->set_huge_pages(true);
+	std::vector<void*> blocks;
+	for (uint32 i = 0u; i < 8u; ++i)
+		blocks.push_back(pool->allocate(nb_bytes));
+	pool->set_huge_pages(false);
+	EXPECT_EQ(pool->stats().hits, 0u);
+	EXPECT_EQ(pool->stats().misses, 8u);
+
+	// a slab is freed once all its blocks are free
+	pool->release(blocks.back(), nb_bytes);
+	EXPECT_EQ(pool->trim(), 0u);
+	blocks.pop_back();
+	for (void* b : blocks)
+		pool->release(b, nb_bytes);
+	EXPECT_GE(pool->trim(), std::size_t(ChunkPool::HUGE_PAGE_SIZE));
+	EXPECT_EQ(pool->stats().cached_bytes, 0u);
+}
+
+TEST_F(ChunkArrayContainerTest, test_permute)
+{
+	ChunkArrayContainer ca_cont;
+	for (uint32 i = 0u; i < 40u; ++i)
+		ca_cont.insert_lines<1>();
+	ChunkArray<uint32>* values = ca_cont.add_chunk_array<uint32>("values");
+	ChunkArray<std::string>* str = ca_cont.add_chunk_array<std::string>("str");
+	auto* marker = ca_cont.add_marker_attribute();
+	for (uint32 i = ca_cont.begin(); i != ca_cont.end(); ca_cont.next(i))
+	{
+		(*values)[i] = i;
+		(*str)[i] = std::to_string(i);
+		if (i % 3u == 0u)
+			marker->set_true(i);
+	}
+
+	// reverse the lines
+	std::vector<uint32> old_new(ca_cont.end());
+	for (uint32 i = 0u; i < 40u; ++i)
+		old_new[i] = 39u - i;
+	ca_cont.permute(old_new);
+
+	EXPECT_EQ(ca_cont.size(), 40u);
+	for (uint32 i = ca_cont.begin(); i != ca_cont.end(); ca_cont.next(i))
+	{
+		EXPECT_EQ((*values)[i], 39u - i);
+		EXPECT_EQ((*str)[i], std::to_string(39u - i));
+		EXPECT_EQ((*marker)[i], (39u - i) % 3u == 0u);
+	}
+}
+
+TEST_F(ChunkArrayContainerTest, test_insert_lines_bulk)
+{
+	ChunkArrayContainer ca_cont;
+	ChunkArray<uint32>* values = ca_cont.add_chunk_array<uint32>("values");
+
+	std::vector<uint32> lines;
+	ca_cont.insert_lines_bulk<1>(40u, lines);
+	EXPECT_EQ(ca_cont.size(), 40u);
+	for (uint32 i = 0u; i < 40u; ++i)
+		EXPECT_EQ(lines[i], i);
+
+	ca_cont.remove_lines<1>(3);
+	ca_cont.remove_lines<1>(19);
+	ca_cont.remove_lines<1>(37);
+
+	// the holes are filled first, then the lines are appended at the end
+	lines.clear();
+	ca_cont.insert_lines_bulk<1>(5u, lines);
+	EXPECT_EQ(ca_cont.size(), 42u);
+	EXPECT_EQ(lines, std::vector<uint32>({ 37u, 19u, 3u, 40u, 41u }));
+
+	EXPECT_EQ(ca_cont.insert_contiguous_lines<1>(30u), 42u);
+	EXPECT_EQ(ca_cont.size(), 72u);
+	EXPECT_EQ(ca_cont.end(), 72u);
+	for (uint32 i = ca_cont.begin(); i != ca_cont.end(); ca_cont.next(i))
+		(*values)[i] = i;
+	EXPECT_EQ((*values)[71u], 71u);
+
+	// same layout as successive insert_lines
+	ChunkArrayContainer ca_cont2;
+	for (uint32 i = 0u; i < 24u; ++i)
+		ca_cont2.insert_lines<3>();
+	ChunkArrayContainer ca_cont3;
+	EXPECT_EQ(ca_cont3.insert_contiguous_lines<3>(24u), 0u);
+	EXPECT_EQ(ca_cont3.end(), ca_cont2.end());
+	EXPECT_EQ(ca_cont3.capacity(), ca_cont2.capacity());
+	EXPECT_EQ(ca_cont3.insert_lines<3>(), ca_cont2.insert_lines<3>());
+}
+
+TEST_F(ChunkArrayContainerTest, test_line_reservation)
+{
+	ChunkArrayContainer ca_cont;
+	for (uint32 i = 0u; i < 10u; ++i)
+		ca_cont.insert_lines<1>();
+	ca_cont.remove_lines<1>(5);
+
+	{
+		const uint32 unknown = ChunkArrayContainer::UNKNOWN;
+		ChunkArrayContainer::LineReservation<1> reservation(ca_cont, 100u);
+		EXPECT_EQ(ca_cont.size(), 109u);
+		EXPECT_EQ(reservation.nb_available(), 100u);
+
+		std::vector<uint32> taken(60u, unknown);
+		parallel_for(0u, 60u, 8u, [&] (uint32 first, uint32 last)
+		{
+			for (uint32 i = first; i < last; ++i)
+				taken[i] = reservation.take();
+		});
+		std::vector<uint32> block;
+		EXPECT_EQ(reservation.take(30u, block), 30u);
+		EXPECT_EQ(reservation.take(30u, block), 10u);
+		EXPECT_EQ(reservation.take(), unknown);
+		EXPECT_EQ(reservation.nb_available(), 0u);
+
+		taken.insert(taken.end(), block.begin(), block.end());
+		std::sort(taken.begin(), taken.end());
+		EXPECT_TRUE(std::adjacent_find(taken.begin(), taken.end()) == taken.end());
+		EXPECT_EQ(taken.front(), 5u);
+		EXPECT_EQ(taken.back(), 108u);
+	}
+	EXPECT_EQ(ca_cont.size(), 109u);
+
+	// the lines that have not been taken are released
+	{
+		ChunkArrayContainer::LineReservation<1> reservation(ca_cont, 20u);
+		reservation.take();
+	}
+	EXPECT_EQ(ca_cont.size(), 110u);
+}
+
 } // namespace cgogn
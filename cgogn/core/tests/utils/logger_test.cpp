@@ -0,0 +1,158 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <cgogn/core/utils/logger.h>
+
+using namespace cgogn::numerics;
+
+namespace
+{
+
+// counts the entries of a given sender, waiting until it is opened before processing them
+class CountingOutput : public cgogn::logger::LoggerOutput
+{
+public:
+
+	CountingOutput(const std::string& sender) : sender_(sender), count_(0u), nb_reports_(0u), open_(true)
+	{}
+
+	virtual void process_entry(const cgogn::logger::LogEntry& e) override
+	{
+		while (!open_.load())
+			std::this_thread::yield();
+		if (e.get_sender() == sender_)
+		{
+			if (e.get_message_str().find("suppressed") != std::string::npos)
+				++nb_reports_;
+			else
+				++count_;
+		}
+	}
+
+	std::string sender_;
+	std::atomic<uint32> count_;
+	std::atomic<uint32> nb_reports_;
+	std::atomic<bool> open_;
+};
+
+class LoggerTest : public ::testing::Test
+{
+protected:
+
+	// the thousands of entries of the tests are neither printed nor written in the cgogn.log file of the working directory
+	LoggerTest() : logger_(cgogn::logger::Logger::get_logger()), output_("LoggerTest")
+	{
+		logger_.remove_console_output();
+		logger_.remove_file_output("cgogn.log");
+		logger_.add_output(&output_);
+	}
+
+	~LoggerTest()
+	{
+		logger_.set_async(false);
+		logger_.set_rate_limit(0u);
+		logger_.remove_output(&output_);
+		logger_.add_file_output("cgogn.log");
+		logger_.add_console_output();
+	}
+
+	void log_from_threads(uint32 nb_threads, uint32 nb_entries)
+	{
+		std::vector<std::thread> threads;
+		for (uint32 t = 0u; t < nb_threads; ++t)
+			threads.emplace_back([nb_entries] ()
+			{
+				for (uint32 i = 0u; i < nb_entries; ++i)
+					cgogn_log_info("LoggerTest") << "entry " << i;
+			});
+		for (std::thread& t : threads)
+			t.join();
+	}
+
+	cgogn::logger::Logger& logger_;
+	CountingOutput output_;
+};
+
+} // namespace
+
+TEST_F(LoggerTest, AsyncBlock)
+{
+	logger_.set_async(true, 16u, cgogn::logger::Logger::OverflowPolicy::BLOCK);
+	EXPECT_TRUE(logger_.is_async());
+	log_from_threads(4u, 500u);
+	logger_.flush();
+	EXPECT_EQ(output_.count_.load(), 2000u);
+	EXPECT_EQ(logger_.nb_dropped_entries(), 0u);
+	logger_.set_async(false);
+	EXPECT_FALSE(logger_.is_async());
+}
+
+TEST_F(LoggerTest, AsyncDrop)
+{
+	logger_.set_async(true, 4u, cgogn::logger::Logger::OverflowPolicy::DROP);
+	output_.open_ = false;
+	log_from_threads(2u, 10u);
+	// at most the 4 entries of the buffer and the one held by the writer thread are kept
+	EXPECT_GE(logger_.nb_dropped_entries(), 15u);
+	const uint64 nb_dropped = logger_.nb_dropped_entries();
+	output_.open_ = true;
+	logger_.flush();
+	EXPECT_EQ(output_.count_.load() + nb_dropped, 20u);
+}
+
+TEST_F(LoggerTest, RateLimit)
+{
+	auto log = [] (uint32 n)
+	{
+		for (uint32 i = 0u; i < n; ++i)
+			cgogn_log_info("LoggerTest") << "entry " << i;
+	};
+
+	logger_.set_rate_limit(10u, std::chrono::milliseconds(200));
+	log(100u);
+	EXPECT_EQ(output_.count_.load(), 10u);
+	EXPECT_EQ(output_.nb_reports_.load(), 0u);
+
+	// the limit applies to each call site
+	for (uint32 i = 0u; i < 100u; ++i)
+		cgogn_log_info("LoggerTest") << "other entry " << i;
+	EXPECT_EQ(output_.count_.load(), 20u);
+
+	// the suppressed entries are reported at the beginning of the next period
+	std::this_thread::sleep_for(std::chrono::milliseconds(250));
+	log(2u);
+	EXPECT_EQ(output_.count_.load(), 22u);
+	EXPECT_EQ(output_.nb_reports_.load(), 1u);
+
+	logger_.set_rate_limit(0u);
+	log(100u);
+	EXPECT_EQ(output_.count_.load(), 122u);
+}
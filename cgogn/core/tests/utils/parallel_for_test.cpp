@@ -0,0 +1,69 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <atomic>
+
+#include <cgogn/core/utils/parallel_for.h>
+
+using namespace cgogn::numerics;
+
+TEST(ParallelForTest, EachIndexOnce)
+{
+	const uint32 first = 7u;
+	const uint32 last = 100003u;
+	std::vector<std::atomic<uint32>> counts(last);
+	for (auto& c : counts)
+		c = 0u;
+
+	cgogn::parallel_for(first, last, 1000u, [&] (uint32 b, uint32 e)
+	{
+		EXPECT_LE(e - b, 1000u);
+		for (uint32 i = b; i < e; ++i)
+			++counts[i];
+	});
+
+	for (uint32 i = 0u; i < last; ++i)
+		EXPECT_EQ(counts[i], i < first ? 0u : 1u);
+}
+
+TEST(ParallelForTest, EmptyRange)
+{
+	uint32 nb_calls = 0u;
+	cgogn::parallel_for(10u, 10u, 16u, [&] (uint32, uint32) { ++nb_calls; });
+	EXPECT_EQ(nb_calls, 0u);
+}
+
+TEST(ParallelForTest, Nested)
+{
+	std::atomic<uint32> sum(0u);
+	cgogn::parallel_for(0u, 64u, 1u, [&] (uint32 b, uint32 e)
+	{
+		for (uint32 i = b; i < e; ++i)
+			cgogn::parallel_for(0u, 1000u, 10u, [&] (uint32 bb, uint32 ee) { sum += ee - bb; });
+	});
+	EXPECT_EQ(sum, 64000u);
+}
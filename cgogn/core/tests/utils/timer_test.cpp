@@ -0,0 +1,85 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include <cgogn/core/utils/timer.h>
+#include <cgogn/core/utils/parallel_for.h>
+
+using namespace cgogn::numerics;
+
+TEST(ProfilerTest, Statistics)
+{
+	cgogn::Profiler& profiler = cgogn::Profiler::get_profiler();
+	profiler.clear();
+
+	for (uint32 i = 0u; i < 3u; ++i)
+	{
+		cgogn::ProfileZone outer("outer");
+		cgogn::ProfileZone inner("inner");
+	}
+	cgogn::parallel_for(0u, 5000u, 1u, [] (uint32, uint32)
+	{
+		cgogn::ProfileZone zone("block");
+	});
+	EXPECT_EQ(profiler.nb_zones(), 5006u);
+
+	const std::vector<cgogn::Profiler::ZoneStatistics> stats = profiler.statistics();
+	ASSERT_EQ(stats.size(), 3u);
+	for (const cgogn::Profiler::ZoneStatistics& s : stats)
+	{
+		EXPECT_EQ(s.count_, s.name_ == "block" ? 5000u : 3u);
+		EXPECT_LE(s.min_, s.mean_);
+		EXPECT_LE(s.mean_, s.max_);
+	}
+
+	profiler.clear();
+	EXPECT_EQ(profiler.nb_zones(), 0u);
+	EXPECT_EQ(cgogn::Profiler::thread_depth(), 0u);
+}
+
+TEST(ProfilerTest, ChromeTrace)
+{
+	cgogn::Profiler& profiler = cgogn::Profiler::get_profiler();
+	profiler.clear();
+
+	{
+		cgogn::ProfileZone outer("outer \"zone\"");
+		cgogn::ProfileZone inner("inner");
+	}
+
+	std::stringstream ss;
+	profiler.export_chrome_trace(ss);
+	const std::string trace = ss.str();
+	EXPECT_EQ(trace.find("{\"traceEvents\":["), 0u);
+	EXPECT_NE(trace.find("\"name\":\"outer \\\"zone\\\"\""), std::string::npos);
+	EXPECT_NE(trace.find("\"name\":\"inner\",\"cat\":\"cgogn\",\"ph\":\"X\""), std::string::npos);
+	EXPECT_NE(trace.find("\"args\":{\"depth\":1}"), std::string::npos);
+
+	profiler.clear();
+}
@@ -24,10 +24,13 @@
 #ifndef CGOGN_CORE_UTILS_BUFFERS_H_
 #define CGOGN_CORE_UTILS_BUFFERS_H_
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <type_traits>
 
 #include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/definitions.h>
 #include <cgogn/core/basic/dart.h>
 #include <cgogn/core/basic/cell.h>
 
@@ -78,6 +81,34 @@ public:
 		b->clear();
 		buffers_.push_back(b);
 	}
+
+	/**
+	 * @brief free the cached buffers
+	 * @return the number of bytes released
+	 */
+	inline std::size_t shrink()
+	{
+		std::size_t nb_bytes = buffers_.capacity() * sizeof(std::vector<T>*);
+		for (auto i : buffers_)
+		{
+			nb_bytes += sizeof(std::vector<T>) + i->capacity() * sizeof(T);
+			delete i;
+		}
+		buffers_.clear();
+		buffers_.shrink_to_fit();
+		return nb_bytes;
+	}
+
+	/**
+	 * @brief memory used by the cached buffers
+	 */
+	inline std::size_t memory_usage() const
+	{
+		std::size_t nb_bytes = buffers_.capacity() * sizeof(std::vector<T>*);
+		for (auto i : buffers_)
+			nb_bytes += sizeof(std::vector<T>) + i->capacity() * sizeof(T);
+		return nb_bytes;
+	}
 };
 
 template <>
@@ -125,6 +156,34 @@ public:
 		buffers_.push_back(b);
 	}
 
+	/**
+	 * @brief free the cached buffers
+	 * @return the number of bytes released
+	 */
+	inline std::size_t shrink()
+	{
+		std::size_t nb_bytes = buffers_.capacity() * sizeof(std::vector<Dart>*);
+		for (auto i : buffers_)
+		{
+			nb_bytes += sizeof(std::vector<Dart>) + i->capacity() * sizeof(Dart);
+			delete i;
+		}
+		buffers_.clear();
+		buffers_.shrink_to_fit();
+		return nb_bytes;
+	}
+
+	/**
+	 * @brief memory used by the cached buffers
+	 */
+	inline std::size_t memory_usage() const
+	{
+		std::size_t nb_bytes = buffers_.capacity() * sizeof(std::vector<Dart>*);
+		for (auto i : buffers_)
+			nb_bytes += sizeof(std::vector<Dart>) + i->capacity() * sizeof(Dart);
+		return nb_bytes;
+	}
+
 	template <typename CELL>
 	inline std::vector<CELL>* cell_buffer()
 	{
@@ -140,6 +199,66 @@ public:
 	}
 };
 
+/**
+ * @brief array of atomic uint32 (uninitialized) reused by the successive instances created by a thread
+ * The array of each thread only grows: it is reallocated when a larger size is requested and kept until
+ * the end of the thread. An instance created while the array of the thread is already used (nested call)
+ * allocates its own array.
+ */
+class AtomicUintBuffer
+{
+	struct Storage
+	{
+		std::unique_ptr<std::atomic<uint32>[]> data_;
+		uint32 size_;
+		bool used_;
+	};
+
+	static inline Storage& local_storage()
+	{
+		static thread_local Storage storage{nullptr, 0u, false};
+		return storage;
+	}
+
+	Storage& local_;
+	std::unique_ptr<std::atomic<uint32>[]> own_;
+	std::atomic<uint32>* data_;
+
+public:
+
+	explicit AtomicUintBuffer(uint32 size) :
+		local_(local_storage()),
+		data_(nullptr)
+	{
+		if (local_.used_)
+		{
+			own_.reset(new std::atomic<uint32>[size]);
+			data_ = own_.get();
+			return;
+		}
+		if (local_.size_ < size)
+		{
+			local_.data_.reset(new std::atomic<uint32>[size]);
+			local_.size_ = size;
+		}
+		local_.used_ = true;
+		data_ = local_.data_.get();
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(AtomicUintBuffer);
+
+	~AtomicUintBuffer()
+	{
+		if (!own_)
+			local_.used_ = false;
+	}
+
+	inline std::atomic<uint32>& operator[](uint32 i)
+	{
+		return data_[i];
+	}
+};
+
 } // namespace cgogn
 
 #endif // CGOGN_CORE_UTILS_BUFFERS_H_
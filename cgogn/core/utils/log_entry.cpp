@@ -70,21 +70,25 @@ std::ostream& add_color(std::ostream& o, LogLevel lvl)
 
 FileInfo::FileInfo(const char* f, uint32 l) :
 	filename_(f),
+	file_(f),
 	line_(l)
 {}
 
 FileInfo::FileInfo() :
 	filename_("unspecified file"),
+	file_(nullptr),
 	line_(std::numeric_limits<uint32>::max())
 {}
 
 FileInfo::FileInfo(const FileInfo& other) :
 	filename_(other.filename_),
+	file_(other.file_),
 	line_(other.line_)
 {}
 
 FileInfo::FileInfo(FileInfo&& other) :
 	filename_(std::move(other.filename_)),
+	file_(other.file_),
 	line_(other.line_)
 {}
 
@@ -93,6 +97,7 @@ FileInfo& FileInfo::operator=(const FileInfo& other)
 	if (this != &other)
 	{
 		filename_ = other.filename_;
+		file_ = other.file_;
 		line_ = other.line_;
 	}
 	return *this;
@@ -103,6 +108,7 @@ FileInfo& FileInfo::operator=(FileInfo&& other)
 	if (this != &other)
 	{
 		filename_ = std::move(other.filename_);
+		file_ = other.file_;
 		line_ = other.line_;
 	}
 	return *this;
@@ -52,12 +52,18 @@ public:
 	FileInfo& operator=(FileInfo&& other);
 	bool empty() const;
 
+	inline const std::string& filename() const { return filename_; }
+	inline uint32 line() const { return line_; }
+	// the file name given at construction (e.g. __FILE__, nullptr if unspecified): identifies the call site with line()
+	inline const char* file() const { return file_; }
+
 	friend std::ostream& operator<<(std::ostream& o, const FileInfo& fileinfo);
 private:
 #pragma warning(push)
 #pragma warning(disable:4251)
 	std::string filename_;
 #pragma warning(pop)
+	const char* file_;
 	uint32 line_;
 };
 
@@ -44,7 +44,7 @@ LogStream::LogStream(LogStream&& ls)
 
 LogStream::~LogStream()
 {
-	Logger::get_logger().process(log_entry_);
+	Logger::get_logger().process(std::move(log_entry_));
 }
 
 
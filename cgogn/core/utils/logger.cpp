@@ -24,6 +24,12 @@
 #define CGOGN_CORE_UTILS_LOGGER_CPP_
 
 #include <iostream>
+#include <thread>
+#include <condition_variable>
+#include <array>
+#include <cstdint>
+#include <limits>
+
 #include <cgogn/core/utils/logger.h>
 
 namespace cgogn
@@ -32,6 +38,284 @@ namespace cgogn
 namespace logger
 {
 
+/**
+ * Bounded multiple producers / single consumer queue of log entries (D. Vyukov's algorithm):
+ * each cell holds a sequence number telling whether it is free for the producer of a given position
+ * or ready for the consumer, so that producers only compete on an atomic increment of the enqueue position.
+ * The entries are written to the outputs of the logger by a background thread.
+ */
+class Logger::AsyncWriter
+{
+public:
+
+	AsyncWriter(const Logger& logger, uint32 capacity, OverflowPolicy policy, uint32 sample_rate) :
+		logger_(logger),
+		mask_(0u),
+		policy_(policy),
+		sample_rate_(sample_rate > 0u ? sample_rate : 1u),
+		enqueue_pos_(0u),
+		dequeue_pos_(0u),
+		nb_dropped_(0u),
+		nb_reported_dropped_(0u),
+		sample_counter_(0u),
+		sleeping_(false),
+		stop_(false)
+	{
+		uint64 size = 2u;
+		while (size < capacity)
+			size *= 2u;
+		mask_ = size - 1u;
+		cells_ = make_unique<Cell[]>(size);
+		for (uint64 i = 0u; i < size; ++i)
+			cells_[i].sequence_.store(i, std::memory_order_relaxed);
+		thread_ = std::thread(&AsyncWriter::run, this);
+	}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(AsyncWriter);
+
+	~AsyncWriter()
+	{
+		{
+			std::lock_guard<std::mutex> guard(wake_mutex_);
+			stop_ = true;
+		}
+		wake_cv_.notify_one();
+		thread_.join();
+	}
+
+	void push(LogEntry&& entry)
+	{
+		if (policy_ == OverflowPolicy::SAMPLE &&
+			enqueue_pos_.load(std::memory_order_relaxed) - dequeue_pos_.load(std::memory_order_relaxed) >= (mask_ + 1u) / 4u * 3u &&
+			sample_counter_.fetch_add(1u, std::memory_order_relaxed) % sample_rate_ != 0u)
+		{
+			nb_dropped_.fetch_add(1u, std::memory_order_relaxed);
+			return;
+		}
+
+		while (!try_push(entry))
+		{
+			if (policy_ != OverflowPolicy::BLOCK)
+			{
+				nb_dropped_.fetch_add(1u, std::memory_order_relaxed);
+				return;
+			}
+			wake_writer();
+			std::this_thread::yield();
+		}
+		wake_writer();
+	}
+
+	void flush()
+	{
+		const uint64 target = enqueue_pos_.load(std::memory_order_acquire);
+		std::unique_lock<std::mutex> lock(wake_mutex_);
+		flushed_cv_.wait(lock, [&] () { return dequeue_pos_.load(std::memory_order_acquire) >= target; });
+	}
+
+	inline uint64 nb_dropped() const
+	{
+		return nb_dropped_.load(std::memory_order_relaxed);
+	}
+
+private:
+
+	struct Cell
+	{
+		std::atomic<uint64> sequence_;
+		LogEntry entry_;
+	};
+
+	bool try_push(LogEntry& entry)
+	{
+		uint64 pos = enqueue_pos_.load(std::memory_order_relaxed);
+		Cell* cell;
+		for (;;)
+		{
+			cell = &cells_[pos & mask_];
+			const uint64 seq = cell->sequence_.load(std::memory_order_acquire);
+			const int64 diff = int64(seq) - int64(pos);
+			if (diff == 0)
+			{
+				if (enqueue_pos_.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false; // full
+			else
+				pos = enqueue_pos_.load(std::memory_order_relaxed);
+		}
+		cell->entry_ = std::move(entry);
+		cell->sequence_.store(pos + 1u, std::memory_order_release);
+		return true;
+	}
+
+	// the writer thread only sleeps when the buffer is empty: it is woken up if it is sleeping
+	void wake_writer()
+	{
+		// pairs with the fence of run: either the writer sees the new entry, or this thread sees it sleeping
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleeping_.load(std::memory_order_relaxed))
+		{
+			std::lock_guard<std::mutex> guard(wake_mutex_);
+			wake_cv_.notify_one();
+		}
+	}
+
+	// only called by the writer thread
+	bool ready() const
+	{
+		const uint64 pos = dequeue_pos_.load(std::memory_order_relaxed);
+		return cells_[pos & mask_].sequence_.load(std::memory_order_acquire) == pos + 1u;
+	}
+
+	// only called by the writer thread
+	bool try_pop(LogEntry& entry)
+	{
+		const uint64 pos = dequeue_pos_.load(std::memory_order_relaxed);
+		Cell& cell = cells_[pos & mask_];
+		const uint64 seq = cell.sequence_.load(std::memory_order_acquire);
+		if (int64(seq) - int64(pos + 1u) < 0)
+			return false; // empty (or the producer of this cell has not finished yet)
+		entry = std::move(cell.entry_);
+		cell.sequence_.store(pos + mask_ + 1u, std::memory_order_release);
+		return true;
+	}
+
+	void run()
+	{
+		LogEntry entry;
+		for (;;)
+		{
+			while (try_pop(entry))
+			{
+				logger_.write(entry);
+				dequeue_pos_.fetch_add(1u, std::memory_order_release);
+			}
+
+			const uint64 nb_dropped = nb_dropped_.load(std::memory_order_relaxed);
+			if (nb_dropped != nb_reported_dropped_)
+			{
+				LogEntry report(LogLevel::LogLevel_WARNING, "Logger", CGOGN_FILE_INFO);
+				report << nb_dropped - nb_reported_dropped_ << " log entries were dropped by the asynchronous logger (buffer full).";
+				logger_.write(report);
+				nb_reported_dropped_ = nb_dropped;
+			}
+
+			std::unique_lock<std::mutex> lock(wake_mutex_);
+			flushed_cv_.notify_all();
+			if (stop_ && dequeue_pos_.load(std::memory_order_relaxed) == enqueue_pos_.load(std::memory_order_acquire))
+				break;
+			// sleep until an entry is pushed (no periodic wake up when the logger is idle)
+			sleeping_.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			wake_cv_.wait(lock, [this] () { return stop_ || ready(); });
+			sleeping_.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	const Logger&				logger_;
+	std::unique_ptr<Cell[]>		cells_;
+	uint64						mask_;
+	OverflowPolicy				policy_;
+	uint32						sample_rate_;
+	// positions on their own cache lines: written by the producers (resp. the consumer)
+	char						padding0_[64];
+	std::atomic<uint64>			enqueue_pos_;
+	char						padding1_[64];
+	std::atomic<uint64>			dequeue_pos_;
+	char						padding2_[64];
+	std::atomic<uint64>			nb_dropped_;
+	uint64						nb_reported_dropped_;
+	std::atomic<uint32>			sample_counter_;
+	std::mutex					wake_mutex_;
+	std::condition_variable		wake_cv_;
+	std::condition_variable		flushed_cv_;
+	std::atomic<bool>			sleeping_;
+	bool						stop_;
+	std::thread					thread_;
+};
+
+/**
+ * Fixed-size table of the call sites (file, line) seen by the rate limit, with one atomic counter per site:
+ * a call site is looked up (and inserted the first time) without lock by linear probing.
+ * Once the table is full, the entries of the new call sites share the counter of the last slot.
+ */
+class Logger::RateLimiter
+{
+public:
+
+	using Clock = std::chrono::steady_clock;
+
+	static const uint32 NB_CALL_SITES = 1024u;
+
+	struct CallSite
+	{
+		std::atomic<uint32> state_; // EMPTY, WRITING or READY
+		const char* file_;
+		uint32 line_;
+		std::atomic<int64> period_start_; // in nanoseconds
+		std::atomic<uint32> count_;
+		std::atomic<uint32> nb_suppressed_;
+	};
+
+	RateLimiter() :
+		period_(std::chrono::nanoseconds(std::chrono::milliseconds(1000)).count())
+	{
+		for (CallSite& site : call_sites_)
+		{
+			site.state_.store(EMPTY, std::memory_order_relaxed);
+			site.file_ = nullptr;
+			site.line_ = 0u;
+		}
+		reset();
+	}
+
+	// the counters of the call sites are reset, the call sites are kept
+	void reset()
+	{
+		for (CallSite& site : call_sites_)
+		{
+			site.period_start_.store(std::numeric_limits<int64>::min() / 2, std::memory_order_relaxed);
+			site.count_.store(0u, std::memory_order_relaxed);
+			site.nb_suppressed_.store(0u, std::memory_order_relaxed);
+		}
+	}
+
+	CallSite& call_site(const char* file, uint32 line)
+	{
+		const uint64 h = (uint64(reinterpret_cast<std::uintptr_t>(file)) ^ (uint64(line) << 32u)) * 0x9E3779B97F4A7C15ull;
+		for (uint32 i = 0u, slot = uint32(h >> 54u) % (NB_CALL_SITES - 1u); i < NB_CALL_SITES - 1u; ++i, slot = (slot + 1u) % (NB_CALL_SITES - 1u))
+		{
+			CallSite& site = call_sites_[slot];
+			uint32 state = site.state_.load(std::memory_order_acquire);
+			if (state == EMPTY && site.state_.compare_exchange_strong(state, WRITING, std::memory_order_acquire))
+			{
+				site.file_ = file;
+				site.line_ = line;
+				site.state_.store(READY, std::memory_order_release);
+				return site;
+			}
+			while (state == WRITING)
+			{
+				std::this_thread::yield();
+				state = site.state_.load(std::memory_order_acquire);
+			}
+			if (site.file_ == file && site.line_ == line)
+				return site;
+		}
+		return call_sites_[NB_CALL_SITES - 1u];
+	}
+
+	std::atomic<int64> period_;
+
+private:
+
+	enum : uint32 { EMPTY = 0u, WRITING, READY };
+
+	std::array<CallSite, NB_CALL_SITES> call_sites_;
+};
+
 Logger& Logger::get_logger()
 {
 	static Logger logger_instance;
@@ -39,6 +323,36 @@ Logger& Logger::get_logger()
 }
 
 void Logger::process(const LogEntry& entry) const
+{
+	if (!pass_rate_limit(entry))
+		return;
+	if (async_writer_.load(std::memory_order_acquire))
+	{
+		LogEntry copy(entry.get_level(), entry.get_sender(), entry.get_fileinfo());
+		copy << entry.get_message_str();
+		dispatch(std::move(copy));
+	}
+	else
+		write(entry);
+}
+
+void Logger::process(LogEntry&& entry) const
+{
+	if (!pass_rate_limit(entry))
+		return;
+	dispatch(std::move(entry));
+}
+
+void Logger::dispatch(LogEntry&& entry) const
+{
+	AsyncWriter* writer = async_writer_.load(std::memory_order_acquire);
+	if (writer)
+		writer->push(std::move(entry));
+	else
+		write(entry);
+}
+
+void Logger::write(const LogEntry& entry) const
 {
 	std::lock_guard<std::mutex> guard(process_mutex_);
 	if (console_out_)
@@ -49,6 +363,75 @@ void Logger::process(const LogEntry& entry) const
 		o->process_entry(entry);
 }
 
+bool Logger::pass_rate_limit(const LogEntry& entry) const
+{
+	const uint32 max_per_period = rate_limit_.load(std::memory_order_relaxed);
+	if (max_per_period == 0u)
+		return true;
+
+	const FileInfo& fileinfo = entry.get_fileinfo();
+	RateLimiter::CallSite& site = rate_limiter_->call_site(fileinfo.file(), fileinfo.line());
+
+	// the first thread that sees the end of the period starts the next one
+	const int64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(RateLimiter::Clock::now().time_since_epoch()).count();
+	int64 period_start = site.period_start_.load(std::memory_order_relaxed);
+	uint32 nb_suppressed = 0u;
+	if (now - period_start >= rate_limiter_->period_.load(std::memory_order_relaxed) &&
+		site.period_start_.compare_exchange_strong(period_start, now, std::memory_order_relaxed))
+	{
+		nb_suppressed = site.nb_suppressed_.exchange(0u, std::memory_order_relaxed);
+		site.count_.store(0u, std::memory_order_relaxed);
+	}
+
+	if (site.count_.fetch_add(1u, std::memory_order_relaxed) >= max_per_period)
+	{
+		site.nb_suppressed_.fetch_add(1u, std::memory_order_relaxed);
+		return false;
+	}
+
+	if (nb_suppressed > 0u)
+	{
+		LogEntry report(entry.get_level(), entry.get_sender(), fileinfo);
+		report << nb_suppressed << " log entries of this call site were suppressed by the rate limit.";
+		dispatch(std::move(report));
+	}
+	return true;
+}
+
+void Logger::set_async(bool async, uint32 capacity, OverflowPolicy policy, uint32 sample_rate)
+{
+	// stopping the writer thread writes the remaining entries
+	delete async_writer_.exchange(nullptr, std::memory_order_acq_rel);
+	if (async)
+		async_writer_.store(new AsyncWriter(*this, capacity, policy, sample_rate), std::memory_order_release);
+}
+
+bool Logger::is_async() const
+{
+	return async_writer_.load(std::memory_order_acquire) != nullptr;
+}
+
+void Logger::flush() const
+{
+	AsyncWriter* writer = async_writer_.load(std::memory_order_acquire);
+	if (writer)
+		writer->flush();
+}
+
+uint64 Logger::nb_dropped_entries() const
+{
+	AsyncWriter* writer = async_writer_.load(std::memory_order_acquire);
+	return writer ? writer->nb_dropped() : 0u;
+}
+
+void Logger::set_rate_limit(uint32 max_per_period, std::chrono::milliseconds period)
+{
+	rate_limit_.store(0u, std::memory_order_relaxed);
+	rate_limiter_->period_.store(std::chrono::nanoseconds(period).count(), std::memory_order_relaxed);
+	rate_limiter_->reset();
+	rate_limit_.store(max_per_period, std::memory_order_relaxed);
+}
+
 LogStream Logger::info(const std::string& sender, Logger::FileInfo fileinfo) const
 {
 	return log(LogLevel::LogLevel_INFO, sender, fileinfo);
@@ -136,12 +519,37 @@ void Logger::add_output(LoggerOutput* output)
 		std::cerr << "Logger::add_output : the specified output is already added. Ignoring." << std::endl;
 }
 
-Logger::Logger()
+void Logger::remove_output(LoggerOutput* output)
+{
+	bool found = false;
+	std::lock_guard<std::mutex> guard(process_mutex_);
+	for (auto it = other_outputs_.begin(), end = other_outputs_.end(); it != end ; ++it)
+	{
+		if (*it == output)
+		{
+			found = true;
+			other_outputs_.erase(it);
+			break;
+		}
+	}
+	if (!found)
+		std::cerr << "Logger::remove_output: the specified output was not used by the logger." << std::endl;
+}
+
+Logger::Logger() :
+	async_writer_(nullptr),
+	rate_limiter_(make_unique<RateLimiter>()),
+	rate_limit_(0u)
 {
 	add_console_output();
 	add_file_output("cgogn.log");
 }
 
+Logger::~Logger()
+{
+	set_async(false);
+}
+
 LogStream Logger::log(LogLevel lvl, const std::string& sender, Logger::FileInfo fileinfo) const
 {
 	return LogStream(lvl, sender, fileinfo);
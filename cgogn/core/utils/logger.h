@@ -27,6 +27,9 @@
 #include <ostream>
 #include <memory>
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
 
 #include <cgogn/core/utils/log_entry.h>
 #include <cgogn/core/utils/logger_output.h>
@@ -54,10 +57,55 @@ public:
 	using FileInfo = internal::FileInfo;
 	using LogLevel = internal::LogLevel;
 
+	/**
+	 * behavior of the asynchronous logger when its ring buffer is full
+	 */
+	enum class OverflowPolicy : uint8
+	{
+		DROP = 0,	// the entry is dropped (the number of dropped entries is reported afterwards)
+		BLOCK,		// the producer waits for a free slot
+		SAMPLE		// once the buffer is 3/4 full, only one entry out of sample_rate is kept, the others are dropped
+	};
+
 	CGOGN_NOT_COPYABLE_NOR_MOVABLE(Logger);
 
+	~Logger();
+
 	static Logger& get_logger();
 	void process(const LogEntry& entry) const;
+	void process(LogEntry&& entry) const;
+
+	/**
+	 * @brief enable or disable the asynchronous mode
+	 * In asynchronous mode, the entries are moved into a bounded lock-free ring buffer
+	 * (multiple producers, single consumer) and written to the outputs by a background thread,
+	 * so that the logging threads never wait for the outputs (except with the BLOCK policy when the buffer is full).
+	 * Must not be called while other threads are logging. Disabling the asynchronous mode flushes the buffer.
+	 * @param async true to enable the asynchronous mode
+	 * @param capacity number of entries of the ring buffer (rounded up to a power of 2)
+	 * @param policy behavior when the ring buffer is full
+	 * @param sample_rate one entry out of sample_rate is kept by the SAMPLE policy
+	 */
+	void set_async(bool async, uint32 capacity = 4096u, OverflowPolicy policy = OverflowPolicy::DROP, uint32 sample_rate = 8u);
+	bool is_async() const;
+
+	/**
+	 * @brief wait until the entries logged before the call have been written (no-op in synchronous mode)
+	 */
+	void flush() const;
+
+	/**
+	 * @brief number of entries dropped by the asynchronous mode since it was enabled
+	 */
+	uint64 nb_dropped_entries() const;
+
+	/**
+	 * @brief limit the number of entries of a same call site (file and line) to max_per_period per period
+	 * The entries over the limit are suppressed and their number is reported when the next period starts.
+	 * @param max_per_period maximum number of entries per call site and per period (0: no limit)
+	 * @param period duration of a period
+	 */
+	void set_rate_limit(uint32 max_per_period, std::chrono::milliseconds period = std::chrono::milliseconds(1000));
 
 	LogStream info(const std::string& sender, FileInfo fileinfo) const;
 	LogStream debug(const std::string& sender, FileInfo fileinfo) const;
@@ -74,17 +122,27 @@ public:
 	 * @param output : the logger doesn't take the ownership of the output
 	 */
 	void add_output(LoggerOutput* output);
+	void remove_output(LoggerOutput* output);
 
 private:
 
+	class AsyncWriter;
+	class RateLimiter;
+
 	Logger();
 	LogStream log(LogLevel lvl, const std::string& sender, FileInfo fileinfo) const;
+	void dispatch(LogEntry&& entry) const;
+	void write(const LogEntry& entry) const;
+	bool pass_rate_limit(const LogEntry& entry) const;
 #pragma warning(push)
 #pragma warning(disable:4251)
 	std::unique_ptr<ConsoleOutput>				console_out_;
 	std::vector<std::unique_ptr<FileOutput>>	file_out_;
 	std::vector<LoggerOutput*>					other_outputs_;
 	mutable std::mutex							process_mutex_;
+	std::atomic<AsyncWriter*>					async_writer_;
+	std::unique_ptr<RateLimiter>				rate_limiter_;
+	std::atomic<uint32>							rate_limit_;
 #pragma warning(pop)
 };
 
@@ -26,10 +26,14 @@
 
 #include <vector>
 #include <array>
+#include <functional>
+#include <memory>
 
 #include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/unique_ptr.h>
 #include <cgogn/core/basic/cell.h>
 #include <cgogn/core/cmap/attribute.h>
+#include <cgogn/core/cmap/map_base_data.h>
 
 namespace cgogn
 {
@@ -123,7 +127,7 @@ public:
 	using Inherit = CellTraversor;
 	using Self = QuickTraversor<MAP>;
 
-	using const_iterator = typename Attribute_T<Dart>::const_iterator;
+	using const_iterator = typename Attribute_T<Dart, MAP::CHUNK_SIZE>::const_iterator;
 
 	CGOGN_NOT_COPYABLE_NOR_MOVABLE(QuickTraversor);
 
@@ -197,7 +201,7 @@ public:
 private:
 
 	MAP& map_;
-	std::array<Attribute_T<Dart>, NB_ORBITS> qt_attributes_;
+	std::array<Attribute_T<Dart, MAP::CHUNK_SIZE>, NB_ORBITS> qt_attributes_;
 	static uint32 qt_counter_;
 };
 
@@ -233,7 +237,7 @@ public:
 
 		const Self* const qt_ptr_;
 		Orbit orbit_;
-		const Attribute_T<Dart>::ChunkArrayContainer& ca_cont_;
+		const typename Attribute_T<Dart, MAP::CHUNK_SIZE>::ChunkArrayContainer& ca_cont_;
 		uint32 index_;
 
 		inline const_iterator(const Self* qt, Orbit orbit, uint32 i) :
@@ -358,7 +362,7 @@ public:
 private:
 
 	MAP& map_;
-	std::array<Attribute_T<Dart>, NB_ORBITS> qt_attributes_;
+	std::array<Attribute_T<Dart, MAP::CHUNK_SIZE>, NB_ORBITS> qt_attributes_;
 	std::array<std::function<bool(Dart)>, NB_ORBITS> qt_filters_;
 	static uint32 fqt_counter_;
 };
@@ -465,6 +469,421 @@ private:
 	std::array<std::vector<Dart>, NB_ORBITS> cells_;
 };
 
+/**
+ * @brief The DirtyCellCache class
+ * A cell cache filled incrementally with the cells whose data has been modified (cf. mark_dirty), each cell being
+ * cached once until the cache is cleared. It can be used as a mask to restrict the updates of the data that depend
+ * on the modified cells, e.g. to the faces incident to the displaced vertices (cf. mark_incident_dirty).
+ * The topology of the map should not change while cells are marked.
+ */
+template <typename MAP>
+class DirtyCellCache : public CellTraversor
+{
+public:
+
+	using Inherit = CellTraversor;
+	using Self = DirtyCellCache<MAP>;
+	using DartMarkerStore = typename MAP::DartMarkerStore;
+
+	using const_iterator = std::vector<Dart>::const_iterator;
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(DirtyCellCache);
+
+	inline DirtyCellCache(const MAP& m) : Inherit(),
+		map_(m)
+	{}
+
+	template <typename CellType>
+	inline const_iterator begin() const
+	{
+		return cells_[CellType::ORBIT].begin();
+	}
+
+	template <typename CellType>
+	inline const_iterator end() const
+	{
+		return cells_[CellType::ORBIT].end();
+	}
+
+	template <typename CellType>
+	inline std::size_t size() const
+	{
+		return cells_[CellType::ORBIT].size();
+	}
+
+	template <typename CellType>
+	inline bool is_dirty(CellType c) const
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		return markers_[ORBIT] && markers_[ORBIT]->is_marked(c.dart);
+	}
+
+	/**
+	 * @brief add the cell c to the cache, if it is not already in it
+	 */
+	template <typename CellType>
+	inline void mark_dirty(CellType c)
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		if (!markers_[ORBIT])
+			markers_[ORBIT] = cgogn::make_unique<DartMarkerStore>(map_);
+		if (markers_[ORBIT]->is_marked(c.dart))
+			return;
+		markers_[ORBIT]->mark_orbit(c);
+		cells_[ORBIT].push_back(c.dart);
+		traversed_cells_ |= orbit_mask<CellType>();
+	}
+
+	/**
+	 * @brief add to the cache the (non boundary) cells of type CellType incident to the cells of type FromType of dirty
+	 * dirty may be this cache.
+	 */
+	template <typename CellType, typename FromType>
+	inline void mark_incident_dirty(const Self& dirty)
+	{
+		// mark_dirty may grow the vector of dirty when it is this cache and the orbits are the same
+		const std::vector<Dart>& from = dirty.cells_[FromType::ORBIT];
+		const std::size_t nb = from.size();
+		for (std::size_t i = 0u; i < nb; ++i)
+		{
+			map_.foreach_dart_of_orbit(FromType(from[i]), [&] (Dart d)
+			{
+				if (!map_.is_boundary_cell(CellType(d)))
+					mark_dirty(CellType(d));
+			});
+		}
+	}
+
+	template <typename CellType>
+	inline void clear()
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		if (markers_[ORBIT])
+			markers_[ORBIT]->unmark_all();
+		cells_[ORBIT].clear();
+	}
+
+private:
+
+	const MAP& map_;
+	std::array<std::vector<Dart>, NB_ORBITS> cells_;
+	// the markers only unmark the darts they have marked: a cache costs the size of its cells, not of the map
+	std::array<std::unique_ptr<DartMarkerStore>, NB_ORBITS> markers_;
+};
+
+/**
+ * @brief The IncrementalCellCache class
+ * A cell cache that observes the topology of its map, so that it stays valid across the topological modifications
+ * without being rebuilt: the cells created or changed by the operators of the map are (re)evaluated against
+ * the selection function given to build and the cells whose darts are removed are withdrawn.
+ * The evaluations are delayed until the next access to the cache (size, begin, pop), when the embeddings are set.
+ * The selection of a cell should only depend on its own darts and embeddings: the neighbors of a changed cell are
+ * not re-evaluated. The cache should not be traversed with foreach_cell while the map is modified: use pop in a
+ * worklist loop instead.
+ * Without CGOGN_WITH_TOPOLOGY_OBSERVERS, the cache does not follow the modifications and is rebuilt once per pass:
+ * size, begin and end rebuild it if the map has been modified since it was filled, and pop checks the cells
+ * as they are popped (removed darts and unselected or boundary cells are skipped) and rebuilds it only when
+ * they have all been popped (the cells added or removed by hand are then lost).
+ */
+template <typename MAP>
+class IncrementalCellCache : public CellTraversor, public TopologyObserver
+{
+public:
+
+	using Inherit = CellTraversor;
+	using Self = IncrementalCellCache<MAP>;
+
+	using const_iterator = std::vector<Dart>::const_iterator;
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(IncrementalCellCache);
+
+	inline IncrementalCellCache(MAP& m) : Inherit(),
+		map_(m)
+	{
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+		map_.add_topology_observer(this);
+#endif
+	}
+
+	virtual ~IncrementalCellCache() override
+	{
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+		if (MapBaseGen::is_alive(&map_))
+			map_.remove_topology_observer(this);
+#endif
+	}
+
+	template <typename CellType>
+	inline const_iterator begin() const
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		flush(ORBIT);
+		return orbits_[ORBIT].cells_.begin();
+	}
+
+	template <typename CellType>
+	inline const_iterator end() const
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		flush(ORBIT);
+		return orbits_[ORBIT].cells_.end();
+	}
+
+	template <typename CellType>
+	inline std::size_t size() const
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		flush(ORBIT);
+		return orbits_[ORBIT].cells_.size();
+	}
+
+	/**
+	 * @brief build the cache with the cells selected by the given function
+	 * The selection function is kept to evaluate the cells created or changed afterwards.
+	 */
+	template <typename CellType, typename SelectionFunction>
+	inline void build(const SelectionFunction& select)
+	{
+		static_assert(is_func_return_same<SelectionFunction, bool>::value && is_func_parameter_same<SelectionFunction, CellType>::value, "Badly formed SelectionFunction");
+		static const Orbit ORBIT = CellType::ORBIT;
+		OrbitCache& oc = orbits_[ORBIT];
+		oc.cells_.reserve(4096u);
+		oc.select_ = [select] (Dart d) -> bool { return select(CellType(d)); };
+		oc.update_ = [this] (Dart d) { this->update(CellType(d)); };
+		oc.fill_ = [this, select] () { this->fill<CellType>(select); };
+		// pending events of the map are obsolete
+		map_.flush_topology_events();
+		fill<CellType>(select);
+		traversed_cells_ |= orbit_mask<CellType>();
+	}
+
+	template <typename CellType>
+	inline void build()
+	{
+		this->build<CellType>([] (CellType) { return true; });
+	}
+
+	/**
+	 * @brief add the cell c to the cache, if it is not already in it
+	 */
+	template <typename CellType>
+	inline void add(CellType c)
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		cgogn_message_assert(is_traversed<CellType>(), "Try to add a cell to an IncrementalCellCache that has not been built");
+		OrbitCache& oc = orbits_[ORBIT];
+		if (representative(oc, c).is_nil())
+			insert(oc, c.dart);
+	}
+
+	/**
+	 * @brief remove the cell c from the cache, it is added again if it changes afterwards and is selected
+	 */
+	template <typename CellType>
+	inline void remove(CellType c)
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		cgogn_message_assert(is_traversed<CellType>(), "Try to remove a cell from an IncrementalCellCache that has not been built");
+		OrbitCache& oc = orbits_[ORBIT];
+		const Dart d = representative(oc, c);
+		if (!d.is_nil())
+			erase(oc, d);
+	}
+
+	/**
+	 * @brief remove a cell from the cache and return it
+	 * @return the removed cell, or an invalid cell if the cache is empty
+	 */
+	template <typename CellType>
+	inline CellType pop()
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		OrbitCache& oc = orbits_[ORBIT];
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+		flush(ORBIT);
+		if (oc.cells_.empty())
+			return CellType();
+		const Dart d = oc.cells_.back();
+		erase(oc, d);
+		return CellType(d);
+#else
+		while (true)
+		{
+			if (oc.cells_.empty())
+			{
+				// end of the pass: the cells created or changed during the pass are collected by a single rebuild
+				if (!oc.fill_ || !is_stale(oc))
+					return CellType();
+				oc.fill_();
+				continue;
+			}
+			const Dart d = oc.cells_.back();
+			erase(oc, d);
+			if (!is_stale(oc))
+				return CellType(d);
+			const CellType c(d);
+			if (map_.topology_container().used(d.index) && !map_.is_boundary_cell(c) && oc.select_(d))
+				return c;
+		}
+#endif
+	}
+
+	template <typename CellType>
+	inline void clear()
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		OrbitCache& oc = orbits_[ORBIT];
+		for (Dart d : oc.cells_)
+			oc.slots_[d.index] = INVALID_INDEX;
+		oc.cells_.clear();
+		oc.pending_.clear();
+	}
+
+	virtual void darts_removed(const std::vector<Dart>& darts) override
+	{
+		for (OrbitCache& oc : orbits_)
+		{
+			for (Dart d : darts)
+			{
+				if (slot(oc, d) != INVALID_INDEX)
+					erase(oc, d);
+			}
+		}
+	}
+
+	virtual void cells_created(Orbit orbit, const std::vector<Dart>& darts) override
+	{
+		OrbitCache& oc = orbits_[orbit];
+		if (oc.update_)
+			oc.pending_.insert(oc.pending_.end(), darts.begin(), darts.end());
+	}
+
+	virtual void cells_modified(Orbit orbit, const std::vector<Dart>& darts) override
+	{
+		cells_created(orbit, darts);
+	}
+
+private:
+
+	struct OrbitCache
+	{
+		// darts representing the cells of the cache
+		std::vector<Dart> cells_;
+		// position in cells_ of each dart, INVALID_INDEX for the darts that do not represent a cell of the cache
+		std::vector<uint32> slots_;
+		// darts of the cells to evaluate at the next access
+		std::vector<Dart> pending_;
+		std::function<bool(Dart)> select_;
+		std::function<void(Dart)> update_;
+		std::function<void()> fill_;
+		// topology revision of the map when the cache was filled
+		uint64 revision_ = 0u;
+	};
+
+	template <typename CellType, typename SelectionFunction>
+	inline void fill(const SelectionFunction& select) const
+	{
+		OrbitCache& oc = orbits_[CellType::ORBIT];
+		oc.cells_.clear();
+		oc.pending_.clear();
+		oc.slots_.assign(map_.topology_container().end(), INVALID_INDEX);
+		map_.foreach_cell([&] (CellType c) { insert(oc, c.dart); }, select);
+		oc.revision_ = map_.topology_revision();
+	}
+
+	inline uint32 slot(const OrbitCache& oc, Dart d) const
+	{
+		return d.index < oc.slots_.size() ? oc.slots_[d.index] : INVALID_INDEX;
+	}
+
+	inline void insert(OrbitCache& oc, Dart d) const
+	{
+		if (d.index >= oc.slots_.size())
+			oc.slots_.resize(map_.topology_container().end(), INVALID_INDEX);
+		oc.slots_[d.index] = uint32(oc.cells_.size());
+		oc.cells_.push_back(d);
+	}
+
+	inline void erase(OrbitCache& oc, Dart d) const
+	{
+		const uint32 pos = oc.slots_[d.index];
+		const Dart last = oc.cells_.back();
+		oc.cells_[pos] = last;
+		oc.slots_[last.index] = pos;
+		oc.cells_.pop_back();
+		oc.slots_[d.index] = INVALID_INDEX;
+	}
+
+	template <typename CellType>
+	inline Dart representative(const OrbitCache& oc, CellType c) const
+	{
+		Dart res;
+		map_.foreach_dart_of_orbit(c, [&] (Dart d) -> bool
+		{
+			if (slot(oc, d) != INVALID_INDEX)
+				res = d;
+			return res.is_nil();
+		});
+		return res;
+	}
+
+	/**
+	 * @brief evaluate a cell that has been created or changed
+	 * The cell keeps a single representative dart in the cache if it is selected and is not a boundary cell.
+	 */
+	template <typename CellType>
+	inline void update(CellType c) const
+	{
+		static const Orbit ORBIT = CellType::ORBIT;
+		OrbitCache& oc = orbits_[ORBIT];
+		Dart rep;
+		map_.foreach_dart_of_orbit(c, [&] (Dart d)
+		{
+			if (slot(oc, d) != INVALID_INDEX)
+			{
+				if (rep.is_nil())
+					rep = d;
+				else
+					erase(oc, d); // the cell has been merged with another cell of the cache
+			}
+		});
+		const bool selected = !map_.is_boundary_cell(c) && oc.select_(c.dart);
+		if (selected && rep.is_nil())
+			insert(oc, c.dart);
+		else if (!selected && !rep.is_nil())
+			erase(oc, rep);
+	}
+
+	inline bool is_stale(const OrbitCache& oc) const
+	{
+		return oc.revision_ != map_.topology_revision();
+	}
+
+	inline void flush(Orbit orbit) const
+	{
+		OrbitCache& oc = orbits_[orbit];
+#ifdef CGOGN_WITH_TOPOLOGY_OBSERVERS
+		// the maps that do not flush their events in their operators
+		map_.flush_topology_events();
+#else
+		if (oc.fill_ && is_stale(oc))
+			oc.fill_();
+#endif
+		if (oc.pending_.empty())
+			return;
+		// the evaluations do not modify the map and thus do not notify new cells
+		for (Dart d : oc.pending_)
+		{
+			if (map_.topology_container().used(d.index))
+				oc.update_(d);
+		}
+		oc.pending_.clear();
+	}
+
+	MAP& map_;
+	mutable std::array<OrbitCache, NB_ORBITS> orbits_;
+};
+
 template <typename MAP>
 class BoundaryCache : public CellTraversor
 {
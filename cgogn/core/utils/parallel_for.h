@@ -0,0 +1,218 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+
+#ifndef CGOGN_CORE_UTILS_PARALLEL_FOR_H_
+#define CGOGN_CORE_UTILS_PARALLEL_FOR_H_
+
+#include <vector>
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/type_traits.h>
+#include <cgogn/core/utils/thread.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/buffers.h>
+
+namespace cgogn
+{
+
+/**
+ * @brief apply f in parallel on the blocks of grain consecutive indices of [first, last)
+ * The blocks are dynamically grabbed by the workers (at most one job per worker is enqueued),
+ * nothing is allocated and f is only called from the workers of the pool
+ * (so that current_thread_index() can be used inside f).
+ * In NUMA-aware mode (see ThreadPool::set_numa_aware), the blocks are statically distributed:
+ * block b is processed by worker b % nb_workers, which is the worker that first touched the chunk b
+ * when grain is the CHUNK_SIZE of the traversed container and first is 0.
+ * @param first first index of the range
+ * @param last end of the range (excluded)
+ * @param grain number of indices of a block
+ * @param f function with 2 params (begin and end of a block)
+ */
+template <typename FUNC>
+void parallel_for(uint32 first, uint32 last, uint32 grain, const FUNC& f)
+{
+	static_assert(is_ith_func_parameter_same<FUNC, 0, uint32>::value && is_ith_func_parameter_same<FUNC, 1, uint32>::value, "parallel_for: given function should take 2 uint32 as parameters");
+
+	if (first >= last)
+		return;
+
+	ThreadPool* thread_pool = cgogn::thread_pool();
+	const uint32 nb_workers = thread_pool->nb_workers();
+	if (nb_workers == 0u)
+	{
+		f(first, last);
+		return;
+	}
+
+	grain = std::max(grain, 1u);
+	const uint32 nb_blocks = (last - first) / grain + ((last - first) % grain == 0u ? 0u : 1u);
+
+	auto block = [&] (uint32 b)
+	{
+		const uint32 begin = first + b * grain;
+		f(begin, (last - begin > grain) ? begin + grain : last);
+	};
+
+	JobCounter counter;
+	const uint32 nb_jobs = std::min(nb_workers, nb_blocks);
+
+	if (thread_pool->numa_aware())
+	{
+		struct StaticJob
+		{
+			const decltype(block)* block_;
+			uint32 worker_;
+			uint32 nb_workers_;
+			uint32 nb_blocks_;
+
+			inline void operator()() const
+			{
+				for (uint32 b = worker_; b < nb_blocks_; b += nb_workers_)
+					(*block_)(b);
+			}
+		};
+
+		std::vector<StaticJob> jobs;
+		jobs.reserve(nb_jobs);
+		for (uint32 j = 0u; j < nb_jobs; ++j)
+		{
+			jobs.push_back(StaticJob{&block, j, nb_workers, nb_blocks});
+			thread_pool->enqueue_job(counter, jobs.back(), j);
+		}
+		thread_pool->wait(counter);
+		return;
+	}
+
+	std::atomic<uint32> next_block(0u);
+	auto job = [&] ()
+	{
+		for (uint32 b = next_block++; b < nb_blocks; b = next_block++)
+			block(b);
+	};
+
+	for (uint32 j = 0u; j < nb_jobs; ++j)
+		thread_pool->enqueue_job(counter, job);
+	thread_pool->wait(counter);
+}
+
+namespace internal
+{
+
+/**
+ * @brief a value followed by a cache line of padding
+ * (used for per thread accumulators, so that two threads never write in the same cache line)
+ */
+template <typename T>
+struct PaddedValue
+{
+	PaddedValue(const T& value) : value_(value) {}
+
+	T value_;
+	char padding_[64];
+};
+
+/**
+ * @brief apply f in parallel on a sequence of elements produced by the calling thread
+ * The calling thread fills buffers of elements (fill(buffer) returns false when the sequence is exhausted)
+ * while the workers process the previously filled buffers (double buffering).
+ * The buffers are taken from the given pool (T and B must have the same size, cf. Buffers<Dart>::cell_buffer)
+ * and the jobs are dispatched without any future.
+ * @param buffs pool of buffers
+ * @param fill function that fills a buffer with at most PARALLEL_BUFFER_SIZE elements
+ * @param f function applied on each element
+ */
+template <typename T, typename B, typename FILL, typename FUNC>
+void parallel_foreach_buffered(Buffers<B>* buffs, const FILL& fill, const FUNC& f)
+{
+	static_assert(sizeof(T) == sizeof(B), "Cannot cast buffer of B in buffer of T");
+
+	using VecT = std::vector<T>;
+
+	struct Job
+	{
+		VecT* elements_;
+		const FUNC* f_;
+
+		inline void operator()() const
+		{
+			for (const auto& e : *elements_)
+				(*f_)(e);
+		}
+	};
+
+	ThreadPool* thread_pool = cgogn::thread_pool();
+	const uint32 nb_workers = thread_pool->nb_workers();
+
+	std::vector<Job> jobs(2u * nb_workers, Job{nullptr, &f});
+	std::array<JobCounter, 2> counters;
+	std::array<uint32, 2> nb_jobs = {{0u, 0u}};
+
+	auto release = [&] (uint32 i)
+	{
+		for (uint32 j = 0u; j < nb_jobs[i]; ++j)
+			buffs->release_buffer(reinterpret_cast<std::vector<B>*>(jobs[i * nb_workers + j].elements_));
+		nb_jobs[i] = 0u;
+	};
+
+	uint32 i = 0u; // buffer id (0/1)
+	bool more = true;
+	while (more)
+	{
+		VecT* elements = reinterpret_cast<VecT*>(buffs->buffer());
+		elements->reserve(PARALLEL_BUFFER_SIZE);
+		more = fill(*elements);
+		if (elements->empty())
+		{
+			buffs->release_buffer(reinterpret_cast<std::vector<B>*>(elements));
+			continue;
+		}
+
+		Job& job = jobs[i * nb_workers + nb_jobs[i]++];
+		job.elements_ = elements;
+		thread_pool->enqueue_job(counters[i], job);
+
+		if (nb_jobs[i] == nb_workers)
+		{	// change buffer
+			i = (i + 1u) % 2u;
+			thread_pool->wait(counters[i]);
+			release(i);
+		}
+	}
+
+	// clean all at end
+	thread_pool->wait(counters[0u]);
+	release(0u);
+	thread_pool->wait(counters[1u]);
+	release(1u);
+}
+
+} // namespace internal
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_PARALLEL_FOR_H_
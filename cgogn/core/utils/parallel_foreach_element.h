@@ -32,6 +32,7 @@
 #include <cgogn/core/utils/thread.h>
 #include <cgogn/core/utils/thread_pool.h>
 #include <cgogn/core/utils/buffers.h>
+#include <cgogn/core/utils/parallel_for.h>
 
 namespace cgogn
 {
@@ -56,9 +57,6 @@ void parallel_foreach_element(CONT& cont, const FUNC& f)
 				  "Wrong function parameter type");
 
 
-	using VectItELt = std::vector<IterElt>;
-	using Future = std::future<typename std::result_of<FUNC(T_ELT)>::type>;
-
 	ThreadPool* thread_pool = cgogn::thread_pool();
 	uint32 nb_workers = thread_pool->nb_workers();
 
@@ -69,59 +67,21 @@ void parallel_foreach_element(CONT& cont, const FUNC& f)
 		return;
 	}
 
-	std::array<std::vector<VectItELt*>, 2> elts_buffers;
-	std::array<std::vector<Future>, 2> futures;
-	elts_buffers[0].reserve(nb_workers);
-	elts_buffers[1].reserve(nb_workers);
-	futures[0].reserve(nb_workers);
-	futures[1].reserve(nb_workers);
-
 	Buffers<IterElt> buffs;
 
 	IterElt it = cont.begin();
 	IterElt last = cont.end();
 
-	uint32 i = 0u; // buffer id (0/1)
-	uint32 j = 0u; // thread id (0..nb_workers)
-	while (it != last)
-	{
-		// fill buffer
-		elts_buffers[i].push_back(buffs.buffer());
-		VectItELt& elts = *elts_buffers[i].back();
-		elts.reserve(PARALLEL_BUFFER_SIZE);
-		for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && it!= last; ++it,++k)
-		{
-			elts.push_back(it);
-		}
-		// launch thread
-		futures[i].push_back(thread_pool->enqueue([&elts, &f] ()
+	internal::parallel_foreach_buffered<IterElt>(
+		&buffs,
+		[&] (std::vector<IterElt>& elts) -> bool
 		{
-			for (auto e : elts)
-				f(*e);
-		}));
-		// next thread
-		if (++j == nb_workers)
-		{	// again from 0 & change buffer
-			j = 0;
-			i = (i+1u) % 2u;
-			for (auto& fu : futures[i])
-				fu.wait();
-			for (auto& b : elts_buffers[i])
-				buffs.release_buffer(b);
-			futures[i].clear();
-			elts_buffers[i].clear();
-		}
-	}
-
-	// clean all at end
-	for (auto& fu : futures[0u])
-		fu.wait();
-	for (auto& b : elts_buffers[0u])
-		buffs.release_buffer(b);
-	for (auto& fu : futures[1u])
-		fu.wait();
-	for (auto& b : elts_buffers[1u])
-		buffs.release_buffer(b);
+			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && it != last; ++it, ++k)
+				elts.push_back(it);
+			return it != last;
+		},
+		[&f] (IterElt e) { f(*e); }
+	);
 }
 
 
@@ -153,9 +113,6 @@ namespace internal
 	{
 		using Iterators = typename PFP::Iterators;
 
-		using Future = std::future<void>;
-		using VectItELt = std::vector<Iterators>;
-
 		ThreadPool* thread_pool = cgogn::thread_pool();
 		uint32 nb_workers = thread_pool->nb_workers();
 
@@ -172,58 +129,20 @@ namespace internal
 			return;
 		}
 
-		std::array<std::vector<VectItELt*>, 2> elts_buffers;
-		std::array<std::vector<Future>, 2> futures;
-		elts_buffers[0].reserve(nb_workers);
-		elts_buffers[1].reserve(nb_workers);
-		futures[0].reserve(nb_workers);
-		futures[1].reserve(nb_workers);
-
 		Buffers<Iterators> buffs;
 		Iterators its = p.begin();
 		Iterators ends = p.end();
-		uint32 i = 0u; // buffer id (0/1)
-		uint32 j = 0u; // thread id (0..nb_workers)
 
-		while (PFP::diff(its, ends))
-		{
-			// fill buffer
-			elts_buffers[i].push_back(buffs.buffer());
-			VectItELt& elts = *elts_buffers[i].back();
-			elts.reserve(PARALLEL_BUFFER_SIZE);
-			for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && PFP::diff(its, ends); p.next(its), ++k)
-			{
-				elts.push_back(its);
-			}
-			// launch thread
-			futures[i].push_back(thread_pool->enqueue([&elts, &f]()
+		parallel_foreach_buffered<Iterators>(
+			&buffs,
+			[&] (std::vector<Iterators>& elts) -> bool
 			{
-				for (auto e : elts)
-					PFP::call(f, e);
-			}));
-			// next thread
-			if (++j == nb_workers)
-			{	// again from 0 & change buffer
-				j = 0;
-				i = (i + 1u) % 2u;
-				for (auto& fu : futures[i])
-					fu.wait();
-				for (auto& b : elts_buffers[i])
-					buffs.release_buffer(b);
-				futures[i].clear();
-				elts_buffers[i].clear();
-			}
-		}
-
-		// clean all at end
-		for (auto& fu : futures[0u])
-			fu.wait();
-		for (auto& b : elts_buffers[0u])
-			buffs.release_buffer(b);
-		for (auto& fu : futures[1u])
-			fu.wait();
-		for (auto& b : elts_buffers[1u])
-			buffs.release_buffer(b);
+				for (unsigned k = 0u; k < PARALLEL_BUFFER_SIZE && PFP::diff(its, ends); p.next(its), ++k)
+					elts.push_back(its);
+				return PFP::diff(its, ends);
+			},
+			[&f] (const Iterators& e) { PFP::call(f, e); }
+		);
 	}
 
 }
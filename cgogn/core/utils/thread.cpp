@@ -76,6 +76,55 @@ CGOGN_CORE_EXPORT uint32 current_thread_index()
 }
 
 
+namespace
+{
+
+std::size_t shrink_local_buffers()
+{
+	std::size_t nb_bytes = 0u;
+	if (dart_buffers_thread_ != nullptr)
+		nb_bytes += dart_buffers_thread_->shrink();
+	if (uint_buffers_thread_ != nullptr)
+		nb_bytes += uint_buffers_thread_->shrink();
+	return nb_bytes;
+}
+
+std::size_t local_buffers_memory_usage()
+{
+	std::size_t nb_bytes = 0u;
+	if (dart_buffers_thread_ != nullptr)
+		nb_bytes += dart_buffers_thread_->memory_usage();
+	if (uint_buffers_thread_ != nullptr)
+		nb_bytes += uint_buffers_thread_->memory_usage();
+	return nb_bytes;
+}
+
+} // namespace
+
+CGOGN_CORE_EXPORT std::size_t shrink_thread_buffers()
+{
+	std::size_t nb_bytes = shrink_local_buffers();
+	ThreadPool* pool = thread_pool();
+	if (!pool->is_worker())
+	{
+		for (uint32 i = 0u, nb_workers = pool->nb_workers(); i < nb_workers; ++i)
+			pool->execute_on_worker(i, [&nb_bytes] () { nb_bytes += shrink_local_buffers(); });
+	}
+	return nb_bytes;
+}
+
+CGOGN_CORE_EXPORT std::size_t thread_buffers_memory_usage()
+{
+	std::size_t nb_bytes = local_buffers_memory_usage();
+	ThreadPool* pool = thread_pool();
+	if (!pool->is_worker())
+	{
+		for (uint32 i = 0u, nb_workers = pool->nb_workers(); i < nb_workers; ++i)
+			pool->execute_on_worker(i, [&nb_bytes] () { nb_bytes += local_buffers_memory_usage(); });
+	}
+	return nb_bytes;
+}
+
 CGOGN_CORE_EXPORT ThreadPool* thread_pool()
 {
 	// thread safe accoring to http://stackoverflow.com/questions/8102125/is-local-static-variable-initialization-thread-safe-in-c11
@@ -84,6 +84,17 @@ CGOGN_CORE_EXPORT uint32 current_thread_marker_index();
  */
 CGOGN_CORE_EXPORT uint32 current_thread_index();
 
+/**
+ * @brief free the buffers cached by the calling thread and by the workers of the internal thread pool
+ * @return the number of bytes released
+ */
+CGOGN_CORE_EXPORT std::size_t shrink_thread_buffers();
+
+/**
+ * @brief memory used by the buffers cached by the calling thread and by the workers of the internal thread pool
+ */
+CGOGN_CORE_EXPORT std::size_t thread_buffers_memory_usage();
+
 
 
 } // namespace cgogn
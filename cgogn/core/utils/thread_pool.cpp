@@ -22,19 +22,32 @@
 *******************************************************************************/
 
 
+#include <algorithm>
+
 #include <cgogn/core/utils/thread_pool.h>
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
 namespace cgogn
 
 {
 
+// pool and deque index of the current thread (only set in the workers)
+static CGOGN_TLS ThreadPool* local_pool_ = nullptr;
+static CGOGN_TLS uint32 local_queue_index_ = 0u;
+
 ThreadPool::~ThreadPool()
 {
 	nb_working_workers_ = uint32(workers_.size());
 	condition_running_.notify_all();
 
 	{
-		std::unique_lock<std::mutex> lock(queue_mutex_);
+		std::unique_lock<std::mutex> lock(sleep_mutex_);
 		stop_ = true;
 	}
 #if !(defined(CGOGN_WIN_VER) && (CGOGN_WIN_VER <= 61))
@@ -48,16 +61,25 @@ ThreadPool::~ThreadPool()
 
 
 ThreadPool::ThreadPool(const std::string& name, uint32 shift_index)
-	:  name_(name), stop_(false), shift_index_(shift_index)
+	:  name_(name), nb_pending_tasks_(0u), next_queue_(0u), stop_(false), shift_index_(shift_index), numa_aware_(false)
 {
 	uint32 nb_ww = std::thread::hardware_concurrency();
 	this->nb_working_workers_ = nb_ww;
+
+	queues_.reserve(nb_ww);
+	for(uint32 i = 0u; i< nb_ww; ++i)
+		queues_.emplace_back(new WorkQueue());
+
 	for(uint32 i = 0u; i< nb_ww; ++i)
 	{
 		workers_.emplace_back(
 		[this, i] () -> void
 		{
 			cgogn::thread_start(i,this->shift_index_);
+			local_pool_ = this;
+			local_queue_index_ = i;
+
+			Task task;
 			for(;;)
 			{
 				while (i >= this->nb_working_workers_)
@@ -66,40 +88,148 @@ ThreadPool::ThreadPool(const std::string& name, uint32 shift_index)
 					this->condition_running_.wait(lock);
 				}
 
-				std::unique_lock<std::mutex> lock(this->queue_mutex_);
+				if (this->pop_task(i, task))
+				{
+					task.run();
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(this->sleep_mutex_);
 				this->condition_.wait(
 					lock,
-					[this] { return this->stop_ || !this->tasks_.empty(); }
+					[this, i] { return this->stop_ || this->nb_pending_tasks_ > 0u || this->queues_[i]->nb_pinned_tasks_ > 0u || i >= this->nb_working_workers_; }
 				);
 
-				if (this->stop_ && this->tasks_.empty())
+				if (this->stop_ && this->nb_pending_tasks_ == 0u && this->queues_[i]->nb_pinned_tasks_ == 0u)
 				{
+					local_pool_ = nullptr;
 					cgogn::thread_stop();
 					return;
 				}
-
-				if (i < this->nb_working_workers_)
-				{
-					PackagedTask task = std::move(this->tasks_.front());
-					this->tasks_.pop();
-					lock.unlock();
-#if defined(_MSC_VER) && _MSC_VER < 1900
-					(*task)();
-#else
-					task();
-#endif
-				}
-				else
-				{
-					lock.unlock();
-					condition_.notify_one();
-				}
 			}
 		});
 	}
 }
 
+void ThreadPool::push_task(Task&& task, uint32 worker)
+{
+	const uint32 nb_queues = uint32(queues_.size());
+	// workers push in their own deque, other threads distribute the tasks over the working workers
+	const uint32 q = (worker < nb_queues) ?
+		worker :
+		(local_pool_ == this) ?
+			local_queue_index_ :
+			next_queue_++ % std::max(1u, std::min(nb_working_workers_, nb_queues));
+
+	const bool pinned = task.pinned_;
+	{
+		std::lock_guard<std::mutex> lock(queues_[q]->mutex_);
+		queues_[q]->tasks_.push_back(std::move(task));
+		if (pinned)
+			++queues_[q]->nb_pinned_tasks_;
+		else
+			++nb_pending_tasks_;
+	}
+
+	{
+		// taking the lock ensures that no worker is between its predicate check and its sleep
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
+	}
+	// Notify a thread that there is new work to perform (the target worker for a pinned task)
+	if (pinned)
+		condition_.notify_all();
+	else
+		condition_.notify_one();
+}
 
+bool ThreadPool::pop_task(uint32 i, Task& task)
+{
+	if (nb_pending_tasks_ == 0u && queues_[i]->nb_pinned_tasks_ == 0u)
+		return false;
+
+	const uint32 nb_queues = uint32(queues_.size());
+
+	// own deque first (LIFO)
+	{
+		WorkQueue& wq = *queues_[i];
+		std::lock_guard<std::mutex> lock(wq.mutex_);
+		if (!wq.tasks_.empty())
+		{
+			task = std::move(wq.tasks_.back());
+			wq.tasks_.pop_back();
+			if (task.pinned_)
+				--wq.nb_pinned_tasks_;
+			else
+				--nb_pending_tasks_;
+			return true;
+		}
+	}
+
+	// steal the oldest task of another worker (FIFO), pinned tasks excepted
+	for (uint32 k = 1u; k < nb_queues && nb_pending_tasks_ > 0u; ++k)
+	{
+		WorkQueue& wq = *queues_[(i + k) % nb_queues];
+		std::unique_lock<std::mutex> lock(wq.mutex_, std::try_to_lock);
+		if (lock.owns_lock())
+		{
+			auto it = std::find_if(wq.tasks_.begin(), wq.tasks_.end(), [] (const Task& t) { return !t.pinned_; });
+			if (it != wq.tasks_.end())
+			{
+				task = std::move(*it);
+				wq.tasks_.erase(it);
+				--nb_pending_tasks_;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool ThreadPool::is_worker() const
+{
+	return local_pool_ == this;
+}
+
+bool ThreadPool::run_pending_task()
+{
+	cgogn_message_assert(is_worker(), "run_pending_task must be called from a worker of the pool");
+
+	Task task;
+	if (!pop_task(local_queue_index_, task))
+		return false;
+	task.run();
+	return true;
+}
+
+void ThreadPool::wait(JobCounter& counter)
+{
+	if (is_worker())
+	{
+		// help the other workers instead of blocking one of them
+		while (!counter.finished())
+		{
+			if (!run_pending_task())
+				std::this_thread::yield();
+		}
+	}
+	counter.wait();
+}
+
+void ThreadPool::Task::run()
+{
+	if (job_ != nullptr)
+	{
+		job_(job_data_);
+		counter_->done();
+		return;
+	}
+#if defined(_MSC_VER) && _MSC_VER < 1900
+	(*packaged_task_)();
+#else
+	packaged_task_();
+#endif
+}
 
 void ThreadPool::set_nb_workers(uint32 nb )
 {
@@ -109,9 +239,45 @@ void ThreadPool::set_nb_workers(uint32 nb )
 		nb_working_workers_ = std::min(uint32(workers_.size()), nb);
 
 	condition_running_.notify_all();
+	condition_.notify_all();
 
 	cgogn_log_info("ThreadPool") << name_ << " using " << nb_working_workers_ << " thread-workers";
 }
 
-} // namespace cgogn
+void ThreadPool::set_numa_aware(bool b)
+{
+	if (b == numa_aware_)
+		return;
+	pin_workers(b);
+	numa_aware_ = b;
+	cgogn_log_info("ThreadPool") << name_ << (b ? " NUMA-aware mode on" : " NUMA-aware mode off");
+}
 
+void ThreadPool::pin_workers(bool b)
+{
+	const uint32 nb_cores = std::max(1u, std::thread::hardware_concurrency());
+	for (uint32 i = 0u; i < uint32(workers_.size()); ++i)
+	{
+#if defined(__linux__)
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		if (b)
+			CPU_SET(i % nb_cores, &cpuset);
+		else
+			for (uint32 c = 0u; c < nb_cores; ++c)
+				CPU_SET(c, &cpuset);
+		if (pthread_setaffinity_np(workers_[i].native_handle(), sizeof(cpu_set_t), &cpuset) != 0)
+			cgogn_log_warning("ThreadPool::pin_workers") << "Unable to set the affinity of worker " << i;
+#elif defined(_WIN32)
+		const DWORD_PTR mask = b ? (DWORD_PTR(1) << (i % nb_cores)) : ~DWORD_PTR(0) >> (sizeof(DWORD_PTR) * 8u - std::min(nb_cores, uint32(sizeof(DWORD_PTR) * 8u)));
+		if (SetThreadAffinityMask(workers_[i].native_handle(), mask) == 0)
+			cgogn_log_warning("ThreadPool::pin_workers") << "Unable to set the affinity of worker " << i;
+#else
+		unused_parameters(b);
+		cgogn_log_warning("ThreadPool::pin_workers") << "Thread pinning is not supported on this platform";
+		return;
+#endif
+	}
+}
+
+} // namespace cgogn
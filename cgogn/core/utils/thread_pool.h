@@ -57,10 +57,12 @@
 #define CGOGN_CORE_UTILS_THREADPOOL_H_
 
 #include <vector>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <future>
 #include <functional>
@@ -72,6 +74,63 @@
 namespace cgogn
 {
 
+/**
+ * @brief Counter of the jobs (see ThreadPool::enqueue_job) that remain to be executed.
+ * It replaces the futures for the synchronization of the parallel algorithms:
+ * it does not allocate anything and can live on the stack of the calling function.
+ */
+class CGOGN_CORE_EXPORT JobCounter final
+{
+public:
+
+	inline JobCounter() : nb_jobs_(0u) {}
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(JobCounter);
+
+	inline void add(uint32 nb = 1u)
+	{
+		nb_jobs_ += nb;
+	}
+
+	inline void done()
+	{
+		// the lock keeps the counter alive until the waiting thread is notified
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (--nb_jobs_ == 0u)
+			condition_.notify_all();
+	}
+
+	inline bool finished() const
+	{
+		return nb_jobs_ == 0u;
+	}
+
+	inline void wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		condition_.wait(lock, [this] { return nb_jobs_ == 0u; });
+	}
+
+private:
+#pragma warning(push)
+#pragma warning(disable:4251)
+	std::atomic<uint32> nb_jobs_;
+	std::mutex mutex_;
+	std::condition_variable condition_;
+#pragma warning(pop)
+};
+
+/**
+ * @brief Pool of worker threads with a work-stealing scheduler.
+ * Each worker owns a deque of tasks: it pops its own tasks from the back (LIFO)
+ * and, when its deque is empty, steals tasks from the front (FIFO) of the deques of the other workers.
+ * Tasks enqueued from a worker are pushed in its own deque, tasks enqueued from another thread
+ * are distributed over the deques of the working workers in a round-robin fashion.
+ * Jobs can also be pinned to a given worker (they are never stolen).
+ *
+ * In NUMA-aware mode (set_numa_aware), the workers are pinned to the cores, the chunks of the
+ * ChunkArrays are first touched by the worker that processes them in the parallel traversals
+ * and parallel_for distributes its blocks statically (block b is processed by worker b % nb_workers).
+ */
 class CGOGN_CORE_EXPORT ThreadPool final
 {
 public:
@@ -88,6 +147,45 @@ public:
 	template <class F, class... Args>
 	std::future<void> enqueue(const F& f, Args&&... args);
 
+	/**
+	 * @brief wait for the end of a task enqueued in this pool
+	 * When called from one of the workers of the pool, the waiting worker executes pending tasks
+	 * until the awaited one is done. Parallel algorithms can thus be launched from inside a task
+	 * (nested parallelism) without deadlocking the pool.
+	 * @param fu the future returned by enqueue
+	 */
+	template <typename T>
+	void wait(std::future<T>& fu);
+
+	/**
+	 * @brief enqueue a job without allocating any task nor future
+	 * The job is called by reference: it must stay alive until the counter has been waited for.
+	 * @param counter the counter incremented now and decremented when the job is done
+	 * @param job a callable without parameter
+	 */
+	template <typename JOB>
+	void enqueue_job(JobCounter& counter, JOB& job);
+
+	/**
+	 * @brief enqueue a job that can only be executed by the given worker (it is never stolen)
+	 * @param worker index of the worker in [0, nb_workers()[
+	 */
+	template <typename JOB>
+	void enqueue_job(JobCounter& counter, JOB& job, uint32 worker);
+
+	/**
+	 * @brief execute f in the given worker and wait for its end
+	 * If the calling thread is itself a worker, f is directly executed.
+	 */
+	template <typename FUNC>
+	void execute_on_worker(uint32 worker, const FUNC& f);
+
+	/**
+	 * @brief wait for the end of all the jobs attached to the given counter
+	 * As for the futures, a waiting worker executes pending tasks in the meantime.
+	 */
+	void wait(JobCounter& counter);
+
 	~ThreadPool();
 
 	/**
@@ -112,22 +210,82 @@ public:
 	 */
 	void set_nb_workers(uint32 nb = 0xffffffff);
 
+	/**
+	 * @brief enable/disable the NUMA-aware mode: workers pinned to the cores, first-touch
+	 * of the chunks by the worker that processes them and static distribution of parallel_for
+	 */
+	void set_numa_aware(bool b);
+
+	inline bool numa_aware() const
+	{
+		return numa_aware_;
+	}
+
+	/**
+	 * @brief return true if the calling thread is one of the workers of this pool
+	 */
+	bool is_worker() const;
+
+	/**
+	 * @brief execute one pending task (if any) in the calling thread
+	 * @return true if a task has been executed
+	 * Only meaningful when called from one of the workers of the pool.
+	 */
+	bool run_pending_task();
+
 private:
 #pragma warning(push)
 #pragma warning(disable:4251)
 
+	// either a packaged task (enqueue) or a job (enqueue_job)
+	struct Task
+	{
+		inline Task() : job_(nullptr), job_data_(nullptr), counter_(nullptr), pinned_(false) {}
+
+		PackagedTask packaged_task_;
+		void (*job_)(void*);
+		void* job_data_;
+		JobCounter* counter_;
+		bool pinned_;
+
+		void run();
+	};
+
+	// per worker deque of tasks
+	struct WorkQueue
+	{
+		inline WorkQueue() : nb_pinned_tasks_(0u) {}
+		std::mutex mutex_;
+		std::deque<Task> tasks_;
+		std::atomic<uint32> nb_pinned_tasks_;
+	};
+
+	// push in the deque of the given worker (or chosen as explained above if worker is out of range)
+	void push_task(Task&& task, uint32 worker = 0xffffffff);
+
+	// pin (or unpin) the worker threads to the cores
+	void pin_workers(bool b);
+
+	// pop a task from the deque of worker i or steal it from another worker
+	bool pop_task(uint32 i, Task& task);
+
 	// just info log
 	std::string name_;
 
 	// need to keep track of threads so we can join them
 	std::vector<std::thread> workers_;
-	// the task queue
-	std::queue<PackagedTask> tasks_;
+	// the task deques (one per worker)
+	std::vector<std::unique_ptr<WorkQueue>> queues_;
+	// number of tasks waiting in the deques that can be stolen
+	std::atomic<uint32> nb_pending_tasks_;
+	// round-robin index for tasks enqueued from outside of the pool
+	std::atomic<uint32> next_queue_;
 
 	// synchronization
-	std::mutex queue_mutex_;
+	std::mutex sleep_mutex_;
 	std::condition_variable condition_;
-	bool stop_;
+	// read without lock by the threads that enqueue tasks
+	std::atomic<bool> stop_;
 
 	// limit usage to the n-th first workers
 	uint32 nb_working_workers_;
@@ -136,6 +294,8 @@ private:
 
 	uint32 shift_index_;
 
+	bool numa_aware_;
+
 #pragma warning(pop)
 };
 
@@ -158,20 +318,83 @@ std::future<void> ThreadPool::enqueue(const F& f, Args&&... args)
 	std::future<void> res = task.get_future();
 #endif
 
+	// don't allow enqueueing after stopping the pool
+	if (stop_.load(std::memory_order_acquire))
 	{
-		std::unique_lock<std::mutex> lock(queue_mutex_);
-		// don't allow enqueueing after stopping the pool
-		if (stop_)
+		cgogn_log_error("ThreadPool::enqueue") << "Enqueue on stopped ThreadPool.";
+		cgogn_assert_not_reached("enqueue on stopped ThreadPool");
+	}
+
+	Task t;
+	t.packaged_task_ = std::move(task);
+	push_task(std::move(t));
+	return res;
+}
+
+template <typename JOB>
+void ThreadPool::enqueue_job(JobCounter& counter, JOB& job)
+{
+	if (stop_.load(std::memory_order_acquire))
+	{
+		cgogn_log_error("ThreadPool::enqueue_job") << "Enqueue on stopped ThreadPool.";
+		cgogn_assert_not_reached("enqueue on stopped ThreadPool");
+	}
+
+	Task t;
+	t.job_ = [] (void* data) { (*static_cast<JOB*>(data))(); };
+	t.job_data_ = &job;
+	t.counter_ = &counter;
+	counter.add();
+	push_task(std::move(t));
+}
+
+template <typename JOB>
+void ThreadPool::enqueue_job(JobCounter& counter, JOB& job, uint32 worker)
+{
+	cgogn_message_assert(worker < nb_workers(), "enqueue_job: invalid worker index");
+
+	if (stop_.load(std::memory_order_acquire))
+	{
+		cgogn_log_error("ThreadPool::enqueue_job") << "Enqueue on stopped ThreadPool.";
+		cgogn_assert_not_reached("enqueue on stopped ThreadPool");
+	}
+
+	Task t;
+	t.job_ = [] (void* data) { (*static_cast<JOB*>(data))(); };
+	t.job_data_ = &job;
+	t.counter_ = &counter;
+	t.pinned_ = true;
+	counter.add();
+	push_task(std::move(t), worker);
+}
+
+template <typename FUNC>
+void ThreadPool::execute_on_worker(uint32 worker, const FUNC& f)
+{
+	if (is_worker() || worker >= nb_workers())
+	{
+		f();
+		return;
+	}
+	JobCounter counter;
+	auto job = [&f] () { f(); };
+	enqueue_job(counter, job, worker);
+	wait(counter);
+}
+
+template <typename T>
+void ThreadPool::wait(std::future<T>& fu)
+{
+	if (is_worker())
+	{
+		// help the other workers instead of blocking one of them
+		while (fu.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
 		{
-			cgogn_log_error("ThreadPool::enqueue") << "Enqueue on stopped ThreadPool.";
-			cgogn_assert_not_reached("enqueue on stopped ThreadPool");
+			if (!run_pending_task())
+				std::this_thread::yield();
 		}
-		// Push work back on the queue
-		tasks_.push(std::move(task));
 	}
-	// Notify a thread that there is new work to perform
-	condition_.notify_one();
-	return res;
+	fu.wait();
 }
 
 /**
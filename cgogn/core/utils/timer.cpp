@@ -22,7 +22,15 @@
 *******************************************************************************/
 
 #include <iostream>
+#include <fstream>
+#include <array>
+#include <atomic>
+#include <map>
+#include <algorithm>
+#include <limits>
+
 #include <cgogn/core/utils/timer.h>
+#include <cgogn/core/utils/logger.h>
 
 namespace cgogn
 {
@@ -30,13 +38,273 @@ namespace cgogn
 AutoTimer::AutoTimer(const char* name) :
 	name_(name),
 	start_(std::chrono::steady_clock::now())
-{}
+{
+#ifdef CGOGN_WITH_PROFILING
+	++Profiler::thread_depth();
+#endif
+}
 
 AutoTimer::~AutoTimer()
 {
 	const auto end = std::chrono::steady_clock::now();
 	const auto diff = end - start_;
 	std::cout << "Duration of " << name_ << " : " << std::chrono::duration<double, std::nano>(diff).count() << " ns." << std::endl;
+#ifdef CGOGN_WITH_PROFILING
+	const uint32 depth = --Profiler::thread_depth();
+	Profiler::get_profiler().record(name_, start_, end, depth);
+#endif
+}
+
+/**
+ * The zones of a thread are stored in a list of blocks that is only modified by this thread:
+ * a zone is written before the size of its block is incremented (release), and a block is filled
+ * before being linked to the previous one (release), so that the readers see complete zones only.
+ */
+struct Profiler::ThreadBuffer
+{
+	static const uint32 BLOCK_SIZE = 1024u;
+
+	struct Block
+	{
+		Block() : size_(0u), next_(nullptr) {}
+		std::array<Zone, BLOCK_SIZE> zones_;
+		std::atomic<uint32> size_;
+		std::atomic<Block*> next_;
+	};
+
+	ThreadBuffer(uint32 thread_id) :
+		thread_id_(thread_id),
+		last_(&first_)
+	{}
+
+	~ThreadBuffer()
+	{
+		Block* b = first_.next_.load();
+		while (b != nullptr)
+		{
+			Block* next = b->next_.load();
+			delete b;
+			b = next;
+		}
+	}
+
+	inline void push(const Zone& z)
+	{
+		uint32 size = last_->size_.load(std::memory_order_relaxed);
+		if (size == BLOCK_SIZE)
+		{
+			Block* b = new Block();
+			last_->next_.store(b, std::memory_order_release);
+			last_ = b;
+			size = 0u;
+		}
+		last_->zones_[size] = z;
+		last_->size_.store(size + 1u, std::memory_order_release);
+	}
+
+	uint32 thread_id_;
+	Block first_;
+	Block* last_;
+};
+
+namespace
+{
+
+thread_local uint32 thread_depth_ = 0u;
+
+// origin of the start times of the zones (zones may start before the creation of the profiler)
+const Profiler::Clock::time_point profiler_origin = Profiler::Clock::now();
+
+void write_json_string(std::ostream& out, const char* s)
+{
+	out << '"';
+	for (; *s != '\0'; ++s)
+	{
+		switch (*s)
+		{
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			default: out << *s;
+		}
+	}
+	out << '"';
+}
+
+} // namespace
+
+Profiler::Profiler()
+{}
+
+Profiler::~Profiler()
+{}
+
+Profiler& Profiler::get_profiler()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+uint32& Profiler::thread_depth()
+{
+	return thread_depth_;
+}
+
+Profiler::ThreadBuffer* Profiler::thread_buffer()
+{
+	static thread_local ThreadBuffer* buffer = nullptr;
+	if (buffer == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(buffers_mutex_);
+		buffers_.emplace_back(new ThreadBuffer(uint32(buffers_.size())));
+		buffer = buffers_.back().get();
+	}
+	return buffer;
+}
+
+void Profiler::record(const char* name, Clock::time_point start, Clock::time_point end, uint32 depth)
+{
+	Zone z;
+	z.name_ = name;
+	z.start_ = uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(start - profiler_origin).count());
+	z.duration_ = uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	z.depth_ = depth;
+	thread_buffer()->push(z);
+}
+
+template <typename FUNC>
+void Profiler::foreach_zone(const FUNC& f) const
+{
+	std::lock_guard<std::mutex> lock(buffers_mutex_);
+	for (const auto& buffer : buffers_)
+	{
+		for (const ThreadBuffer::Block* b = &buffer->first_; b != nullptr; b = b->next_.load(std::memory_order_acquire))
+		{
+			const uint32 size = b->size_.load(std::memory_order_acquire);
+			for (uint32 i = 0u; i < size; ++i)
+				f(buffer->thread_id_, b->zones_[i]);
+		}
+	}
+}
+
+std::size_t Profiler::nb_zones() const
+{
+	std::size_t nb = 0u;
+	foreach_zone([&nb] (uint32, const Zone&) { ++nb; });
+	return nb;
+}
+
+std::vector<Profiler::ZoneStatistics> Profiler::statistics() const
+{
+	struct Accumulator
+	{
+		uint64 count_ = 0u;
+		uint64 total_ = 0u;
+		uint64 min_ = std::numeric_limits<uint64>::max();
+		uint64 max_ = 0u;
+	};
+
+	// zones are grouped by name (not by address, the same literal may have several addresses)
+	std::map<std::string, Accumulator> accumulators;
+	foreach_zone([&accumulators] (uint32, const Zone& z)
+	{
+		Accumulator& acc = accumulators[z.name_];
+		++acc.count_;
+		acc.total_ += z.duration_;
+		acc.min_ = std::min(acc.min_, z.duration_);
+		acc.max_ = std::max(acc.max_, z.duration_);
+	});
+
+	std::vector<std::pair<uint64, ZoneStatistics>> stats;
+	stats.reserve(accumulators.size());
+	for (const auto& it : accumulators)
+	{
+		const Accumulator& acc = it.second;
+		ZoneStatistics zs;
+		zs.name_ = it.first;
+		zs.count_ = acc.count_;
+		zs.min_ = float64(acc.min_) * 1e-6;
+		zs.mean_ = float64(acc.total_) * 1e-6 / float64(acc.count_);
+		zs.max_ = float64(acc.max_) * 1e-6;
+		stats.emplace_back(acc.total_, zs);
+	}
+	std::stable_sort(stats.begin(), stats.end(), [] (const std::pair<uint64, ZoneStatistics>& a, const std::pair<uint64, ZoneStatistics>& b)
+	{
+		return a.first > b.first;
+	});
+
+	std::vector<ZoneStatistics> result;
+	result.reserve(stats.size());
+	for (const auto& it : stats)
+		result.push_back(it.second);
+	return result;
+}
+
+void Profiler::export_chrome_trace(std::ostream& out) const
+{
+	const auto precision = out.precision();
+	const auto flags = out.flags();
+	out.setf(std::ios::fixed);
+	out.precision(3);
+
+	out << "{\"traceEvents\":[";
+	bool first = true;
+	foreach_zone([&] (uint32 thread_id, const Zone& z)
+	{
+		out << (first ? "\n" : ",\n") << "{\"name\":";
+		write_json_string(out, z.name_);
+		out << ",\"cat\":\"cgogn\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread_id
+			<< ",\"ts\":" << float64(z.start_) * 1e-3
+			<< ",\"dur\":" << float64(z.duration_) * 1e-3
+			<< ",\"args\":{\"depth\":" << z.depth_ << "}}";
+		first = false;
+	});
+	out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	out.precision(precision);
+	out.flags(flags);
+}
+
+bool Profiler::export_chrome_trace(const std::string& filename) const
+{
+	std::ofstream out(filename, std::ios::out | std::ios::trunc);
+	if (!out.good())
+	{
+		cgogn_log_warning("export_chrome_trace") << "Unable to open file \"" << filename << "\".";
+		return false;
+	}
+	export_chrome_trace(out);
+	return out.good();
+}
+
+void Profiler::clear()
+{
+	std::lock_guard<std::mutex> lock(buffers_mutex_);
+	for (const auto& buffer : buffers_)
+	{
+		ThreadBuffer::Block* b = buffer->first_.next_.exchange(nullptr);
+		while (b != nullptr)
+		{
+			ThreadBuffer::Block* next = b->next_.load();
+			delete b;
+			b = next;
+		}
+		buffer->first_.size_ = 0u;
+		buffer->last_ = &buffer->first_;
+	}
+}
+
+ProfileZone::ProfileZone(const char* name) :
+	name_(name),
+	depth_(Profiler::thread_depth()++),
+	start_(Profiler::Clock::now())
+{}
+
+ProfileZone::~ProfileZone()
+{
+	const auto end = Profiler::Clock::now();
+	--Profiler::thread_depth();
+	Profiler::get_profiler().record(name_, start_, end, depth_);
 }
 
 } // namespace cgogn
@@ -25,7 +25,28 @@
 #define CGOGN_CORE_UTILS_TIMER_H_
 
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <iosfwd>
+
 #include <cgogn/core/cgogn_core_export.h>
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/definitions.h>
+
+/**
+ * cgogn_profile_zone(name) records the duration of the enclosing scope as a zone named name (a string literal)
+ * in the Profiler. The zones are only recorded when cgogn is built with CGOGN_WITH_PROFILING,
+ * otherwise the macro expands to nothing.
+ */
+#ifdef CGOGN_WITH_PROFILING
+#define CGOGN_PROFILE_ZONE_VARIABLE_(line) cgogn_profile_zone_##line
+#define CGOGN_PROFILE_ZONE_VARIABLE(line) CGOGN_PROFILE_ZONE_VARIABLE_(line)
+#define cgogn_profile_zone(name) ::cgogn::ProfileZone CGOGN_PROFILE_ZONE_VARIABLE(__LINE__)(name)
+#else
+#define cgogn_profile_zone(name)
+#endif
 
 namespace cgogn
 {
@@ -40,6 +61,103 @@ private:
 	std::chrono::time_point<std::chrono::steady_clock> start_;
 };
 
+/**
+ * @brief The Profiler collects the zones recorded by all the threads
+ * Each thread records its zones in its own buffer of blocks, without any lock
+ * (a lock is only taken once per thread, to register its buffer at its first zone).
+ * The zones can be aggregated in statistics per name or exported as a Chrome trace (chrome://tracing, Perfetto).
+ * statistics(), nb_zones() and export_chrome_trace() can be called while threads are recording,
+ * clear() can not.
+ */
+class CGOGN_CORE_EXPORT Profiler final
+{
+public:
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Zone
+	{
+		const char* name_;
+		uint64 start_;    // ns since the loading of the library
+		uint64 duration_; // ns
+		uint32 depth_;    // number of enclosing zones of the same thread
+	};
+
+	struct ZoneStatistics
+	{
+		std::string name_;
+		uint64 count_;
+		float64 min_;  // ms
+		float64 mean_; // ms
+		float64 max_;  // ms
+	};
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(Profiler);
+
+	static Profiler& get_profiler();
+
+	/**
+	 * @brief record a zone of the calling thread
+	 */
+	void record(const char* name, Clock::time_point start, Clock::time_point end, uint32 depth);
+
+	std::size_t nb_zones() const;
+
+	/**
+	 * @brief count, min, mean and max duration of the recorded zones, per name (sorted by decreasing total duration)
+	 */
+	std::vector<ZoneStatistics> statistics() const;
+
+	/**
+	 * @brief write the recorded zones in the Chrome trace event format (complete events, one track per thread)
+	 */
+	void export_chrome_trace(std::ostream& out) const;
+	bool export_chrome_trace(const std::string& filename) const;
+
+	/**
+	 * @brief remove all the recorded zones (no thread may record a zone concurrently)
+	 */
+	void clear();
+
+	/**
+	 * @brief nesting depth of the zones of the calling thread
+	 */
+	static uint32& thread_depth();
+
+private:
+
+	Profiler();
+	~Profiler();
+
+	struct ThreadBuffer;
+	ThreadBuffer* thread_buffer();
+
+	template <typename FUNC>
+	void foreach_zone(const FUNC& f) const;
+
+	mutable std::mutex buffers_mutex_;
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+/**
+ * @brief a scope recorded in the Profiler (see cgogn_profile_zone)
+ */
+class CGOGN_CORE_EXPORT ProfileZone final
+{
+public:
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ProfileZone);
+
+	explicit ProfileZone(const char* name);
+	~ProfileZone();
+
+private:
+
+	const char* name_;
+	uint32 depth_;
+	Profiler::Clock::time_point start_;
+};
+
 } // namespace cgogn
 
 #endif // CGOGN_CORE_UTILS_TIMER_H_
@@ -298,10 +298,50 @@ using nested_type = typename internal::type_traits::nested_type_helper<T>::type;
 template<typename T>
 using array_data_type = typename internal::type_traits::array_data_type_helper<T>::type;
 
+namespace internal
+{
+
+namespace type_traits
+{
+
+template <class T>
+static auto test_size_at_compile_time(int32) -> sfinae_true<decltype(T::SizeAtCompileTime)>;
+template <class>
+static auto test_size_at_compile_time(int64) -> std::false_type;
+
+/**
+ * fixed size matrices (e.g. Eigen::Vector3d) whose data is a plain array of SizeAtCompileTime arithmetic scalars
+ */
+template <typename T, typename Enable = void>
+struct is_fixed_size_matrix : std::false_type {};
+
+template <typename T>
+struct is_fixed_size_matrix<T, typename std::enable_if<decltype(test_size_at_compile_time<T>(0))::value>::type> :
+	std::integral_constant<bool,
+		(int(T::SizeAtCompileTime) > 0) &&
+		std::is_arithmetic<typename T::Scalar>::value &&
+		std::is_trivially_destructible<T>::value &&
+		sizeof(T) == std::size_t(T::SizeAtCompileTime) * sizeof(typename T::Scalar)>
+{};
+
+} // namespace type_traits
+
+} // namespace internal
+
+/**
+ * @brief tell if the objects of type T can be copied bytewise
+ * True for the trivially copyable types and for the fixed size matrices of arithmetic scalars, whose copy
+ * constructors only copy their array. It can be specialized for the other types with such a layout.
+ */
+template <typename T>
+struct is_raw_copyable : std::integral_constant<bool,
+	std::is_trivially_copyable<T>::value || internal::type_traits::is_fixed_size_matrix<T>::value>
+{};
+
 template <typename T>
 inline typename std::enable_if<!(has_size_method<T>::value || has_rows_method<T>::value || has_cols_method<T>::value), uint32>::type nb_components(const T& );
 template <typename T>
-inline typename std::enable_if<has_size_method<T>::value && has_begin_method<T>::value, uint32>::type nb_components(const T& val);
+inline typename std::enable_if<has_size_method<T>::value && has_begin_method<T>::value && (!has_rows_method<T>::value || !has_cols_method<T>::value), uint32>::type nb_components(const T& val);
 template <typename T>
 inline typename std::enable_if<has_size_method<T>::value && !has_begin_method<T>::value && (!has_rows_method<T>::value || !has_cols_method<T>::value), uint32>::type nb_components(const T& val);
 template <typename T>
@@ -314,7 +354,7 @@ inline typename std::enable_if<!(has_size_method<T>::value || has_rows_method<T>
 }
 
 template <typename T>
-inline typename std::enable_if<has_size_method<T>::value && has_begin_method<T>::value, uint32>::type nb_components(const T& val)
+inline typename std::enable_if<has_size_method<T>::value && has_begin_method<T>::value && (!has_rows_method<T>::value || !has_cols_method<T>::value), uint32>::type nb_components(const T& val)
 {
 	const uint32 size = uint32(val.size());
 	if (size == 0u)
@@ -29,6 +29,7 @@
 #include <cgogn/geometry/types/geometry_traits.h>
 #include <cgogn/geometry/functions/basics.h>
 #include <cgogn/geometry/algos/normal.h>
+#include <cgogn/geometry/algos/dirty_cells.h>
 
 #include <cgogn/core/utils/masks.h>
 #include <cgogn/core/cmap/cmap2.h>
@@ -153,6 +154,32 @@ inline void compute_angle_between_face_normals(
 	compute_angle_between_face_normals(map, AllCellsFilter(), position, edge_angle);
 }
 
+/**
+ * @brief update the angles between face normals after the displacement of the dirty vertices
+ * Only the edges of the faces incident to the dirty vertices are recomputed.
+ * @param map
+ * @param dirty_vertices the displaced vertices
+ * @param position vertex attribute of position
+ * @param edge_angle edge attribute to update
+ */
+template <typename MAP, typename VERTEX_ATTR>
+inline void update_angle_between_face_normals(
+	const MAP& map,
+	const DirtyCellCache<MAP>& dirty_vertices,
+	const VERTEX_ATTR& position,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI2>& edge_angle
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value, "position must be a vertex attribute");
+
+	DirtyCellCache<MAP> edges(map);
+	internal::mark_affected_cells<Cell<Orbit::PHI2>>(dirty_vertices, edges);
+	internal::foreach_dirty_cell(map, edges, [&] (Cell<Orbit::PHI2> e)
+	{
+		edge_angle[e] = angle_between_face_normals(map, e, position);
+	});
+}
+
 
 
 #if defined(CGOGN_USE_EXTERNAL_TEMPLATES) && (!defined(CGOGN_GEOMETRY_EXTERNAL_TEMPLATES_CPP_))
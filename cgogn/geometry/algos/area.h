@@ -27,6 +27,7 @@
 #include <cgogn/geometry/types/geometry_traits.h>
 #include <cgogn/geometry/functions/area.h>
 #include <cgogn/geometry/algos/centroid.h>
+#include <cgogn/geometry/algos/dirty_cells.h>
 
 #include <cgogn/core/cmap/attribute.h>
 
@@ -137,6 +138,41 @@ inline auto compute_area(
 	compute_area<CellType>(map, AllCellsFilter(), position, cell_area);
 }
 
+/**
+ * @brief compute the sum of the areas of the faces of the map
+ * @param map the map
+ * @param mask the faces to consider
+ * @param position the position vertex attribute
+ * @return the total area
+ */
+template <typename MAP, typename MASK, typename VERTEX_ATTR>
+inline ScalarOf<InsideTypeOf<VERTEX_ATTR>> total_area(
+	const MAP& map,
+	const MASK& mask,
+	const VERTEX_ATTR& position)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
+
+	using Scalar = ScalarOf<InsideTypeOf<VERTEX_ATTR>>;
+
+	return map.parallel_transform_reduce(
+		Scalar(0),
+		[&] (typename MAP::Face f) { return area(map, f, position); },
+		[] (Scalar a, Scalar b) { return a + b; },
+		mask
+	);
+}
+
+template <typename MAP, typename VERTEX_ATTR>
+inline ScalarOf<InsideTypeOf<VERTEX_ATTR>> total_area(
+	const MAP& map,
+	const VERTEX_ATTR& position)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
+
+	return total_area(map, AllCellsFilter(), position);
+}
+
 
 template <typename CellType, typename MAP, typename VERTEX_ATTR>
 inline ScalarOf<InsideTypeOf<VERTEX_ATTR>> incident_faces_area(
@@ -186,6 +222,44 @@ inline void compute_incident_faces_area(
 	compute_incident_faces_area<CellType>(map, AllCellsFilter(), position, area);
 }
 
+/**
+ * @brief update the areas of the cells after the displacement of the dirty vertices
+ * Only the cells incident to the faces incident to the dirty vertices are recomputed.
+ */
+template <typename CellType, typename MAP, typename VERTEX_ATTR>
+inline void update_area(
+	const MAP& map,
+	const DirtyCellCache<MAP>& dirty_vertices,
+	const VERTEX_ATTR& position,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, CellType::ORBIT>& cell_area)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
+
+	DirtyCellCache<MAP> cells(map);
+	internal::mark_affected_cells<CellType>(dirty_vertices, cells);
+	internal::foreach_dirty_cell(map, cells, [&] (CellType c)
+	{
+		cell_area[c] = area(map, c, position);
+	});
+}
+
+template <typename CellType, typename MAP, typename VERTEX_ATTR>
+inline void update_incident_faces_area(
+	const MAP& map,
+	const DirtyCellCache<MAP>& dirty_vertices,
+	const VERTEX_ATTR& position,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, CellType::ORBIT>& area)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
+
+	DirtyCellCache<MAP> cells(map);
+	internal::mark_affected_cells<CellType>(dirty_vertices, cells);
+	internal::foreach_dirty_cell(map, cells, [&] (CellType c)
+	{
+		area[c] = incident_faces_area(map, c, position);
+	});
+}
+
 } // namespace geometry
 
 } // namespace cgogn
@@ -45,11 +45,22 @@ void compute_AABB(const ATTR& attr, AABB<array_data_type<ATTR>>& bb)
 template <typename ATTR, typename MAP>
 void compute_AABB(const ATTR& attr, const MAP& map, AABB<array_data_type<ATTR>>& bb)
 {
-	bb.reset();
-	map.foreach_cell([&] (Cell<ATTR::orb_> c)
-	{
-		bb.add_point(attr[c]);
-	});
+	using BB = AABB<array_data_type<ATTR>>;
+
+	bb = map.parallel_reduce(
+		BB(),
+		[&] (BB& acc, Cell<ATTR::orb_> c) { acc.add_point(attr[c]); },
+		[] (const BB& a, const BB& b)
+		{
+			if (!b.is_initialized())
+				return a;
+			if (!a.is_initialized())
+				return b;
+			BB r(a);
+			r.fusion(b);
+			return r;
+		}
+	);
 }
 
 template <typename ATTR>
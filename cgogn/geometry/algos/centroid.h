@@ -24,6 +24,9 @@
 #ifndef CGOGN_GEOMETRY_ALGOS_CENTROID_H_
 #define CGOGN_GEOMETRY_ALGOS_CENTROID_H_
 
+#include <utility>
+#include <limits>
+
 #include <cgogn/geometry/types/geometry_traits.h>
 #include <cgogn/core/basic/cell.h>
 #include <cgogn/core/utils/masks.h>
@@ -98,26 +101,22 @@ inline auto centroid(
 	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"attribute must be a vertex attribute");
 
 	using VEC = InsideTypeOf<VERTEX_ATTR>;
-	std::vector<VEC> sum_per_thread(thread_pool()->nb_workers());
-	for (VEC& v :sum_per_thread) { set_zero(v); }
-	std::vector<uint32> nb_vertices_per_thread(thread_pool()->nb_workers(), 0);
-
-	map.parallel_foreach_cell([&] (typename MAP::Vertex v)
-	{
-		uint32 thread_index = current_thread_index();
-
-		sum_per_thread[thread_index] += attribute[v];
-		++nb_vertices_per_thread[thread_index];
-	},
-	mask);
-
-	VEC result;
-	set_zero(result);
-	uint32 nbv = 0;
-	for (VEC& v : sum_per_thread) result += v;
-	for (uint32 n : nb_vertices_per_thread) nbv += n;
+	using Sum = std::pair<VEC, uint32>;
 
-	return result / ScalarOf<VEC>(nbv);
+	VEC zero;
+	set_zero(zero);
+	const Sum sum = map.parallel_reduce(
+		Sum(zero, 0u),
+		[&] (Sum& acc, typename MAP::Vertex v)
+		{
+			acc.first += attribute[v];
+			++acc.second;
+		},
+		[] (const Sum& a, const Sum& b) { return Sum(a.first + b.first, a.second + b.second); },
+		mask
+	);
+
+	return sum.first / ScalarOf<VEC>(sum.second);
 }
 
 template <typename MAP,typename VERTEX_ATTR>
@@ -146,25 +145,21 @@ typename MAP::Vertex central_vertex(
 
 	VEC center = centroid(map, mask, attribute);
 
-	std::vector<double> min_dist_per_thread(thread_pool()->nb_workers(), std::numeric_limits<Scalar>::max());
-	std::vector<Vertex> min_vertex_per_thread(thread_pool()->nb_workers());
-
-	map.parallel_foreach_cell([&] (Vertex v)
-	{
-		uint32 thread_index = current_thread_index();
-
-		Scalar distance = (attribute[v] - center).squaredNorm();
+	using Closest = std::pair<Scalar, Vertex>;
 
-		if (distance < min_dist_per_thread[thread_index])
+	const Closest closest = map.parallel_reduce(
+		Closest(std::numeric_limits<Scalar>::max(), Vertex()),
+		[&] (Closest& acc, Vertex v)
 		{
-			min_dist_per_thread[thread_index] = distance;
-			min_vertex_per_thread[thread_index] = v;
-		}
-	},
-	mask);
-
-	uint32 min_pos = std::distance(min_dist_per_thread.begin(), std::min_element(min_dist_per_thread.begin(), min_dist_per_thread.end()));
-	return min_vertex_per_thread[min_pos];
+			const Scalar distance = (attribute[v] - center).squaredNorm();
+			if (distance < acc.first)
+				acc = Closest(distance, v);
+		},
+		[] (const Closest& a, const Closest& b) { return b.first < a.first ? b : a; },
+		mask
+	);
+
+	return closest.second;
 }
 
 
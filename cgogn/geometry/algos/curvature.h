@@ -27,6 +27,7 @@
 #include <cgogn/geometry/types/geometry_traits.h>
 #include <cgogn/geometry/algos/selection.h>
 #include <cgogn/geometry/algos/length.h>
+#include <cgogn/geometry/algos/dirty_cells.h>
 #include <cgogn/geometry/functions/intersection.h>
 #include <cgogn/core/cmap/attribute.h>
 #include <cgogn/core/utils/masks.h>
@@ -203,6 +204,54 @@ void compute_curvature(
 	compute_curvature(map, AllCellsFilter(), radius, position, normal, edge_angle, edge_area, kmax, kmin, Kmax, Kmin, Knormal);
 }
 
+/**
+ * @brief update the curvatures after the displacement of the dirty vertices
+ * The vertices within the radius of a vertex of the faces incident to the dirty vertices are recomputed.
+ * The vertex normals, the edge angles (cf. update_angle_between_face_normals) and the edge areas
+ * (cf. update_incident_faces_area) should have been updated beforehand.
+ */
+template <typename MAP, typename VERTEX_ATTR>
+void update_curvature(
+	const MAP& map,
+	const DirtyCellCache<MAP>& dirty_vertices,
+	ScalarOf<InsideTypeOf<VERTEX_ATTR>> radius,
+	const VERTEX_ATTR& position,
+	const VERTEX_ATTR& normal,
+	const Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI2>& edge_angle,
+	const Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI2>& edge_area,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI21>& kmax,
+	Attribute<ScalarOf<InsideTypeOf<VERTEX_ATTR>>, Orbit::PHI21>& kmin,
+	VERTEX_ATTR& Kmax,
+	VERTEX_ATTR& Kmin,
+	VERTEX_ATTR& Knormal
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, Orbit::PHI21>::value,"position must be a vertex attribute");
+
+	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
+	using Vertex2 = Cell<Orbit::PHI21>;
+
+	// the edge angles and the areas change around the vertices of the faces incident to the dirty vertices
+	DirtyCellCache<MAP> seeds(map);
+	internal::mark_affected_cells<Vertex2>(dirty_vertices, seeds);
+
+	DirtyCellCache<MAP> vertices(map);
+	geometry::Collector_WithinSphere<VEC3, MAP> neighborhood(map, radius, position);
+	map.foreach_cell([&] (Vertex2 v)
+	{
+		vertices.mark_dirty(v);
+		neighborhood.collect(v);
+		for (Dart d : neighborhood.cells(Vertex2::ORBIT))
+			vertices.mark_dirty(Vertex2(d));
+	},
+	seeds);
+
+	internal::foreach_dirty_cell(map, vertices, [&] (Vertex2 v)
+	{
+		curvature(map, v, radius, position, normal, edge_angle, edge_area, kmax, kmin, Kmax, Kmin, Knormal);
+	});
+}
+
 } // namespace geometry
 
 } // namespace cgogn
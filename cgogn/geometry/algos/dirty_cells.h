@@ -0,0 +1,84 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_DIRTY_CELLS_H_
+#define CGOGN_GEOMETRY_ALGOS_DIRTY_CELLS_H_
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/type_traits.h>
+#include <cgogn/core/utils/masks.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+namespace internal
+{
+
+// below this number of cells, the incremental updates are done sequentially
+const uint32 PARALLEL_UPDATE_MIN_CELLS = 4096u;
+
+/**
+ * @brief add to affected the cells of type CellType whose geometry depends on the positions of the dirty vertices,
+ * i.e. the cells incident to the faces incident to the dirty vertices
+ */
+template <typename CellType, typename MAP>
+inline void mark_affected_cells(
+	const DirtyCellCache<MAP>& dirty_vertices,
+	DirtyCellCache<MAP>& affected
+)
+{
+	using Vertex = typename MAP::Vertex;
+	using Face = typename MAP::Face;
+
+	affected.template mark_incident_dirty<Face, Vertex>(dirty_vertices);
+	affected.template mark_incident_dirty<CellType, Face>(affected);
+}
+
+/**
+ * @brief apply f on the cells of the cache, in parallel if they are numerous
+ */
+template <typename MAP, typename FUNC>
+inline void foreach_dirty_cell(
+	const MAP& map,
+	const DirtyCellCache<MAP>& cells,
+	const FUNC& f
+)
+{
+	using CellType = func_parameter_type<FUNC>;
+
+	if (cells.template size<CellType>() < PARALLEL_UPDATE_MIN_CELLS)
+		map.foreach_cell(f, cells);
+	else
+		map.parallel_foreach_cell(f, cells);
+}
+
+} // namespace internal
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_DIRTY_CELLS_H_
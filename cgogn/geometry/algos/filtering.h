@@ -95,22 +95,29 @@ void filter_bilateral(
 	using Vertex = typename MAP::Vertex;
 	using Edge = typename MAP::Edge;
 
-	Scalar length_sum = 0;
-	Scalar angle_sum = 0;
-	uint32 nb_edges = 0;
-
-	map.foreach_cell([&] (Edge e)
+	struct Sums
 	{
-		std::pair<Vertex, Vertex> v = map.vertices(e);
-		VEC3 edge = position_in[v.first] - position_in[v.second];
-		length_sum += edge.norm();
-		angle_sum += angle(normal[v.first], normal[v.second]);
-		++nb_edges;
-	},
-	mask);
-
-	Scalar sigmaC = 1.0 * (length_sum / Scalar(nb_edges));
-	Scalar sigmaS = 2.5 * (angle_sum / Scalar(nb_edges));
+		Scalar length_;
+		Scalar angle_;
+		uint32 nb_edges_;
+	};
+
+	const Sums sums = map.parallel_reduce(
+		Sums{Scalar(0), Scalar(0), 0u},
+		[&] (Sums& acc, Edge e)
+		{
+			std::pair<Vertex, Vertex> v = map.vertices(e);
+			VEC3 edge = position_in[v.first] - position_in[v.second];
+			acc.length_ += edge.norm();
+			acc.angle_ += angle(normal[v.first], normal[v.second]);
+			++acc.nb_edges_;
+		},
+		[] (const Sums& a, const Sums& b) { return Sums{a.length_ + b.length_, a.angle_ + b.angle_, a.nb_edges_ + b.nb_edges_}; },
+		mask
+	);
+
+	Scalar sigmaC = 1.0 * (sums.length_ / Scalar(sums.nb_edges_));
+	Scalar sigmaS = 2.5 * (sums.angle_ / Scalar(sums.nb_edges_));
 
 	map.parallel_foreach_cell([&] (Vertex v)
 	{
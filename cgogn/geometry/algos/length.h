@@ -24,6 +24,8 @@
 #ifndef CGOGN_GEOMETRY_ALGOS_LENGTH_H_
 #define CGOGN_GEOMETRY_ALGOS_LENGTH_H_
 
+#include <utility>
+
 #include <cgogn/core/basic/cell.h>
 
 #include <cgogn/geometry/types/geometry_traits.h>
@@ -101,24 +103,20 @@ inline ScalarOf<InsideTypeOf<VERTEX_ATTR>> mean_edge_length(
 	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
 	using Scalar = ScalarOf<VEC3>;
 	using Edge = typename MAP::Edge;
-
-	std::vector<Scalar> edge_length_per_thread(thread_pool()->nb_workers(), 0);
-	std::vector<uint32> nb_edges_per_thread(thread_pool()->nb_workers(), 0);
-
-	map.parallel_foreach_cell([&] (Edge e)
-	{
-		uint32 thread_index = current_thread_index();
-		edge_length_per_thread[thread_index] += length(map, e, position);
-		++nb_edges_per_thread[thread_index];
-	},
-	mask);
-
-	Scalar length = 0;
-	uint32 nbe = 0;
-	for (Scalar l : edge_length_per_thread) length += l;
-	for (uint32 n : nb_edges_per_thread) nbe += n;
-
-	return length / Scalar(nbe);
+	using Sum = std::pair<Scalar, uint32>;
+
+	const Sum sum = map.parallel_reduce(
+		Sum(Scalar(0), 0u),
+		[&] (Sum& acc, Edge e)
+		{
+			acc.first += length(map, e, position);
+			++acc.second;
+		},
+		[] (const Sum& a, const Sum& b) { return Sum(a.first + b.first, a.second + b.second); },
+		mask
+	);
+
+	return sum.first / Scalar(sum.second);
 }
 
 
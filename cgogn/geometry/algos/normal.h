@@ -30,6 +30,7 @@
 #include <cgogn/core/utils/masks.h>
 
 #include <cgogn/geometry/algos/area.h>
+#include <cgogn/geometry/algos/dirty_cells.h>
 #include <cgogn/geometry/functions/basics.h>
 #include <cgogn/geometry/functions/normal.h>
 #include <cgogn/geometry/types/geometry_traits.h>
@@ -132,7 +133,7 @@ inline InsideTypeOf<VERTEX_ATTR> normal(
 		const VEC3& p2 = position[Vertex(map.phi_1(f.dart))];
 		const Scalar l = (p1-p).squaredNorm() * (p2-p).squaredNorm();
 		if (l != Scalar(0))
-			facen *= convex_area<VEC3>(map, f, position) / l;
+			facen *= convex_area(map, f, position) / l;
 		n += facen;
 	});
 	normalize_safe(n);
@@ -233,6 +234,73 @@ inline void compute_normal(
 	compute_normal(map, AllCellsFilter(), position, face_normal, vertex_normal);
 }
 
+/**
+ * @brief update the face normals after the displacement of the dirty vertices
+ * Only the faces incident to the dirty vertices are recomputed.
+ */
+template <typename MAP, typename VERTEX_ATTR>
+inline void update_normal(
+	const MAP& map,
+	const DirtyCellCache<MAP>& dirty_vertices,
+	const VERTEX_ATTR& position,
+	Attribute<InsideTypeOf<VERTEX_ATTR>, Orbit::PHI1>& face_normal
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
+
+	DirtyCellCache<MAP> faces(map);
+	internal::mark_affected_cells<typename MAP::Face>(dirty_vertices, faces);
+	internal::foreach_dirty_cell(map, faces, [&] (Cell<Orbit::PHI1> f)
+	{
+		face_normal[f] = normal(map, f, position);
+	});
+}
+
+/**
+ * @brief update the vertex normals after the displacement of the dirty vertices
+ * Only the vertices of the faces incident to the dirty vertices are recomputed.
+ */
+template <typename MAP, typename VERTEX_ATTR>
+inline void update_normal(
+	const MAP& map,
+	const DirtyCellCache<MAP>& dirty_vertices,
+	const VERTEX_ATTR& position,
+	Attribute<InsideTypeOf<VERTEX_ATTR>, Orbit::PHI21>& vertex_normal
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
+
+	DirtyCellCache<MAP> vertices(map);
+	internal::mark_affected_cells<typename MAP::Vertex>(dirty_vertices, vertices);
+	internal::foreach_dirty_cell(map, vertices, [&] (Cell<Orbit::PHI21> v)
+	{
+		vertex_normal[v] = normal(map, v, position);
+	});
+}
+
+/**
+ * @brief update the vertex normals after the displacement of the dirty vertices
+ * The face normals should have been updated beforehand (cf. update_normal).
+ */
+template <typename MAP, typename VERTEX_ATTR>
+inline void update_normal(
+	const MAP& map,
+	const DirtyCellCache<MAP>& dirty_vertices,
+	const VERTEX_ATTR& position,
+	const Attribute<InsideTypeOf<VERTEX_ATTR>, Orbit::PHI1>& face_normal,
+	Attribute<InsideTypeOf<VERTEX_ATTR>, Orbit::PHI21>& vertex_normal
+)
+{
+	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value,"position must be a vertex attribute");
+
+	DirtyCellCache<MAP> vertices(map);
+	internal::mark_affected_cells<typename MAP::Vertex>(dirty_vertices, vertices);
+	internal::foreach_dirty_cell(map, vertices, [&] (Cell<Orbit::PHI21> v)
+	{
+		vertex_normal[v] = normal(map, v, position, face_normal);
+	});
+}
+
 } // namespace geometry
 
 } // namespace cgogn
@@ -0,0 +1,113 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/container/chunk_array_container.h>
+
+#include <cgogn/geometry/types/eigen.h>
+
+#include <chrono>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 NB_LINES = 16000000u;
+const uint32 NB_REPEAT = 10u;
+
+using Container = ChunkArrayContainer<CGOGN_CHUNK_SIZE, uint32>;
+using Vec3 = Eigen::Vector3d;
+using ChunkArrayVec3 = ChunkArray<CGOGN_CHUNK_SIZE, Vec3>;
+
+// bandwidth (in GB/s) of NB_REPEAT parallel "triad" traversals (2 reads + 1 write of a Vec3 per line)
+// on the Vec3 type of the positions and normals of the meshes
+float64 bench_bandwidth(bool numa_aware)
+{
+	thread_pool()->set_numa_aware(numa_aware);
+
+	// the chunks are allocated (and first touched) with the current mode
+	Container container;
+	ChunkArrayVec3* a = container.add_chunk_array<Vec3>("a");
+	ChunkArrayVec3* b = container.add_chunk_array<Vec3>("b");
+	ChunkArrayVec3* c = container.add_chunk_array<Vec3>("c");
+	for (uint32 i = 0u; i < NB_LINES; ++i)
+		container.insert_lines<1>();
+
+	container.parallel_foreach_index([&] (uint32 i)
+	{
+		(*a)[i] = Vec3(1.0, 2.0, 3.0);
+		(*b)[i] = Vec3(float64(i), 0.5, 0.25);
+	});
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32 r = 0u; r < NB_REPEAT; ++r)
+	{
+		container.parallel_foreach_index([&] (uint32 i)
+		{
+			(*c)[i] = (*a)[i] + 0.5 * (*b)[i];
+		});
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	const float64 seconds = std::chrono::duration<float64>(end - start).count();
+	const float64 bytes = float64(NB_REPEAT) * float64(NB_LINES) * 3.0 * sizeof(Vec3);
+	return bytes / seconds * 1e-9;
+}
+
+// mean time (in ms) to add (then remove) an attribute to a container of NB_LINES lines
+float64 bench_add_attribute(bool numa_aware)
+{
+	thread_pool()->set_numa_aware(numa_aware);
+
+	Container container;
+	container.add_chunk_array<Vec3>("a");
+	for (uint32 i = 0u; i < NB_LINES; ++i)
+		container.insert_lines<1>();
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32 r = 0u; r < NB_REPEAT; ++r)
+	{
+		container.add_chunk_array<Vec3>("tmp");
+		container.remove_chunk_array("tmp");
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<float64, std::milli>(end - start).count() / NB_REPEAT;
+}
+
+int main()
+{
+	thread_start(0, 0);
+
+	const float64 ref = bench_bandwidth(false);
+	cgogn_log_info("bench_numa") << "default mode:     " << ref << " GB/s";
+
+	const float64 numa = bench_bandwidth(true);
+	cgogn_log_info("bench_numa") << "NUMA-aware mode:  " << numa << " GB/s (x" << numa / ref << ")";
+
+	cgogn_log_info("bench_numa") << "add attribute (default mode):    " << bench_add_attribute(false) << " ms";
+	cgogn_log_info("bench_numa") << "add attribute (NUMA-aware mode): " << bench_add_attribute(true) << " ms";
+
+	thread_pool()->set_numa_aware(false);
+	thread_stop();
+
+	return 0;
+}
@@ -0,0 +1,167 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap2_builder.h>
+
+#include <cgogn/geometry/types/eigen.h>
+#include <cgogn/geometry/algos/area.h>
+#include <cgogn/geometry/algos/bounding_box.h>
+#include <cgogn/geometry/algos/centroid.h>
+#include <cgogn/geometry/algos/length.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace cgogn;
+using namespace cgogn::numerics;
+
+const uint32 GRID_SIZE = 1000u;
+const uint32 NB_RUNS = 5u;
+
+using Vec3 = Eigen::Vector3d;
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+using Face = CMap2::Face;
+
+// GRID_SIZE x GRID_SIZE grid of quads
+void build_grid(CMap2& map, CMap2::VertexAttribute<Vec3>& position)
+{
+	CMap2Builder_T<CMap2> builder(map);
+	std::vector<Dart> quads(GRID_SIZE * GRID_SIZE);
+	for (Dart& d : quads)
+		d = builder.add_face_topo_fp(4u);
+
+	for (uint32 j = 0u; j < GRID_SIZE; ++j)
+	{
+		for (uint32 i = 0u; i < GRID_SIZE; ++i)
+		{
+			const Dart d = quads[j * GRID_SIZE + i];
+			if (i + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(d), map.phi_1(quads[j * GRID_SIZE + i + 1u]));
+			if (j + 1u < GRID_SIZE)
+				builder.phi2_sew(map.phi1(map.phi1(d)), quads[(j + 1u) * GRID_SIZE + i]);
+		}
+	}
+	builder.close_map();
+
+	position = map.add_attribute<Vec3, Vertex>("position");
+	for (uint32 j = 0u; j < GRID_SIZE; ++j)
+	{
+		for (uint32 i = 0u; i < GRID_SIZE; ++i)
+		{
+			const Dart d = quads[j * GRID_SIZE + i];
+			position[Vertex(d)] = Vec3(float64(i), float64(j), 0.0);
+			position[Vertex(map.phi1(d))] = Vec3(float64(i + 1u), float64(j), 0.0);
+			position[Vertex(map.phi1(map.phi1(d)))] = Vec3(float64(i + 1u), float64(j + 1u), 0.0);
+			position[Vertex(map.phi_1(d))] = Vec3(float64(i), float64(j + 1u), 0.0);
+		}
+	}
+}
+
+template <typename F>
+float64 timed(const F& f)
+{
+	const auto start = std::chrono::steady_clock::now();
+	f();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<float64, std::milli>(end - start).count();
+}
+
+template <typename SERIAL, typename PARALLEL>
+void bench(const std::string& name, const SERIAL& serial, const PARALLEL& parallel)
+{
+	float64 serial_time = 0.0;
+	float64 parallel_time = 0.0;
+	for (uint32 i = 0u; i < NB_RUNS; ++i)
+	{
+		serial_time += timed(serial);
+		parallel_time += timed(parallel);
+	}
+	cgogn_log_info("bench_reductions") << name << " foreach_cell: " << serial_time / NB_RUNS << " ms, parallel_reduce: " << parallel_time / NB_RUNS << " ms";
+}
+
+int main()
+{
+	thread_start(0, 0);
+
+	CMap2 map;
+	CMap2::VertexAttribute<Vec3> position;
+	build_grid(map, position);
+
+	cgogn_log_info("bench_reductions") << map.nb_darts() << " darts, " << thread_pool()->nb_workers() << " workers";
+
+	float64 result = 0.0;
+
+	bench("mean_edge_length",
+		[&] ()
+		{
+			float64 sum = 0.0;
+			uint32 nb = 0u;
+			map.foreach_cell([&] (Edge e) { sum += geometry::length(map, e, position); ++nb; });
+			result += sum / float64(nb);
+		},
+		[&] () { result += geometry::mean_edge_length(map, position); }
+	);
+
+	bench("compute_AABB",
+		[&] ()
+		{
+			geometry::AABB<Vec3> bb;
+			map.foreach_cell([&] (Vertex v) { bb.add_point(position[v]); });
+			result += bb.max_size();
+		},
+		[&] ()
+		{
+			geometry::AABB<Vec3> bb;
+			geometry::compute_AABB(position, map, bb);
+			result += bb.max_size();
+		}
+	);
+
+	bench("centroid",
+		[&] ()
+		{
+			Vec3 sum = Vec3::Zero();
+			uint32 nb = 0u;
+			map.foreach_cell([&] (Vertex v) { sum += position[v]; ++nb; });
+			result += (sum / float64(nb))[0];
+		},
+		[&] () { result += geometry::centroid(map, position)[0]; }
+	);
+
+	bench("total_area",
+		[&] ()
+		{
+			float64 sum = 0.0;
+			map.foreach_cell([&] (Face f) { sum += geometry::area(map, f, position); });
+			result += sum;
+		},
+		[&] () { result += geometry::total_area(map, position); }
+	);
+
+	cgogn_log_debug("bench_reductions") << result;
+
+	thread_stop();
+	return 0;
+}
@@ -22,11 +22,16 @@
 *******************************************************************************/
 
 #include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/frozen_topology.h>
 
 #include <cgogn/geometry/types/eigen.h>
 #include <cgogn/geometry/types/vec.h>
+#include <cgogn/geometry/algos/angle.h>
 #include <cgogn/geometry/algos/area.h>
 #include <cgogn/geometry/algos/centroid.h>
+#include <cgogn/geometry/algos/curvature.h>
+#include <cgogn/geometry/algos/bounding_box.h>
+#include <cgogn/geometry/algos/length.h>
 #include <cgogn/geometry/algos/normal.h>
 #include <cgogn/geometry/algos/ear_triangulation.h>
 
@@ -173,6 +178,27 @@ TYPED_TEST(Algos_TEST, QuadNormal)
 	EXPECT_TRUE(cgogn::almost_equal_relative(cross[2], Scalar(0)));
 }
 
+TYPED_TEST(Algos_TEST, Reductions)
+{
+	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, CMap2::Vertex>("position");
+	this->add_polygone(4);
+	this->add_polygone(4);
+
+	EXPECT_TRUE(cgogn::almost_equal_relative(cgogn::geometry::total_area(this->map2_, vertex_position), Scalar(4)));
+	EXPECT_TRUE(cgogn::almost_equal_relative(cgogn::geometry::mean_edge_length(this->map2_, vertex_position), Scalar(std::sqrt(2.0))));
+
+	const TypeParam centroid = cgogn::geometry::centroid(this->map2_, vertex_position);
+	EXPECT_TRUE(cgogn::almost_equal_absolute(centroid[0], Scalar(0)));
+	EXPECT_TRUE(cgogn::almost_equal_absolute(centroid[1], Scalar(0)));
+
+	cgogn::geometry::AABB<TypeParam> bb;
+	cgogn::geometry::compute_AABB(vertex_position, this->map2_, bb);
+	EXPECT_TRUE(cgogn::almost_equal_absolute(bb.min()[0], Scalar(-1)));
+	EXPECT_TRUE(cgogn::almost_equal_absolute(bb.max()[1], Scalar(1)));
+	EXPECT_TRUE(cgogn::almost_equal_absolute(bb.max()[2], Scalar(0)));
+}
+
 TYPED_TEST(Algos_TEST, EarTriangulation)
 {
 	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
@@ -210,3 +236,184 @@ TYPED_TEST(Algos_TEST, EarTriangulation)
 //	EXPECT_TRUE(this->map2_.nb_boundary_cells() == 1);
 	EXPECT_TRUE(this->map2_.template nb_cells<Edge::ORBIT>() == 7);
 }
+
+TYPED_TEST(Algos_TEST, IncrementalUpdate)
+{
+	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
+	using EdgeScalar = cgogn::Attribute<Scalar, Edge::ORBIT>;
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, Vertex>("position");
+	CMap2::FaceAttribute<TypeParam> face_normal = this->map2_.template add_attribute<TypeParam, Face>("face_normal");
+	VertexAttribute<TypeParam> vertex_normal = this->map2_.template add_attribute<TypeParam, Vertex>("vertex_normal");
+	CMap2::FaceAttribute<Scalar> face_area = this->map2_.template add_attribute<Scalar, Face>("face_area");
+	VertexAttribute<Scalar> vertex_area = this->map2_.template add_attribute<Scalar, Vertex>("vertex_area");
+	EdgeScalar edge_angle = this->map2_.template add_attribute<Scalar, Edge>("edge_angle");
+	EdgeScalar edge_area = this->map2_.template add_attribute<Scalar, Edge>("edge_area");
+	VertexAttribute<Scalar> kmax = this->map2_.template add_attribute<Scalar, Vertex>("kmax");
+	VertexAttribute<Scalar> kmin = this->map2_.template add_attribute<Scalar, Vertex>("kmin");
+	VertexAttribute<TypeParam> Kmax = this->map2_.template add_attribute<TypeParam, Vertex>("Kmax");
+	VertexAttribute<TypeParam> Kmin = this->map2_.template add_attribute<TypeParam, Vertex>("Kmin");
+	VertexAttribute<TypeParam> Knormal = this->map2_.template add_attribute<TypeParam, Vertex>("Knormal");
+
+	// prisms whose base vertices lie on the unit circle, numerous enough for the updates to run in parallel
+	const uint32 n = 12u;
+	const uint32 nb_prisms = 600u;
+	std::vector<Dart> bases;
+	for (uint32 k = 0u; k < nb_prisms; ++k)
+	{
+		const Dart base = this->map2_.add_prism(n).dart;
+		bases.push_back(base);
+		Dart d = base;
+		for (uint32 i = 0u; i < n; ++i)
+		{
+			const Scalar alpha = Scalar(2 * M_PI * i / n);
+			vertex_position[Vertex(d)] = TypeParam(std::cos(alpha), std::sin(alpha), Scalar(0));
+			vertex_position[Vertex(this->map2_.phi1(this->map2_.phi1(this->map2_.phi2(d))))] = TypeParam(std::cos(alpha), std::sin(alpha), Scalar(1));
+			d = this->map2_.phi_1(d);
+		}
+	}
+
+	const Scalar radius = Scalar(0.6);
+	cgogn::geometry::compute_normal(this->map2_, vertex_position, face_normal);
+	cgogn::geometry::compute_normal(this->map2_, vertex_position, face_normal, vertex_normal);
+	cgogn::geometry::compute_area<Face>(this->map2_, vertex_position, face_area);
+	cgogn::geometry::compute_area<Vertex>(this->map2_, vertex_position, vertex_area);
+	cgogn::geometry::compute_angle_between_face_normals(this->map2_, vertex_position, edge_angle);
+	cgogn::geometry::compute_incident_faces_area<Edge>(this->map2_, vertex_position, edge_area);
+	cgogn::geometry::compute_curvature(this->map2_, radius, vertex_position, vertex_normal, edge_angle, edge_area, kmax, kmin, Kmax, Kmin, Knormal);
+
+	// move some vertices and update the attributes incrementally
+	CMap2::DirtyCellCache dirty(this->map2_);
+	for (Dart base : bases)
+	{
+		Dart d = base;
+		for (uint32 i = 0u; i < n; i += 4u)
+		{
+			vertex_position[Vertex(d)] *= Scalar(2);
+			dirty.mark_dirty(Vertex(d));
+			dirty.mark_dirty(Vertex(d)); // marking twice is harmless
+			d = this->map2_.phi_1(this->map2_.phi_1(this->map2_.phi_1(this->map2_.phi_1(d))));
+		}
+	}
+	EXPECT_EQ(dirty.template size<Vertex>(), std::size_t(nb_prisms * n / 4u));
+
+	// the faces incident to the dirty vertices are above the threshold of the parallel updates
+	CMap2::DirtyCellCache affected(this->map2_);
+	cgogn::geometry::internal::mark_affected_cells<Face>(dirty, affected);
+	EXPECT_GE(affected.template size<Face>(), std::size_t(cgogn::geometry::internal::PARALLEL_UPDATE_MIN_CELLS));
+
+	cgogn::geometry::update_normal(this->map2_, dirty, vertex_position, face_normal);
+	cgogn::geometry::update_normal(this->map2_, dirty, vertex_position, face_normal, vertex_normal);
+	cgogn::geometry::update_area<Face>(this->map2_, dirty, vertex_position, face_area);
+	cgogn::geometry::update_area<Vertex>(this->map2_, dirty, vertex_position, vertex_area);
+	cgogn::geometry::update_angle_between_face_normals(this->map2_, dirty, vertex_position, edge_angle);
+	cgogn::geometry::update_incident_faces_area<Edge>(this->map2_, dirty, vertex_position, edge_area);
+	cgogn::geometry::update_curvature(this->map2_, dirty, radius, vertex_position, vertex_normal, edge_angle, edge_area, kmax, kmin, Kmax, Kmin, Knormal);
+
+	// the attributes are those computed from scratch
+	this->map2_.foreach_cell([&] (Face f)
+	{
+		const TypeParam n1 = cgogn::geometry::normal(this->map2_, f, vertex_position);
+		EXPECT_TRUE(cgogn::almost_equal_absolute(Scalar((face_normal[f] - n1).norm()), Scalar(0)));
+		EXPECT_TRUE(cgogn::almost_equal_absolute(face_area[f], cgogn::geometry::area(this->map2_, f, vertex_position)));
+	});
+	this->map2_.foreach_cell([&] (Edge e)
+	{
+		EXPECT_TRUE(cgogn::almost_equal_absolute(edge_angle[e], cgogn::geometry::angle_between_face_normals(this->map2_, e, vertex_position)));
+		EXPECT_TRUE(cgogn::almost_equal_absolute(edge_area[e], cgogn::geometry::incident_faces_area(this->map2_, e, vertex_position)));
+	});
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		const TypeParam n1 = cgogn::geometry::normal(this->map2_, v, vertex_position, face_normal);
+		EXPECT_TRUE(cgogn::almost_equal_absolute(Scalar((vertex_normal[v] - n1).norm()), Scalar(0)));
+		EXPECT_TRUE(cgogn::almost_equal_absolute(vertex_area[v], cgogn::geometry::area(this->map2_, v, vertex_position)));
+	});
+
+	VertexAttribute<Scalar> kmax_ref = this->map2_.template add_attribute<Scalar, Vertex>("kmax_ref");
+	VertexAttribute<Scalar> kmin_ref = this->map2_.template add_attribute<Scalar, Vertex>("kmin_ref");
+	VertexAttribute<TypeParam> Kmax_ref = this->map2_.template add_attribute<TypeParam, Vertex>("Kmax_ref");
+	VertexAttribute<TypeParam> Kmin_ref = this->map2_.template add_attribute<TypeParam, Vertex>("Kmin_ref");
+	VertexAttribute<TypeParam> Knormal_ref = this->map2_.template add_attribute<TypeParam, Vertex>("Knormal_ref");
+	cgogn::geometry::compute_curvature(this->map2_, radius, vertex_position, vertex_normal, edge_angle, edge_area, kmax_ref, kmin_ref, Kmax_ref, Kmin_ref, Knormal_ref);
+	// the sums depend on the dart the neighborhood of a vertex is collected from: the results may differ by a few ulps
+	const Scalar tolerance = Scalar(1e-4);
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_TRUE(cgogn::almost_equal_absolute(kmax[v], kmax_ref[v], tolerance));
+		EXPECT_TRUE(cgogn::almost_equal_absolute(kmin[v], kmin_ref[v], tolerance));
+		EXPECT_TRUE(cgogn::almost_equal_absolute(Scalar((Knormal[v] - Knormal_ref[v]).norm()), Scalar(0), tolerance));
+	});
+
+	dirty.template clear<Vertex>();
+	EXPECT_EQ(dirty.template size<Vertex>(), 0u);
+	EXPECT_FALSE(dirty.is_dirty(Vertex(bases.front())));
+}
+
+/**
+ * \brief The positions are written as they are in a snapshot and read back from the mapping.
+ */
+TYPED_TEST(Algos_TEST, Snapshot)
+{
+	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
+	EXPECT_TRUE(cgogn::is_raw_copyable<TypeParam>::value);
+
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, Vertex>("position");
+	const uint32 n = 12u;
+	this->map2_.add_prism(n);
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		vertex_position[v] = TypeParam(Scalar(v.dart.index), Scalar(1), Scalar(-1));
+	});
+
+	const std::string filename("algos_test_snapshot.cgogn");
+	EXPECT_TRUE(this->map2_.save_snapshot(filename));
+
+	cgogn::chunk_array_factory<CMap2::CHUNK_SIZE>().template register_CA<TypeParam>();
+	CMap2 map;
+	EXPECT_TRUE(map.load_snapshot(filename));
+	VertexAttribute<TypeParam> map_position = map.template get_attribute<TypeParam, Vertex>("position");
+	ASSERT_TRUE(map_position.is_valid());
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_TRUE(cgogn::almost_equal_absolute(Scalar((map_position[v] - vertex_position[v]).norm()), Scalar(0)));
+	});
+	std::remove(filename.c_str());
+}
+
+TYPED_TEST(Algos_TEST, FrozenTopology)
+{
+	using Scalar = typename cgogn::geometry::vector_traits<TypeParam>::Scalar;
+	VertexAttribute<TypeParam> vertex_position = this->map2_.template add_attribute<TypeParam, Vertex>("position");
+	CMap2::FaceAttribute<TypeParam> face_normal = this->map2_.template add_attribute<TypeParam, Face>("face_normal");
+	VertexAttribute<TypeParam> vertex_normal = this->map2_.template add_attribute<TypeParam, Vertex>("vertex_normal");
+	CMap2::FaceAttribute<TypeParam> frozen_face_normal = this->map2_.template add_attribute<TypeParam, Face>("frozen_face_normal");
+	VertexAttribute<TypeParam> frozen_vertex_normal = this->map2_.template add_attribute<TypeParam, Vertex>("frozen_vertex_normal");
+
+	const uint32 n = 12u;
+	Dart d = this->map2_.add_prism(n).dart;
+	for (uint32 i = 0u; i < n; ++i)
+	{
+		const Scalar alpha = Scalar(2 * M_PI * i / n);
+		vertex_position[Vertex(d)] = TypeParam(std::cos(alpha), std::sin(alpha), Scalar(0));
+		vertex_position[Vertex(this->map2_.phi1(this->map2_.phi1(this->map2_.phi2(d))))] = TypeParam(Scalar(0.5) * std::cos(alpha), Scalar(0.5) * std::sin(alpha), Scalar(1));
+		d = this->map2_.phi_1(d);
+	}
+
+	cgogn::geometry::compute_normal(this->map2_, vertex_position, face_normal);
+	cgogn::geometry::compute_normal(this->map2_, vertex_position, face_normal, vertex_normal);
+
+	// the same algorithm run on a snapshot of the topology gives the same results
+	const cgogn::FrozenTopology<CMap2> frozen(this->map2_);
+	cgogn::geometry::compute_normal(frozen, vertex_position, frozen_face_normal);
+	cgogn::geometry::compute_normal(frozen, vertex_position, frozen_face_normal, frozen_vertex_normal);
+
+	this->map2_.foreach_cell([&] (Face f)
+	{
+		EXPECT_TRUE(cgogn::almost_equal_absolute(Scalar((face_normal[f] - frozen_face_normal[f]).norm()), Scalar(0)));
+		EXPECT_TRUE(cgogn::almost_equal_absolute(cgogn::geometry::area(frozen, f, vertex_position), cgogn::geometry::area(this->map2_, f, vertex_position)));
+	});
+	this->map2_.foreach_cell([&] (Vertex v)
+	{
+		EXPECT_TRUE(cgogn::almost_equal_absolute(Scalar((vertex_normal[v] - frozen_vertex_normal[v]).norm()), Scalar(0)));
+		EXPECT_TRUE(cgogn::almost_equal_absolute(cgogn::geometry::area(frozen, v, vertex_position), cgogn::geometry::area(this->map2_, v, vertex_position)));
+	});
+}
@@ -295,6 +295,11 @@ extern template class CGOGN_GEOMETRY_EXPORT Vec_T<std::array<float64,3>>;
 
 } // namespace geometry
 
+// a Vec_T is its container: the arrays of Vec_T<std::array<...>> are copied bytewise in the snapshots
+template <class Container>
+struct is_raw_copyable<geometry::Vec_T<Container>> : is_raw_copyable<Container>
+{};
+
 } // namespace cgogn
 
 #endif // CGOGN_GEOMETRY_TYPES_VEC_H_
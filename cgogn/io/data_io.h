@@ -291,8 +291,12 @@ public:
 
 	virtual ChunkArray* add_attribute(ChunkArrayContainer& cac, const std::string& att_name) const override
 	{
-		for (std::size_t i = cac.capacity(), end = data_.size(); i < end; i += PRIM_SIZE)
-			cac.template insert_lines<PRIM_SIZE>();
+		const std::size_t capacity = cac.capacity();
+		if (capacity < data_.size())
+		{
+			std::vector<uint32> lines;
+			cac.template insert_lines_bulk<PRIM_SIZE>(uint32((data_.size() - capacity + PRIM_SIZE - 1u) / PRIM_SIZE), lines);
+		}
 		return cac.template add_chunk_array<T>(att_name);
 	}
 
@@ -87,7 +87,7 @@ protected:
 
 		// read vertices position
 		std::vector<uint32> vertices_id;
-		vertices_id.reserve(nb_vertices);
+		this->insert_lines_vertex_container(nb_vertices, vertices_id);
 
 		for (uint32 i = 0; i < nb_vertices; ++i)
 		{
@@ -98,10 +98,7 @@ protected:
 
 			VEC3 pos{Scalar(x), Scalar(y), Scalar(z)};
 
-			uint32 vertex_id = this->insert_line_vertex_container();
-			(*position)[vertex_id] = pos;
-
-			vertices_id.push_back(vertex_id);
+			(*position)[vertices_id[i]] = pos;
 		}
 
 		// read faces (vertex indices)
@@ -137,7 +134,7 @@ protected:
 		const uint32 BUFFER_SZ = 1024 * 1024;
 		std::vector<float32> buff_pos(3*BUFFER_SZ);
 		std::vector<uint32> vertices_id;
-		vertices_id.reserve(nb_vertices);
+		this->insert_lines_vertex_container(nb_vertices, vertices_id);
 
 		{
 			uint32 j = BUFFER_SZ;
@@ -159,10 +156,7 @@ protected:
 
 				VEC3 pos{ buff_pos[3u * j], buff_pos[3u * j + 1u], buff_pos[3u * j + 2u] };
 
-				uint32 vertex_id = this->insert_line_face_container();
-				(*position)[vertex_id] = pos;
-
-				vertices_id.push_back(vertex_id);
+				(*position)[vertices_id[i]] = pos;
 			}
 		}
 
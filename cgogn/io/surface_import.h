@@ -31,6 +31,7 @@
 #include <cgogn/core/utils/endian.h>
 #include <cgogn/core/utils/name_types.h>
 #include <cgogn/core/utils/string.h>
+#include <cgogn/core/utils/timer.h>
 
 #include <cgogn/core/cmap/cmap2.h>
 #include <cgogn/core/cmap/cmap2_builder.h>
@@ -96,6 +97,14 @@ public:
 		return vertex_container().template insert_lines<1>();
 	}
 
+	/**
+	 * \brief insert n lines at once in the vertex container, their indices are appended to ids
+	 */
+	inline void insert_lines_vertex_container(uint32 n, std::vector<uint32>& ids)
+	{
+		vertex_container().template insert_lines_bulk<1>(n, ids);
+	}
+
 	inline uint32 insert_line_face_container()
 	{
 		return face_container().template insert_lines<1>();
@@ -167,6 +176,8 @@ public:
 
 	void create_map()
 	{
+		cgogn_profile_zone("SurfaceImport::create_map");
+
 		if (nb_faces() == 0u)
 			return;
 
@@ -30,6 +30,7 @@
 #include <cgogn/geometry/types/geometry_traits.h>
 
 #include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/utils/timer.h>
 
 #include <cgogn/modeling/decimation/edge_traversor_map_order.h>
 #include <cgogn/modeling/decimation/edge_traversor_edge_length.h>
@@ -73,6 +74,8 @@ void decimate(
 	using Vertex = CMap2::Vertex;
 	using Edge = CMap2::Edge;
 
+	cgogn_profile_zone("decimate");
+
 	approx.init();
 
 	uint32 count = 0;
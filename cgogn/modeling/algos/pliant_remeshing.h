@@ -34,6 +34,7 @@
 
 #include <cgogn/core/cmap/cmap2.h>
 #include <cgogn/core/utils/masks.h>
+#include <cgogn/core/utils/timer.h>
 
 namespace cgogn
 {
@@ -55,12 +56,16 @@ void pliant_remeshing(
 	using Vertex = typename CMap2::Vertex;
 	using Edge = typename CMap2::Edge;
 
+	cgogn_profile_zone("pliant_remeshing");
+
 	Scalar mean_edge_length = geometry::mean_edge_length(map, position);
 
 	const Scalar squared_min_edge_length = Scalar(0.5625) * mean_edge_length * mean_edge_length; // 0.5625 = 0.75^2
 	const Scalar squared_max_edge_length = Scalar(1.5625) * mean_edge_length * mean_edge_length; // 1.5625 = 1.25^2
 
-	CMap2::CellCache cache(map);
+	// the cache follows the modifications of the map: the cells created or changed by the operators
+	// are evaluated against the selection and it is used as a worklist
+	CMap2::IncrementalCellCache cache(map);
 
 //	for (uint32 i = 0; i < 3; ++i)
 //	{
@@ -72,19 +77,16 @@ void pliant_remeshing(
 	};
 
 	cache.template build<Edge>(long_edges_selection);
-	while (cache.template size<Edge>() > 0)
+	for (Edge e = cache.template pop<Edge>(); e.is_valid(); e = cache.template pop<Edge>())
 	{
-		map.foreach_cell([&] (Edge e)
-		{
-			Dart e2 = map.phi2(e.dart);
-			Vertex nv = map.cut_edge(e);
-			position[nv] = Scalar(0.5) * (position[Vertex(e.dart)] + position[Vertex(e2)]);
-			map.cut_face(map.phi1(e.dart), map.phi_1(e.dart));
-			if (!map.is_boundary(e2))
-				map.cut_face(map.phi1(e2), map.phi_1(e2));
-		},
-		cache);
-		cache.template build<Edge>(long_edges_selection);
+		if (map.is_boundary(e.dart))
+			e = Edge(map.phi2(e.dart));
+		Dart e2 = map.phi2(e.dart);
+		Vertex nv = map.cut_edge(e);
+		position[nv] = Scalar(0.5) * (position[Vertex(e.dart)] + position[Vertex(e2)]);
+		map.cut_face(map.phi1(e.dart), map.phi_1(e.dart));
+		if (!map.is_boundary(e2))
+			map.cut_face(map.phi1(e2), map.phi_1(e2));
 	}
 
 	// collapse short edges
@@ -110,14 +112,16 @@ void pliant_remeshing(
 		return collapse;
 	};
 
+	// the selection of an edge depends on the neighborhood of its vertices and is not re-evaluated
+	// when this neighborhood changes: the cache is rebuilt once the worklist is empty
 	cache.template build<Edge>(short_edges_selection);
 	while (cache.template size<Edge>() > 0)
 	{
-		map.foreach_cell([&] (Edge e)
+		for (Edge e = cache.template pop<Edge>(); e.is_valid(); e = cache.template pop<Edge>())
 		{
 			std::pair<Vertex,Vertex> v = map.vertices(e);
 			bool collapse = true;
-			const VEC3& p = position[v.first];
+			const VEC3 p = position[v.first];
 			map.foreach_adjacent_vertex_through_edge(v.second, [&] (Vertex vv)
 			{
 				const VEC3& vec = p - position[vv];
@@ -132,8 +136,7 @@ void pliant_remeshing(
 					position[cv] = p;
 				}
 			}
-		},
-		cache);
+		}
 		cache.template build<Edge>(short_edges_selection);
 	}
 
@@ -0,0 +1,136 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <memory>
+
+#include <cgogn/core/basic/dart_marker.h>
+#include <cgogn/core/basic/cell_marker.h>
+
+#include "benchmark.h"
+#include "meshes.h"
+
+namespace cgogn
+{
+
+namespace benchmark
+{
+
+using Vertex = CMap2::Vertex;
+using Edge = CMap2::Edge;
+using Face = CMap2::Face;
+
+const std::vector<uint32> SURFACE_SIZES = { 32u, 128u, 512u };
+
+/**
+ * Each iteration applies the operator on a set of edges of a copy of the generated mesh:
+ * the copy of the mesh, the selection of the edges and the destruction of the copy are not measured.
+ */
+template <typename SELECT, typename OPERATOR>
+void apply_on_edges(State& state, const CMap2& mesh, const SELECT& select, const OPERATOR& op)
+{
+	uint64 nb_operations = 0u;
+	while (state.keep_running())
+	{
+		state.pause_timing();
+		std::unique_ptr<CMap2> map = mesh.clone();
+		std::vector<Edge> edges;
+		select(*map, edges);
+		state.resume_timing();
+
+		for (Edge e : edges)
+			op(*map, e);
+
+		state.pause_timing();
+		nb_operations += edges.size();
+		map.reset();
+		state.resume_timing();
+	}
+	state.set_items_processed(nb_operations);
+}
+
+// all the edges of the square tore
+void cut_edge(State& state)
+{
+	apply_on_edges(state, square_tore(state.arg()),
+		[] (const CMap2& map, std::vector<Edge>& edges)
+		{
+			map.foreach_cell([&] (Edge e) { edges.push_back(e); });
+		},
+		[] (CMap2& map, Edge e) { map.cut_edge(e); }
+	);
+}
+CGOGN_BENCHMARK(cut_edge)->args(SURFACE_SIZES);
+
+// edges of the triangular tore whose incident faces are not incident to another selected edge
+void flip_edge(State& state)
+{
+	apply_on_edges(state, triangular_tore(state.arg()),
+		[] (const CMap2& map, std::vector<Edge>& edges)
+		{
+			// the faces are not embedded: their darts are marked
+			DartMarker<CMap2> marker(map);
+			map.foreach_cell([&] (Edge e)
+			{
+				const Dart d = e.dart;
+				const Dart d2 = map.phi2(e.dart);
+				if (!marker.is_marked(d) && !marker.is_marked(d2))
+				{
+					marker.mark_orbit(Face(d));
+					marker.mark_orbit(Face(d2));
+					edges.push_back(e);
+				}
+			});
+		},
+		[] (CMap2& map, Edge e) { map.flip_edge(e); }
+	);
+}
+CGOGN_BENCHMARK(flip_edge)->args(SURFACE_SIZES);
+
+// collapsible edges of the triangular tore whose vertices are not adjacent to another selected edge
+void collapse_edge(State& state)
+{
+	apply_on_edges(state, triangular_tore(state.arg()),
+		[] (const CMap2& map, std::vector<Edge>& edges)
+		{
+			CellMarker<CMap2, Vertex::ORBIT> marker(map);
+			map.foreach_cell([&] (Edge e)
+			{
+				const std::pair<Vertex, Vertex> v = map.vertices(e);
+				if (marker.is_marked(v.first) || marker.is_marked(v.second) || !map.edge_can_collapse(e))
+					return;
+				for (Vertex w : { v.first, v.second })
+				{
+					marker.mark(w);
+					map.foreach_adjacent_vertex_through_edge(w, [&] (Vertex u) { marker.mark(u); });
+				}
+				edges.push_back(e);
+			});
+		},
+		[] (CMap2& map, Edge e) { map.collapse_edge(e); }
+	);
+}
+CGOGN_BENCHMARK(collapse_edge)->args(SURFACE_SIZES);
+
+} // namespace benchmark
+
+} // namespace cgogn
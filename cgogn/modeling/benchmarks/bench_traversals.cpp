@@ -0,0 +1,348 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <algorithm>
+
+#include <cgogn/core/basic/dart_marker.h>
+#include <cgogn/core/basic/cell_marker.h>
+
+#include "benchmark.h"
+#include "meshes.h"
+
+namespace cgogn
+{
+
+namespace benchmark
+{
+
+using Vertex2 = CMap2::Vertex;
+using Face2 = CMap2::Face;
+using Vertex3 = CMap3::Vertex;
+using Volume3 = CMap3::Volume;
+
+// number of quads per side of the tori / of hexahedra per side of the volumes
+const std::vector<uint32> SURFACE_SIZES = { 32u, 128u, 512u };
+const std::vector<uint32> VOLUME_SIZES = { 8u, 16u, 32u };
+
+/*****************************************************************************
+ * traversals of the cells (surface)
+ *****************************************************************************/
+
+template <TraversalStrategy STRATEGY>
+void foreach_vertex(State& state)
+{
+	const CMap2& map = square_tore(state.arg());
+	const CMap2::VertexAttribute<Vec3> position = map.get_attribute<Vec3, Vertex2>("position");
+	uint64 nb_cells = 0u;
+	float64 sum = 0.0;
+	while (state.keep_running())
+	{
+		map.foreach_cell<STRATEGY>([&] (Vertex2 v)
+		{
+			sum += position[v][0];
+			++nb_cells;
+		});
+	}
+	do_not_optimize(sum);
+	state.set_items_processed(nb_cells);
+}
+CGOGN_BENCHMARK(foreach_vertex<AUTO>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(foreach_vertex<FORCE_DART_MARKING>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(foreach_vertex<FORCE_CELL_MARKING>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(foreach_vertex<FORCE_CHUNK_RANGE>)->args(SURFACE_SIZES);
+
+// the faces are not embedded: traversal by dart marking
+void foreach_face(State& state)
+{
+	const CMap2& map = square_tore(state.arg());
+	uint64 nb_cells = 0u;
+	while (state.keep_running())
+		map.foreach_cell([&] (Face2) { ++nb_cells; });
+	do_not_optimize(nb_cells);
+	state.set_items_processed(nb_cells);
+}
+CGOGN_BENCHMARK(foreach_face)->args(SURFACE_SIZES);
+
+template <TraversalStrategy STRATEGY>
+void parallel_foreach_vertex(State& state)
+{
+	CMap2& map = square_tore(state.arg());
+	const CMap2::VertexAttribute<Vec3> position = map.get_attribute<Vec3, Vertex2>("position");
+	CMap2::VertexAttribute<Vec3> result = map.add_attribute<Vec3, Vertex2>("result");
+	uint64 nb_cells = 0u;
+	while (state.keep_running())
+	{
+		map.parallel_foreach_cell<STRATEGY>([&] (Vertex2 v)
+		{
+			result[v] = position[v] * 2.0;
+		});
+		nb_cells += map.nb_cells<Vertex2>();
+	}
+	map.remove_attribute(result);
+	state.set_items_processed(nb_cells);
+}
+CGOGN_BENCHMARK(parallel_foreach_vertex<AUTO>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(parallel_foreach_vertex<FORCE_DART_MARKING>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(parallel_foreach_vertex<FORCE_CELL_MARKING>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(parallel_foreach_vertex<FORCE_CHUNK_RANGE>)->args(SURFACE_SIZES);
+
+/*****************************************************************************
+ * traversals of the cells (volume)
+ *****************************************************************************/
+
+template <TraversalStrategy STRATEGY>
+void foreach_vertex_3(State& state)
+{
+	const CMap3& map = hexa_grid(state.arg());
+	const CMap3::VertexAttribute<Vec3> position = map.get_attribute<Vec3, Vertex3>("position");
+	uint64 nb_cells = 0u;
+	float64 sum = 0.0;
+	while (state.keep_running())
+	{
+		map.foreach_cell<STRATEGY>([&] (Vertex3 v)
+		{
+			sum += position[v][0];
+			++nb_cells;
+		});
+	}
+	do_not_optimize(sum);
+	state.set_items_processed(nb_cells);
+}
+CGOGN_BENCHMARK(foreach_vertex_3<AUTO>)->args(VOLUME_SIZES);
+CGOGN_BENCHMARK(foreach_vertex_3<FORCE_DART_MARKING>)->args(VOLUME_SIZES);
+CGOGN_BENCHMARK(foreach_vertex_3<FORCE_CELL_MARKING>)->args(VOLUME_SIZES);
+CGOGN_BENCHMARK(foreach_vertex_3<FORCE_CHUNK_RANGE>)->args(VOLUME_SIZES);
+
+void foreach_volume_3(State& state)
+{
+	const CMap3& map = hexa_grid(state.arg());
+	uint64 nb_cells = 0u;
+	while (state.keep_running())
+		map.foreach_cell([&] (Volume3) { ++nb_cells; });
+	do_not_optimize(nb_cells);
+	state.set_items_processed(nb_cells);
+}
+CGOGN_BENCHMARK(foreach_volume_3)->args(VOLUME_SIZES);
+
+void parallel_foreach_vertex_3(State& state)
+{
+	CMap3& map = hexa_grid(state.arg());
+	const CMap3::VertexAttribute<Vec3> position = map.get_attribute<Vec3, Vertex3>("position");
+	CMap3::VertexAttribute<Vec3> result = map.add_attribute<Vec3, Vertex3>("result");
+	uint64 nb_cells = 0u;
+	while (state.keep_running())
+	{
+		map.parallel_foreach_cell([&] (Vertex3 v)
+		{
+			result[v] = position[v] * 2.0;
+		});
+		nb_cells += map.nb_cells<Vertex3>();
+	}
+	map.remove_attribute(result);
+	state.set_items_processed(nb_cells);
+}
+CGOGN_BENCHMARK(parallel_foreach_vertex_3)->args(VOLUME_SIZES);
+
+/*****************************************************************************
+ * markers
+ *****************************************************************************/
+
+using DartMarker2 = DartMarker<CMap2>;
+using DartMarkerStore2 = DartMarkerStore<CMap2>;
+using DartMarkerEpoch2 = DartMarkerEpoch<CMap2>;
+using CellMarker2 = CellMarker<CMap2, Vertex2::ORBIT>;
+using CellMarkerStore2 = CellMarkerStore<CMap2, Vertex2::ORBIT>;
+using CellMarkerEpoch2 = CellMarkerEpoch<CMap2, Vertex2::ORBIT>;
+
+// one marker marking all the darts of the map
+template <typename MARKER>
+void mark_all_darts(State& state)
+{
+	const CMap2& map = square_tore(state.arg());
+	uint64 nb_darts = 0u;
+	while (state.keep_running())
+	{
+		MARKER marker(map);
+		map.foreach_dart([&] (Dart d)
+		{
+			if (!marker.is_marked(d))
+			{
+				marker.mark(d);
+				++nb_darts;
+			}
+		});
+	}
+	state.set_items_processed(nb_darts);
+}
+CGOGN_BENCHMARK(mark_all_darts<DartMarker2>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(mark_all_darts<DartMarkerStore2>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(mark_all_darts<DartMarkerEpoch2>)->args(SURFACE_SIZES);
+
+// one marker marking all the vertices of the map
+template <typename MARKER>
+void mark_all_vertices(State& state)
+{
+	const CMap2& map = square_tore(state.arg());
+	uint64 nb_cells = 0u;
+	while (state.keep_running())
+	{
+		MARKER marker(map);
+		map.foreach_dart([&] (Dart d)
+		{
+			if (!marker.is_marked(Vertex2(d)))
+			{
+				marker.mark(Vertex2(d));
+				++nb_cells;
+			}
+		});
+	}
+	state.set_items_processed(nb_cells);
+}
+CGOGN_BENCHMARK(mark_all_vertices<CellMarker2>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(mark_all_vertices<CellMarkerStore2>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(mark_all_vertices<CellMarkerEpoch2>)->args(SURFACE_SIZES);
+
+// a marker per local query (the darts of the faces incident to a vertex), for the first NB_QUERIES vertices
+template <typename MARKER>
+void mark_vertex_stars(State& state)
+{
+	const uint32 NB_QUERIES = 256u;
+	const CMap2& map = square_tore(state.arg());
+	std::vector<Vertex2> vertices;
+	map.foreach_cell([&] (Vertex2 v) -> bool
+	{
+		vertices.push_back(v);
+		return vertices.size() < NB_QUERIES;
+	});
+
+	uint64 nb_queries = 0u;
+	while (state.keep_running())
+	{
+		for (Vertex2 v : vertices)
+		{
+			MARKER marker(map);
+			map.foreach_incident_face(v, [&] (Face2 f)
+			{
+				map.foreach_dart_of_orbit(f, [&] (Dart d) { marker.mark(d); });
+			});
+		}
+		nb_queries += vertices.size();
+	}
+	state.set_items_processed(nb_queries);
+}
+CGOGN_BENCHMARK(mark_vertex_stars<DartMarker2>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(mark_vertex_stars<DartMarkerStore2>)->args(SURFACE_SIZES);
+CGOGN_BENCHMARK(mark_vertex_stars<DartMarkerEpoch2>)->args(SURFACE_SIZES);
+
+/*****************************************************************************
+ * phi composition
+ *****************************************************************************/
+
+// compile-time composition phi<N>
+void phi_composition(State& state)
+{
+	const CMap2& map = square_tore(state.arg());
+	uint64 nb_darts = 0u;
+	uint32 sum = 0u;
+	while (state.keep_running())
+	{
+		map.foreach_dart([&] (Dart d)
+		{
+			sum += map.phi<12121>(d).index;
+			++nb_darts;
+		});
+	}
+	do_not_optimize(sum);
+	state.set_items_processed(nb_darts);
+}
+CGOGN_BENCHMARK(phi_composition)->args(SURFACE_SIZES);
+
+// same composition with nested calls
+void phi_nested_calls(State& state)
+{
+	const CMap2& map = square_tore(state.arg());
+	uint64 nb_darts = 0u;
+	uint32 sum = 0u;
+	while (state.keep_running())
+	{
+		map.foreach_dart([&] (Dart d)
+		{
+			sum += map.phi1(map.phi2(map.phi1(map.phi2(map.phi1(d))))).index;
+			++nb_darts;
+		});
+	}
+	do_not_optimize(sum);
+	state.set_items_processed(nb_darts);
+}
+CGOGN_BENCHMARK(phi_nested_calls)->args(SURFACE_SIZES);
+
+/*****************************************************************************
+ * attribute access
+ *****************************************************************************/
+
+// access through the cells: indirection by the embedding of the vertices
+void attribute_access_by_cell(State& state)
+{
+	const CMap2& map = square_tore(state.arg());
+	const CMap2::VertexAttribute<Vec3> position = map.get_attribute<Vec3, Vertex2>("position");
+	uint64 nb_accesses = 0u;
+	Vec3 sum(0.0, 0.0, 0.0);
+	while (state.keep_running())
+	{
+		map.foreach_cell([&] (Vertex2 v)
+		{
+			map.foreach_adjacent_vertex_through_edge(v, [&] (Vertex2 u)
+			{
+				sum += position[u];
+				++nb_accesses;
+			});
+		});
+	}
+	do_not_optimize(sum);
+	state.set_items_processed(nb_accesses);
+}
+CGOGN_BENCHMARK(attribute_access_by_cell)->args(SURFACE_SIZES);
+
+// sequential access through the iterator of the attribute
+void attribute_access_by_iterator(State& state)
+{
+	const CMap2& map = square_tore(state.arg());
+	const CMap2::VertexAttribute<Vec3> position = map.get_attribute<Vec3, Vertex2>("position");
+	uint64 nb_accesses = 0u;
+	Vec3 sum(0.0, 0.0, 0.0);
+	while (state.keep_running())
+	{
+		for (const Vec3& p : position)
+		{
+			sum += p;
+			++nb_accesses;
+		}
+	}
+	do_not_optimize(sum);
+	state.set_items_processed(nb_accesses);
+}
+CGOGN_BENCHMARK(attribute_access_by_iterator)->args(SURFACE_SIZES);
+
+} // namespace benchmark
+
+} // namespace cgogn
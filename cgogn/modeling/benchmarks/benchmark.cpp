@@ -0,0 +1,422 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+#include <cgogn/core/utils/logger.h>
+#include <cgogn/core/utils/thread.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/unique_ptr.h>
+
+#include "benchmark.h"
+
+namespace cgogn
+{
+
+namespace benchmark
+{
+
+State::State(uint64 nb_iterations, uint32 arg) :
+	nb_iterations_(nb_iterations),
+	iteration_(0u),
+	arg_(arg),
+	nb_items_(0u),
+	running_(false),
+	cpu_start_(0),
+	real_time_(0.0),
+	cpu_time_(0.0)
+{}
+
+bool State::keep_running()
+{
+	if (iteration_ == 0u)
+		start_timing();
+	if (iteration_ < nb_iterations_)
+	{
+		++iteration_;
+		return true;
+	}
+	stop_timing();
+	return false;
+}
+
+void State::pause_timing()
+{
+	stop_timing();
+}
+
+void State::resume_timing()
+{
+	start_timing();
+}
+
+void State::start_timing()
+{
+	if (!running_)
+	{
+		running_ = true;
+		cpu_start_ = std::clock();
+		real_start_ = Clock::now();
+	}
+}
+
+void State::stop_timing()
+{
+	if (running_)
+	{
+		real_time_ += std::chrono::duration<float64>(Clock::now() - real_start_).count();
+		cpu_time_ += float64(std::clock() - cpu_start_) / CLOCKS_PER_SEC;
+		running_ = false;
+	}
+}
+
+Benchmark::Benchmark(const std::string& name, const Function& function) :
+	name_(name),
+	function_(function)
+{}
+
+Benchmark* Benchmark::register_benchmark(const std::string& name, const Function& function)
+{
+	std::vector<std::unique_ptr<Benchmark>>& registered = const_cast<std::vector<std::unique_ptr<Benchmark>>&>(benchmarks());
+	registered.push_back(make_unique<Benchmark>(name, function));
+	return registered.back().get();
+}
+
+const std::vector<std::unique_ptr<Benchmark>>& Benchmark::benchmarks()
+{
+	static std::vector<std::unique_ptr<Benchmark>> registered;
+	return registered;
+}
+
+Benchmark* Benchmark::arg(uint32 a)
+{
+	args_.push_back(a);
+	return this;
+}
+
+Benchmark* Benchmark::args(const std::vector<uint32>& a)
+{
+	args_.insert(args_.end(), a.begin(), a.end());
+	return this;
+}
+
+namespace
+{
+
+struct Options
+{
+	Options() :
+		filter_(".*"),
+		min_time_(0.5),
+		repetitions_(1u),
+		json_on_console_(false),
+		list_only_(false)
+	{}
+
+	std::string filter_;
+	float64 min_time_;
+	uint32 repetitions_;
+	std::string out_filename_;
+	bool json_on_console_;
+	bool list_only_;
+};
+
+struct Result
+{
+	std::string name_;
+	std::string run_name_;
+	std::string aggregate_name_; // empty for an iteration run
+	uint32 repetitions_;
+	uint64 iterations_;
+	float64 real_time_;	// ns per iteration
+	float64 cpu_time_;	// ns per iteration
+	float64 items_per_second_;
+	std::string label_;
+};
+
+bool parse_options(int argc, char** argv, Options& options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string option(argv[i]);
+		const std::size_t eq = option.find('=');
+		const std::string key = option.substr(0u, eq);
+		const std::string value = eq == std::string::npos ? std::string() : option.substr(eq + 1u);
+		if (key == "--benchmark_filter")
+			options.filter_ = value;
+		else if (key == "--benchmark_min_time")
+			options.min_time_ = std::stod(value);
+		else if (key == "--benchmark_repetitions")
+			options.repetitions_ = std::max(1, std::stoi(value));
+		else if (key == "--benchmark_out")
+			options.out_filename_ = value;
+		else if (key == "--benchmark_format")
+			options.json_on_console_ = (value == "json");
+		else if (key == "--benchmark_list_tests")
+			options.list_only_ = true;
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]"
+					  << " [--benchmark_repetitions=<n>] [--benchmark_out=<file.json>] [--benchmark_format=<console|json>]"
+					  << " [--benchmark_list_tests]" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string escape_json(const std::string& str)
+{
+	std::string escaped;
+	escaped.reserve(str.size());
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+			escaped.push_back('\\');
+		escaped.push_back(c);
+	}
+	return escaped;
+}
+
+Result make_result(const std::string& name, const State& state)
+{
+	Result r;
+	r.name_ = name;
+	r.run_name_ = name;
+	r.repetitions_ = 1u;
+	r.iterations_ = state.iterations();
+	r.real_time_ = state.real_time() * 1e9 / float64(state.iterations());
+	r.cpu_time_ = state.cpu_time() * 1e9 / float64(state.iterations());
+	r.items_per_second_ = state.real_time() > 0.0 ? float64(state.items_processed()) / state.real_time() : 0.0;
+	r.label_ = state.label();
+	return r;
+}
+
+// runs of a benchmark with an increasing number of iterations, until the measure lasts min_time
+std::vector<Result> run(const Benchmark& b, uint32 arg, const std::string& name, const Options& options)
+{
+	uint64 nb_iterations = 1u;
+	for (;;)
+	{
+		State state(nb_iterations, arg);
+		b.run(state);
+		const float64 t = state.real_time();
+		if (t >= options.min_time_ || nb_iterations >= 1000000000u)
+			break;
+		// as Google Benchmark: aim 40% over min_time, at most 10 times more iterations than the previous try
+		const float64 multiplier = t > 0.0 ? std::min(10.0, options.min_time_ * 1.4 / t) : 10.0;
+		nb_iterations = std::max(nb_iterations + 1u, uint64(float64(nb_iterations) * multiplier));
+	}
+
+	std::vector<Result> results;
+	for (uint32 r = 0u; r < options.repetitions_; ++r)
+	{
+		State state(nb_iterations, arg);
+		b.run(state);
+		results.push_back(make_result(name, state));
+		results.back().repetitions_ = options.repetitions_;
+	}
+
+	if (options.repetitions_ > 1u)
+	{
+		const uint32 n = options.repetitions_;
+		auto aggregate = [&] (const std::string& aggregate_name, const std::function<float64(std::vector<float64>)>& f)
+		{
+			Result a = results.front();
+			a.name_ = name + "_" + aggregate_name;
+			a.aggregate_name_ = aggregate_name;
+			std::vector<float64> real, cpu, items;
+			for (uint32 i = 0u; i < n; ++i)
+			{
+				real.push_back(results[i].real_time_);
+				cpu.push_back(results[i].cpu_time_);
+				items.push_back(results[i].items_per_second_);
+			}
+			a.real_time_ = f(real);
+			a.cpu_time_ = f(cpu);
+			a.items_per_second_ = f(items);
+			return a;
+		};
+		auto mean = [] (std::vector<float64> v)
+		{
+			float64 sum = 0.0;
+			for (float64 x : v)
+				sum += x;
+			return sum / float64(v.size());
+		};
+		auto median = [] (std::vector<float64> v)
+		{
+			std::sort(v.begin(), v.end());
+			const std::size_t m = v.size() / 2u;
+			return v.size() % 2u == 1u ? v[m] : (v[m - 1u] + v[m]) / 2.0;
+		};
+		auto stddev = [mean] (std::vector<float64> v)
+		{
+			const float64 mu = mean(v);
+			float64 sum = 0.0;
+			for (float64 x : v)
+				sum += (x - mu) * (x - mu);
+			return std::sqrt(sum / float64(v.size() - 1u));
+		};
+		results.push_back(aggregate("mean", mean));
+		results.push_back(aggregate("median", median));
+		results.push_back(aggregate("stddev", stddev));
+	}
+
+	return results;
+}
+
+void print_console_header(std::ostream& o)
+{
+	o << std::left << std::setw(64) << "Benchmark" << std::right
+	  << std::setw(16) << "Time (ns)" << std::setw(16) << "CPU (ns)"
+	  << std::setw(14) << "Iterations" << "  Items/s" << std::endl;
+	o << std::string(128, '-') << std::endl;
+}
+
+void print_console(std::ostream& o, const Result& r)
+{
+	o << std::left << std::setw(64) << r.name_ << std::right << std::fixed << std::setprecision(0)
+	  << std::setw(16) << r.real_time_ << std::setw(16) << r.cpu_time_
+	  << std::setw(14) << r.iterations_;
+	if (r.items_per_second_ > 0.0)
+		o << "  " << std::scientific << std::setprecision(3) << r.items_per_second_;
+	if (!r.label_.empty())
+		o << "  " << r.label_;
+	o << std::defaultfloat << std::endl;
+}
+
+void write_json(std::ostream& o, const std::vector<Result>& results, const char* executable)
+{
+	const std::time_t now = std::time(nullptr);
+	char date[64];
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+	o << "{\n  \"context\": {\n";
+	o << "    \"date\": \"" << date << "\",\n";
+	o << "    \"executable\": \"" << escape_json(executable) << "\",\n";
+	o << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+	o << "    \"nb_workers\": " << thread_pool()->nb_workers() << ",\n";
+#ifdef NDEBUG
+	o << "    \"library_build_type\": \"release\"\n";
+#else
+	o << "    \"library_build_type\": \"debug\"\n";
+#endif
+	o << "  },\n  \"benchmarks\": [";
+	o << std::setprecision(10);
+	for (std::size_t i = 0u; i < results.size(); ++i)
+	{
+		const Result& r = results[i];
+		o << (i == 0u ? "\n" : ",\n") << "    {\n";
+		o << "      \"name\": \"" << escape_json(r.name_) << "\",\n";
+		o << "      \"run_name\": \"" << escape_json(r.run_name_) << "\",\n";
+		o << "      \"run_type\": \"" << (r.aggregate_name_.empty() ? "iteration" : "aggregate") << "\",\n";
+		if (!r.aggregate_name_.empty())
+			o << "      \"aggregate_name\": \"" << r.aggregate_name_ << "\",\n";
+		o << "      \"repetitions\": " << r.repetitions_ << ",\n";
+		o << "      \"iterations\": " << r.iterations_ << ",\n";
+		o << "      \"real_time\": " << r.real_time_ << ",\n";
+		o << "      \"cpu_time\": " << r.cpu_time_ << ",\n";
+		o << "      \"time_unit\": \"ns\"";
+		if (r.items_per_second_ > 0.0)
+			o << ",\n      \"items_per_second\": " << r.items_per_second_;
+		if (!r.label_.empty())
+			o << ",\n      \"label\": \"" << escape_json(r.label_) << "\"";
+		o << "\n    }";
+	}
+	o << "\n  ]\n}\n";
+}
+
+} // namespace
+
+int32 run_benchmarks(int argc, char** argv)
+{
+	Options options;
+	if (!parse_options(argc, argv, options))
+		return 1;
+
+	const std::regex filter(options.filter_);
+	std::vector<Result> results;
+
+	if (!options.json_on_console_ && !options.list_only_)
+		print_console_header(std::cout);
+
+	for (const auto& b : Benchmark::benchmarks())
+	{
+		std::vector<uint32> args = b->arguments();
+		if (args.empty())
+			args.push_back(0u);
+		for (uint32 a : args)
+		{
+			const std::string name = b->arguments().empty() ? b->name() : b->name() + "/" + std::to_string(a);
+			if (!std::regex_search(name, filter))
+				continue;
+			if (options.list_only_)
+			{
+				std::cout << name << std::endl;
+				continue;
+			}
+			for (const Result& r : run(*b, a, name, options))
+			{
+				if (!options.json_on_console_)
+					print_console(std::cout, r);
+				results.push_back(r);
+			}
+		}
+	}
+
+	if (options.json_on_console_)
+		write_json(std::cout, results, argv[0]);
+
+	if (!options.out_filename_.empty())
+	{
+		std::ofstream out(options.out_filename_, std::ios::out | std::ios::trunc);
+		if (!out.good())
+		{
+			cgogn_log_error("run_benchmarks") << "Unable to open the file \"" << options.out_filename_ << "\".";
+			return 1;
+		}
+		write_json(out, results, argv[0]);
+	}
+
+	return 0;
+}
+
+} // namespace benchmark
+
+} // namespace cgogn
+
+int main(int argc, char** argv)
+{
+	cgogn::thread_start(0, 0);
+	const cgogn::numerics::int32 status = cgogn::benchmark::run_benchmarks(argc, argv);
+	cgogn::thread_stop();
+	return status;
+}
@@ -0,0 +1,165 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_MODELING_BENCHMARKS_BENCHMARK_H_
+#define CGOGN_MODELING_BENCHMARKS_BENCHMARK_H_
+
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/definitions.h>
+
+/**
+ * Minimal micro-benchmark framework, in the manner of Google Benchmark:
+ * a benchmark is a function void(State&) registered with CGOGN_BENCHMARK(function)->arg(...)
+ * that repeats the measured code while state.keep_running() returns true.
+ * The runner chooses the number of iterations so that a run lasts at least --benchmark_min_time seconds
+ * and reports the time per iteration on the console and/or in a JSON file whose format is the one of
+ * Google Benchmark (so that its tools, e.g. compare.py, can be used to track the regressions).
+ */
+
+#define CGOGN_BENCHMARK_VARIABLE_(line) cgogn_benchmark_##line
+#define CGOGN_BENCHMARK_VARIABLE(line) CGOGN_BENCHMARK_VARIABLE_(line)
+#define CGOGN_BENCHMARK(function) \
+	static ::cgogn::benchmark::Benchmark* CGOGN_BENCHMARK_VARIABLE(__LINE__) = \
+		::cgogn::benchmark::Benchmark::register_benchmark(#function, function)
+
+namespace cgogn
+{
+
+namespace benchmark
+{
+
+class State final
+{
+public:
+
+	using Clock = std::chrono::steady_clock;
+
+	State(uint64 nb_iterations, uint32 arg);
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(State);
+
+	/**
+	 * @brief returns true while the measured code must be run again
+	 * The timing starts at the first call and stops when the number of iterations is reached.
+	 */
+	bool keep_running();
+
+	/**
+	 * @brief exclude the code between pause_timing() and resume_timing() from the measure (preparation of the data)
+	 */
+	void pause_timing();
+	void resume_timing();
+
+	inline uint32 arg() const { return arg_; }
+	inline uint64 iterations() const { return nb_iterations_; }
+
+	/**
+	 * @brief number of items (cells, darts...) processed by all the iterations, reported as items_per_second
+	 */
+	inline void set_items_processed(uint64 nb_items) { nb_items_ = nb_items; }
+	inline uint64 items_processed() const { return nb_items_; }
+
+	inline void set_label(const std::string& label) { label_ = label; }
+	inline const std::string& label() const { return label_; }
+
+	// measured times in seconds
+	inline float64 real_time() const { return real_time_; }
+	inline float64 cpu_time() const { return cpu_time_; }
+
+private:
+
+	void start_timing();
+	void stop_timing();
+
+	uint64 nb_iterations_;
+	uint64 iteration_;
+	uint32 arg_;
+	uint64 nb_items_;
+	std::string label_;
+	bool running_;
+	Clock::time_point real_start_;
+	std::clock_t cpu_start_;
+	float64 real_time_;
+	float64 cpu_time_;
+};
+
+class Benchmark final
+{
+public:
+
+	using Function = std::function<void(State&)>;
+
+	Benchmark(const std::string& name, const Function& function);
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(Benchmark);
+
+	static Benchmark* register_benchmark(const std::string& name, const Function& function);
+	static const std::vector<std::unique_ptr<Benchmark>>& benchmarks();
+
+	/**
+	 * @brief add a run of the benchmark with the given argument (e.g. the size of the generated mesh)
+	 */
+	Benchmark* arg(uint32 a);
+	Benchmark* args(const std::vector<uint32>& a);
+
+	inline const std::string& name() const { return name_; }
+	inline const std::vector<uint32>& arguments() const { return args_; }
+	inline void run(State& state) const { function_(state); }
+
+private:
+
+	std::string name_;
+	Function function_;
+	std::vector<uint32> args_;
+};
+
+/**
+ * @brief prevent the compiler from optimizing away the computation of value
+ */
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+/**
+ * @brief run the registered benchmarks selected by the command line options (cf. benchmark.cpp)
+ * @return the exit code of the program
+ */
+int32 run_benchmarks(int argc, char** argv);
+
+} // namespace benchmark
+
+} // namespace cgogn
+
+#endif // CGOGN_MODELING_BENCHMARKS_BENCHMARK_H_
@@ -0,0 +1,96 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <map>
+#include <memory>
+
+#include <cgogn/core/utils/unique_ptr.h>
+#include <cgogn/modeling/tiling/square_tore.h>
+#include <cgogn/modeling/tiling/triangular_tore.h>
+#include <cgogn/modeling/tiling/hexa_volume.h>
+
+#include "meshes.h"
+
+namespace cgogn
+{
+
+namespace benchmark
+{
+
+namespace
+{
+
+template <typename MAP, typename GENERATOR>
+MAP& cached_mesh(std::map<uint32, std::unique_ptr<MAP>>& cache, uint32 n, const GENERATOR& generate)
+{
+	std::unique_ptr<MAP>& map = cache[n];
+	if (!map)
+	{
+		map = make_unique<MAP>();
+		generate(*map, n);
+	}
+	return *map;
+}
+
+} // namespace
+
+CMap2& square_tore(uint32 n)
+{
+	static std::map<uint32, std::unique_ptr<CMap2>> cache;
+	return cached_mesh(cache, n, [] (CMap2& map, uint32 size)
+	{
+		CMap2::VertexAttribute<Vec3> position = map.add_attribute<Vec3, CMap2::Vertex>("position");
+		modeling::SquareTore<CMap2> tore(map, size, size);
+		tore.embed_into_tore(position, 10.0f, 4.0f);
+	});
+}
+
+CMap2& triangular_tore(uint32 n)
+{
+	static std::map<uint32, std::unique_ptr<CMap2>> cache;
+	return cached_mesh(cache, n, [] (CMap2& map, uint32 size)
+	{
+		CMap2::VertexAttribute<Vec3> position = map.add_attribute<Vec3, CMap2::Vertex>("position");
+		modeling::TriangularTore<CMap2> tore(map, size, size);
+		tore.embed_into_tore(position, 10.0f, 4.0f);
+	});
+}
+
+CMap3& hexa_grid(uint32 n)
+{
+	static std::map<uint32, std::unique_ptr<CMap3>> cache;
+	return cached_mesh(cache, n, [] (CMap3& map, uint32 size)
+	{
+		CMap3::VertexAttribute<Vec3> position = map.add_attribute<Vec3, CMap3::Vertex>("position");
+		modeling::TilingHexa grid(map, size, size, size);
+		grid.embedded_grid3D();
+		grid.update_positions([&] (CMap3::Vertex v, float64 x, float64 y, float64 z)
+		{
+			position[v] = Vec3(x, y, z);
+		});
+	});
+}
+
+} // namespace benchmark
+
+} // namespace cgogn
@@ -0,0 +1,66 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_MODELING_BENCHMARKS_MESHES_H_
+#define CGOGN_MODELING_BENCHMARKS_MESHES_H_
+
+#include <array>
+
+#include <cgogn/core/cmap/cmap2.h>
+#include <cgogn/core/cmap/cmap3.h>
+#include <cgogn/geometry/types/vec.h>
+
+namespace cgogn
+{
+
+namespace benchmark
+{
+
+using Vec3 = geometry::Vec_T<std::array<float64, 3>>;
+
+/**
+ * The meshes of the benchmarks are generated tilings (so that the measures are reproducible),
+ * with a "position" vertex attribute. They are generated once per size and kept for the next runs:
+ * the benchmarks that modify a mesh must work on a copy (cf. MapBase::clone).
+ */
+
+/**
+ * @brief closed surface of n x n quads (each vertex has degree 4)
+ */
+CMap2& square_tore(uint32 n);
+
+/**
+ * @brief closed surface of 2 x n x n triangles (each vertex has degree 6)
+ */
+CMap2& triangular_tore(uint32 n);
+
+/**
+ * @brief volume mesh of n x n x n hexahedra
+ */
+CMap3& hexa_grid(uint32 n);
+
+} // namespace benchmark
+
+} // namespace cgogn
+
+#endif // CGOGN_MODELING_BENCHMARKS_MESHES_H_
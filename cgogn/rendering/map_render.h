@@ -266,6 +266,8 @@ public:
 
 		using VEC3 = InsideTypeOf<VERTEX_ATTR>;
 
+		cgogn_profile_zone("MapRender::init_primitives");
+
 		std::vector<uint32> table_indices;
 
 		switch (prim)
@@ -315,6 +317,8 @@ public:
 
 		using VEC3 = InsideTypeOf<VERTEX_ATTR>;
 
+		cgogn_profile_zone("MapRender::init_primitives");
+
 		std::vector<uint32> table_indices;
 
 		switch (prim)
@@ -352,6 +356,8 @@ public:
 
 		using VEC3 = InsideTypeOf<VERTEX_ATTR>;
 
+		cgogn_profile_zone("MapRender::init_primitives");
+
 		std::vector<uint32> table_indices;
 
 		switch (prim)
@@ -401,6 +407,8 @@ public:
 	)
 		-> typename std::enable_if<(MAP::DIMENSION == 2 || MAP::DIMENSION == 3) && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
 	{
+		cgogn_profile_zone("MapRender::init_primitives");
+
 		std::vector<uint32> table_indices;
 
 		switch (prim)
@@ -442,6 +450,8 @@ public:
 	)
 		-> typename std::enable_if<MAP::DIMENSION == 0 && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
 	{
+		cgogn_profile_zone("MapRender::init_primitives");
+
 		std::vector<uint32> table_indices;
 
 		switch (prim)
@@ -474,6 +484,8 @@ public:
 	)
 		-> typename std::enable_if<MAP::DIMENSION == 1 && !std::is_same<MASK, typename MAP::BoundaryCache>::value, void>::type
 	{
+		cgogn_profile_zone("MapRender::init_primitives");
+
 		std::vector<uint32> table_indices;
 
 		switch (prim)